@@ -1,4 +1,5 @@
 #include "AdamBashforth.h"
+#include <stdexcept>
 
 AdamBashforth::AdamBashforth()
 {
@@ -10,8 +11,12 @@ AdamBashforth::~AdamBashforth()
 
 }
 
-AdamBashforth::AdamBashforth(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, Eigen::VectorXd beta) : MultiStep(step_size, initial_time, final_time, initial_condition, function, beta, BETA)
+AdamBashforth::AdamBashforth(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, Eigen::VectorXd beta) : MultiStep(step_size, initial_time, final_time, initial_condition, function)
 {
+    // The explicit method has no coefficient for the new time point, only one per previous step.
+    if (beta.size() != initial_condition.cols())
+        throw std::invalid_argument("Coefficient vector must have the same size as the number of steps in the initial condition matrix.");
+    this->beta = beta;
     SetAlpha();
 }
 
@@ -26,16 +31,29 @@ void AdamBashforth::SetAlpha()
 }
 
 Eigen::MatrixXd AdamBashforth::Solve()
+{
+    MatrixSink sink;
+    SolveTo(sink);
+    return sink.Release();
+}
+
+void AdamBashforth::SolveTo(TrajectorySink& sink)
 {
     auto y0 = initial_condition;
-    Eigen::MatrixXd approximations = Eigen::MatrixXd::Zero(y0.col(0).size(), (int)((final_time - initial_time) / step_size) + 1);
+    Eigen::MatrixXd approximations = Eigen::MatrixXd::Zero(y0.col(0).size(), GetNumTimePoints());
     int n_max = approximations.cols();
     for(int i = 0; i < beta.size(); i++)
     {
         approximations.col(i) = initial_condition.col(i);
     }
-    int current_col = beta.size();
-
+    Eigen::MatrixXd rhs;
+    int first = RestoreHistory(approximations, rhs, beta.size());
+    int current_col = std::max(first, (int)beta.size());
+    sink.Begin(y0.rows(), n_max - first);
+    for (int n = first; n < current_col; n++)
+    {
+        sink.Append(approximations.col(n));
+    }
 
     for (int n = current_col; n < n_max; n++)
     {
@@ -49,8 +67,14 @@ Eigen::MatrixXd AdamBashforth::Solve()
 
         auto y1 = approximations.col(current_col - 1) + step_size * sum;
         approximations.col(current_col) = y1;
+        sink.Append(approximations.col(current_col));
         current_col++;
+        if (CheckpointDue())
+        {
+            sink.Flush();
+            SaveHistory(approximations, rhs, current_col, t, beta.size());
+        }
+        ReportStep(t);
     }
-
-    return approximations;
+    sink.End();
 }
\ No newline at end of file
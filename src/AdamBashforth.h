@@ -46,6 +46,7 @@ public:
      * @param initial_condition The initial condition of the problem.
      * @param function A Function object that includes the actual function of the problem.
      * @param beta The vector of coefficients for the Adam-Bashforth method.
+     * @throws std::invalid_argument If the coefficient vector size does not match the number of steps in the initial condition.
      */
     AdamBashforth(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, Eigen::VectorXd beta);
 
@@ -68,6 +69,12 @@ public:
      */
     Eigen::MatrixXd Solve() override;
 
+    /**
+     * @brief Solve the ODE using the Adam-Bashforth method, handing every time point to a sink as soon as it is computed.
+     * @param sink The sink receiving the solution at each time point.
+     */
+    void SolveTo(TrajectorySink& sink) override;
+
 private:
     /**
      * @brief Set the alpha coefficients for the Adam-Bashforth method.
@@ -1,5 +1,7 @@
 #include "AdamMoulton.h"
 #include "NewtonMethod.h"
+#include <stdexcept>
+#include <string>
 #include <typeinfo>
 
 AdamMoulton::AdamMoulton()
@@ -10,11 +12,13 @@ AdamMoulton::AdamMoulton()
 AdamMoulton::AdamMoulton(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, Eigen::VectorXd beta) : MultiStep(step_size, initial_time, final_time, initial_condition, function, beta, BETA)
 {
     SetAlpha();
+    SetPredictor(ADAMS_BASHFORTH);
 }
 
 AdamMoulton::AdamMoulton(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : MultiStep(step_size, initial_time, final_time, initial_condition, function)
 {
     SetAlpha();
+    SetPredictor(ADAMS_BASHFORTH);
 }
 
 AdamMoulton::~AdamMoulton()
@@ -27,31 +31,73 @@ void AdamMoulton::SetAlpha()
     this->alpha = Eigen::VectorXd::Zero(this->beta.size());
 }
 
+void AdamMoulton::SetCorrector(CorrectorType corrector)
+{
+    this->corrector = corrector;
+}
+
 Eigen::MatrixXd AdamMoulton::Solve()
+{
+    MatrixSink sink;
+    SolveTo(sink);
+    return sink.Release();
+}
+
+void AdamMoulton::SolveTo(TrajectorySink& sink)
 {
     auto y0 = initial_condition;
-    Eigen::MatrixXd approximations = Eigen::MatrixXd::Zero(y0.col(0).size(), (int)((final_time - initial_time) / step_size) + 1);
+    Eigen::MatrixXd approximations = Eigen::MatrixXd::Zero(y0.col(0).size(), GetNumTimePoints());
     int n_max = approximations.cols();
-    for(int i = 0; i < (beta.size() - 1); i++)
+    int history = beta.size() - 1;
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(y0.col(0).size(), n_max);
+    for(int i = 0; i < history; i++)
     {
         approximations.col(i) = initial_condition.col(i);
+        rhs.col(i) = function.BuildRightHandSide(initial_time + (i * step_size), approximations.col(i));
+    }
+    Eigen::VectorXd coefficients = PredictorCoefficients(history);
+    int first = RestoreHistory(approximations, rhs, std::max(history, 1));
+    int current_col = std::max(first, history);
+    sink.Begin(y0.rows(), n_max - first);
+    for (int n = first; n < current_col; n++)
+    {
+        sink.Append(approximations.col(n));
     }
-    int current_col = beta.size() - 1;
 
     for (int n = current_col; n < n_max; n++)
     {
         double t = initial_time + (n * step_size);
         Eigen::VectorXd sum = Eigen::VectorXd::Zero(y0.col(0).size());
-        for(int i = 0; i < (beta.size() - 1); i++)
+        for(int i = 0; i < history; i++)
         {
-            sum = sum + beta(i + 1) * function.BuildRightHandSide(t - ((i + 1) * step_size),  approximations.col(current_col - i - 1));
+            sum = sum + beta(i + 1) * rhs.col(current_col - i - 1);
+        }
+        Eigen::VectorXd guess = Predict(approximations, rhs, current_col, coefficients);
+
+        Eigen::VectorXd y1;
+        if (corrector == PECE)
+        {
+            y1 = approximations.col(current_col - 1) + step_size * (beta(0) * function.BuildRightHandSide(t, guess) + sum);
+        }
+        else
+        {
+            NewtonMethod newton_solver(function, approximations.col(current_col - 1), t, beta(0), sum, step_size);
+            newton_solver.SetInitialGuess(guess);
+            newton_solver.SetErrorWeights(ErrorWeights(approximations.col(current_col - 1)));
+            if (newton_solver.Solve(y1) != CONVERGED)
+                throw std::runtime_error("Newton method did not converge at time " + std::to_string(t) + ", try a smaller step size");
         }
-        NewtonMethod newton_solver(function, approximations.col(current_col - 1), t, beta(0), sum, step_size);
-        auto y1 = newton_solver.Solve();
 
         approximations.col(current_col) = y1;
+        rhs.col(current_col) = function.BuildRightHandSide(t, y1);
+        sink.Append(approximations.col(current_col));
         current_col++;
+        if (CheckpointDue())
+        {
+            sink.Flush();
+            SaveHistory(approximations, rhs, current_col, t, std::max(history, 1));
+        }
+        ReportStep(t);
     }
-
-    return approximations;
-}
\ No newline at end of file
+    sink.End();
+}
@@ -12,6 +12,14 @@
 #include <Eigen/Dense>
 #include "MultiStep.h"
 
+/**
+ * @brief An enumeration for the ways the Adams-Moulton corrector can be applied.
+ * 
+ * - NEWTON: the implicit equation is solved with Newton's method, starting from the predictor.
+ * - PECE: Predict-Evaluate-Correct-Evaluate, the corrector is applied once to the predicted value, so that no Jacobian or linear solve is needed. Suitable for non-stiff problems only.
+ */
+enum CorrectorType { NEWTON, PECE };
+
 /**
  * @brief A class for solving ordinary differential equations (ODEs) using the Adams-Moulton method.
  * 
@@ -24,6 +32,9 @@
  * \f]
  * 
  * where \f$ \alpha_0 = 1 \f$ the others \f$ \alpha_i = 0 \f$.
+ * 
+ * By default the implicit equation is solved with Newton's method starting from an explicit
+ * Adams-Bashforth predictor of the same number of steps.
  */
 class AdamMoulton : public MultiStep
 {
@@ -69,7 +80,21 @@ public:
      */
     Eigen::MatrixXd Solve() override;
 
+    /**
+     * @brief Solve the ODE using the Adam-Moulton method, handing every time point to a sink as soon as it is computed.
+     * @param sink The sink receiving the solution at each time point.
+     */
+    void SolveTo(TrajectorySink& sink) override;
+
+    /**
+     * @brief Set how the corrector is applied.
+     * @param corrector The corrector type.
+     */
+    void SetCorrector(CorrectorType corrector);
+
 private:
+    CorrectorType corrector = NEWTON;  ///< How the corrector is applied.
+
     /**
      * @brief Set the alpha coefficients for the Adam-Moulton method.
      * 
@@ -0,0 +1,235 @@
+#include "AdaptiveSolver.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+AdaptiveSolver::AdaptiveSolver()
+{
+
+}
+
+AdaptiveSolver::AdaptiveSolver(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : OdeSolver(step_size, initial_time, final_time, initial_condition, function)
+{
+
+}
+
+AdaptiveSolver::~AdaptiveSolver()
+{
+
+}
+
+void AdaptiveSolver::SetAdaptive(bool adaptive)
+{
+    this->adaptive = adaptive;
+}
+
+int AdaptiveSolver::GetAcceptedSteps() const
+{
+    return accepted_steps;
+}
+
+int AdaptiveSolver::GetRejectedSteps() const
+{
+    return rejected_steps;
+}
+
+void AdaptiveSolver::StartIntegration()
+{
+
+}
+
+double AdaptiveSolver::ProposeStepSize(double h, double error, bool accepted) const
+{
+    const double safety = 0.9;
+    const double min_factor = 0.2;
+    double max_factor = accepted ? 5.0 : 1.0;
+    if (!std::isfinite(error))
+        return h * min_factor;
+    if (error == 0.0)
+        return h * max_factor;
+    double factor = safety * std::pow(error, -1.0 / (ErrorOrder() + 1));
+    return h * std::min(max_factor, std::max(min_factor, factor));
+}
+
+double AdaptiveSolver::InitialStepSize(double t, const Eigen::VectorXd& y)
+{
+    Eigen::VectorXd weights = ErrorWeights(y);
+    Eigen::VectorXd f0 = function.BuildRightHandSide(t, y);
+    double d0 = WeightedRmsNorm(y, weights);
+    double d1 = WeightedRmsNorm(f0, weights);
+    double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+    h0 = std::min(h0, step_size);
+
+    // Estimate the second derivative with an explicit Euler step.
+    Eigen::VectorXd f1 = function.BuildRightHandSide(t + h0, y + h0 * f0);
+    double d2 = WeightedRmsNorm(f1 - f0, weights) / h0;
+    double d = std::max(d1, d2);
+    double h1 = (d <= 1e-15) ? std::max(1e-6, h0 * 1e-3) : std::pow(0.01 / d, 1.0 / (ErrorOrder() + 2));
+    return std::min(std::min(100 * h0, h1), step_size);
+}
+
+Eigen::MatrixXd AdaptiveSolver::Solve()
+{
+    MatrixSink sink;
+    SolveTo(sink);
+    return sink.Release();
+}
+
+void AdaptiveSolver::SolveTo(TrajectorySink& sink)
+{
+    int n_max = GetNumTimePoints();
+    Eigen::VectorXd y = initial_condition.col(0);
+    accepted_steps = 0;
+    rejected_steps = 0;
+    StartIntegration();
+
+    double t = initial_time;
+    double h;
+    int first = 1;
+    std::shared_ptr<const SolverCheckpoint> checkpoint = StartSolve(1);
+    if (checkpoint)
+    {
+        first = checkpoint->next_point;
+        t = checkpoint->time;
+        y = checkpoint->history.rightCols(1);
+        h = checkpoint->step_size;
+        accepted_steps = checkpoint->accepted_steps;
+        rejected_steps = checkpoint->rejected_steps;
+        RestoreControllerState(*checkpoint);
+        sink.Begin(y.size(), n_max - first);
+    }
+    else
+    {
+        h = adaptive ? InitialStepSize(t, y) : step_size;
+        sink.Begin(y.size(), n_max);
+        sink.Append(y);
+    }
+    Eigen::VectorXd y_new;
+    if (!events.IsEmpty())
+        events.Start(t, y);
+
+    for (int n = first; n < n_max; n++)
+    {
+        double t_out = initial_time + n * step_size;
+        if (!adaptive)
+        {
+            FixedStep(t, t_out - t, y, y_new);
+            double t_event;
+            while (!events.IsEmpty() && events.Check(function, t, y, t_out, y_new, t_event))
+            {
+                FixedStep(t, t_event - t, y, y_new);
+                if (events.Apply(t_event, y_new))
+                {
+                    sink.End();
+                    return;
+                }
+                t = t_event;
+                y = y_new;
+                accepted_steps++;
+                if (t >= t_out)
+                    break;
+                FixedStep(t, t_out - t, y, y_new);
+            }
+            y = y_new;
+            t = t_out;
+            accepted_steps++;
+            sink.Append(y);
+            if (CheckpointDue())
+            {
+                sink.Flush();
+                SaveCheckpoint(n + 1, t, h, y);
+            }
+            ReportStep(t);
+            continue;
+        }
+
+        while (t < t_out)
+        {
+            // Shorten the step to land on the output time, without letting that shrink the next proposal.
+            bool clipped = (t + h >= t_out);
+            double h_try = clipped ? t_out - t : h;
+            if (h_try < 16 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::abs(t)))
+                throw std::runtime_error("Step size too small at time " + std::to_string(t));
+
+            double error = std::numeric_limits<double>::infinity();
+            bool computed = AttemptStep(t, h_try, y, y_new, error);
+            if (!computed || !y_new.allFinite())
+                error = std::numeric_limits<double>::infinity();
+            bool accepted = (error <= 1.0);
+            double h_new = ProposeStepSize(h_try, error, accepted);
+
+            double t_event;
+            if (accepted && !events.IsEmpty() && events.Check(function, t, y, clipped ? t_out : t + h_try, y_new, t_event))
+            {
+                // Replace the step by a shorter one that ends at the event, whose error is smaller.
+                FixedStep(t, t_event - t, y, y_new);
+                accepted_steps++;
+                if (events.Apply(t_event, y_new))
+                {
+                    sink.End();
+                    return;
+                }
+                t = t_event;
+                y = y_new;
+                ReportStep(t);
+                continue;
+            }
+            if (accepted)
+            {
+                t = clipped ? t_out : t + h_try;
+                y = y_new;
+                accepted_steps++;
+                h = clipped ? std::max(h, h_new) : h_new;
+                ReportStep(t);
+            }
+            else
+            {
+                rejected_steps++;
+                h = h_new;
+            }
+        }
+        sink.Append(y);
+        if (CheckpointDue())
+        {
+            sink.Flush();
+            SaveCheckpoint(n + 1, t, h, y);
+        }
+    }
+    sink.End();
+}
+
+void AdaptiveSolver::FixedStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new)
+{
+    double error;
+    if (!AttemptStep(t, h, y, y_new, error))
+        throw std::runtime_error("Step failed at time " + std::to_string(t) + ", try a smaller step size");
+}
+
+bool AdaptiveSolver::SupportsEvents() const
+{
+    return true;
+}
+
+void AdaptiveSolver::SaveCheckpoint(long next_point, double t, double h, const Eigen::VectorXd& y)
+{
+    SolverCheckpoint checkpoint = NewCheckpoint(next_point, t);
+    checkpoint.step_size = h;
+    checkpoint.accepted_steps = accepted_steps;
+    checkpoint.rejected_steps = rejected_steps;
+    checkpoint.history = y;
+    SaveControllerState(checkpoint);
+    OdeSolver::SaveCheckpoint(checkpoint);
+}
+
+void AdaptiveSolver::SaveControllerState(SolverCheckpoint& /*checkpoint*/) const
+{
+
+}
+
+void AdaptiveSolver::RestoreControllerState(const SolverCheckpoint& /*checkpoint*/)
+{
+
+}
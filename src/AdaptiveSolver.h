@@ -0,0 +1,179 @@
+/**
+ * @file AdaptiveSolver.h
+ * @brief Defines the AdaptiveSolver class for one-step methods with embedded error estimation and step size control.
+ */
+
+#ifndef ADAPTIVESOLVER_H
+#define ADAPTIVESOLVER_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "OdeSolver.h"
+
+/**
+ * @brief A class for one-step solvers that estimate their local error and control the step size.
+ *
+ * The solution is still returned at the initial time and at every multiple of the step size, but in
+ * adaptive mode the solver takes as many internal steps as the tolerances require between two of these
+ * output times. Each internal step \f$ h \f$ produces an error estimate \f$ err \f$ measured in the weighted
+ * norm of the tolerances; the step is accepted if \f$ err \le 1 \f$ and the next step size is
+ *
+ * \f[
+ * h_{new} = h \cdot \min\left(f_{max}, \max\left(f_{min}, 0.9 \, err^{-1/(q+1)}\right)\right),
+ * \f]
+ *
+ * where \f$ q \f$ is the order of the embedded solution.
+ *
+ * In fixed mode exactly one step of size \f$ h \f$ is taken between two output times and the error estimate is ignored.
+ */
+class AdaptiveSolver : public OdeSolver
+{
+public:
+    /**
+     * @brief Construct a new AdaptiveSolver object.
+     */
+    AdaptiveSolver();
+
+    /**
+     * @brief Construct a new AdaptiveSolver object.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and optionally its Jacobian.
+     */
+    AdaptiveSolver(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the AdaptiveSolver object.
+     */
+    ~AdaptiveSolver();
+
+    /**
+     * @brief Enable or disable step size control.
+     * @param adaptive True to control the step size with the error estimate (default), false to take fixed steps.
+     */
+    void SetAdaptive(bool adaptive);
+
+    /**
+     * @brief Get the number of accepted steps of the last solve.
+     * @return int The number of accepted steps.
+     */
+    int GetAcceptedSteps() const;
+
+    /**
+     * @brief Get the number of rejected steps of the last solve.
+     * @return int The number of rejected steps.
+     */
+    int GetRejectedSteps() const;
+
+    /**
+     * @brief Solve the ODE problem.
+     * @return Eigen::MatrixXd A matrix containing the solution of the ODE at each output time.
+     * @throws std::runtime_error If a fixed step fails or the adaptive step size falls below the resolution of the time variable.
+     */
+    Eigen::MatrixXd Solve() override;
+
+    /**
+     * @brief Solve the ODE problem, handing every output time point to a sink as soon as it is reached.
+     * @param sink The sink receiving the solution at each time point.
+     * @throws std::runtime_error If a step fails or the step size becomes too small.
+     */
+    void SolveTo(TrajectorySink& sink) override;
+
+    /**
+     * @brief Check whether the method watches events.
+     * @return true, since every step can be shortened to end at an event.
+     */
+    bool SupportsEvents() const override;
+
+protected:
+    bool adaptive = true;  ///< Whether the step size is controlled by the error estimate.
+    int accepted_steps = 0;  ///< The number of accepted steps of the last solve.
+    int rejected_steps = 0;  ///< The number of rejected steps of the last solve.
+
+    /**
+     * @brief Attempt a single step of the method.
+     *
+     * @param t The time at the beginning of the step.
+     * @param h The step size.
+     * @param y The solution at the beginning of the step.
+     * @param y_new The solution at the end of the step.
+     * @param error The weighted norm of the local error estimate.
+     * @return true if the step could be computed, false if it failed (e.g. the Newton iteration did not converge).
+     */
+    virtual bool AttemptStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new, double& error) = 0;
+
+    /**
+     * @brief Get the order of the embedded solution used for the error estimate.
+     * @return int The order \f$ q \f$.
+     */
+    virtual int ErrorOrder() const = 0;
+
+    /**
+     * @brief Propose the size of the next step.
+     *
+     * @param h The size of the last attempted step.
+     * @param error The weighted norm of its error estimate, infinite if the step failed.
+     * @param accepted Whether the step was accepted.
+     * @return double The proposed step size.
+     */
+    virtual double ProposeStepSize(double h, double error, bool accepted) const;
+
+    /**
+     * @brief Prepare the method for a new integration.
+     *
+     * Called at the beginning of Solve(), so that data cached by a previous solve (e.g. a Jacobian) is discarded.
+     */
+    virtual void StartIntegration();
+
+    /**
+     * @brief Choose the size of the first step in adaptive mode.
+     *
+     * @param t The initial time.
+     * @param y The initial solution.
+     * @return double The initial step size, never larger than the output step.
+     */
+    double InitialStepSize(double t, const Eigen::VectorXd& y);
+
+    /**
+     * @brief Add the state the method keeps across steps to a checkpoint.
+     * 
+     * The default implementation adds nothing. Methods that carry a state from one step to the next, such as
+     * an order or a reused Jacobian, save it here so that a resumed solve takes the same steps.
+     * 
+     * @param checkpoint The checkpoint, with the solution and the step size already filled in.
+     */
+    virtual void SaveControllerState(SolverCheckpoint& checkpoint) const;
+
+    /**
+     * @brief Restore the state saved by SaveControllerState().
+     * 
+     * Called after StartIntegration() when a solve resumes from a checkpoint.
+     * 
+     * @param checkpoint The checkpoint.
+     * @throws std::runtime_error If the checkpoint does not hold the state of the method.
+     */
+    virtual void RestoreControllerState(const SolverCheckpoint& checkpoint);
+
+    /**
+     * @brief Write a checkpoint of the state reached at a time point.
+     * @param next_point The index of the time point after the state.
+     * @param t The time of the state.
+     * @param h The size of the next step.
+     * @param y The solution at the time point.
+     */
+    void SaveCheckpoint(long next_point, double t, double h, const Eigen::VectorXd& y);
+
+    /**
+     * @brief Take a step whose error estimate is ignored, as in fixed mode.
+     * @param t The time at the start of the step.
+     * @param h The size of the step.
+     * @param y The solution at the start of the step.
+     * @param y_new Set to the solution at the end of the step.
+     * @throws std::runtime_error If the step fails.
+     */
+    void FixedStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new);
+};
+
+#endif
@@ -2,6 +2,8 @@
 #include "MultiStep.h"
 #include "NewtonMethod.h"
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
 BDF::BDF()
 {
@@ -11,6 +13,7 @@ BDF::BDF()
 BDF::BDF(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, Eigen::VectorXd alpha) : MultiStep(step_size, initial_time, final_time, initial_condition, function, alpha, ALPHA)
 {
     SetBeta();
+    SetPredictor(EXTRAPOLATION);
 }
 
 BDF::~BDF()
@@ -25,34 +28,65 @@ void BDF::SetBeta()
 }
 
 Eigen::MatrixXd BDF::Solve()
+{
+    MatrixSink sink;
+    SolveTo(sink);
+    return sink.Release();
+}
+
+void BDF::SolveTo(TrajectorySink& sink)
 {
     auto y0 = initial_condition;
-    Eigen::MatrixXd approximations = Eigen::MatrixXd::Zero(y0.col(0).size(), (int)((final_time - initial_time) / step_size) + 1);
+    Eigen::MatrixXd approximations = Eigen::MatrixXd::Zero(y0.col(0).size(), GetNumTimePoints());
     int n_max = approximations.cols();
-    for(int i = 0; i < (alpha.size() - 1); i++)
+    int history = alpha.size() - 1;
+    // The function history is only needed by the Adams-Bashforth predictor.
+    bool store_rhs = (predictor == ADAMS_BASHFORTH);
+    Eigen::MatrixXd rhs = store_rhs ? Eigen::MatrixXd::Zero(y0.col(0).size(), n_max) : Eigen::MatrixXd(0, 0);
+    for(int i = 0; i < history; i++)
     {
         approximations.col(i) = initial_condition.col(i);
+        if (store_rhs)
+            rhs.col(i) = function.BuildRightHandSide(initial_time + (i * step_size), approximations.col(i));
+    }
+    Eigen::VectorXd coefficients = PredictorCoefficients(history);
+    int first = RestoreHistory(approximations, rhs, std::max(history, 1));
+    int current_col = std::max(first, history);
+    sink.Begin(y0.rows(), n_max - first);
+    for (int n = first; n < current_col; n++)
+    {
+        sink.Append(approximations.col(n));
     }
-    int current_col = alpha.size() - 1;
 
     for (int n = current_col; n < n_max; n++)
     {
         double t = initial_time + (n * step_size);
         Eigen::VectorXd sum = Eigen::VectorXd::Zero(y0.col(0).size());
-        for(int i = 0; i < (alpha.size() - 1); i++)
+        for(int i = 0; i < history; i++)
         {
             sum = sum + alpha(i+1) * approximations.col(current_col - i - 1);
         }
         
         NewtonMethod newton_solver(function, sum, t, alpha(0), step_size);
-        auto y1 = newton_solver.Solve();
+        newton_solver.SetInitialGuess(Predict(approximations, rhs, current_col, coefficients));
+        newton_solver.SetErrorWeights(ErrorWeights(approximations.col(current_col - 1)));
+        Eigen::VectorXd y1;
+        if (newton_solver.Solve(y1) != CONVERGED)
+            throw std::runtime_error("Newton method did not converge at time " + std::to_string(t) + ", try a smaller step size");
 
         approximations.col(current_col) = y1;
+        if (store_rhs)
+            rhs.col(current_col) = function.BuildRightHandSide(t, y1);
+        sink.Append(approximations.col(current_col));
         current_col++;
+        if (CheckpointDue())
+        {
+            sink.Flush();
+            SaveHistory(approximations, rhs, current_col, t, std::max(history, 1));
+        }
+        ReportStep(t);
     }
-
-    return approximations;
-
-}   
+    sink.End();
+}
 
 
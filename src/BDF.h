@@ -54,6 +54,12 @@ public:
      * @return An Eigen::MatrixXd containing the solution of the ODE at each time step.
      */
     Eigen::MatrixXd Solve() override;
+
+    /**
+     * @brief Solve the ODE using the BDF method, handing every time point to a sink as soon as it is computed.
+     * @param sink The sink receiving the solution at each time point.
+     */
+    void SolveTo(TrajectorySink& sink) override;
     
 private:
     /**
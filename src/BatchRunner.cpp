@@ -0,0 +1,168 @@
+#include "BatchRunner.h"
+#include "Problem.h"
+#include "ProblemCache.h"
+#include "ThreadPool.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace
+{
+// The directory part of a path, with its trailing slash, or an empty string.
+std::string DirectoryOf(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    return (slash == std::string::npos) ? "" : path.substr(0, slash + 1);
+}
+}
+
+BatchRunner::BatchRunner(int num_threads) : num_threads(num_threads)
+{
+
+}
+
+void BatchRunner::AddInputFile(const std::string& filename)
+{
+    inputs.push_back(filename);
+}
+
+void BatchRunner::AddDirectory(const std::string& directory)
+{
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr)
+        throw std::runtime_error("Could not open directory: " + directory);
+    std::string prefix = (directory.back() == '/') ? directory : directory + "/";
+    std::vector<std::string> files;
+    while (dirent* entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        struct stat info;
+        bool result_file = name.size() > 4 && name.compare(name.size() - 4, 4, ".out") == 0;
+        if (name[0] == '.' || result_file || stat((prefix + name).c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+            continue;
+        files.push_back(prefix + name);
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+    inputs.insert(inputs.end(), files.begin(), files.end());
+}
+
+void BatchRunner::AddManifest(const std::string& manifest)
+{
+    std::ifstream file(manifest);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open manifest: " + manifest);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+        inputs.push_back(line[0] == '/' ? line : DirectoryOf(manifest) + line);
+    }
+}
+
+void BatchRunner::SetOutputDirectory(const std::string& directory)
+{
+    output_directory = directory;
+    if (!output_directory.empty() && output_directory.back() != '/')
+        output_directory += '/';
+}
+
+void BatchRunner::SetCacheDirectory(const std::string& directory)
+{
+    if (directory.empty())
+        cache.reset();
+    else
+        cache = std::make_shared<const ProblemCache>(directory);
+}
+
+const std::vector<std::string>& BatchRunner::GetInputFiles() const
+{
+    return inputs;
+}
+
+std::string BatchRunner::GetOutputFile(const std::string& input) const
+{
+    std::string directory = DirectoryOf(input);
+    std::string name = input.substr(directory.size());
+    return (output_directory.empty() ? directory : output_directory) + name + ".out";
+}
+
+std::vector<BatchResult> BatchRunner::Run()
+{
+    // Two problems writing the same result file at the same time would corrupt it.
+    std::map<std::string, std::string> outputs;
+    for (const auto& input : inputs)
+    {
+        auto inserted = outputs.emplace(GetOutputFile(input), input);
+        if (!inserted.second)
+            throw std::runtime_error("Input files " + inserted.first->second + " and " + input + " have the same output file: " + inserted.first->first);
+    }
+
+    std::vector<BatchResult> results(inputs.size());
+    ThreadPool pool(num_threads);
+    // One task per problem, so that idle workers can steal any problem that is still queued.
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        pool.Enqueue([this, &results, i] { results[i] = RunOne(inputs[i]); });
+    }
+    pool.Wait();
+    return results;
+}
+
+BatchResult BatchRunner::RunOne(const std::string& input) const
+{
+    BatchResult result;
+    result.input = input;
+    result.output = GetOutputFile(input);
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        InputParameters params = cache ? ParseInputFile(input, *cache) : ParseInputFile(input);
+        std::string method;
+        Eigen::MatrixXd approximations = SolveProblem(params, method);
+        std::ofstream file(result.output);
+        if (!file.is_open())
+            throw std::runtime_error("Could not open output file: " + result.output);
+        file << method << std::endl;
+        file.precision(std::numeric_limits<double>::max_digits10);
+        WriteMatrix(file, approximations, "Approximations");
+        if (!file)
+            throw std::runtime_error("Could not write output file: " + result.output);
+        result.method = method;
+        result.success = true;
+    }
+    catch (const std::exception& e)
+    {
+        result.error = e.what();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void BatchRunner::WriteReport(const std::vector<BatchResult>& results, std::ostream& out)
+{
+    int failed = 0;
+    double total = 0.0;
+    for (const auto& result : results)
+    {
+        out << std::fixed << std::setprecision(6) << std::setw(12) << result.seconds << " s  " << result.input << "  ";
+        if (result.success)
+            out << result.method << " -> " << result.output << std::endl;
+        else
+            out << "FAILED: " << result.error << std::endl;
+        failed += !result.success;
+        total += result.seconds;
+    }
+    out << results.size() << " problems, " << failed << " failed, " << std::fixed << std::setprecision(6) << total << " s of solver time" << std::endl;
+    out.unsetf(std::ios::floatfield);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file BatchRunner.h
+ * @brief Defines the BatchRunner class for solving many input files in one process.
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#pragma once
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ProblemCache;
+
+/**
+ * @brief The outcome of one problem of a batch.
+ */
+struct BatchResult
+{
+    std::string input;  ///< The input file.
+    std::string output;  ///< The result file.
+    std::string method;  ///< The name of the method, empty if the input could not be solved.
+    double seconds = 0.0;  ///< The wall-clock time spent on the problem, parsing and writing included.
+    bool success = false;  ///< Whether the result file was written.
+    std::string error;  ///< The error message if the problem failed.
+};
+
+/**
+ * @brief A class for solving a batch of input files on a work-stealing thread pool.
+ *
+ * Every input file is an independent task: it is parsed, solved with the method it selects and written to its
+ * own result file, in the format printed by the single-file mode with full precision. The tasks run on a
+ * ThreadPool, whose idle workers steal queued problems, so that a few expensive problems do not hold up the rest.
+ * A failing problem is reported in its BatchResult and does not stop the others.
+ */
+class BatchRunner
+{
+public:
+    /**
+     * @brief Construct a new BatchRunner object.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     */
+    explicit BatchRunner(int num_threads = 0);
+
+    /**
+     * @brief Add an input file to the batch.
+     * @param filename The input file.
+     */
+    void AddInputFile(const std::string& filename);
+
+    /**
+     * @brief Add every regular file of a directory to the batch, in alphabetical order.
+     * @param directory The directory; hidden files, subdirectories and ".out" result files are skipped.
+     * @throws std::runtime_error If the directory cannot be opened.
+     */
+    void AddDirectory(const std::string& directory);
+
+    /**
+     * @brief Add the input files listed in a manifest to the batch.
+     * @param manifest A file with one input file per line; empty lines and lines starting with '#' are skipped,
+     *                 and relative paths are relative to the directory of the manifest.
+     * @throws std::runtime_error If the manifest cannot be opened.
+     */
+    void AddManifest(const std::string& manifest);
+
+    /**
+     * @brief Set the directory receiving the result files.
+     * @param directory The directory, or an empty string to write every result next to its input file.
+     */
+    void SetOutputDirectory(const std::string& directory);
+
+    /**
+     * @brief Set the directory of the cache of compiled systems shared by the problems (see ProblemCache).
+     * @param directory The directory, or an empty string to parse every input file in full.
+     * @throws std::runtime_error If the directory cannot be created.
+     */
+    void SetCacheDirectory(const std::string& directory);
+
+    /**
+     * @brief Get the input files of the batch.
+     * @return const std::vector<std::string>& The input files, in the order they were added.
+     */
+    const std::vector<std::string>& GetInputFiles() const;
+
+    /**
+     * @brief Get the result file of an input file.
+     * @param input The input file.
+     * @return std::string The input file name followed by ".out", in the output directory if set.
+     */
+    std::string GetOutputFile(const std::string& input) const;
+
+    /**
+     * @brief Solve every input file of the batch.
+     * @return std::vector<BatchResult> The outcome of every problem, in the order of the input files.
+     * @throws std::runtime_error If two input files have the same output file, before any of them is solved.
+     */
+    std::vector<BatchResult> Run();
+
+    /**
+     * @brief Write a report with the method, the timing and the status of every problem.
+     * @param results The results of Run().
+     * @param out The stream to write to.
+     */
+    static void WriteReport(const std::vector<BatchResult>& results, std::ostream& out);
+
+private:
+    int num_threads;  ///< The number of worker threads.
+    std::vector<std::string> inputs;  ///< The input files.
+    std::string output_directory;  ///< The directory receiving the result files, empty for the input directories.
+    std::shared_ptr<const ProblemCache> cache;  ///< The cache of compiled systems, null to parse every input file in full.
+
+    /**
+     * @brief Parse, solve and write one problem.
+     * @param input The input file.
+     * @return BatchResult The outcome of the problem.
+     */
+    BatchResult RunOne(const std::string& input) const;
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "Checkpoint.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+const char kMagic[8] = {'O', 'D', 'E', 'C', 'K', 'P', 'T', '\0'};
+const std::uint32_t kVersion = 1;
+const std::size_t kFixedHeaderSize = 104;
+
+void AppendLittleEndian(std::vector<char>& buffer, std::uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        buffer.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+}
+
+void AppendDoubles(std::vector<char>& buffer, const double* values, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        AppendLittleEndian(buffer, bits, 8);
+    }
+}
+
+// Reads the fields of a checkpoint in order, checking that the file holds them.
+class Reader
+{
+public:
+    Reader(const std::vector<char>& bytes) : bytes(bytes) {}
+
+    std::uint64_t Integer(int count)
+    {
+        Require(count);
+        std::uint64_t value = 0;
+        for (int i = 0; i < count; i++)
+        {
+            value |= (std::uint64_t)(unsigned char)bytes[position + i] << (8 * i);
+        }
+        position += count;
+        return value;
+    }
+
+    double Double()
+    {
+        std::uint64_t bits = Integer(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void Doubles(double* values, std::size_t count)
+    {
+        Require(8 * count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            values[i] = Double();
+        }
+    }
+
+private:
+    const std::vector<char>& bytes;
+    std::size_t position = 0;
+
+    void Require(std::size_t count) const
+    {
+        if (bytes.size() - position < count)
+            throw std::runtime_error("Truncated checkpoint file");
+    }
+};
+}
+
+void WriteCheckpoint(const std::string& filename, const SolverCheckpoint& checkpoint)
+{
+    std::uint32_t dimension = checkpoint.history.rows();
+    bool has_jacobian = checkpoint.jacobian.size() > 0;
+    if (checkpoint.rhs_history.size() > 0 && checkpoint.rhs_history.rows() != dimension)
+        throw std::invalid_argument("The function history must have one row per variable");
+    if (has_jacobian && (checkpoint.jacobian.rows() != dimension || checkpoint.jacobian.cols() != dimension || checkpoint.jacobian_state.size() != dimension))
+        throw std::invalid_argument("The Jacobian must be a square matrix of the dimension of the problem");
+
+    std::vector<char> buffer(kMagic, kMagic + sizeof(kMagic));
+    AppendLittleEndian(buffer, kVersion, 4);
+    AppendLittleEndian(buffer, dimension, 4);
+    AppendDoubles(buffer, &checkpoint.initial_time, 1);
+    AppendDoubles(buffer, &checkpoint.final_time, 1);
+    AppendDoubles(buffer, &checkpoint.output_step, 1);
+    AppendLittleEndian(buffer, checkpoint.next_point, 8);
+    AppendDoubles(buffer, &checkpoint.time, 1);
+    AppendDoubles(buffer, &checkpoint.step_size, 1);
+    AppendLittleEndian(buffer, checkpoint.accepted_steps, 8);
+    AppendLittleEndian(buffer, checkpoint.rejected_steps, 8);
+    AppendLittleEndian(buffer, checkpoint.history.cols(), 4);
+    AppendLittleEndian(buffer, checkpoint.rhs_history.cols(), 4);
+    AppendLittleEndian(buffer, checkpoint.controller.size(), 4);
+    AppendLittleEndian(buffer, has_jacobian, 4);
+    AppendDoubles(buffer, &checkpoint.jacobian_time, 1);
+    AppendDoubles(buffer, checkpoint.history.data(), checkpoint.history.size());
+    AppendDoubles(buffer, checkpoint.rhs_history.data(), checkpoint.rhs_history.size());
+    AppendDoubles(buffer, checkpoint.controller.data(), checkpoint.controller.size());
+    if (has_jacobian)
+    {
+        AppendDoubles(buffer, checkpoint.jacobian_state.data(), dimension);
+        AppendDoubles(buffer, checkpoint.jacobian.data(), checkpoint.jacobian.size());
+    }
+
+    std::string temporary = filename + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("Could not open file: " + temporary);
+    out.write(buffer.data(), buffer.size());
+    out.close();
+    if (!out || std::rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Could not write file: " + filename);
+    }
+}
+
+SolverCheckpoint ReadCheckpoint(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+        throw std::runtime_error("Could not open file: " + filename);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (bytes.size() < kFixedHeaderSize || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("Not a checkpoint file: " + filename);
+
+    Reader reader(bytes);
+    reader.Integer(8);
+    std::uint32_t version = reader.Integer(4);
+    if (version != kVersion)
+        throw std::runtime_error("Unsupported checkpoint file version: " + std::to_string(version));
+    SolverCheckpoint checkpoint;
+    std::uint32_t dimension = reader.Integer(4);
+    checkpoint.initial_time = reader.Double();
+    checkpoint.final_time = reader.Double();
+    checkpoint.output_step = reader.Double();
+    checkpoint.next_point = reader.Integer(8);
+    checkpoint.time = reader.Double();
+    checkpoint.step_size = reader.Double();
+    checkpoint.accepted_steps = reader.Integer(8);
+    checkpoint.rejected_steps = reader.Integer(8);
+    std::uint32_t history_columns = reader.Integer(4);
+    std::uint32_t rhs_columns = reader.Integer(4);
+    std::uint32_t controller_size = reader.Integer(4);
+    bool has_jacobian = reader.Integer(4) != 0;
+    checkpoint.jacobian_time = reader.Double();
+
+    // The sizes are checked against the file before anything is allocated from them.
+    std::uint64_t values = (std::uint64_t)dimension * (history_columns + rhs_columns) + controller_size + (has_jacobian ? (std::uint64_t)dimension * (dimension + 1) : 0);
+    if (values != (bytes.size() - kFixedHeaderSize) / 8 || (bytes.size() - kFixedHeaderSize) % 8 != 0)
+        throw std::runtime_error("Invalid checkpoint file: " + filename);
+    checkpoint.history.resize(dimension, history_columns);
+    reader.Doubles(checkpoint.history.data(), checkpoint.history.size());
+    checkpoint.rhs_history.resize(rhs_columns > 0 ? dimension : 0, rhs_columns);
+    reader.Doubles(checkpoint.rhs_history.data(), checkpoint.rhs_history.size());
+    checkpoint.controller.resize(controller_size);
+    reader.Doubles(checkpoint.controller.data(), controller_size);
+    if (has_jacobian)
+    {
+        checkpoint.jacobian_state.resize(dimension);
+        reader.Doubles(checkpoint.jacobian_state.data(), dimension);
+        checkpoint.jacobian.resize(dimension, dimension);
+        reader.Doubles(checkpoint.jacobian.data(), checkpoint.jacobian.size());
+    }
+    return checkpoint;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file Checkpoint.h
+ * @brief Declares the state of a solver saved in a checkpoint file, and the functions writing and reading it.
+ *
+ * A checkpoint file holds everything a solver needs to continue an integration exactly as if it had not been
+ * stopped. All the fields are little-endian, so a checkpoint written on one node can be resumed on another:
+ *
+ * | Offset | Type        | Field                                                  |
+ * |--------|-------------|--------------------------------------------------------|
+ * | 0      | char[8]     | The magic string "ODECKPT" and a zero byte             |
+ * | 8      | uint32      | The version of the format, currently 1                 |
+ * | 12     | uint32      | The dimension of the problem                           |
+ * | 16     | double      | The initial time of the problem                        |
+ * | 24     | double      | The final time of the problem                          |
+ * | 32     | double      | The step between two time points                       |
+ * | 40     | uint64      | The index of the next time point                       |
+ * | 48     | double      | The time of the state                                  |
+ * | 56     | double      | The size of the next step                              |
+ * | 64     | uint64      | The number of accepted steps                           |
+ * | 72     | uint64      | The number of rejected steps                           |
+ * | 80     | uint32      | The number of columns of the history                   |
+ * | 84     | uint32      | The number of columns of the function history          |
+ * | 88     | uint32      | The number of controller values                        |
+ * | 92     | uint32      | 1 if a Jacobian is saved, 0 otherwise                  |
+ * | 96     | double      | The time of the saved Jacobian                         |
+ * | 104    | double[]    | The history, the function history, the controller values, then the state and the matrix of the Jacobian, column by column |
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The state of an integration after a time point, from which a solver resumes bit for bit.
+ *
+ * The problem fields identify the integration, so that a checkpoint is not resumed by another problem. The
+ * other fields are filled by the solvers that need them: one-step methods only save the current solution,
+ * multistep methods save the solutions (and function values) their next steps depend on, and adaptive methods
+ * also save the state of their step size controller and of the Jacobian they reuse across steps.
+ */
+struct SolverCheckpoint
+{
+    double initial_time = 0.0;  ///< The initial time of the problem.
+    double final_time = 0.0;  ///< The final time of the problem.
+    double output_step = 0.0;  ///< The step between two time points of the problem.
+    long next_point = 0;  ///< The index of the next time point: the points before it have been produced.
+    double time = 0.0;  ///< The time of the state.
+    double step_size = 0.0;  ///< The size of the next step, as proposed by the step size controller.
+    long accepted_steps = 0;  ///< The number of accepted steps so far.
+    long rejected_steps = 0;  ///< The number of rejected steps so far.
+    Eigen::MatrixXd history;  ///< The latest solutions, one per column, the current one last.
+    Eigen::MatrixXd rhs_history;  ///< The function values at the latest solutions, empty if the method does not keep them.
+    std::vector<double> controller;  ///< The other values of the step size controller, specific to the method.
+    double jacobian_time = 0.0;  ///< The time at which the saved Jacobian was evaluated.
+    Eigen::VectorXd jacobian_state;  ///< The state at which the saved Jacobian was evaluated, empty if there is none.
+    Eigen::MatrixXd jacobian;  ///< The Jacobian reused across steps, empty if there is none.
+};
+
+/**
+ * @brief Writes a checkpoint file.
+ *
+ * The file is written under a temporary name and renamed, so that an interruption while writing leaves the
+ * previous checkpoint intact.
+ *
+ * @param filename The name of the file.
+ * @param checkpoint The state to save.
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void WriteCheckpoint(const std::string& filename, const SolverCheckpoint& checkpoint);
+
+/**
+ * @brief Reads a checkpoint file.
+ *
+ * @param filename The name of the file.
+ * @return SolverCheckpoint The saved state.
+ * @throws std::runtime_error If the file cannot be opened, is not a checkpoint file or is truncated.
+ */
+SolverCheckpoint ReadCheckpoint(const std::string& filename);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,481 @@
+#include "CompressedTrajectory.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// The largest block accepted by the decoder, so that a corrupted count does not allocate without bound.
+const std::uint64_t kMaxBlockWords = std::uint64_t(1) << 40;
+
+int LeadingZeros(std::uint64_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    for (std::uint64_t bit = std::uint64_t(1) << 63; !(value & bit); bit >>= 1)
+        count++;
+    return count;
+#endif
+}
+
+int TrailingZeros(std::uint64_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    for (; !(value & 1); value >>= 1)
+        count++;
+    return count;
+#endif
+}
+
+std::uint64_t Bits(double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Appends bits to a stream of 64-bit words, from the most significant bit of each word.
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<std::uint64_t>& words) : words(words) {}
+
+    // Write the low count bits of value, 0 <= count <= 64.
+    void Write(std::uint64_t value, int count)
+    {
+        if (count == 0)
+            return;
+        if (count < 64)
+            value &= (std::uint64_t(1) << count) - 1;
+        int space = 64 - used;
+        if (count < space)
+        {
+            current |= value << (space - count);
+            used += count;
+            return;
+        }
+        // Complete the current word with the first bits, and start the next one with the rest.
+        int rest = count - space;
+        words.push_back(current | (value >> rest));
+        current = (rest == 0) ? 0 : value << (64 - rest);
+        used = rest;
+    }
+
+    // Write the last partial word.
+    void Flush()
+    {
+        if (used > 0)
+            words.push_back(current);
+        current = 0;
+        used = 0;
+    }
+
+private:
+    std::vector<std::uint64_t>& words;
+    std::uint64_t current = 0;
+    int used = 0;
+};
+
+// Reads the bits written by a BitWriter.
+class BitReader
+{
+public:
+    explicit BitReader(const std::vector<std::uint64_t>& words) : words(words) {}
+
+    // Read count bits, 0 <= count <= 64.
+    std::uint64_t Read(int count)
+    {
+        if (count == 0)
+            return 0;
+        int available = 64 - used;
+        if (count <= available)
+        {
+            std::uint64_t value = (current << used) >> (64 - count);
+            used += count;
+            return value;
+        }
+        // Take the last bits of the current word, and the rest from the next one.
+        std::uint64_t high = (available == 0) ? 0 : (current << used) >> used;
+        if (index == words.size())
+            throw std::runtime_error("Truncated compressed block");
+        current = words[index++];
+        int rest = count - available;
+        used = rest;
+        std::uint64_t low = current >> (64 - rest);
+        return (rest == 64) ? low : (high << rest) | low;
+    }
+
+private:
+    const std::vector<std::uint64_t>& words;
+    std::size_t index = 0;
+    std::uint64_t current = 0;
+    int used = 64;
+};
+
+// The largest order of the predictors, which is stored on 3 bits.
+const int kMaxOrder = 7;
+
+// The number of points of a series on which the predictors are compared.
+const long kSamplePoints = 256;
+
+// The coefficients of the polynomial extrapolation of each order: the prediction of order k is the sum of
+// kPredictor[k][j] times the value j + 1 steps back, which is exact for polynomials of degree k - 1.
+const double kPredictor[kMaxOrder + 1][kMaxOrder] = {
+    {0, 0, 0, 0, 0, 0, 0},
+    {1, 0, 0, 0, 0, 0, 0},
+    {2, -1, 0, 0, 0, 0, 0},
+    {3, -3, 1, 0, 0, 0, 0},
+    {4, -6, 4, -1, 0, 0, 0},
+    {5, -10, 10, -5, 1, 0, 0},
+    {6, -15, 20, -15, 6, -1, 0},
+    {7, -21, 35, -35, 21, -7, 1}};
+
+// Predict the value of a series at a step from the previous values, which are stride apart. The first steps
+// of a block use the order the available values allow.
+//
+// The encoder and the decoder must compute the same prediction bit for bit, on any host: every product is
+// rounded on its own, and must not be fused with the sum (GCC does not fuse in ISO C++ mode).
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+double Predict(const double* values, long n, long stride, int order)
+{
+    int k = (n < order) ? (int)n : order;
+    const double* coefficients = kPredictor[k];
+    const double* previous = values + (n - 1) * stride;
+    double prediction = 0.0;
+    for (int j = 0; j < k; j++)
+    {
+        double term = coefficients[j] * previous[-j * stride];
+        prediction = prediction + term;
+    }
+    return prediction;
+}
+
+// The number of bits of a residual (see CompressedTrajectory.h).
+int ResidualBits(std::uint64_t residual)
+{
+    if (residual == 0)
+        return 1;
+    int leading = LeadingZeros(residual);
+    int trailing = TrailingZeros(residual);
+    return std::min(71 - leading, 77 - leading - trailing);
+}
+
+void WriteResidual(BitWriter& writer, std::uint64_t residual)
+{
+    if (residual == 0)
+    {
+        writer.Write(0, 1);
+        return;
+    }
+    int leading = LeadingZeros(residual);
+    int trailing = TrailingZeros(residual);
+    // The most significant meaningful bit is always one, so it is not written. The control bits and the counts
+    // are written with the residual when they fit in one word together.
+    if (trailing <= 6)
+    {
+        std::uint64_t control = (2 << 6) | leading;
+        int bits = 63 - leading;
+        if (bits <= 56)
+        {
+            writer.Write((control << bits) | (residual & ((std::uint64_t(1) << bits) - 1)), bits + 8);
+            return;
+        }
+        writer.Write(control, 8);
+        writer.Write(residual, bits);
+        return;
+    }
+    int length = 64 - leading - trailing;
+    std::uint64_t control = (((std::uint64_t)3 << 6 | leading) << 6) | (length - 1);
+    int bits = length - 1;
+    if (bits <= 50)
+    {
+        writer.Write((control << bits) | ((residual >> trailing) & ((std::uint64_t(1) << bits) - 1)), bits + 14);
+        return;
+    }
+    writer.Write(control, 14);
+    writer.Write(residual >> trailing, bits);
+}
+
+std::uint64_t ReadResidual(BitReader& reader)
+{
+    if (reader.Read(1) == 0)
+        return 0;
+    bool explicit_length = reader.Read(1) == 1;
+    int leading = (int)reader.Read(6);
+    if (!explicit_length)
+        return (std::uint64_t(1) << (63 - leading)) | reader.Read(63 - leading);
+    int length = (int)reader.Read(6) + 1;
+    int trailing = 64 - leading - length;
+    if (trailing < 0)
+        throw std::runtime_error("Invalid compressed block");
+    return ((std::uint64_t(1) << (length - 1)) | reader.Read(length - 1)) << trailing;
+}
+
+// Encode the series of every component of a block, one after the other (see CompressedTrajectory.h).
+void EncodeBlock(const double* values, int dimension, long num_points, std::vector<std::uint64_t>& words)
+{
+    BitWriter writer(words);
+    for (int i = 0; i < dimension; i++)
+    {
+        const double* series = values + i;
+        // Keep the order that gives the shortest residuals, on a sample of the series.
+        long cost[kMaxOrder + 1] = {0};
+        long sample_step = std::max(1L, num_points / kSamplePoints);
+        for (long n = std::min(num_points - 1, (long)kMaxOrder); n < num_points; n += sample_step)
+        {
+            std::uint64_t bits = Bits(series[n * dimension]);
+            for (int order = 0; order <= kMaxOrder; order++)
+            {
+                cost[order] += ResidualBits(bits ^ Bits(Predict(series, n, dimension, order)));
+            }
+        }
+        int best = (int)(std::min_element(cost, cost + kMaxOrder + 1) - cost);
+        writer.Write(best, 3);
+        for (long n = 0; n < num_points; n++)
+        {
+            WriteResidual(writer, Bits(series[n * dimension]) ^ Bits(Predict(series, n, dimension, best)));
+        }
+    }
+    writer.Flush();
+}
+
+// Decode a block into the columns of a matrix, starting at a given column.
+void DecodeBlock(const std::vector<std::uint64_t>& words, Eigen::MatrixXd& values, long first, long num_points)
+{
+    BitReader reader(words);
+    long stride = values.rows();
+    for (Eigen::Index i = 0; i < values.rows(); i++)
+    {
+        double* series = &values(i, first);
+        int order = (int)reader.Read(3);
+        for (long n = 0; n < num_points; n++)
+        {
+            std::uint64_t bits = ReadResidual(reader) ^ Bits(Predict(series, n, stride, order));
+            std::memcpy(&series[n * stride], &bits, sizeof(bits));
+        }
+    }
+}
+
+void AppendLittleEndian(std::vector<char>& buffer, std::uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        buffer.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+}
+
+std::uint64_t LoadLittleEndian(const char* bytes)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        value |= (std::uint64_t)(unsigned char)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+// Encode a block and write it with its counts, returning the number of bytes written.
+std::uint64_t WriteBlock(std::ostream& out, const double* values, int dimension, long num_points)
+{
+    std::vector<std::uint64_t> words;
+    EncodeBlock(values, dimension, num_points, words);
+    std::vector<char> buffer;
+    buffer.reserve(8 * (words.size() + 2));
+    AppendLittleEndian(buffer, num_points);
+    AppendLittleEndian(buffer, words.size());
+    for (std::uint64_t word : words)
+    {
+        AppendLittleEndian(buffer, word);
+    }
+    out.write(buffer.data(), buffer.size());
+    if (!out)
+        throw std::runtime_error("Could not write the compressed trajectory");
+    return buffer.size();
+}
+}
+
+void WriteCompressedValues(std::ostream& out, const Eigen::MatrixXd& results, long block_points)
+{
+    if (block_points <= 0)
+        throw std::invalid_argument("The number of time points of a block must be positive");
+    for (long first = 0; first < results.cols(); first += block_points)
+    {
+        long count = std::min<long>(block_points, results.cols() - first);
+        WriteBlock(out, results.data() + first * results.rows(), results.rows(), count);
+    }
+}
+
+Eigen::MatrixXd ReadCompressedValues(std::istream& in, const TrajectoryHeader& header)
+{
+    Eigen::MatrixXd values(header.dimension, header.num_points);
+    std::vector<std::uint64_t> words;
+    std::vector<char> bytes;
+    char counts[16];
+    for (std::uint64_t first = 0; first < header.num_points;)
+    {
+        if (!in.read(counts, sizeof(counts)))
+            throw std::runtime_error("Truncated compressed trajectory");
+        std::uint64_t num_points = LoadLittleEndian(counts);
+        std::uint64_t num_words = LoadLittleEndian(counts + 8);
+        if (num_points == 0 || num_points > header.num_points - first || num_words > kMaxBlockWords)
+            throw std::runtime_error("Invalid compressed block");
+        bytes.resize(8 * num_words);
+        if (!in.read(bytes.data(), bytes.size()))
+            throw std::runtime_error("Truncated compressed trajectory");
+        words.resize(num_words);
+        for (std::uint64_t j = 0; j < num_words; j++)
+        {
+            words[j] = LoadLittleEndian(bytes.data() + 8 * j);
+        }
+        DecodeBlock(words, values, first, num_points);
+        first += num_points;
+    }
+    return values;
+}
+
+CompressedTrajectory::CompressedTrajectory(const std::string& filename, const TrajectoryHeader& header, long block_points) : filename(filename), header(header), block_points(block_points)
+{
+    if (block_points <= 0)
+        throw std::invalid_argument("The number of time points of a block must be positive");
+    this->header.layout = XOR_COMPRESSED;
+}
+
+CompressedTrajectory::~CompressedTrajectory()
+{
+    Stop();
+}
+
+void CompressedTrajectory::Begin(int dimension, long num_points)
+{
+    Stop();
+    out.close();
+    out.clear();
+    out.open(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("Could not open file: " + filename);
+    header.dimension = dimension;
+    header.num_points = 0;
+    WriteTrajectoryHeader(out, header);
+    file_size = header.data_offset;
+
+    long block = std::max(1L, std::min(block_points, num_points));
+    filling.resize(dimension, block);
+    pending.resize(dimension, block);
+    filled = 0;
+    has_pending = false;
+    finished = false;
+    error = nullptr;
+    worker = std::thread(&CompressedTrajectory::Run, this);
+}
+
+void CompressedTrajectory::Append(const Eigen::VectorXd& y)
+{
+    if (y.size() != (Eigen::Index)header.dimension)
+        throw std::invalid_argument("Expected a state of dimension " + std::to_string(header.dimension) + ", got " + std::to_string(y.size()));
+    // Fewer points than announced make the first block smaller; more make it grow to the block size.
+    if (filled == filling.cols())
+    {
+        if (filling.cols() < block_points)
+        {
+            filling.conservativeResize(Eigen::NoChange, block_points);
+            pending.resize(Eigen::NoChange, block_points);
+        }
+        else
+        {
+            Submit();
+        }
+    }
+    filling.col(filled++) = y;
+    header.num_points++;
+}
+
+void CompressedTrajectory::End()
+{
+    if (filled > 0)
+        Submit();
+    Stop();
+    std::exception_ptr failure = error;
+    error = nullptr;
+    if (failure)
+        std::rethrow_exception(failure);
+    out.seekp(0);
+    WriteTrajectoryHeader(out, header);
+    out.close();
+    if (!out)
+        throw std::runtime_error("Could not write file: " + filename);
+}
+
+const TrajectoryHeader& CompressedTrajectory::GetHeader() const
+{
+    return header;
+}
+
+std::uint64_t CompressedTrajectory::GetFileSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return file_size;
+}
+
+void CompressedTrajectory::Submit()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return !has_pending || error; });
+    if (error)
+        std::rethrow_exception(error);
+    filling.swap(pending);
+    pending_points = filled;
+    has_pending = true;
+    filled = 0;
+    condition.notify_all();
+}
+
+void CompressedTrajectory::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return has_pending || finished; });
+        if (!has_pending)
+            return;
+        // The producer does not touch the pending block until it is released, so it is encoded unlocked.
+        lock.unlock();
+        std::uint64_t written = 0;
+        std::exception_ptr failure;
+        try
+        {
+            written = WriteBlock(out, pending.data(), pending.rows(), pending_points);
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+        lock.lock();
+        file_size += written;
+        has_pending = false;
+        error = failure;
+        condition.notify_all();
+        if (failure)
+            return;
+    }
+}
+
+void CompressedTrajectory::Stop()
+{
+    if (!worker.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    condition.notify_all();
+    worker.join();
+}
@@ -0,0 +1,162 @@
+/**
+ * @file CompressedTrajectory.h
+ * @brief Defines the CompressedTrajectory class, a sink that writes a solution as a losslessly compressed
+ * trajectory file, and the functions encoding and decoding the compressed values.
+ *
+ * A compressed trajectory file has the header of the binary trajectory format with the XOR_COMPRESSED layout
+ * (see TrajectoryFile.h), followed by blocks of consecutive time points. Every block is decoded on its own:
+ *
+ * | Offset | Type        | Field                                                  |
+ * |--------|-------------|--------------------------------------------------------|
+ * | 0      | uint64      | The number of time points of the block                 |
+ * | 8      | uint64      | The number of 64-bit words of the encoded values       |
+ * | 16     | uint64[]    | The encoded values, as little-endian words             |
+ *
+ * The words form a stream of bits, read from the most significant bit of each word. It holds the time series
+ * of the first component over the block, then of the second one, and so on. Every series starts with the
+ * order k of its predictor (3 bits), the one that gives the shortest series. Every value is predicted by the
+ * polynomial extrapolation of degree k - 1 of the k previous values of the series (of the values available in
+ * the block for its first points), with zero as the prediction of order zero. The XOR of the bit patterns of
+ * the value and of its prediction, the residual, is written as:
+ *
+ * - "0" if it is zero;
+ * - "10", the number of leading zeros (6 bits), then the bits after the leading one;
+ * - "11", the number of leading zeros (6 bits), the number of meaningful bits minus one (6 bits), then the
+ *   meaningful bits after the leading one, when the residual ends with more than 6 zeros.
+ *
+ * The values of a smooth solution agree with their prediction on the sign, the exponent and most of the
+ * mantissa, so that their residuals start with many zeros and take a fraction of the 64 bits of a double.
+ */
+
+#ifndef COMPRESSEDTRAJECTORY_H
+#define COMPRESSEDTRAJECTORY_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include "TrajectoryFile.h"
+#include "TrajectorySink.h"
+
+/**
+ * @brief Writes the values of a solution as compressed blocks.
+ *
+ * @param out The binary stream to write to, after a header with the XOR_COMPRESSED layout.
+ * @param results The solution, one row per variable and one column per time point.
+ * @param block_points The number of time points of a block.
+ * @throws std::invalid_argument If the number of time points of a block is not positive.
+ */
+void WriteCompressedValues(std::ostream& out, const Eigen::MatrixXd& results, long block_points = 4096);
+
+/**
+ * @brief Reads the compressed values of a trajectory file.
+ *
+ * @param in The binary stream to read from, at the end of the header.
+ * @param header The header of the file, which gives the dimension and the number of time points.
+ * @return Eigen::MatrixXd The solution, one row per variable and one column per time point.
+ * @throws std::runtime_error If the blocks are truncated or inconsistent with the header.
+ */
+Eigen::MatrixXd ReadCompressedValues(std::istream& in, const TrajectoryHeader& header);
+
+/**
+ * @brief A sink that writes a solution to a compressed trajectory file.
+ *
+ * The time points are gathered into blocks. A full block is handed to a background thread, which encodes and
+ * writes it while the solver fills the next one, so that the compression does not slow the solver down unless
+ * it is slower than the solver. Read the file back with ReadTrajectory().
+ */
+class CompressedTrajectory : public TrajectorySink
+{
+public:
+    /**
+     * @brief Construct a new CompressedTrajectory object.
+     * @param filename The name of the file, which is replaced if it exists.
+     * @param header The description of the solution; its layout, dimension and number of time points are set by the sink.
+     * @param block_points The number of time points of a block.
+     * @throws std::invalid_argument If the number of time points of a block is not positive.
+     */
+    CompressedTrajectory(const std::string& filename, const TrajectoryHeader& header, long block_points = 4096);
+
+    /**
+     * @brief Stop the background thread, leaving the file incomplete if End() was not called.
+     */
+    ~CompressedTrajectory();
+
+    CompressedTrajectory(const CompressedTrajectory&) = delete;
+    CompressedTrajectory& operator=(const CompressedTrajectory&) = delete;
+
+    /**
+     * @brief Create the file, write its header and start the background thread.
+     * @param dimension The dimension of the problem.
+     * @param num_points The number of time points that will be appended.
+     * @throws std::runtime_error If the file cannot be created.
+     */
+    void Begin(int dimension, long num_points) override;
+
+    /**
+     * @brief Add the solution at the next time point to the current block.
+     * @param y The solution.
+     * @throws std::invalid_argument If the solution does not have the dimension given to Begin().
+     * @throws std::runtime_error If the background thread failed to write a previous block.
+     */
+    void Append(const Eigen::VectorXd& y) override;
+
+    /**
+     * @brief Write the last block, wait for the background thread and complete the header.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void End() override;
+
+    /**
+     * @brief Get the header of the file.
+     * @return const TrajectoryHeader& The header, with the number of time points appended so far.
+     */
+    const TrajectoryHeader& GetHeader() const;
+
+    /**
+     * @brief Get the size of the file.
+     * @return std::uint64_t The number of bytes written so far.
+     */
+    std::uint64_t GetFileSize() const;
+
+private:
+    std::string filename;  ///< The name of the file.
+    TrajectoryHeader header;  ///< The header of the file.
+    long block_points;  ///< The number of time points of a block.
+    std::ofstream out;  ///< The file, written by the background thread between Begin() and End().
+    Eigen::MatrixXd filling;  ///< The block receiving the time points.
+    long filled = 0;  ///< The number of time points in the block being filled.
+    Eigen::MatrixXd pending;  ///< The block handed to the background thread.
+    long pending_points = 0;  ///< The number of time points in the pending block.
+    bool has_pending = false;  ///< Whether the pending block is waiting to be written.
+    bool finished = false;  ///< Whether the background thread should stop once the pending block is written.
+    std::uint64_t file_size = 0;  ///< The number of bytes written.
+    std::exception_ptr error;  ///< The error of the background thread, if any.
+    std::thread worker;  ///< The background thread.
+    mutable std::mutex mutex;  ///< The mutex protecting the pending block and the flags.
+    std::condition_variable condition;  ///< Signaled when a block is handed over or written.
+
+    /**
+     * @brief Hand the block being filled to the background thread, once it has written the previous one.
+     * @throws std::runtime_error If the background thread failed.
+     */
+    void Submit();
+
+    /**
+     * @brief The loop run by the background thread.
+     */
+    void Run();
+
+    /**
+     * @brief Stop the background thread and wait for it.
+     */
+    void Stop();
+};
+
+#endif // COMPRESSEDTRAJECTORY_H
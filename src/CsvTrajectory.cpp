@@ -0,0 +1,47 @@
+#include "CsvTrajectory.h"
+#include <string>
+
+CsvTrajectory::CsvTrajectory(std::ostream& out, double initial_time, double step_size) : writer(out), initial_time(initial_time), step_size(step_size)
+{
+
+}
+
+TextWriter& CsvTrajectory::GetWriter()
+{
+    return writer;
+}
+
+void CsvTrajectory::Resume(long num_points)
+{
+    resume_points = num_points;
+}
+
+void CsvTrajectory::Begin(int dimension, long /*num_points*/)
+{
+    count = resume_points;
+    resume_points = 0;
+    if (count > 0)
+        return;
+    writer.Write("t");
+    for (int i = 1; i <= dimension; i++)
+    {
+        writer.Write(writer.GetDelimiter() + "y" + std::to_string(i));
+    }
+    writer.Write("\n");
+}
+
+void CsvTrajectory::Append(const Eigen::VectorXd& y)
+{
+    writer.WriteRow(initial_time + count * step_size, y);
+    count++;
+}
+
+void CsvTrajectory::Flush()
+{
+    writer.Flush();
+}
+
+void CsvTrajectory::End()
+{
+    writer.Flush();
+}
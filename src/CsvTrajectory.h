@@ -0,0 +1,81 @@
+/**
+ * @file CsvTrajectory.h
+ * @brief Defines the CsvTrajectory class, a sink that writes a solution as delimited text with a time column.
+ */
+
+#ifndef CSVTRAJECTORY_H
+#define CSVTRAJECTORY_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <ostream>
+#include "TextWriter.h"
+#include "TrajectorySink.h"
+
+/**
+ * @brief A sink that writes a solution as delimited text, one row per time point.
+ *
+ * The first row names the columns, "t" then "y1" to "yn"; every following row holds the time and the solution
+ * at that time. The text goes through a TextWriter, whose precision and delimiter can be changed with GetWriter().
+ */
+class CsvTrajectory : public TrajectorySink
+{
+public:
+    /**
+     * @brief Construct a new CsvTrajectory object.
+     * @param out The stream to write to, which must outlive the sink.
+     * @param initial_time The time of the first time point.
+     * @param step_size The time between two time points.
+     */
+    CsvTrajectory(std::ostream& out, double initial_time, double step_size);
+
+    /**
+     * @brief Get the writer formatting the text.
+     * @return TextWriter& The writer.
+     */
+    TextWriter& GetWriter();
+
+    /**
+     * @brief Make the next solve continue a text that already holds the row naming the columns and some time points.
+     * 
+     * Begin() then writes no row naming the columns, and the times continue after the time points already written.
+     * This resumes the output of a solve that restarts from a checkpoint.
+     * 
+     * @param num_points The number of time points already written.
+     */
+    void Resume(long num_points);
+
+    /**
+     * @brief Write the row naming the columns, unless set by Resume().
+     * @param dimension The dimension of the problem.
+     * @param num_points The number of time points.
+     */
+    void Begin(int dimension, long num_points) override;
+
+    /**
+     * @brief Write the row of the next time point.
+     * @param y The solution.
+     */
+    void Append(const Eigen::VectorXd& y) override;
+
+    /**
+     * @brief Flush the text written so far to the stream.
+     * @throws std::runtime_error If the stream cannot be written.
+     */
+    void Flush() override;
+
+    /**
+     * @brief Flush the text to the stream.
+     * @throws std::runtime_error If the stream cannot be written.
+     */
+    void End() override;
+
+private:
+    TextWriter writer;  ///< The writer formatting the text.
+    double initial_time;  ///< The time of the first time point.
+    double step_size;  ///< The time between two time points.
+    long count = 0;  ///< The number of time points written.
+    long resume_points = 0;  ///< The number of time points already written, for the next Begin().
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "EnsembleRungeKutta.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+EnsembleRungeKutta::EnsembleRungeKutta(const RungeKutta& prototype, int num_threads) : pool(num_threads)
+{
+    if (prototype.IsImplicit())
+        throw std::invalid_argument("The ensemble Runge-Kutta solver only supports explicit methods");
+    a = prototype.GetA();
+    b = prototype.GetB();
+    c = prototype.GetC();
+    step_size = prototype.GetStepSize();
+    initial_time = prototype.GetInitialTime();
+    num_points = prototype.GetNumTimePoints();
+    function = prototype.GetFunction();
+    initial_conditions = prototype.GetInitialCondition().col(0).array();
+}
+
+void EnsembleRungeKutta::SetInitialConditions(const EnsembleState& initial_conditions)
+{
+    if (initial_conditions.rows() != this->initial_conditions.rows())
+        throw std::invalid_argument("Expected initial conditions with " + std::to_string(this->initial_conditions.rows()) + " rows, got " + std::to_string(initial_conditions.rows()));
+    this->initial_conditions = initial_conditions;
+}
+
+void EnsembleRungeKutta::SetBlockSize(int lanes)
+{
+    if (lanes <= 0)
+        throw std::invalid_argument("The block size must be positive");
+    block_size = lanes;
+}
+
+int EnsembleRungeKutta::GetNumMembers() const
+{
+    return initial_conditions.cols();
+}
+
+int EnsembleRungeKutta::GetDimension() const
+{
+    return initial_conditions.rows();
+}
+
+int EnsembleRungeKutta::GetNumTimePoints() const
+{
+    return num_points;
+}
+
+Eigen::MatrixXd EnsembleRungeKutta::Solve()
+{
+    Eigen::MatrixXd results(GetDimension(), GetNumMembers() * num_points);
+    Solve(results);
+    return results;
+}
+
+void EnsembleRungeKutta::Solve(Eigen::MatrixXd& results)
+{
+    int num_members = GetNumMembers();
+    if (results.rows() != GetDimension() || results.cols() != num_members * num_points)
+        throw std::invalid_argument("The results matrix must have " + std::to_string(GetDimension()) + " rows and " + std::to_string(num_members * num_points) + " columns");
+    pool.ParallelFor(0, num_members, [&](int begin, int end) {
+        SolveBlock(begin, end, results);
+    }, block_size);
+}
+
+void EnsembleRungeKutta::SolveBlock(int begin, int end, Eigen::MatrixXd& results) const
+{
+    int lanes = end - begin;
+    int s = b.size();
+    EnsembleState y = initial_conditions.middleCols(begin, lanes);
+    EnsembleState y_stage(y.rows(), lanes);
+    std::vector<EnsembleState> k(s);
+
+    auto store = [&](int n) {
+        for (int m = 0; m < lanes; m++)
+        {
+            results.col((begin + m) * num_points + n) = y.col(m);
+        }
+    };
+    store(0);
+
+    for (int n = 1; n < num_points; n++)
+    {
+        double t = initial_time + (n - 1) * step_size;
+        for (int i = 0; i < s; i++)
+        {
+            y_stage = y;
+            for (int j = 0; j < i; j++)
+            {
+                if (a(i, j) != 0)
+                    y_stage += (step_size * a(i, j)) * k[j];
+            }
+            function.BuildEnsembleRightHandSide(t + c(i) * step_size, y_stage, k[i]);
+        }
+        for (int i = 0; i < s; i++)
+        {
+            if (b(i) != 0)
+                y += (step_size * b(i)) * k[i];
+        }
+        store(n);
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file EnsembleRungeKutta.h
+ * @brief Defines the EnsembleRungeKutta class for advancing many trajectories of an explicit Runge-Kutta method in vector lanes.
+ */
+
+#ifndef ENSEMBLERUNGEKUTTA_H
+#define ENSEMBLERUNGEKUTTA_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Function.h"
+#include "RungeKutta.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief A class for solving an ensemble of initial conditions with an explicit Runge-Kutta method, one trajectory per vector lane.
+ *
+ * The states of the ensemble are stored in structure-of-arrays form (see EnsembleState): the values of one variable
+ * for all trajectories are contiguous, so every Runge-Kutta stage and every term of the Function is evaluated for
+ * a whole block of trajectories with vector instructions, instead of once per trajectory as in EnsembleSolver.
+ * The blocks of trajectories are distributed over a thread pool.
+ *
+ * All trajectories share the method, the time interval, the step size and the coefficients of the prototype;
+ * coefficient sweeps and implicit methods are handled by EnsembleSolver.
+ *
+ * The results have the same layout as those of EnsembleSolver: trajectory \f$ m \f$ occupies the columns
+ * \f$ [m T, (m + 1) T) \f$, where \f$ T \f$ is the number of time points.
+ */
+class EnsembleRungeKutta
+{
+public:
+    /**
+     * @brief Construct a new EnsembleRungeKutta object.
+     * @param prototype The explicit Runge-Kutta solver that describes the method and the problem.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     * @throws std::invalid_argument If the method of the prototype has implicit stages.
+     */
+    EnsembleRungeKutta(const RungeKutta& prototype, int num_threads = 0);
+
+    /**
+     * @brief Set the initial conditions of the trajectories.
+     * @param initial_conditions The initial conditions, one row per variable and one column per trajectory.
+     * @throws std::invalid_argument If the number of rows does not match the dimension of the prototype.
+     */
+    void SetInitialConditions(const EnsembleState& initial_conditions);
+
+    /**
+     * @brief Set the number of trajectories advanced together by one task.
+     * @param lanes The number of trajectories per block.
+     * @throws std::invalid_argument If the number is not positive.
+     */
+    void SetBlockSize(int lanes);
+
+    /**
+     * @brief Get the number of trajectories.
+     * @return int The number of columns of the initial conditions.
+     */
+    int GetNumMembers() const;
+
+    /**
+     * @brief Get the dimension of the problem.
+     * @return int The number of rows of the results.
+     */
+    int GetDimension() const;
+
+    /**
+     * @brief Get the number of time points of every trajectory.
+     * @return int The number of columns of each trajectory's block of the results.
+     */
+    int GetNumTimePoints() const;
+
+    /**
+     * @brief Solve every trajectory into a new matrix.
+     * @return Eigen::MatrixXd The results, laid out as described in the class documentation.
+     */
+    Eigen::MatrixXd Solve();
+
+    /**
+     * @brief Solve every trajectory into a preallocated matrix.
+     * @param results The matrix receiving the results, of size dimension by trajectories times time points.
+     * @throws std::invalid_argument If the matrix does not have the expected size.
+     */
+    void Solve(Eigen::MatrixXd& results);
+
+private:
+    Eigen::MatrixXd a;  ///< The matrix of coefficients of the method.
+    Eigen::VectorXd b;  ///< The weights of the method.
+    Eigen::VectorXd c;  ///< The nodes of the method.
+    double step_size;  ///< The step size.
+    double initial_time;  ///< The initial time.
+    int num_points;  ///< The number of time points.
+    Function function;  ///< The right-hand side of the problem.
+    EnsembleState initial_conditions;  ///< The initial conditions, one column per trajectory.
+    int block_size = 256;  ///< The number of trajectories per task.
+    ThreadPool pool;  ///< The worker threads.
+
+    /**
+     * @brief Advance one block of trajectories over the whole time interval.
+     * @param begin The first trajectory of the block.
+     * @param end One past the last trajectory of the block.
+     * @param results The results of all trajectories.
+     */
+    void SolveBlock(int begin, int end, Eigen::MatrixXd& results) const;
+};
+
+#endif
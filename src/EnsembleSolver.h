@@ -0,0 +1,193 @@
+/**
+ * @file EnsembleSolver.h
+ * @brief Defines the EnsembleSolver class for solving one ODE problem from many initial conditions and coefficient sets in parallel.
+ */
+
+#ifndef ENSEMBLESOLVER_H
+#define ENSEMBLESOLVER_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Function.h"
+#include "OdeSolver.h"
+#include "ThreadPool.h"
+#include "TrajectorySink.h"
+
+/**
+ * @brief A class for solving an ensemble of ODE problems that differ only in their initial condition or coefficients.
+ *
+ * The ensemble is described by a prototype solver, which fixes the method, the time interval, the step size and
+ * the Function, and by per-member initial conditions and/or per-member term coefficients (see Function::SetCoefficients()).
+ * The members are distributed over a thread pool. Every worker copies the prototype once per chunk of members;
+ * the copies share the compiled terms of the Function, so no member parses the problem again.
+ *
+ * The results of all members are written into one matrix with the dimension of the problem as the number of rows.
+ * Member \f$ m \f$ occupies the contiguous columns \f$ [m T, (m + 1) T) \f$, where \f$ T \f$ is the number of time
+ * points, and this block is exactly what Solve() of the prototype would return for that member. Each member streams
+ * its solution straight into its block through a BlockSink, so no per-member matrix is built and copied.
+ *
+ * A member whose solve throws is filled with NaN and reported by GetFailedMembers(); the other members are not affected.
+ *
+ * @tparam Solver The concrete solver class, which must be copyable.
+ */
+template <typename Solver>
+class EnsembleSolver
+{
+public:
+    /**
+     * @brief Construct a new EnsembleSolver object.
+     * @param prototype The solver that every member copies.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     */
+    EnsembleSolver(const Solver& prototype, int num_threads = 0) : prototype(prototype), pool(num_threads)
+    {
+
+    }
+
+    /**
+     * @brief Set one initial condition per member.
+     * @param initial_conditions The initial conditions, with the same layout as the initial condition of the prototype.
+     * @throws std::invalid_argument If the initial conditions do not all have the same number of rows.
+     */
+    void SetInitialConditions(const std::vector<Eigen::MatrixXd>& initial_conditions)
+    {
+        for (const auto& initial_condition : initial_conditions)
+        {
+            if (initial_condition.rows() != initial_conditions.front().rows())
+                throw std::invalid_argument("All initial conditions of an ensemble must have the same number of rows");
+        }
+        this->initial_conditions = initial_conditions;
+    }
+
+    /**
+     * @brief Set one set of term coefficients per member.
+     * @param coefficients The coefficients, one column per member, laid out as in Function::GetCoefficients().
+     * @throws std::invalid_argument If the number of rows does not match the coefficients of the prototype's Function.
+     */
+    void SetCoefficients(const Eigen::MatrixXd& coefficients)
+    {
+        if (coefficients.rows() != prototype.GetFunction().GetCoefficients().size())
+            throw std::invalid_argument("Expected " + std::to_string(prototype.GetFunction().GetCoefficients().size()) + " coefficients per member, got " + std::to_string(coefficients.rows()));
+        this->coefficients = coefficients;
+    }
+
+    /**
+     * @brief Get the number of members.
+     * @return int The number of initial conditions or of coefficient sets, whichever is set; at least one.
+     * @throws std::invalid_argument If both are set with a different number of members.
+     */
+    int GetNumMembers() const
+    {
+        int from_conditions = initial_conditions.size();
+        int from_coefficients = coefficients.cols();
+        if (from_conditions > 0 && from_coefficients > 0 && from_conditions != from_coefficients)
+            throw std::invalid_argument("The ensemble has " + std::to_string(from_conditions) + " initial conditions but " + std::to_string(from_coefficients) + " coefficient sets");
+        return std::max(1, std::max(from_conditions, from_coefficients));
+    }
+
+    /**
+     * @brief Get the dimension of the problem.
+     * @return int The number of rows of the results.
+     */
+    int GetDimension() const
+    {
+        return initial_conditions.empty() ? prototype.GetInitialCondition().rows() : initial_conditions.front().rows();
+    }
+
+    /**
+     * @brief Get the number of time points of every member.
+     * @return int The number of columns of each member's block of the results.
+     */
+    int GetNumTimePoints() const
+    {
+        return prototype.GetNumTimePoints();
+    }
+
+    /**
+     * @brief Solve every member into a new matrix.
+     * @return Eigen::MatrixXd The results, laid out as described in the class documentation.
+     */
+    Eigen::MatrixXd Solve()
+    {
+        Eigen::MatrixXd results(GetDimension(), GetNumMembers() * GetNumTimePoints());
+        Solve(results);
+        return results;
+    }
+
+    /**
+     * @brief Solve every member into a preallocated matrix.
+     * @param results The matrix receiving the results, of size dimension by members times time points.
+     * @throws std::invalid_argument If the matrix does not have the expected size.
+     */
+    void Solve(Eigen::MatrixXd& results)
+    {
+        int num_members = GetNumMembers();
+        int num_points = GetNumTimePoints();
+        if (results.rows() != GetDimension() || results.cols() != num_members * num_points)
+            throw std::invalid_argument("The results matrix must have " + std::to_string(GetDimension()) + " rows and " + std::to_string(num_members * num_points) + " columns");
+        failed_members.clear();
+
+        pool.ParallelFor(0, num_members, [&](int begin, int end) {
+            Solver solver = prototype;
+            Function function = prototype.GetFunction();
+            for (int m = begin; m < end; m++)
+            {
+                if (!initial_conditions.empty())
+                    solver.SetInitialCondition(initial_conditions[m]);
+                if (coefficients.cols() > 0)
+                {
+                    function.SetCoefficients(coefficients.col(m));
+                    solver.SetFunction(function);
+                }
+                try
+                {
+                    BlockSink sink(results, (long)m * num_points, num_points);
+                    solver.SolveTo(sink);
+                }
+                catch (const std::exception&)
+                {
+                    results.middleCols(m * num_points, num_points).setConstant(std::numeric_limits<double>::quiet_NaN());
+                    std::lock_guard<std::mutex> lock(failed_mutex);
+                    failed_members.push_back(m);
+                }
+            }
+        });
+        std::sort(failed_members.begin(), failed_members.end());
+    }
+
+    /**
+     * @brief Get the solution of one member.
+     * @param results The results of Solve().
+     * @param member The index of the member.
+     * @return Eigen::MatrixXd The solution of the member at each time point.
+     */
+    Eigen::MatrixXd GetMemberSolution(const Eigen::MatrixXd& results, int member) const
+    {
+        return results.middleCols(member * GetNumTimePoints(), GetNumTimePoints());
+    }
+
+    /**
+     * @brief Get the members whose solve failed in the last call to Solve().
+     * @return const std::vector<int>& The indices of the failed members, in increasing order.
+     */
+    const std::vector<int>& GetFailedMembers() const
+    {
+        return failed_members;
+    }
+
+private:
+    Solver prototype;  ///< The solver that every member copies.
+    ThreadPool pool;  ///< The worker threads.
+    std::vector<Eigen::MatrixXd> initial_conditions;  ///< The initial condition of every member, if set.
+    Eigen::MatrixXd coefficients;  ///< The term coefficients of every member, one column per member, if set.
+    std::vector<int> failed_members;  ///< The members whose last solve failed.
+    std::mutex failed_mutex;  ///< The mutex protecting the list of failed members.
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "Esdirk4.h"
+#include "OdeSolver.h"
+
+Esdirk4::Esdirk4()
+{
+
+}
+
+Esdirk4::~Esdirk4()
+{
+
+}
+
+Esdirk4::Esdirk4(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : RungeKutta(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetA();
+    SetB();
+    SetC();
+}
+
+void Esdirk4::SetA()
+{
+    const double gamma = 0.57281606248213479;
+    this->a = Eigen::MatrixXd::Zero(5, 5);
+    this->a << 0, 0, 0, 0, 0,
+               gamma, gamma, 0, 0, 0,
+               0.38276420807242012, -0.11096116312273778, gamma, 0, 0,
+               0.17488238211858576, 0.39876700991945652, -0.72208103708157312, gamma, 0,
+               0.12647034026171361, -0.18097306841032196, -0.16635422591088933, 0.648040891577363, gamma;
+}
+
+void Esdirk4::SetB()
+{
+    this->b = this->a.row(4).transpose();
+}
+
+void Esdirk4::SetC()
+{
+    this->c = this->a.rowwise().sum();
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+/**
+ * @file Esdirk4.h
+ * @brief Defines the Esdirk4 class for solving stiff ordinary differential equations (ODEs) using the ESDIRK4 method.
+ */
+#ifndef ESDIRK4_H
+#define ESDIRK4_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "OdeSolver.h"
+#include "RungeKutta.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the five-stage ESDIRK of order four.
+ * 
+ * The ESDIRK4 method is a five-stage, fourth-order, L-stable ESDIRK method: the first stage is explicit and the
+ * others share the diagonal coefficient \f$ \gamma \approx 0.5728160625 \f$, the root of the quartic that makes the
+ * stability function vanish at infinity (the same \f$ \gamma \f$ as the fourth-order method of Kvaerno). The second
+ * and third stages have stage order two and the method is stiffly accurate: the solution is the last stage.
+ * 
+ * In this setting, the coefficients \f$ a_{ij} \f$, \f$ b_i \f$, and \f$ c_i \f$  are:
+ * 
+ * \f[
+ * \begin{array}{c|ccccc}
+ * 0 & 0 & & & & \\
+ * 2\gamma & \gamma & \gamma & & & \\
+ * c_3 & a_{31} & a_{32} & \gamma & & \\
+ * c_4 & a_{41} & a_{42} & a_{43} & \gamma & \\
+ * 1 & a_{51} & a_{52} & a_{53} & a_{54} & \gamma \\
+ * \hline
+ *      & a_{51} & a_{52} & a_{53} & a_{54} & \gamma
+ * \end{array}
+ * \f]
+ * 
+ * The Jacobian of the system must be provided in the Function object.
+ */
+class Esdirk4 : public RungeKutta
+{
+public:
+    /**
+     * @brief Construct a new Esdirk4 object.
+     */
+    Esdirk4();
+    /**
+     * @brief Construct a new Esdirk4 object.
+     * @param step_size The step size for the solver.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Esdirk4(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+    /**
+     * @brief Destroy the Esdirk4 object.
+     */
+    ~Esdirk4();
+
+private:
+    /**
+     * @brief Set the A matrix for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's A matrix for
+     * the ESDIRK4 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetA();
+    /**
+     * @brief Set the B vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's B vector for
+     * the ESDIRK4 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetB();
+    /**
+     * @brief Set the C vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's C vector for
+     * the ESDIRK4 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetC();
+};
+
+#endif
\ No newline at end of file
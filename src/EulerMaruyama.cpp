@@ -0,0 +1,21 @@
+#include "EulerMaruyama.h"
+
+EulerMaruyama::EulerMaruyama()
+{
+
+}
+
+EulerMaruyama::EulerMaruyama(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function drift, Function diffusion) : SdeSolver(step_size, initial_time, final_time, initial_condition, drift, diffusion)
+{
+
+}
+
+EulerMaruyama::~EulerMaruyama()
+{
+
+}
+
+Eigen::VectorXd EulerMaruyama::Step(double t, const Eigen::VectorXd& y, const Eigen::VectorXd& dw) const
+{
+    return y + step_size * function.BuildRightHandSide(t, y) + diffusion.BuildRightHandSide(t, y).cwiseProduct(dw);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file EulerMaruyama.h
+ * @brief Defines the EulerMaruyama class for solving stochastic differential equations (SDEs) with the Euler-Maruyama method.
+ */
+
+#ifndef EULERMARUYAMA_H
+#define EULERMARUYAMA_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "SdeSolver.h"
+
+/**
+ * @brief A class for solving stochastic differential equations (SDEs) using the Euler-Maruyama method.
+ *
+ * The Euler-Maruyama method is the stochastic counterpart of the Forward Euler method:
+ * \f[
+ * y_{n+1} = y_n + h f(t_n, y_n) + g(t_n, y_n) \odot \Delta W_n.
+ * \f]
+ * It has strong order 1/2 and weak order 1, and needs no derivative of the diffusion.
+ */
+class EulerMaruyama : public SdeSolver
+{
+public:
+    /**
+     * @brief Construct a new EulerMaruyama object.
+     */
+    EulerMaruyama();
+
+    /**
+     * @brief Construct a new EulerMaruyama object.
+     * @param step_size The step size for the solver.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param drift A Function object with the drift of the problem.
+     * @param diffusion A Function object with the diffusion of the problem, one row per equation.
+     */
+    EulerMaruyama(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function drift, Function diffusion);
+
+    /**
+     * @brief Destroy the EulerMaruyama object.
+     */
+    ~EulerMaruyama();
+
+protected:
+    /**
+     * @brief Advance the solution by one Euler-Maruyama step.
+     * @param t The time at the start of the step.
+     * @param y The solution at the start of the step.
+     * @param dw The Wiener increments of the step.
+     * @return Eigen::VectorXd The solution at the end of the step.
+     */
+    Eigen::VectorXd Step(double t, const Eigen::VectorXd& y, const Eigen::VectorXd& dw) const;
+};
+
+#endif
@@ -0,0 +1,169 @@
+#include "EventMonitor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+SolverEvent ThresholdEvent(int variable, double threshold, int direction, EventAction action)
+{
+    if (variable < 0)
+        throw std::invalid_argument("The variable of an event must not be negative");
+    if (direction < -1 || direction > 1)
+        throw std::invalid_argument("The direction of an event must be -1, 0 or 1");
+    SolverEvent event;
+    event.function = [variable, threshold](double, const Eigen::VectorXd& y) {
+        if (variable >= y.size())
+            throw std::invalid_argument("The variable of an event exceeds the dimension of the problem");
+        return y(variable) - threshold;
+    };
+    event.direction = direction;
+    event.action = action;
+    return event;
+}
+
+int EventMonitor::Add(const SolverEvent& event)
+{
+    if (!event.function)
+        throw std::invalid_argument("An event needs a function");
+    if (event.direction < -1 || event.direction > 1)
+        throw std::invalid_argument("The direction of an event must be -1, 0 or 1");
+    if (event.action == RESTART_AT_EVENT && !event.reset)
+        throw std::invalid_argument("A restarting event needs a reset");
+    events.push_back(event);
+    return events.size() - 1;
+}
+
+void EventMonitor::Clear()
+{
+    events.clear();
+    values.clear();
+    occurrences.clear();
+    pending = -1;
+}
+
+bool EventMonitor::IsEmpty() const
+{
+    return events.empty();
+}
+
+const std::vector<EventOccurrence>& EventMonitor::GetOccurrences() const
+{
+    return occurrences;
+}
+
+void EventMonitor::Start(double t, const Eigen::VectorXd& y)
+{
+    occurrences.clear();
+    pending = -1;
+    values.resize(events.size());
+    for (std::size_t i = 0; i < events.size(); i++)
+        values[i] = events[i].function(t, y);
+}
+
+bool EventMonitor::Check(const Function& function, double t0, const Eigen::VectorXd& y0, double t1, const Eigen::VectorXd& y1, double& t_event)
+{
+    pending = -1;
+    std::vector<double>& next = next_values;
+    next.resize(events.size());
+    std::vector<int> crossed;
+    for (std::size_t i = 0; i < events.size(); i++)
+    {
+        next[i] = events[i].function(t1, y1);
+        // A function at zero takes the sign it has at the end of the next step, without an event.
+        double g0 = values[i];
+        if (g0 == 0.0 || !(g0 > 0.0 ? next[i] <= 0.0 : next[i] >= 0.0))
+            continue;
+        if (events[i].direction == 0 || events[i].direction == (g0 < 0.0 ? 1 : -1))
+            crossed.push_back(i);
+    }
+    if (crossed.empty())
+    {
+        values.swap(next);
+        return false;
+    }
+
+    // The derivatives at both ends are only needed, and only evaluated, when an event has to be located.
+    double h = t1 - t0;
+    Eigen::VectorXd f0 = function.BuildRightHandSide(t0, y0);
+    Eigen::VectorXd f1 = function.BuildRightHandSide(t1, y1);
+    auto interpolant = [&](double t) -> Eigen::VectorXd {
+        double s = (t - t0) / h;
+        double r = 1.0 - s;
+        return ((1.0 + 2.0 * s) * r * r) * y0 + (s * r * r * h) * f0 + (s * s * (3.0 - 2.0 * s)) * y1 - (s * s * r * h) * f1;
+    };
+    std::vector<std::pair<double, int>> roots;
+    for (int i : crossed)
+        roots.push_back({LocateRoot(i, t0, t1, next[i], interpolant), i});
+    std::stable_sort(roots.begin(), roots.end(), [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        return a.first < b.first;
+    });
+
+    for (const auto& root : roots)
+    {
+        if (events[root.second].action != RECORD_EVENT)
+        {
+            pending = root.second;
+            t_event = root.first;
+            break;
+        }
+    }
+    for (const auto& root : roots)
+    {
+        if (events[root.second].action == RECORD_EVENT && (pending < 0 || root.first <= t_event))
+            occurrences.push_back({root.second, root.first, interpolant(root.first)});
+    }
+    if (pending >= 0)
+        return true;
+    values.swap(next);
+    return false;
+}
+
+bool EventMonitor::Apply(double t, Eigen::VectorXd& y)
+{
+    if (pending < 0)
+        throw std::runtime_error("No event to apply");
+    int event = pending;
+    pending = -1;
+    occurrences.push_back({event, t, y});
+    if (events[event].action == STOP_AT_EVENT)
+        return true;
+    events[event].reset(t, y);
+    for (std::size_t i = 0; i < events.size(); i++)
+        values[i] = events[i].function(t, y);
+    return false;
+}
+
+double EventMonitor::LocateRoot(int event, double t0, double t1, double g1, const std::function<Eigen::VectorXd(double)>& interpolant) const
+{
+    // The bracket [a, b] keeps the previous sign at a and the new sign, or zero, at b.
+    double a = t0, fa = values[event];
+    double b = t1, fb = g1;
+    double tolerance = 4 * std::numeric_limits<double>::epsilon() * std::max(std::abs(t0), std::abs(t1));
+    int side = 0;
+    for (int iteration = 0; iteration < 100 && fb != 0.0 && b - a > tolerance; iteration++)
+    {
+        double c = b - fb * (b - a) / (fb - fa);
+        if (!(c > a && c < b))
+            c = 0.5 * (a + b);
+        double fc = events[event].function(c, interpolant(c));
+        if (fc != 0.0 && (fc > 0.0) == (fa > 0.0))
+        {
+            a = c;
+            fa = fc;
+            // Halve the value kept at the other end when the same end moves twice, so that it moves too.
+            if (side == -1)
+                fb *= 0.5;
+            side = -1;
+        }
+        else
+        {
+            b = c;
+            fb = fc;
+            if (side == 1)
+                fa *= 0.5;
+            side = 1;
+        }
+    }
+    return b;
+}
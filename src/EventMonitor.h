@@ -0,0 +1,161 @@
+/**
+ * @file EventMonitor.h
+ * @brief Defines the events a solve can watch for and the EventMonitor class, which locates them.
+ *
+ * An event is a crossing of zero by a function \f$ g(t, y) \f$ of the solution, such as a variable reaching a
+ * threshold. After every step from \f$ (t_0, y_0) \f$ to \f$ (t_1, y_1) \f$, the solver evaluates the event
+ * functions at \f$ (t_1, y_1) \f$. When one changes sign, its root is located on the cubic Hermite interpolant
+ *
+ * \f[
+ * y(t_0 + s h) \approx (1 + 2s)(1 - s)^2 y_0 + s (1 - s)^2 h f_0 + s^2 (3 - 2s) y_1 + s^2 (s - 1) h f_1
+ * \f]
+ *
+ * of the step, with the Illinois variant of the regula falsi, which keeps a bracket of the root and converges
+ * superlinearly. The event then records the solution there, stops the solve, or changes the solution and
+ * restarts the solve from there.
+ */
+
+#ifndef EVENTMONITOR_H
+#define EVENTMONITOR_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <functional>
+#include <vector>
+#include "Function.h"
+
+/**
+ * @brief What a solve does when an event occurs.
+ */
+enum EventAction
+{
+    RECORD_EVENT,  ///< Record the time and the solution of the event and go on.
+    STOP_AT_EVENT,  ///< Record the event and end the solve: no time point after the event is output.
+    RESTART_AT_EVENT  ///< Record the event, change the solution with the reset of the event and restart the solve from the event.
+};
+
+/**
+ * @brief An event watched by a solve.
+ */
+struct SolverEvent
+{
+    std::function<double(double, const Eigen::VectorXd&)> function;  ///< The event function \f$ g(t, y) \f$, whose zeros are the events.
+    EventAction action = RECORD_EVENT;  ///< What the solve does when the event occurs.
+    int direction = 0;  ///< 1 to only watch the crossings where g increases, -1 where it decreases, 0 for both.
+    std::function<void(double, Eigen::VectorXd&)> reset;  ///< The change of the solution at the event, for RESTART_AT_EVENT.
+};
+
+/**
+ * @brief An occurrence of an event during a solve.
+ */
+struct EventOccurrence
+{
+    int event;  ///< The index of the event, in the order the events were added.
+    double time;  ///< The time of the event.
+    Eigen::VectorXd state;  ///< The solution at the event, before its reset.
+};
+
+/**
+ * @brief Creates an event occurring when a variable crosses a threshold.
+ *
+ * @param variable The index of the variable, counted from zero.
+ * @param threshold The threshold.
+ * @param direction 1 for the crossings upwards, -1 for the crossings downwards, 0 for both.
+ * @param action What the solve does when the event occurs.
+ * @return SolverEvent The event, whose function is \f$ y_i - threshold \f$.
+ * @throws std::invalid_argument If the variable index is negative or the direction is not -1, 0 or 1.
+ */
+SolverEvent ThresholdEvent(int variable, double threshold, int direction, EventAction action);
+
+/**
+ * @brief Watches the events of a solve and locates the steps at which they occur.
+ *
+ * The solver calls Start() with the initial state, then Check() after every step. When Check() finds that a
+ * stopping or restarting event occurred within the step, the solver computes the solution at the event with its
+ * own method and hands it to Apply(), which ends the solve or resets the solution.
+ *
+ * A crossing is detected when an event function changes sign over a step or reaches zero at its end. After an
+ * event, the sign of the function at the event is the new reference, so that a restarting event whose reset
+ * leaves the function at zero is not detected again. Such events usually watch one direction only, like a
+ * bouncing ball whose height decreases to zero.
+ */
+class EventMonitor
+{
+public:
+    /**
+     * @brief Add an event to watch.
+     * @param event The event.
+     * @return int The index of the event.
+     * @throws std::invalid_argument If the event has no function, a direction other than -1, 0 or 1, or restarts without a reset.
+     */
+    int Add(const SolverEvent& event);
+
+    /**
+     * @brief Remove every event.
+     */
+    void Clear();
+
+    /**
+     * @brief Check whether events are watched.
+     * @return true if no event was added, false otherwise.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Get the events that occurred during the last solve.
+     * @return const std::vector<EventOccurrence>& The occurrences, in the order of their times.
+     */
+    const std::vector<EventOccurrence>& GetOccurrences() const;
+
+    /**
+     * @brief Forget the occurrences of the previous solve and evaluate the event functions at the initial state.
+     * @param t The initial time.
+     * @param y The initial solution.
+     */
+    void Start(double t, const Eigen::VectorXd& y);
+
+    /**
+     * @brief Check a step for events.
+     *
+     * The recording events that occurred within the step, before the first stopping or restarting one, are
+     * added to the occurrences with their solution on the interpolant.
+     *
+     * @param function The right-hand side of the system, for the interpolant.
+     * @param t0 The time at the start of the step.
+     * @param y0 The solution at the start of the step.
+     * @param t1 The time at the end of the step.
+     * @param y1 The solution at the end of the step.
+     * @param t_event Set to the time of the first stopping or restarting event, if any.
+     * @return true if a stopping or restarting event occurred within the step: the solver must then compute the
+     *         solution at its time and call Apply(). false if the step can be kept.
+     */
+    bool Check(const Function& function, double t0, const Eigen::VectorXd& y0, double t1, const Eigen::VectorXd& y1, double& t_event);
+
+    /**
+     * @brief Record the stopping or restarting event found by Check() and apply it.
+     * @param t The time of the event.
+     * @param y The solution at the event, computed by the solver; reset by a restarting event.
+     * @return true if the event stops the solve, false if the solve restarts from the event.
+     */
+    bool Apply(double t, Eigen::VectorXd& y);
+
+private:
+    std::vector<SolverEvent> events;  ///< The events.
+    std::vector<double> values;  ///< The value of every event function at the end of the last step.
+    std::vector<double> next_values;  ///< The values at the end of the step being checked.
+    std::vector<EventOccurrence> occurrences;  ///< The events that occurred during the solve.
+    int pending = -1;  ///< The stopping or restarting event found by Check(), -1 if none.
+
+    /**
+     * @brief Locate the root of an event function within a step.
+     * @param event The index of the event.
+     * @param t0 The start of the step, where the function has the value of the previous step.
+     * @param t1 The end of the step.
+     * @param g1 The value of the function at the end of the step.
+     * @param interpolant The solution within the step.
+     * @return double The smallest time found on the side of the root where the function has left its previous sign.
+     */
+    double LocateRoot(int event, double t0, double t1, double g1, const std::function<Eigen::VectorXd(double)>& interpolant) const;
+};
+
+#endif // EVENTMONITOR_H
@@ -0,0 +1,154 @@
+#include "Extrapolation.h"
+#include "ThreadPool.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+Extrapolation::Extrapolation()
+{
+
+}
+
+Extrapolation::Extrapolation(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : AdaptiveSolver(step_size, initial_time, final_time, initial_condition, function)
+{
+
+}
+
+Extrapolation::~Extrapolation()
+{
+
+}
+
+void Extrapolation::SetNumThreads(int num_threads)
+{
+    if (num_threads < 0)
+        throw std::invalid_argument("The number of threads must not be negative");
+    if (num_threads == 1)
+        pool.reset();
+    else
+        pool = std::make_shared<ThreadPool>(num_threads);
+}
+
+void Extrapolation::SetMaxColumns(int columns)
+{
+    if (columns < 2 || columns > NumSequences())
+        throw std::invalid_argument("The number of columns must be between 2 and " + std::to_string(NumSequences()));
+    max_columns = columns;
+}
+
+int Extrapolation::GetColumns() const
+{
+    return last_columns;
+}
+
+void Extrapolation::PrepareStep(double /*t*/, const Eigen::VectorXd& /*y*/)
+{
+
+}
+
+int Extrapolation::ErrorOrder() const
+{
+    return Power() * (columns - 1);
+}
+
+void Extrapolation::StartIntegration()
+{
+    if (!adaptive)
+    {
+        columns = max_columns;
+        return;
+    }
+    // The initial number of columns of ODEX: more columns for tighter tolerances.
+    int initial = (int)(-std::log10(rel_tol + 1e-40) * 0.6 + 1.5);
+    columns = std::max(2, std::min(std::max(2, max_columns - 1), initial));
+}
+
+void Extrapolation::SaveControllerState(SolverCheckpoint& checkpoint) const
+{
+    checkpoint.controller = {(double)columns, (double)last_columns};
+}
+
+void Extrapolation::RestoreControllerState(const SolverCheckpoint& checkpoint)
+{
+    if (checkpoint.controller.size() != 2 || checkpoint.controller[0] < 2 || checkpoint.controller[0] > max_columns)
+        throw std::runtime_error("The checkpoint does not hold the state of this method");
+    columns = (int)checkpoint.controller[0];
+    last_columns = (int)checkpoint.controller[1];
+}
+
+bool Extrapolation::AttemptStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new, double& error)
+{
+    int k = columns;
+    last_columns = k;
+    PrepareStep(t, y);
+    Eigen::VectorXd f0 = function.BuildRightHandSide(t, y);
+
+    std::vector<Eigen::VectorXd> first_column(k);
+    std::vector<char> computed(k, 0);
+    auto compute = [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            // The longest sequences are queued first, so that they do not finish last.
+            int j = k - 1 - i;
+            computed[j] = ComputeSequence(t, h, y, f0, Sequence(j), first_column[j]);
+        }
+    };
+    if (pool)
+        pool->ParallelFor(0, k, compute, 1);
+    else
+        compute(0, k);
+    for (int j = 0; j < k; j++)
+    {
+        if (!computed[j])
+            return false;
+    }
+
+    // Aitken-Neville, one row of the table at a time; every column past the first gives an error and an optimal step.
+    int p = Power();
+    std::vector<Eigen::VectorXd> row, previous;
+    std::vector<double> optimal(k, 0.0), work(k, 0.0);
+    double cost = 0.0;
+    for (int j = 0; j < k; j++)
+    {
+        cost += Cost(j);
+        row.assign(1, first_column[j]);
+        for (int l = 1; l <= j; l++)
+        {
+            double ratio = std::pow((double)Sequence(j) / Sequence(j - l), p);
+            row.push_back(row[l - 1] + (row[l - 1] - previous[l - 1]) / (ratio - 1.0));
+        }
+        if (j > 0)
+        {
+            Eigen::VectorXd weights = ErrorWeights(y.cwiseAbs().cwiseMax(row[j].cwiseAbs()));
+            double column_error = WeightedRmsNorm(row[j] - row[j - 1], weights);
+            double factor = (column_error == 0.0) ? 4.0 : 0.94 * std::pow(0.65 / column_error, 1.0 / (p * j + 1));
+            optimal[j] = h * std::min(4.0, std::max(0.02, factor));
+            work[j] = cost / optimal[j];
+            error = column_error;
+        }
+        previous.swap(row);
+    }
+    y_new = previous[k - 1];
+
+    // Keep the number of columns with the least work per unit step, and try one more after a success.
+    int next = k;
+    if (k > 2 && work[k - 2] < 0.8 * work[k - 1])
+        next = k - 1;
+    else if (error <= 1.0 && k < max_columns && (k == 2 || work[k - 1] < 0.9 * work[k - 2]))
+        next = k + 1;
+    proposed_step = (next > k) ? optimal[k - 1] * (cost + Cost(k)) / cost : optimal[next - 1];
+    if (error > 1.0)
+        proposed_step = std::min(proposed_step, h);
+    if (adaptive)
+        columns = next;
+    return true;
+}
+
+double Extrapolation::ProposeStepSize(double h, double error, bool accepted) const
+{
+    if (!std::isfinite(error) || !std::isfinite(proposed_step))
+        return AdaptiveSolver::ProposeStepSize(h, error, accepted);
+    return proposed_step;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file Extrapolation.h
+ * @brief Defines the Extrapolation class for extrapolation methods with order and step size control.
+ */
+
+#ifndef EXTRAPOLATION_H
+#define EXTRAPOLATION_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+#include "AdaptiveSolver.h"
+
+class ThreadPool;
+
+/**
+ * @brief A base class for extrapolation methods, which combine several approximations of the same step.
+ *
+ * A step of size \f$ H \f$ is computed independently with \f$ n_1 < n_2 < \ldots < n_k \f$ substeps of a basic
+ * method whose error has an expansion in powers of \f$ h^p \f$. The results \f$ T_{j,1} \f$ are combined with the
+ * Aitken-Neville scheme
+ * \f[
+ * T_{j,l+1} = T_{j,l} + \frac{T_{j,l} - T_{j-1,l}}{(n_j / n_{j-l})^p - 1},
+ * \f]
+ * and \f$ T_{k,k} \f$ is the new solution. Since the \f$ k \f$ sequences are independent, they can run at the same
+ * time on a thread pool (see SetNumThreads()).
+ *
+ * The error of column \f$ k \f$ is \f$ \| T_{k,k} - T_{k,k-1} \| \f$ in the weighted norm of the tolerances. The step
+ * size and the number of columns are controlled as in ODEX and SEULEX of Hairer and Wanner: every column \f$ j \f$
+ * gives an optimal step \f$ H_j \f$ and a work per unit step \f$ W_j = A_j / H_j \f$, where \f$ A_j \f$ counts the
+ * function evaluations of the first \f$ j \f$ sequences, and the next step uses the column with the least work.
+ */
+class Extrapolation : public AdaptiveSolver
+{
+public:
+    /**
+     * @brief Construct a new Extrapolation object.
+     */
+    Extrapolation();
+
+    /**
+     * @brief Construct a new Extrapolation object.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and optionally its Jacobian.
+     */
+    Extrapolation(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Extrapolation object.
+     */
+    ~Extrapolation();
+
+    /**
+     * @brief Set the number of threads computing the sequences of a step.
+     * @param num_threads The number of threads: one to compute the sequences in turn, zero for one per hardware thread.
+     * @throws std::invalid_argument If the number of threads is negative.
+     */
+    void SetNumThreads(int num_threads);
+
+    /**
+     * @brief Set the number of columns of the extrapolation table.
+     *
+     * In adaptive mode this is the largest number of columns, in fixed mode the number of columns of every step.
+     *
+     * @param columns The number of columns.
+     * @throws std::invalid_argument If the number is smaller than two or larger than the number of sequences of the method.
+     */
+    void SetMaxColumns(int columns);
+
+    /**
+     * @brief Get the number of columns used by the last step.
+     * @return int The number of columns.
+     */
+    int GetColumns() const;
+
+protected:
+    int max_columns = 2;  ///< The largest number of columns.
+    int columns = 2;  ///< The number of columns of the next step.
+    int last_columns = 0;  ///< The number of columns of the last step.
+    double proposed_step = 0.0;  ///< The size proposed for the next step by the last attempt.
+    std::shared_ptr<ThreadPool> pool;  ///< The threads computing the sequences, null to compute them in turn.
+
+    /**
+     * @brief Get the number of substeps of a sequence.
+     * @param j The index of the sequence, from zero.
+     * @return int The number of substeps \f$ n_{j+1} \f$.
+     */
+    virtual int Sequence(int j) const = 0;
+
+    /**
+     * @brief Get the number of sequences the method defines.
+     * @return int The largest possible number of columns.
+     */
+    virtual int NumSequences() const = 0;
+
+    /**
+     * @brief Get the power of the step size in the error expansion of the basic method.
+     * @return int The power \f$ p \f$.
+     */
+    virtual int Power() const = 0;
+
+    /**
+     * @brief Get the cost of a sequence, in function evaluations.
+     * @param j The index of the sequence, from zero.
+     * @return double The cost.
+     */
+    virtual double Cost(int j) const = 0;
+
+    /**
+     * @brief Prepare the data shared by the sequences of a step, such as a Jacobian.
+     * @param t The time at the beginning of the step.
+     * @param y The solution at the beginning of the step.
+     */
+    virtual void PrepareStep(double t, const Eigen::VectorXd& y);
+
+    /**
+     * @brief Compute one sequence of the basic method over a step.
+     *
+     * Called from several threads at the same time, so it must not modify the object.
+     *
+     * @param t The time at the beginning of the step.
+     * @param h The step size.
+     * @param y The solution at the beginning of the step.
+     * @param f0 The right-hand side at the beginning of the step.
+     * @param n The number of substeps.
+     * @param result The approximation at the end of the step.
+     * @return true if the sequence could be computed, false otherwise.
+     */
+    virtual bool ComputeSequence(double t, double h, const Eigen::VectorXd& y, const Eigen::VectorXd& f0, int n, Eigen::VectorXd& result) const = 0;
+
+    /**
+     * @brief Attempt one step with the current number of columns and choose the next step size and number of columns.
+     * @param t The time at the beginning of the step.
+     * @param h The step size.
+     * @param y The solution at the beginning of the step.
+     * @param y_new The solution at the end of the step.
+     * @param error The weighted norm of the error of the last column.
+     * @return true if every sequence could be computed, false otherwise.
+     */
+    bool AttemptStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new, double& error) override;
+
+    /**
+     * @brief Get the order of the error estimate of the current number of columns.
+     * @return int The order \f$ p (k - 1) \f$.
+     */
+    int ErrorOrder() const override;
+
+    /**
+     * @brief Propose the size of the next step, as chosen by the last attempt.
+     * @param h The size of the last attempted step.
+     * @param error The weighted norm of its error estimate, infinite if the step failed.
+     * @param accepted Whether the step was accepted.
+     * @return double The proposed step size.
+     */
+    double ProposeStepSize(double h, double error, bool accepted) const override;
+
+    /**
+     * @brief Choose the initial number of columns from the tolerance.
+     */
+    void StartIntegration() override;
+
+    /**
+     * @brief Save the number of columns of the next step.
+     * @param checkpoint The checkpoint.
+     */
+    void SaveControllerState(SolverCheckpoint& checkpoint) const override;
+
+    /**
+     * @brief Restore the number of columns of the next step.
+     * @param checkpoint The checkpoint.
+     * @throws std::runtime_error If the checkpoint does not hold a valid number of columns.
+     */
+    void RestoreControllerState(const SolverCheckpoint& checkpoint) override;
+};
+
+#endif
@@ -1,35 +1,92 @@
 #include "Function.h"
+#include "ThreadPool.h"
 #include "utils.h"
+#include <algorithm>
 #include <cmath>
 #include <string>
-#include <regex>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
 #include <iostream>
 
+namespace
+{
+// Skips a number of the form [-+]?[0-9]*\.?[0-9]+ and returns one past its end, or null if there is none.
+const char* SkipNumber(const char* p)
+{
+    if (*p == '-' || *p == '+')
+        p++;
+    const char* digits = p;
+    while (*p >= '0' && *p <= '9')
+        p++;
+    if (*p == '.')
+    {
+        digits = ++p;
+        while (*p >= '0' && *p <= '9')
+            p++;
+    }
+    return p > digits ? p : nullptr;
+}
+
+// Entries have the form multiplier_functionNumber_parameter, e.g. "+1_6_1" or "-2.5_1_(-3)".
+// They are matched by hand, since a regular expression costs more than the rest of the compilation of large systems.
+bool ParseEntry(const std::string& entry, int& function, double& multiplier, double& param)
+{
+    const char* begin = entry.c_str();
+    const char* p = SkipNumber(begin);
+    if (p == nullptr || p[0] != '_' || p[1] < '1' || p[1] > '7' || p[2] != '_')
+        return false;
+    multiplier = std::strtod(begin, nullptr);
+    function = p[1] - '0';
+    p += 3;
+    if (*p == '(')
+        p++;
+    const char* number = p;
+    p = SkipNumber(number);
+    if (p == nullptr)
+        return false;
+    if (*p == ')')
+        p++;
+    if (p != begin + entry.size())
+        return false;
+    param = std::strtod(number, nullptr);
+    return true;
+}
+
+// Below this number of terms per task the synchronization of the pool costs more than the evaluation.
+const int kMinTermsPerTask = 4096;
+}
 
 Function::Function()
 {
-    //this->pattern = std::regex("([-+]?[0-9]+)_([1-7])_\\(?([-]?[0-9]+)\\)?");
-    this->pattern = std::regex("([-+]?[0-9]*\\.?[0-9]+)_([1-7])_\\(?([-+]?[0-9]*\\.?[0-9]+)\\)?");
-    this->match = std::smatch();
+    Compile(0, {}, {}, false);
 }
 
 Function::Function(std::vector<std::vector<std::string>> function_combination, std::vector<std::vector<std::string>> derivative_combination)
 {
     if (!IsSquareMatrix(derivative_combination))
         throw std::invalid_argument("Derivative combination must be square matrix");
-    this->function_combination = function_combination;
-    this->derivative_combination = derivative_combination;
-    //this->pattern = std::regex("([-+]?[0-9]+)_([1-7])_\\(?([-]?[0-9]+)\\)?");
-    this->pattern = std::regex("([-+]?[0-9]*\\.?[0-9]+)_([1-7])_\\(?([-+]?[0-9]*\\.?[0-9]+)\\)?");
-    this->match = std::smatch();
+    Compile(function_combination.size(), ListEntries(function_combination), ListEntries(derivative_combination), !derivative_combination.empty());
 }
 
 Function::Function(std::vector<std::vector<std::string>> function_combination)
 {
-    this->function_combination = function_combination;
-    //this->pattern = std::regex("([-+]?[0-9]+)_([1-7])_\\(?([-]?[0-9]+)\\)?");
-    this->pattern = std::regex("([-+]?[0-9]*\\.?[0-9]+)_([1-7])_\\(?([-+]?[0-9]*\\.?[0-9]+)\\)?");
-    this->match = std::smatch();
+    Compile(function_combination.size(), ListEntries(function_combination), {}, false);
+}
+
+Function::Function(int num_equations, std::vector<FunctionTerm> function_terms, std::vector<FunctionTerm> derivative_terms)
+{
+    CheckPositions(function_terms, num_equations, num_equations + 1);
+    CheckPositions(derivative_terms, num_equations, num_equations);
+    Compile(num_equations, std::move(function_terms), std::move(derivative_terms), true);
+}
+
+Function::Function(int num_equations, std::vector<FunctionTerm> function_terms)
+{
+    CheckPositions(function_terms, num_equations, num_equations + 1);
+    Compile(num_equations, std::move(function_terms), {}, false);
 }
 
 Function::~Function()
@@ -39,50 +96,232 @@ Function::~Function()
 
 void Function::SetFunctionCombination(std::vector<std::vector<std::string>> function_combination)
 {
-    this->function_combination = function_combination;
+    std::vector<Term> rhs_terms;
+    std::vector<double> rhs_values;
+    ParseEntries(ListEntries(function_combination), rhs_terms, rhs_values);
+    std::vector<double> jacobian_values(terms->coefficients.data() + 2 * terms->rhs_terms.size(), terms->coefficients.data() + terms->coefficients.size());
+    Assemble(function_combination.size(), std::move(rhs_terms), std::move(rhs_values), terms->jacobian_terms, std::move(jacobian_values), terms->has_jacobian);
 }
 
 void Function::SetDerivativeCombination(std::vector<std::vector<std::string>> derivative_combination)
 {
-    this->derivative_combination = derivative_combination;
+    std::vector<Term> jacobian_terms;
+    std::vector<double> jacobian_values;
+    ParseEntries(ListEntries(derivative_combination), jacobian_terms, jacobian_values);
+    std::vector<double> rhs_values(terms->coefficients.data(), terms->coefficients.data() + 2 * terms->rhs_terms.size());
+    Assemble(terms->num_rows, terms->rhs_terms, std::move(rhs_values), std::move(jacobian_terms), std::move(jacobian_values), !derivative_combination.empty());
+}
+
+std::vector<FunctionTerm> Function::ListEntries(const std::vector<std::vector<std::string>>& combination)
+{
+    std::vector<FunctionTerm> entries;
+    for (int i = 0; i < combination.size(); i++)
+    {
+        for (int j = 0; j < combination[i].size(); j++)
+        {
+            if (combination[i][j] != "0")
+                entries.push_back({i, j, combination[i][j]});
+        }
+    }
+    return entries;
+}
+
+void Function::CheckPositions(const std::vector<FunctionTerm>& terms, int num_rows, int num_columns)
+{
+    for (const auto& term : terms)
+    {
+        if (term.row < 0 || term.row >= num_rows || term.column < 0 || term.column >= num_columns)
+            throw std::invalid_argument("Invalid position of term " + term.entry + ": (" + std::to_string(term.row) + ", " + std::to_string(term.column) + ")");
+    }
+}
+
+void Function::Compile(int num_rows, std::vector<FunctionTerm> function_entries, std::vector<FunctionTerm> derivative_entries, bool has_jacobian)
+{
+    std::vector<Term> rhs_terms, jacobian_terms;
+    std::vector<double> rhs_values, jacobian_values;
+    ParseEntries(std::move(function_entries), rhs_terms, rhs_values);
+    ParseEntries(std::move(derivative_entries), jacobian_terms, jacobian_values);
+    Assemble(num_rows, std::move(rhs_terms), std::move(rhs_values), std::move(jacobian_terms), std::move(jacobian_values), has_jacobian);
+}
+
+void Function::ParseEntries(std::vector<FunctionTerm> entries, std::vector<Term>& parsed, std::vector<double>& values)
+{
+    // Sorting by row keeps the terms of every equation contiguous; the stable sort keeps the order of the columns.
+    std::stable_sort(entries.begin(), entries.end(), [](const FunctionTerm& a, const FunctionTerm& b) { return a.row < b.row; });
+    parsed.reserve(entries.size());
+    values.reserve(2 * entries.size());
+    for (const auto& entry : entries)
+    {
+        if (entry.entry == "0")
+            continue;
+        int function;
+        double multiplier, param;
+        if (!ParseEntry(entry.entry, function, multiplier, param))
+            throw std::invalid_argument("Invalid input: " + entry.entry);
+        parsed.push_back({entry.row, entry.column, function});
+        values.push_back(multiplier);
+        values.push_back(param);
+    }
 }
 
-double Function::f1(double x, double param)
+void Function::Assemble(int num_rows, std::vector<Term> rhs_terms, std::vector<double> rhs_values, std::vector<Term> jacobian_terms, std::vector<double> jacobian_values, bool has_jacobian)
+{
+    auto compiled = std::make_shared<CompiledTerms>();
+    compiled->row_offsets.assign(num_rows + 1, 0);
+    for (const auto& term : rhs_terms)
+    {
+        if (term.column == 0)
+            compiled->autonomous = false;
+        compiled->row_offsets[term.row + 1]++;
+    }
+    for (int i = 0; i < num_rows; i++)
+    {
+        compiled->row_offsets[i + 1] += compiled->row_offsets[i];
+    }
+    compiled->coefficients.resize(rhs_values.size() + jacobian_values.size());
+    compiled->coefficients.head(rhs_values.size()) = Eigen::Map<Eigen::VectorXd>(rhs_values.data(), rhs_values.size());
+    compiled->coefficients.tail(jacobian_values.size()) = Eigen::Map<Eigen::VectorXd>(jacobian_values.data(), jacobian_values.size());
+    compiled->num_rows = num_rows;
+    compiled->rhs_terms = std::move(rhs_terms);
+    compiled->jacobian_terms = std::move(jacobian_terms);
+    compiled->has_jacobian = has_jacobian;
+    this->coefficients = compiled->coefficients;
+    this->terms = compiled;
+    PartitionTerms();
+}
+
+void Function::Save(std::ostream& out) const
+{
+    std::int32_t header[4] = {terms->num_rows, terms->has_jacobian, (std::int32_t)terms->rhs_terms.size(), (std::int32_t)terms->jacobian_terms.size()};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(terms->rhs_terms.data()), terms->rhs_terms.size() * sizeof(Term));
+    out.write(reinterpret_cast<const char*>(terms->jacobian_terms.data()), terms->jacobian_terms.size() * sizeof(Term));
+    out.write(reinterpret_cast<const char*>(terms->coefficients.data()), terms->coefficients.size() * sizeof(double));
+}
+
+Function Function::Load(std::istream& in)
+{
+    std::int32_t header[4];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] < 0 || header[2] < 0 || header[3] < 0)
+        throw std::runtime_error("Invalid compiled function");
+    std::vector<Term> rhs_terms(header[2]), jacobian_terms(header[3]);
+    std::vector<double> rhs_values(2 * rhs_terms.size()), jacobian_values(2 * jacobian_terms.size());
+    in.read(reinterpret_cast<char*>(rhs_terms.data()), rhs_terms.size() * sizeof(Term));
+    in.read(reinterpret_cast<char*>(jacobian_terms.data()), jacobian_terms.size() * sizeof(Term));
+    in.read(reinterpret_cast<char*>(rhs_values.data()), rhs_values.size() * sizeof(double));
+    in.read(reinterpret_cast<char*>(jacobian_values.data()), jacobian_values.size() * sizeof(double));
+    if (!in)
+        throw std::runtime_error("Truncated compiled function");
+    // The terms index the equations and the variables, so they are checked before they are used.
+    int num_rows = header[0];
+    auto check = [&](const std::vector<Term>& terms, int num_columns) {
+        for (int k = 0; k < terms.size(); k++)
+        {
+            const Term& term = terms[k];
+            if (term.row < 0 || term.row >= num_rows || term.column < 0 || term.column >= num_columns || term.function < 1 || term.function > 7 || (k > 0 && term.row < terms[k - 1].row))
+                throw std::runtime_error("Invalid compiled function");
+        }
+    };
+    check(rhs_terms, num_rows + 1);
+    check(jacobian_terms, num_rows);
+    Function function;
+    function.Assemble(num_rows, std::move(rhs_terms), std::move(rhs_values), std::move(jacobian_terms), std::move(jacobian_values), header[1] != 0);
+    return function;
+}
+
+const Eigen::VectorXd& Function::GetCoefficients() const
+{
+    return coefficients;
+}
+
+void Function::SetCoefficients(const Eigen::VectorXd& coefficients)
+{
+    if (coefficients.size() != terms->coefficients.size())
+        throw std::invalid_argument("Expected " + std::to_string(terms->coefficients.size()) + " coefficients, got " + std::to_string(coefficients.size()));
+    this->coefficients = coefficients;
+}
+
+void Function::SetNumThreads(int num_threads)
+{
+    if (num_threads < 0)
+        throw std::invalid_argument("The number of threads must not be negative");
+    if (num_threads == 1)
+        pool.reset();
+    else
+        pool = std::make_shared<ThreadPool>(num_threads);
+    PartitionTerms();
+}
+
+int Function::GetNumThreads() const
+{
+    return pool ? pool->GetNumThreads() : 1;
+}
+
+int Function::GetNumTasks() const
+{
+    return partition.size() - 1;
+}
+
+void Function::PartitionTerms()
+{
+    partition = PartitionByRows(terms->rhs_terms);
+    jacobian_partition = PartitionByRows(terms->jacobian_terms);
+}
+
+std::vector<int> Function::PartitionByRows(const std::vector<Term>& terms) const
+{
+    int num_terms = terms.size();
+    int num_tasks = std::min(GetNumThreads(), std::max(1, num_terms / kMinTermsPerTask));
+    std::vector<int> ranges(1, 0);
+    for (int p = 1; p < num_tasks; p++)
+    {
+        // Move the cut to the first term of a row, so that no two tasks write the same row.
+        int cut = std::max(ranges.back(), (int)((long long)num_terms * p / num_tasks));
+        while (cut > 0 && cut < num_terms && terms[cut].row == terms[cut - 1].row)
+            cut++;
+        if (cut > ranges.back() && cut < num_terms)
+            ranges.push_back(cut);
+    }
+    ranges.push_back(num_terms);
+    return ranges;
+}
+
+double Function::f1(double x, double param) const
 {
     return sin(param * x);
 }
 
-double Function::f2(double x, double param)
+double Function::f2(double x, double param) const
 {
     return cos(param * x);
 }
 
-double Function::f3(double x, double param)
+double Function::f3(double x, double param) const
 {
     return exp(param * x);
 }
 
-double Function::f4(double x, double param)
+double Function::f4(double x, double param) const
 {
     return pow(x, param);
 }
 
-double Function::f5(double x, double param)
+double Function::f5(double x, double param) const
 {
     return log(param * x);
 }
 
-double Function::f6(double x, double param)
+double Function::f6(double x, double param) const
 {
     return param * x;
 }
 
-double Function::f7(double x, double param)
+double Function::f7(double x, double param) const
 {
     return param;
 }
 
-double Function::ApplyFunction(int function, double variable, double param)
+double Function::ApplyFunction(int function, double variable, double param) const
 {
     switch (function)
     {
@@ -97,64 +336,144 @@ double Function::ApplyFunction(int function, double variable, double param)
     }
 }
 
-Eigen::VectorXd Function::BuildRightHandSide(double t, Eigen::VectorXd y)
+Eigen::VectorXd Function::BuildRightHandSide(double t, const Eigen::VectorXd& y) const
 {
-    Eigen::VectorXd rhs(y.size());
-    for (int i = 0; i < y.size(); i++)
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(y.size());
+    if (GetNumTasks() == 1)
     {
-        rhs(i) = 0;
-
-        for (int j = 0; j < function_combination[i].size(); j++)
-        {
-            auto entry = function_combination[i][j];
-            
-            if (entry == "0") 
-                continue;
-
-            if (!std::regex_match(entry, match, pattern))
-                throw std::invalid_argument("Invalid input: " + entry);
+        AccumulateTerms(0, partition.back(), t, y, rhs);
+        return rhs;
+    }
+    pool->ParallelFor(0, GetNumTasks(), [&](int begin, int end) {
+        for (int p = begin; p < end; p++)
+            AccumulateTerms(partition[p], partition[p + 1], t, y, rhs);
+    }, 1);
+    return rhs;
+}
 
-            double multiplier  = std::stod(match[1]);
-            int function = std::stoi(match[2]);
-            double param = std::stod(match[3]);
+void Function::AccumulateTerms(int begin, int end, double t, const Eigen::VectorXd& y, Eigen::VectorXd& rhs) const
+{
+    const auto& rhs_terms = terms->rhs_terms;
+    for (int k = begin; k < end; k++)
+    {
+        const Term& term = rhs_terms[k];
+        if (term.row >= y.size())
+            continue;
+        double variable = (term.column == 0) ? t : y(term.column - 1);
+        rhs(term.row) += coefficients(2 * k) * ApplyFunction(term.function, variable, coefficients(2 * k + 1));
+    }
+}
 
-            double variable = (j == 0) ? t : y(j-1);
-            rhs(i) += multiplier * ApplyFunction(function, variable, param);
+Eigen::VectorXd Function::BuildRightHandSide(double t, const Eigen::VectorXd& y, const std::vector<int>& rows) const
+{
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(rows.size());
+    const auto& rhs_terms = terms->rhs_terms;
+    const auto& row_offsets = terms->row_offsets;
+    for (int r = 0; r < rows.size(); r++)
+    {
+        if (rows[r] < 0 || rows[r] >= y.size())
+            throw std::invalid_argument("Invalid equation: " + std::to_string(rows[r]));
+        if (rows[r] + 1 >= row_offsets.size())
+            continue;
+        for (int k = row_offsets[rows[r]]; k < row_offsets[rows[r] + 1]; k++)
+        {
+            const Term& term = rhs_terms[k];
+            double variable = (term.column == 0) ? t : y(term.column - 1);
+            rhs(r) += coefficients(2 * k) * ApplyFunction(term.function, variable, coefficients(2 * k + 1));
         }
     }
     return rhs;
 }
 
-Eigen::MatrixXd Function::BuildJacobian(double t, Eigen::VectorXd y)
+std::vector<std::vector<int>> Function::GetDependencies(int dim) const
 {
-    Eigen::MatrixXd jacobian(y.size(), y.size());
+    std::vector<std::vector<int>> dependencies(dim);
+    for (const auto& term : terms->rhs_terms)
+    {
+        if (term.row >= dim || term.column == 0 || term.column > dim)
+            continue;
+        auto& row = dependencies[term.row];
+        if (std::find(row.begin(), row.end(), term.column - 1) == row.end())
+            row.push_back(term.column - 1);
+    }
+    for (auto& row : dependencies)
+    {
+        std::sort(row.begin(), row.end());
+    }
+    return dependencies;
+}
 
-    for (int i = 0; i < y.size(); i++)
+void Function::BuildEnsembleRightHandSide(double t, const EnsembleState& y, EnsembleState& rhs) const
+{
+    int lanes = y.cols();
+    rhs.setZero(y.rows(), lanes);
+    const auto& rhs_terms = terms->rhs_terms;
+    for (int k = 0; k < rhs_terms.size(); k++)
     {
-        for (int j = 0; j < y.size(); j++)
+        const Term& term = rhs_terms[k];
+        if (term.row >= y.rows())
+            continue;
+        double multiplier = coefficients(2 * k);
+        double param = coefficients(2 * k + 1);
+        Eigen::Map<Eigen::ArrayXd> out(rhs.data() + term.row * lanes, lanes);
+        if (term.column == 0)
         {
-            auto entry = derivative_combination[i][j];  
-            
-            if (entry == "0")
-                continue; 
-
-            if (!std::regex_match(entry, match, pattern))
-                throw std::invalid_argument("Invalid input: " + entry);
-
-            int multiplier  = std::stoi(match[1]);
-            int function = std::stoi(match[2]);
-            double param = std::stod(match[3]);
-
-            jacobian(i, j) = multiplier * ApplyFunction(function, y(j), param);
-
+            out += multiplier * ApplyFunction(term.function, t, param);
+            continue;
+        }
+        Eigen::Map<const Eigen::ArrayXd> x(y.data() + (term.column - 1) * lanes, lanes);
+        switch (term.function)
+        {
+            case 1: out += multiplier * (param * x).sin(); break;
+            case 2: out += multiplier * (param * x).cos(); break;
+            case 3: out += multiplier * (param * x).exp(); break;
+            case 4: out += multiplier * x.pow(param); break;
+            case 5: out += multiplier * (param * x).log(); break;
+            case 6: out += (multiplier * param) * x; break;
+            case 7: out += multiplier * param; break;
+            default: throw std::invalid_argument("Invalid function: " + std::to_string(term.function));
         }
     }
-
-    return jacobian;
 }
 
+Eigen::MatrixXd Function::BuildJacobian(double t, const Eigen::VectorXd& y) const
+{
+    if (!terms->has_jacobian)
+        throw std::runtime_error("The Jacobian is not provided");
 
+    Eigen::MatrixXd jacobian = Eigen::MatrixXd::Zero(y.size(), y.size());
+    int num_tasks = jacobian_partition.size() - 1;
+    if (num_tasks == 1)
+    {
+        AssignJacobianTerms(0, jacobian_partition.back(), y, jacobian);
+        return jacobian;
+    }
+    pool->ParallelFor(0, num_tasks, [&](int begin, int end) {
+        for (int p = begin; p < end; p++)
+            AssignJacobianTerms(jacobian_partition[p], jacobian_partition[p + 1], y, jacobian);
+    }, 1);
+    return jacobian;
+}
 
+void Function::AssignJacobianTerms(int begin, int end, const Eigen::VectorXd& y, Eigen::MatrixXd& jacobian) const
+{
+    const auto& jacobian_terms = terms->jacobian_terms;
+    int offset = 2 * terms->rhs_terms.size();
+    for (int k = begin; k < end; k++)
+    {
+        const Term& term = jacobian_terms[k];
+        if (term.row >= y.size() || term.column >= y.size())
+            continue;
+        jacobian(term.row, term.column) += coefficients(offset + 2 * k) * ApplyFunction(term.function, y(term.column), coefficients(offset + 2 * k + 1));
+    }
+}
 
+bool Function::IsAutonomous() const
+{
+    return terms->autonomous;
+}
 
-
+bool Function::HasJacobian() const
+{
+    return terms->has_jacobian;
+}
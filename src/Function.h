@@ -8,9 +8,32 @@
 #pragma once
 #include <Eigen/Dense>
 #include <cmath>
+#include <iosfwd>
 #include <string>
 #include <vector>
-#include <regex>
+#include <memory>
+
+class ThreadPool;
+
+/**
+ * @brief The states of an ensemble of trajectories in structure-of-arrays form.
+ * 
+ * Row \f$ i \f$ holds the variable \f$ y_i \f$ of every trajectory contiguously, so that one term of the
+ * system is evaluated for all trajectories with vector instructions.
+ */
+typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> EnsembleState;
+
+/**
+ * @brief A non-zero entry of a function or derivative combination, given by its position.
+ * 
+ * Large sparse systems list their entries as terms instead of writing out every "0" of the combinations.
+ */
+struct FunctionTerm
+{
+    int row;  //< The equation, from zero.
+    int column;  //< The column of the entry in the combination, from zero.
+    std::string entry;  //< The entry, e.g. "+1_6_1".
+};
 
 /**
  * @brief A class for representing and evaluating mathematical functions and their derivatives.
@@ -18,6 +41,16 @@
  * This class is designed to handle mathematical functions used in ODE solvers.
  * It provides methods to define function combinations, apply them, and compute
  * the right-hand side and Jacobian matrices for ODE systems.
+ * 
+ * The entries are parsed once, when the combinations are set, into a list of terms that is shared by all
+ * copies of the object. Copies are therefore cheap, and the evaluation methods are const and can be called
+ * from several threads at the same time.
+ * 
+ * The multiplier and the parameter of every term are its coefficients. They are stored per object, so that
+ * copies sharing the same terms can evaluate different members of a parameter sweep (see SetCoefficients()).
+ *
+ * For large systems the right-hand side and the Jacobian can be evaluated by several threads (see SetNumThreads()).
+ * Every solver then uses the parallel evaluation without further changes.
  */
 class Function
 {
@@ -33,6 +66,7 @@ public:
      * @param function_combination A 2D vector of strings representing function combinations.
      * @param derivative_combination A 2D vector of strings representing derivative combinations.
      * @throws std::invalid_argument If the derivative combination is not a square matrix.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
      */
     Function(std::vector<std::vector<std::string>> function_combination, std::vector<std::vector<std::string>> derivative_combination);
 
@@ -40,9 +74,33 @@ public:
      * @brief Construct a new Function object with function combinations.
      * 
      * @param function_combination A 2D vector of strings representing function combinations.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
      */
     Function(std::vector<std::vector<std::string>> function_combination);
 
+    /**
+     * @brief Construct a new Function object from the non-zero entries of its combinations.
+     * 
+     * The terms may be given in any order. Entries at the same position are added.
+     * 
+     * @param num_equations The number of equations.
+     * @param function_terms The entries of the function combination, whose columns are 0 for the time and j for \f$ y_j \f$.
+     * @param derivative_terms The entries of the derivative combination, whose columns are j for \f$ y_{j+1} \f$.
+     * @throws std::invalid_argument If a term lies outside of its combination.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
+     */
+    Function(int num_equations, std::vector<FunctionTerm> function_terms, std::vector<FunctionTerm> derivative_terms);
+
+    /**
+     * @brief Construct a new Function object from the non-zero entries of its function combination.
+     * 
+     * @param num_equations The number of equations.
+     * @param function_terms The entries of the function combination, whose columns are 0 for the time and j for \f$ y_j \f$.
+     * @throws std::invalid_argument If a term lies outside of the combination.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
+     */
+    Function(int num_equations, std::vector<FunctionTerm> function_terms);
+
     /**
      * @brief Destroy the Function object.
      */
@@ -52,6 +110,7 @@ public:
      * @brief Set the function combination for the Function object.
      * 
      * @param function_combination A 2D vector of strings representing function combinations.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
      */
     void SetFunctionCombination(std::vector<std::vector<std::string>> function_combination);
 
@@ -59,9 +118,56 @@ public:
      * @brief Set the derivative combination for the Function object.
      * 
      * @param derivative_combination A 2D vector of strings representing derivative combinations.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
      */ 
     void SetDerivativeCombination(std::vector<std::vector<std::string>> derivative_combination);
 
+    /**
+     * @brief Get the coefficients of the terms.
+     * 
+     * The vector holds the multiplier and the parameter of every non-zero entry, in this order: the entries of the
+     * function combination row by row, then the entries of the derivative combination row by row.
+     * 
+     * @return const Eigen::VectorXd& The coefficients, two per term.
+     */
+    const Eigen::VectorXd& GetCoefficients() const;
+
+    /**
+     * @brief Replace the coefficients of the terms.
+     * 
+     * Only this object is affected, the terms stay shared with its copies. The coefficients of the derivative
+     * combination are not derived from the others: they must be kept consistent by the caller.
+     * 
+     * @param coefficients The coefficients, laid out as in GetCoefficients().
+     * @throws std::invalid_argument If the number of coefficients does not match the number of terms.
+     */
+    void SetCoefficients(const Eigen::VectorXd& coefficients);
+
+    /**
+     * @brief Set the number of threads evaluating the right-hand side and the Jacobian.
+     *
+     * The terms are split into contiguous ranges of whole equations with about the same number of terms, one
+     * range per task, and the tasks run on a pool of threads that lives as long as the object and its copies.
+     * Systems with few terms are still evaluated on the calling thread, since the synchronization would cost
+     * more than the evaluation.
+     *
+     * @param num_threads The number of threads: one for the serial evaluation, zero for one per hardware thread.
+     * @throws std::invalid_argument If the number of threads is negative.
+     */
+    void SetNumThreads(int num_threads);
+
+    /**
+     * @brief Get the number of threads evaluating the right-hand side and the Jacobian.
+     * @return int The number of threads, one for the serial evaluation.
+     */
+    int GetNumThreads() const;
+
+    /**
+     * @brief Get the number of tasks a call to BuildRightHandSide() is split into.
+     * @return int The number of ranges of terms.
+     */
+    int GetNumTasks() const;
+
     /**
      * @brief Apply a specified function to a given variable and parameter.
      * 
@@ -71,7 +177,7 @@ public:
      * @return double The result of applying the function.
      * @throws std::invalid_argument If the function ID is invalid.
      */
-    double ApplyFunction(int function, double variable, double param);
+    double ApplyFunction(int function, double variable, double param) const;
 
     /**
      * @brief Build the right-hand side of the ODE system.
@@ -79,9 +185,36 @@ public:
      * @param t The current time.
      * @param y The current state vector.
      * @return Eigen::VectorXd The right-hand side vector of the ODE system.
-     * @throws std::invalid_argument If the input format for any function entry is invalid.
      */
-    Eigen::VectorXd BuildRightHandSide(double t, Eigen::VectorXd y);
+    Eigen::VectorXd BuildRightHandSide(double t, const Eigen::VectorXd& y) const;
+
+    /**
+     * @brief Build some equations of the right-hand side of the ODE system.
+     * @param t The current time.
+     * @param y The current state vector.
+     * @param rows The indices of the equations to evaluate.
+     * @return Eigen::VectorXd The right-hand side of the given equations, in the same order.
+     */
+    Eigen::VectorXd BuildRightHandSide(double t, const Eigen::VectorXd& y, const std::vector<int>& rows) const;
+
+    /**
+     * @brief Get the variables every equation of the right-hand side depends on.
+     * @param dim The dimension of the system.
+     * @return std::vector<std::vector<int>> For every equation, the indices of the variables in it, in increasing order and from zero.
+     */
+    std::vector<std::vector<int>> GetDependencies(int dim) const;
+
+    /**
+     * @brief Build the right-hand side of the ODE system for many trajectories at once.
+     * 
+     * Every term is dispatched once and applied to all trajectories, one vector lane per trajectory.
+     * All trajectories use the coefficients of this object.
+     * 
+     * @param t The current time, shared by all trajectories.
+     * @param y The current states, one row per variable and one column per trajectory.
+     * @param rhs The right-hand sides, resized to the size of y.
+     */
+    void BuildEnsembleRightHandSide(double t, const EnsembleState& y, EnsembleState& rhs) const;
 
     /**
      * @brief Build the Jacobian matrix of the ODE system.
@@ -89,16 +222,153 @@ public:
      * @param t The current time.
      * @param y The current state vector.
      * @return Eigen::MatrixXd The Jacobian matrix of the ODE system.
-     * @throws std::invalid_argument If the input format for any derivative entry is invalid.
+     * @throws std::runtime_error If no derivative combination was provided.
+     */
+    Eigen::MatrixXd BuildJacobian(double t, const Eigen::VectorXd& y) const;
+
+    /**
+     * @brief Check whether the right-hand side depends explicitly on time.
+     * 
+     * @return true if no equation has a term in the time variable, false otherwise.
+     */
+    bool IsAutonomous() const;
+
+    /**
+     * @brief Check whether a derivative combination was provided.
+     * 
+     * @return true if BuildJacobian() can be called, false otherwise.
+     */
+    bool HasJacobian() const;
+
+    /**
+     * @brief Write the compiled terms and their coefficients in binary form.
+     * 
+     * The data is written in the byte order of the host, for caches that are read back on the same machine.
+     * 
+     * @param out The stream to write to, opened in binary mode.
+     */
+    void Save(std::ostream& out) const;
+
+    /**
+     * @brief Read terms written by Save(), without parsing the entries again.
+     * 
+     * @param in The stream to read from, opened in binary mode.
+     * @return Function A serial Function with the saved terms and coefficients.
+     * @throws std::runtime_error If the data is truncated or describes invalid terms.
      */
-    Eigen::MatrixXd BuildJacobian(double t, Eigen::VectorXd y);
+    static Function Load(std::istream& in);
 
 private:
-    
-    std::vector<std::vector<std::string>> function_combination;  //< A 2D vector of strings representing function combinations.
-    std::vector<std::vector<std::string>> derivative_combination;   //< A 2D vector of strings representing derivative combinations.
-    std::regex pattern;  //< A regex pattern for parsing function entries.
-    std::smatch match;  //< A regex match object for parsing function entries.
+    /**
+     * @brief A term compiled from an entry such as "+1_6_1".
+     */
+    struct Term
+    {
+        int row;  //< The equation the term contributes to.
+        int column;  //< The column of the entry: for the function combination 0 is the time and j > 0 is \f$ y_j \f$, for the derivative combination j is \f$ y_{j+1} \f$.
+        int function;  //< The function ID (1-7).
+    };
+
+    /**
+     * @brief The compiled terms of the combinations, shared by all copies of a Function.
+     */
+    struct CompiledTerms
+    {
+        int num_rows = 0;  //< The number of rows of the function combination.
+        bool has_jacobian = false;  //< Whether a derivative combination was provided.
+        std::vector<Term> rhs_terms;  //< The terms of the right-hand side.
+        std::vector<Term> jacobian_terms;  //< The terms of the Jacobian.
+        std::vector<int> row_offsets;  //< The first term of the right-hand side of every equation, followed by the number of terms.
+        Eigen::VectorXd coefficients;  //< The coefficients parsed from the entries.
+        bool autonomous = true;  //< Whether no term depends on the time.
+    };
+
+    std::shared_ptr<const CompiledTerms> terms;  //< The compiled terms.
+    Eigen::VectorXd coefficients;  //< The multiplier and parameter of every term.
+    std::shared_ptr<ThreadPool> pool;  //< The threads evaluating the right-hand side, shared by the copies; null for the serial evaluation.
+    std::vector<int> partition;  //< The first term of the right-hand side of every task, followed by the number of terms.
+    std::vector<int> jacobian_partition;  //< The first term of the Jacobian of every task, followed by the number of terms.
+
+    /**
+     * @brief Parse the non-zero entries of the combinations into terms and reset the coefficients.
+     * 
+     * @param num_rows The number of rows of the function combination.
+     * @param function_entries The entries of the function combination.
+     * @param derivative_entries The entries of the derivative combination.
+     * @param has_jacobian Whether the derivative combination is provided.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
+     */
+    void Compile(int num_rows, std::vector<FunctionTerm> function_entries, std::vector<FunctionTerm> derivative_entries, bool has_jacobian);
+
+    /**
+     * @brief Parse entries into terms sorted by row.
+     * @param entries The non-zero entries of a combination.
+     * @param parsed The terms the entries are appended to.
+     * @param values The multiplier and the parameter of every term, appended in the same order.
+     * @throws std::invalid_argument If the input format for any entry is invalid.
+     */
+    static void ParseEntries(std::vector<FunctionTerm> entries, std::vector<Term>& parsed, std::vector<double>& values);
+
+    /**
+     * @brief Share new compiled terms and reset the coefficients to their values.
+     * @param num_rows The number of rows of the function combination.
+     * @param rhs_terms The terms of the right-hand side, sorted by row.
+     * @param rhs_values The coefficients of the terms of the right-hand side.
+     * @param jacobian_terms The terms of the Jacobian, sorted by row.
+     * @param jacobian_values The coefficients of the terms of the Jacobian.
+     * @param has_jacobian Whether the derivative combination is provided.
+     */
+    void Assemble(int num_rows, std::vector<Term> rhs_terms, std::vector<double> rhs_values, std::vector<Term> jacobian_terms, std::vector<double> jacobian_values, bool has_jacobian);
+
+    /**
+     * @brief List the non-zero entries of a combination.
+     * @param combination A 2D vector of strings representing a combination.
+     * @return std::vector<FunctionTerm> The entries other than "0", row by row.
+     */
+    static std::vector<FunctionTerm> ListEntries(const std::vector<std::vector<std::string>>& combination);
+
+    /**
+     * @brief Check that terms lie inside a combination.
+     * @param terms The terms.
+     * @param num_rows The number of rows of the combination.
+     * @param num_columns The number of columns of the combination.
+     * @throws std::invalid_argument If a term lies outside of the combination.
+     */
+    static void CheckPositions(const std::vector<FunctionTerm>& terms, int num_rows, int num_columns);
+
+    /**
+     * @brief Split the terms of the right-hand side and of the Jacobian into ranges, one per task.
+     */
+    void PartitionTerms();
+
+    /**
+     * @brief Split a list of terms sorted by row into ranges of whole rows with about the same number of terms.
+     * @param terms The terms.
+     * @return std::vector<int> The first term of every range, followed by the number of terms.
+     */
+    std::vector<int> PartitionByRows(const std::vector<Term>& terms) const;
+
+    /**
+     * @brief Add a range of terms to the entries of the Jacobian.
+     * 
+     * Terms at the same position are summed, so the Jacobian must start at zero.
+     * 
+     * @param begin The first term.
+     * @param end One past the last term.
+     * @param y The current state vector.
+     * @param jacobian The Jacobian the terms are added to.
+     */
+    void AssignJacobianTerms(int begin, int end, const Eigen::VectorXd& y, Eigen::MatrixXd& jacobian) const;
+
+    /**
+     * @brief Add a range of terms of the right-hand side.
+     * @param begin The first term.
+     * @param end One past the last term.
+     * @param t The current time.
+     * @param y The current state vector.
+     * @param rhs The right-hand side the terms are added to.
+     */
+    void AccumulateTerms(int begin, int end, double t, const Eigen::VectorXd& y, Eigen::VectorXd& rhs) const;
 
     /**
      * @brief Function 1: sine function.
@@ -108,7 +378,7 @@ private:
      * 
      * @return The result of the sin (param * x) 
      */
-    double f1(double x, double param);
+    double f1(double x, double param) const;
 
     /**
      * @brief Function 2: cosine function.
@@ -118,7 +388,7 @@ private:
      * 
      * @return The result of the cos (param * x) 
      */
-    double f2(double x, double param);
+    double f2(double x, double param) const;
 
     /**
      * @brief Function 3: exponential function.
@@ -128,7 +398,7 @@ private:
      * 
      * @return The result of the exp (param * x) 
      */
-    double f3(double x, double param);
+    double f3(double x, double param) const;
 
     /**
      * @brief Function 4: power function.
@@ -138,7 +408,7 @@ private:
      * 
      * @return The result of the pow (x, param) 
      */
-    double f4(double x, double param);
+    double f4(double x, double param) const;
 
     /**
      * @brief Function 5: logarithmic function.
@@ -148,7 +418,7 @@ private:
      * 
      * @return The result of the log (param * x) 
      */
-    double f5(double x, double param);
+    double f5(double x, double param) const;
 
     /**
      * @brief Function 6: identity function.
@@ -158,7 +428,7 @@ private:
      * 
      * @return The result of the param * x 
      */
-    double f6(double x, double param);
+    double f6(double x, double param) const;
 
     /**
      * @brief Function 7: constant function.
@@ -168,7 +438,7 @@ private:
      * 
      * @return The result of the param 
      */
-    double f7(double x, double param); //constant
+    double f7(double x, double param) const; //constant
 };
 
 
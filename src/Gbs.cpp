@@ -0,0 +1,52 @@
+#include "Gbs.h"
+
+Gbs::Gbs()
+{
+    max_columns = 8;
+}
+
+Gbs::Gbs(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : Extrapolation(step_size, initial_time, final_time, initial_condition, function)
+{
+    max_columns = 8;
+}
+
+Gbs::~Gbs()
+{
+
+}
+
+int Gbs::Sequence(int j) const
+{
+    return 2 * (j + 1);
+}
+
+int Gbs::NumSequences() const
+{
+    return 16;
+}
+
+int Gbs::Power() const
+{
+    return 2;
+}
+
+double Gbs::Cost(int j) const
+{
+    // The first sequence also pays for the right-hand side at the beginning of the step, shared by all of them.
+    return (j == 0) ? Sequence(j) + 1 : Sequence(j);
+}
+
+bool Gbs::ComputeSequence(double t, double h, const Eigen::VectorXd& y, const Eigen::VectorXd& f0, int n, Eigen::VectorXd& result) const
+{
+    double substep = h / n;
+    Eigen::VectorXd previous = y;
+    Eigen::VectorXd current = y + substep * f0;
+    for (int m = 1; m < n; m++)
+    {
+        Eigen::VectorXd next = previous + 2.0 * substep * function.BuildRightHandSide(t + m * substep, current);
+        previous.swap(current);
+        current.swap(next);
+    }
+    result = current;
+    return result.allFinite();
+}
@@ -0,0 +1,56 @@
+/**
+ * @file Gbs.h
+ * @brief Defines the Gbs class for solving ordinary differential equations (ODEs) with the Gragg-Bulirsch-Stoer extrapolation method.
+ */
+
+#ifndef GBS_H
+#define GBS_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Extrapolation.h"
+
+/**
+ * @brief A class for solving non-stiff ordinary differential equations (ODEs) with the Gragg-Bulirsch-Stoer extrapolation method.
+ *
+ * The basic method is the modified midpoint rule of Gragg with \f$ n \f$ substeps of size \f$ h = H / n \f$:
+ * \f[
+ * z_1 = y_0 + h f(t_0, y_0), \qquad z_{m+1} = z_{m-1} + 2 h f(t_0 + m h, z_m),
+ * \f]
+ * whose error has an expansion in powers of \f$ h^2 \f$ for even \f$ n \f$. The step numbers are the even harmonic
+ * sequence \f$ 2, 4, 6, 8, \ldots \f$, so that \f$ k \f$ columns give a method of order \f$ 2k \f$.
+ *
+ * By default at most 8 columns are used.
+ */
+class Gbs : public Extrapolation
+{
+public:
+    /**
+     * @brief Construct a new Gbs object.
+     */
+    Gbs();
+
+    /**
+     * @brief Construct a new Gbs object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem.
+     */
+    Gbs(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Gbs object.
+     */
+    ~Gbs();
+
+protected:
+    int Sequence(int j) const override;
+    int NumSequences() const override;
+    int Power() const override;
+    double Cost(int j) const override;
+    bool ComputeSequence(double t, double h, const Eigen::VectorXd& y, const Eigen::VectorXd& f0, int n, Eigen::VectorXd& result) const override;
+};
+
+#endif
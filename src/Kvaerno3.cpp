@@ -0,0 +1,46 @@
+#include "Kvaerno3.h"
+#include "OdeSolver.h"
+
+Kvaerno3::Kvaerno3()
+{
+
+}
+
+Kvaerno3::~Kvaerno3()
+{
+
+}
+
+Kvaerno3::Kvaerno3(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : RungeKutta(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetA();
+    SetB();
+    SetC();
+}
+
+void Kvaerno3::SetA()
+{
+    const double gamma = 0.43586652150845899942;
+    this->a = Eigen::MatrixXd::Zero(4, 4);
+    this->a(1, 0) = gamma;
+    this->a(1, 1) = gamma;
+    this->a(2, 0) = (-4.0 * gamma * gamma + 6.0 * gamma - 1.0) / (4.0 * gamma);
+    this->a(2, 1) = (-2.0 * gamma + 1.0) / (4.0 * gamma);
+    this->a(2, 2) = gamma;
+    this->a(3, 0) = (6.0 * gamma - 1.0) / (12.0 * gamma);
+    this->a(3, 1) = -1.0 / ((24.0 * gamma - 12.0) * gamma);
+    this->a(3, 2) = (-6.0 * gamma * gamma + 6.0 * gamma - 1.0) / (6.0 * gamma - 3.0);
+    this->a(3, 3) = gamma;
+}
+
+void Kvaerno3::SetB()
+{
+    this->b = this->a.row(3).transpose();
+}
+
+void Kvaerno3::SetC()
+{
+    const double gamma = 0.43586652150845899942;
+    this->c = Eigen::VectorXd(4);
+    this->c << 0.0, 2.0 * gamma, 1.0, 1.0;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**
+ * @file Kvaerno3.h
+ * @brief Defines the Kvaerno3 class for solving stiff ordinary differential equations (ODEs) using the Kvaerno 3 method.
+ */
+#ifndef KVAERNO3_H
+#define KVAERNO3_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "OdeSolver.h"
+#include "RungeKutta.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the four-stage Kvaerno ESDIRK of order three.
+ * 
+ * The method of Kvaerno is a four-stage, third-order, L-stable ESDIRK method: the first stage is explicit and the
+ * others share the diagonal coefficient \f$ \gamma \approx 0.43586652 \f$, the root of \f$ 6\gamma^3 - 18\gamma^2 + 9\gamma - 1 = 0 \f$
+ * in \f$ (1/3, 1/2) \f$. It is stiffly accurate: the solution is the last stage.
+ * 
+ * In this setting, the coefficients \f$ a_{ij} \f$, \f$ b_i \f$, and \f$ c_i \f$  are:
+ * 
+ * \f[
+ * \begin{array}{c|cccc}
+ * 0 & 0 & & & \\
+ * 2\gamma & \gamma & \gamma & & \\
+ * 1 & a_{31} & a_{32} & \gamma & \\
+ * 1 & a_{41} & a_{42} & a_{43} & \gamma \\
+ * \hline
+ *      & a_{41} & a_{42} & a_{43} & \gamma
+ * \end{array}
+ * \f]
+ * 
+ * The Jacobian of the system must be provided in the Function object.
+ */
+class Kvaerno3 : public RungeKutta
+{
+public:
+    /**
+     * @brief Construct a new Kvaerno3 object.
+     */
+    Kvaerno3();
+    /**
+     * @brief Construct a new Kvaerno3 object.
+     * @param step_size The step size for the solver.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Kvaerno3(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+    /**
+     * @brief Destroy the Kvaerno3 object.
+     */
+    ~Kvaerno3();
+
+private:
+    /**
+     * @brief Set the A matrix for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's A matrix for
+     * the Kvaerno 3 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetA();
+    /**
+     * @brief Set the B vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's B vector for
+     * the Kvaerno 3 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetB();
+    /**
+     * @brief Set the C vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's C vector for
+     * the Kvaerno 3 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetC();
+};
+
+#endif
\ No newline at end of file
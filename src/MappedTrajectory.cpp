@@ -0,0 +1,159 @@
+#include "MappedTrajectory.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+MappedTrajectory::MappedTrajectory(const std::string& filename, const TrajectoryHeader& header, std::size_t chunk_size) : filename(filename), header(header)
+{
+    if (chunk_size == 0)
+        throw std::invalid_argument("The chunk size must be positive");
+    if (!IsLittleEndianHost())
+        throw std::runtime_error("Trajectory files can only be mapped on little-endian hosts");
+    std::size_t page_size = sysconf(_SC_PAGESIZE);
+    this->chunk_size = (chunk_size + page_size - 1) / page_size * page_size;
+    this->header.layout = TIME_MAJOR;
+}
+
+MappedTrajectory::~MappedTrajectory()
+{
+    UnmapChunk();
+    if (fd >= 0)
+        close(fd);
+}
+
+void MappedTrajectory::Resume(long num_points)
+{
+    if (num_points < 0)
+        throw std::invalid_argument("The number of time points to keep must not be negative");
+    resume_points = num_points;
+}
+
+void MappedTrajectory::Begin(int dimension, long /*num_points*/)
+{
+    UnmapChunk();
+    if (fd >= 0)
+        close(fd);
+    complete = false;
+    long kept = resume_points;
+    resume_points = 0;
+    if (kept > 0)
+    {
+        TrajectoryHeader existing;
+        {
+            std::ifstream in(filename, std::ios::binary);
+            if (!in.is_open())
+                throw std::runtime_error("Could not open file: " + filename);
+            existing = ReadTrajectoryHeader(in);
+        }
+        if (existing.layout != TIME_MAJOR || existing.dimension != (std::uint64_t)dimension || existing.step_size != header.step_size)
+            throw std::runtime_error("The file does not hold a time-major trajectory of this problem: " + filename);
+        if (existing.num_points < (std::uint64_t)kept)
+            throw std::runtime_error("The file holds " + std::to_string(existing.num_points) + " time points, fewer than the " + std::to_string(kept) + " to keep: " + filename);
+        fd = open(filename.c_str(), O_RDWR);
+        if (fd < 0)
+            throw std::runtime_error("Could not open file: " + filename);
+        // The points after the kept ones, written after the last flush, are dropped and produced again.
+        header = existing;
+        header.num_points = kept;
+        end_offset = header.data_offset + kept * dimension * sizeof(double);
+        if (ftruncate(fd, end_offset) != 0)
+            throw std::runtime_error("Could not resize file: " + filename);
+        WriteHeader();
+        return;
+    }
+    fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Could not open file: " + filename);
+    header.dimension = dimension;
+    header.num_points = 0;
+    WriteHeader();
+    end_offset = header.data_offset;
+}
+
+void MappedTrajectory::Append(const Eigen::VectorXd& y)
+{
+    if (y.size() != (Eigen::Index)header.dimension)
+        throw std::invalid_argument("Expected a state of dimension " + std::to_string(header.dimension) + ", got " + std::to_string(y.size()));
+    const char* bytes = reinterpret_cast<const char*>(y.data());
+    std::size_t remaining = y.size() * sizeof(double);
+    // A state may straddle two chunks.
+    while (remaining > 0)
+    {
+        std::size_t index = end_offset / chunk_size;
+        if (!chunk || index != chunk_index)
+            MapChunk(index);
+        std::size_t position = end_offset - index * chunk_size;
+        std::size_t count = std::min(remaining, chunk_size - position);
+        std::memcpy(chunk + position, bytes, count);
+        bytes += count;
+        remaining -= count;
+        end_offset += count;
+    }
+    header.num_points++;
+}
+
+void MappedTrajectory::Flush()
+{
+    // The mapped pages belong to the file already; the header makes them count.
+    WriteHeader();
+}
+
+void MappedTrajectory::End()
+{
+    UnmapChunk();
+    if (ftruncate(fd, end_offset) != 0)
+        throw std::runtime_error("Could not resize file: " + filename);
+    WriteHeader();
+    close(fd);
+    fd = -1;
+    complete = true;
+}
+
+std::size_t MappedTrajectory::GetChunkSize() const
+{
+    return chunk_size;
+}
+
+TrajectoryView MappedTrajectory::GetView() const
+{
+    if (!complete)
+        throw std::runtime_error("The trajectory is not complete: " + filename);
+    return TrajectoryView(filename);
+}
+
+void MappedTrajectory::MapChunk(std::size_t index)
+{
+    UnmapChunk();
+    off_t end = (off_t)((index + 1) * chunk_size);
+    if (ftruncate(fd, end) != 0)
+        throw std::runtime_error("Could not extend file: " + filename);
+    void* address = mmap(nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)(index * chunk_size));
+    if (address == MAP_FAILED)
+        throw std::runtime_error("Could not map file: " + filename);
+    chunk = static_cast<char*>(address);
+    chunk_index = index;
+}
+
+void MappedTrajectory::UnmapChunk()
+{
+    if (!chunk)
+        return;
+    // Start the write-back of the full chunk, so that dirty pages do not pile up in the page cache.
+    msync(chunk, chunk_size, MS_ASYNC);
+    munmap(chunk, chunk_size);
+    chunk = nullptr;
+}
+
+void MappedTrajectory::WriteHeader()
+{
+    std::ostringstream out;
+    WriteTrajectoryHeader(out, header);
+    std::string bytes = out.str();
+    if (pwrite(fd, bytes.data(), bytes.size(), 0) != (ssize_t)bytes.size())
+        throw std::runtime_error("Could not write file: " + filename);
+}
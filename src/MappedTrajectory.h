@@ -0,0 +1,133 @@
+/**
+ * @file MappedTrajectory.h
+ * @brief Defines the MappedTrajectory class, a sink that writes a solution to a memory-mapped trajectory file.
+ */
+
+#ifndef MAPPEDTRAJECTORY_H
+#define MAPPEDTRAJECTORY_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <string>
+#include "TrajectoryFile.h"
+#include "TrajectorySink.h"
+#include "TrajectoryView.h"
+
+/**
+ * @brief A sink that writes a solution to a trajectory file through a sliding memory mapping.
+ *
+ * The file grows by fixed-size chunks. Only the chunk that receives the current time point is mapped: when it
+ * is full, it is unmapped, which leaves its pages to the operating system to write back, and the file is
+ * extended by the next chunk. The memory used by the sink is therefore one chunk, whatever the length of the
+ * solution, and a solver writing to it (see OdeSolver::SolveTo()) can produce trajectories larger than the
+ * physical memory.
+ *
+ * The file is in the time-major binary trajectory format (see TrajectoryFile.h). After End(), it is cut to its
+ * exact size and GetView() maps it back for reading. Flush() records the number of time points written so far in
+ * the header, so that a solve resumed from a checkpoint can append to the file (see Resume()).
+ */
+class MappedTrajectory : public TrajectorySink
+{
+public:
+    /**
+     * @brief Construct a new MappedTrajectory object.
+     * @param filename The name of the file, which is replaced if it exists, unless Resume() is called.
+     * @param header The description of the solution; its layout, dimension and number of time points are set by the sink.
+     * @param chunk_size The number of bytes mapped at a time, rounded up to a multiple of the page size.
+     * @throws std::invalid_argument If the chunk size is zero.
+     * @throws std::runtime_error If the host is not little-endian.
+     */
+    MappedTrajectory(const std::string& filename, const TrajectoryHeader& header, std::size_t chunk_size = 64 << 20);
+
+    /**
+     * @brief Unmap and close the file, which is left incomplete if End() was not called.
+     */
+    ~MappedTrajectory();
+
+    MappedTrajectory(const MappedTrajectory&) = delete;
+    MappedTrajectory& operator=(const MappedTrajectory&) = delete;
+
+    /**
+     * @brief Make the next Begin() keep the first time points of the existing file and append after them.
+     * 
+     * The header of the existing file, including its initial time, is kept, and the points after the kept ones
+     * are dropped. This resumes the output of a solve that restarts from a checkpoint.
+     * 
+     * @param num_points The number of time points to keep.
+     * @throws std::invalid_argument If the number of time points is negative.
+     */
+    void Resume(long num_points);
+
+    /**
+     * @brief Create the file and write its header, or open the existing file if set by Resume().
+     * @param dimension The dimension of the problem.
+     * @param num_points The number of time points that will be appended.
+     * @throws std::runtime_error If the file cannot be created, or if the existing file does not hold the time
+     *                            points to keep of a time-major trajectory of the same dimension and step.
+     */
+    void Begin(int dimension, long num_points) override;
+
+    /**
+     * @brief Write the solution at the next time point.
+     * @param y The solution.
+     * @throws std::runtime_error If the file cannot be extended or mapped.
+     */
+    void Append(const Eigen::VectorXd& y) override;
+
+    /**
+     * @brief Record the number of time points written so far in the header.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void Flush() override;
+
+    /**
+     * @brief Unmap the last chunk, cut the file to its size and complete its header.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void End() override;
+
+    /**
+     * @brief Get the chunk size.
+     * @return std::size_t The number of bytes mapped at a time.
+     */
+    std::size_t GetChunkSize() const;
+
+    /**
+     * @brief Map the completed file for reading.
+     * @return TrajectoryView The read-only view of the solution.
+     * @throws std::runtime_error If End() has not been called.
+     */
+    TrajectoryView GetView() const;
+
+private:
+    std::string filename;  ///< The name of the file.
+    TrajectoryHeader header;  ///< The header of the file.
+    std::size_t chunk_size;  ///< The number of bytes mapped at a time.
+    int fd = -1;  ///< The descriptor of the open file.
+    char* chunk = nullptr;  ///< The mapped chunk, if any.
+    std::size_t chunk_index = 0;  ///< The index of the mapped chunk.
+    std::size_t end_offset = 0;  ///< The offset one past the last value written.
+    bool complete = false;  ///< Whether End() has completed the file.
+    long resume_points = 0;  ///< The number of time points of the existing file the next Begin() keeps.
+
+    /**
+     * @brief Map a chunk of the file, extending the file to cover it.
+     * @param index The index of the chunk.
+     * @throws std::runtime_error If the file cannot be extended or mapped.
+     */
+    void MapChunk(std::size_t index);
+
+    /**
+     * @brief Unmap the mapped chunk, if any.
+     */
+    void UnmapChunk();
+
+    /**
+     * @brief Write the header at the start of the file.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void WriteHeader();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "MemoryProblemCache.h"
+#include <stdexcept>
+#include "Problem.h"
+#include "utils.h"
+
+MemoryProblemCache::MemoryProblemCache(std::size_t capacity) : capacity(capacity)
+{
+    if (capacity == 0)
+        throw std::invalid_argument("The capacity of the cache must be positive");
+}
+
+bool MemoryProblemCache::Load(unsigned long long key, InputParameters& params) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found == index.end())
+    {
+        misses++;
+        return false;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, found->second);
+    params.function = found->second->function;
+    params.diffusion = found->second->diffusion;
+    return true;
+}
+
+bool MemoryProblemCache::Store(unsigned long long key, InputParameters& params) const
+{
+    // Compile outside the lock, so that the hits of other threads do not wait for it.
+    std::shared_ptr<const Function> function, diffusion;
+    try
+    {
+        function = std::make_shared<const Function>(BuildFunction(params));
+        if (!params.diffusion_matrix.empty())
+            diffusion = std::make_shared<const Function>(BuildDiffusion(params));
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    params.function = function;
+    params.diffusion = diffusion;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found != index.end())
+    {
+        // Another thread stored the same system in the meantime.
+        entries.splice(entries.begin(), entries, found->second);
+        return true;
+    }
+    entries.push_front({key, function, diffusion});
+    index[key] = entries.begin();
+    if (entries.size() > capacity)
+    {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    return true;
+}
+
+std::size_t MemoryProblemCache::GetCapacity() const
+{
+    return capacity;
+}
+
+std::size_t MemoryProblemCache::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+unsigned long long MemoryProblemCache::GetHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+unsigned long long MemoryProblemCache::GetMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+void MemoryProblemCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+}
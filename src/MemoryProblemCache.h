@@ -0,0 +1,88 @@
+/**
+ * @file MemoryProblemCache.h
+ * @brief Defines the MemoryProblemCache class, an in-memory cache of the most recently used compiled systems.
+ */
+
+#ifndef MEMORYPROBLEMCACHE_H
+#define MEMORYPROBLEMCACHE_H
+
+#pragma once
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "Function.h"
+#include "SystemCache.h"
+
+/**
+ * @brief A cache of compiled systems kept in memory, for a process that solves many problems.
+ *
+ * A hit attaches the compiled functions themselves to the parameters, without reading or copying them, so that
+ * a problem whose system was seen before is solved right after its other sections are parsed. The cache holds a
+ * fixed number of systems and evicts the least recently used one when a new system is stored. It may be used by
+ * several threads at the same time.
+ */
+class MemoryProblemCache : public SystemCache
+{
+public:
+    /**
+     * @brief Construct a new MemoryProblemCache object.
+     * @param capacity The maximum number of systems held by the cache.
+     * @throws std::invalid_argument If the capacity is zero.
+     */
+    explicit MemoryProblemCache(std::size_t capacity = 256);
+
+    bool Load(unsigned long long key, InputParameters& params) const override;
+
+    bool Store(unsigned long long key, InputParameters& params) const override;
+
+    /**
+     * @brief Get the maximum number of systems held by the cache.
+     * @return std::size_t The capacity.
+     */
+    std::size_t GetCapacity() const;
+
+    /**
+     * @brief Get the number of systems held by the cache.
+     * @return std::size_t The number of systems.
+     */
+    std::size_t GetSize() const;
+
+    /**
+     * @brief Get the number of calls to Load() that found their system.
+     * @return unsigned long long The number of hits.
+     */
+    unsigned long long GetHits() const;
+
+    /**
+     * @brief Get the number of calls to Load() that did not find their system.
+     * @return unsigned long long The number of misses.
+     */
+    unsigned long long GetMisses() const;
+
+    /**
+     * @brief Remove every system of the cache.
+     */
+    void Clear();
+
+private:
+    /**
+     * @brief A compiled system of the cache.
+     */
+    struct Entry
+    {
+        unsigned long long key;  ///< The hash of the sections that define the system.
+        std::shared_ptr<const Function> function;  ///< The compiled function and derivative.
+        std::shared_ptr<const Function> diffusion;  ///< The compiled diffusion, null if there is none.
+    };
+
+    std::size_t capacity;  ///< The maximum number of systems.
+    mutable std::list<Entry> entries;  ///< The systems, the most recently used first.
+    mutable std::unordered_map<unsigned long long, std::list<Entry>::iterator> index;  ///< The system of every key.
+    mutable unsigned long long hits = 0;  ///< The number of hits.
+    mutable unsigned long long misses = 0;  ///< The number of misses.
+    mutable std::mutex mutex;  ///< The mutex protecting the systems and the counters.
+};
+
+#endif // MEMORYPROBLEMCACHE_H
@@ -0,0 +1,24 @@
+#include "Milstein.h"
+
+Milstein::Milstein()
+{
+
+}
+
+Milstein::Milstein(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function drift, Function diffusion) : SdeSolver(step_size, initial_time, final_time, initial_condition, drift, diffusion)
+{
+
+}
+
+Milstein::~Milstein()
+{
+
+}
+
+Eigen::VectorXd Milstein::Step(double t, const Eigen::VectorXd& y, const Eigen::VectorXd& dw) const
+{
+    Eigen::ArrayXd g = diffusion.BuildRightHandSide(t, y).array();
+    Eigen::ArrayXd dg = diffusion.BuildJacobian(t, y).diagonal().array();
+    Eigen::ArrayXd correction = 0.5 * g * dg * (dw.array().square() - step_size);
+    return y + step_size * function.BuildRightHandSide(t, y) + (g * dw.array() + correction).matrix();
+}
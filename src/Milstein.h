@@ -0,0 +1,61 @@
+/**
+ * @file Milstein.h
+ * @brief Defines the Milstein class for solving stochastic differential equations (SDEs) with the Milstein method.
+ */
+
+#ifndef MILSTEIN_H
+#define MILSTEIN_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "SdeSolver.h"
+
+/**
+ * @brief A class for solving stochastic differential equations (SDEs) using the Milstein method.
+ *
+ * The Milstein method adds the Itô correction of the diffusion to the Euler-Maruyama step:
+ * \f[
+ * y_{i,n+1} = y_{i,n} + h f_i(t_n, y_n) + g_i(t_n, y_n) \Delta W_{i,n}
+ *           + \frac{1}{2} g_i \frac{\partial g_i}{\partial y_i} \left( \Delta W_{i,n}^2 - h \right).
+ * \f]
+ * It has strong order 1 when every \f$ g_i \f$ depends on \f$ y_i \f$ only. The derivatives
+ * \f$ \partial g_i / \partial y_i \f$ are the diagonal of the derivative combination of the diffusion Function,
+ * which must therefore be provided.
+ */
+class Milstein : public SdeSolver
+{
+public:
+    /**
+     * @brief Construct a new Milstein object.
+     */
+    Milstein();
+
+    /**
+     * @brief Construct a new Milstein object.
+     * @param step_size The step size for the solver.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param drift A Function object with the drift of the problem.
+     * @param diffusion A Function object with the diffusion of the problem and its derivative combination.
+     */
+    Milstein(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function drift, Function diffusion);
+
+    /**
+     * @brief Destroy the Milstein object.
+     */
+    ~Milstein();
+
+protected:
+    /**
+     * @brief Advance the solution by one Milstein step.
+     * @param t The time at the start of the step.
+     * @param y The solution at the start of the step.
+     * @param dw The Wiener increments of the step.
+     * @return Eigen::VectorXd The solution at the end of the step.
+     * @throws std::runtime_error If the diffusion has no derivative combination.
+     */
+    Eigen::VectorXd Step(double t, const Eigen::VectorXd& y, const Eigen::VectorXd& dw) const;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "MultiStep.h"
+#include "utils.h"
 
 MultiStep::MultiStep()
 {
@@ -44,4 +45,73 @@ void MultiStep::SetAlpha(Eigen::VectorXd alpha)
 void MultiStep::SetBeta(Eigen::VectorXd beta)
 {
     this->beta = beta;
-}
\ No newline at end of file
+}
+
+void MultiStep::SetPredictor(PredictorType predictor)
+{
+    this->predictor = predictor;
+}
+
+Eigen::VectorXd MultiStep::PredictorCoefficients(int history) const
+{
+    // Without a history the predictors reduce to the previous value.
+    if (history == 0)
+        return Eigen::VectorXd(0);
+    switch (predictor)
+    {
+        case EXTRAPOLATION: return ExtrapolationCoefficients(history);
+        case ADAMS_BASHFORTH: return AdamsBashforthCoefficients(history);
+        default: return Eigen::VectorXd(0);
+    }
+}
+
+Eigen::VectorXd MultiStep::Predict(const Eigen::MatrixXd& approximations, const Eigen::MatrixXd& rhs, int current_col, const Eigen::VectorXd& coefficients) const
+{
+    Eigen::VectorXd guess;
+    switch (coefficients.size() == 0 ? PREVIOUS_VALUE : predictor)
+    {
+        case EXTRAPOLATION:
+            guess = Eigen::VectorXd::Zero(approximations.rows());
+            for (int j = 0; j < coefficients.size(); j++)
+            {
+                guess += coefficients(j) * approximations.col(current_col - j - 1);
+            }
+            break;
+        case ADAMS_BASHFORTH:
+            guess = approximations.col(current_col - 1);
+            for (int j = 0; j < coefficients.size(); j++)
+            {
+                guess += step_size * coefficients(j) * rhs.col(current_col - j - 1);
+            }
+            break;
+        default:
+            guess = approximations.col(current_col - 1);
+            break;
+    }
+    return guess;
+}
+
+int MultiStep::RestoreHistory(Eigen::MatrixXd& approximations, Eigen::MatrixXd& rhs, int history)
+{
+    std::shared_ptr<const SolverCheckpoint> checkpoint = StartSolve(history);
+    if (!checkpoint)
+        return 0;
+    int first = checkpoint->next_point;
+    approximations.middleCols(first - history, history) = checkpoint->history.rightCols(history);
+    if (rhs.size() != 0)
+    {
+        if (checkpoint->rhs_history.rows() != rhs.rows() || checkpoint->rhs_history.cols() < history)
+            throw std::runtime_error("The checkpoint does not hold the state of this method");
+        rhs.middleCols(first - history, history) = checkpoint->rhs_history.rightCols(history);
+    }
+    return first;
+}
+
+void MultiStep::SaveHistory(const Eigen::MatrixXd& approximations, const Eigen::MatrixXd& rhs, int next_col, double t, int history)
+{
+    SolverCheckpoint checkpoint = NewCheckpoint(next_col, t);
+    checkpoint.history = approximations.middleCols(next_col - history, history);
+    if (rhs.size() != 0)
+        checkpoint.rhs_history = rhs.middleCols(next_col - history, history);
+    SaveCheckpoint(checkpoint);
+}
@@ -16,6 +16,15 @@
  */
 enum CoeffType { ALPHA, BETA };
 
+/**
+ * @brief An enumeration for the predictors that provide the initial guess of implicit multi-step methods.
+ * 
+ * - PREVIOUS_VALUE: the solution at the previous time step.
+ * - EXTRAPOLATION: polynomial extrapolation of the stored solution history.
+ * - ADAMS_BASHFORTH: an explicit Adams-Bashforth step using the stored function history.
+ */
+enum PredictorType { PREVIOUS_VALUE, EXTRAPOLATION, ADAMS_BASHFORTH };
+
 /**
  * @brief A class for solving ordinary differential equations (ODEs) using multi-step methods.
  * 
@@ -106,6 +115,16 @@ public:
      */
     void SetBeta(Eigen::VectorXd beta);
 
+    /**
+     * @brief Set the predictor used to compute the initial guess of the implicit solve.
+     * 
+     * A better initial guess saves Newton iterations, each of which costs a function evaluation,
+     * a Jacobian evaluation and a linear solve. Explicit methods ignore the predictor.
+     * 
+     * @param predictor The predictor type.
+     */
+    void SetPredictor(PredictorType predictor);
+
 protected:
     /**
      * @brief The alpha coefficients for the MultiStep method.
@@ -121,6 +140,53 @@ protected:
      * 
      */
     Eigen::VectorXd beta;
+    /**
+     * @brief The predictor used to compute the initial guess of the implicit solve.
+     */
+    PredictorType predictor = PREVIOUS_VALUE;
+
+    /**
+     * @brief Compute the coefficients of the predictor.
+     * 
+     * @param history The number of previous time steps available to the predictor.
+     * @return Eigen::VectorXd The coefficients applied to the solution history (EXTRAPOLATION) or to the function history (ADAMS_BASHFORTH), empty for PREVIOUS_VALUE or when there is no history, in which case Predict() falls back to the previous value.
+     */
+    Eigen::VectorXd PredictorCoefficients(int history) const;
+
+    /**
+     * @brief Predict the solution at the next time step.
+     * 
+     * @param approximations The solution history, one column per time step.
+     * @param rhs The function evaluated at each column of the solution history. Only used by ADAMS_BASHFORTH.
+     * @param current_col The column to predict.
+     * @param coefficients The coefficients returned by PredictorCoefficients().
+     * @return Eigen::VectorXd The predicted solution.
+     */
+    Eigen::VectorXd Predict(const Eigen::MatrixXd& approximations, const Eigen::MatrixXd& rhs, int current_col, const Eigen::VectorXd& coefficients) const;
+
+    /**
+     * @brief Restore the solution history from the checkpoint set by SetRestart(), if any.
+     * 
+     * Called by Solve() once the history of the initial condition is filled in, which the checkpoint overwrites.
+     * 
+     * @param approximations The solution history, one column per time step.
+     * @param rhs The function history, or an empty matrix if the method does not keep it.
+     * @param history The number of previous time steps the next step depends on.
+     * @return int The first column of the solution to return: zero, or the next point of the checkpoint.
+     * @throws std::runtime_error If the checkpoint does not match the problem or lacks the function history.
+     */
+    int RestoreHistory(Eigen::MatrixXd& approximations, Eigen::MatrixXd& rhs, int history);
+
+    /**
+     * @brief Write a checkpoint with the solutions (and function values) the next step depends on.
+     * 
+     * @param approximations The solution history, one column per time step.
+     * @param rhs The function history, or an empty matrix if the method does not keep it.
+     * @param next_col The column of the next step.
+     * @param t The time of the last solution.
+     * @param history The number of previous time steps the next step depends on.
+     */
+    void SaveHistory(const Eigen::MatrixXd& approximations, const Eigen::MatrixXd& rhs, int next_col, double t, int history);
 };
 
 #endif
\ No newline at end of file
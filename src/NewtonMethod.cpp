@@ -1,5 +1,9 @@
 #include "NewtonMethod.h"
+#include "utils.h"
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
 NewtonMethod::NewtonMethod()
 {
@@ -44,32 +48,116 @@ void NewtonMethod::SetFunction(Function function)
     this->function = function;
 }
 
-void NewtonMethod::SetInitialGuess(Eigen::VectorXd y0)
+void NewtonMethod::SetInitialGuess(Eigen::VectorXd initial_guess)
 {
-    this->y0 = y0;
+    this->initial_guess = initial_guess;
+}
+
+void NewtonMethod::SetTolerance(double tol)
+{
+    if (tol <= 0)
+        throw std::invalid_argument("Tolerance must be positive");
+    this->tol = tol;
+}
+
+void NewtonMethod::SetErrorWeights(Eigen::VectorXd error_weights)
+{
+    this->error_weights = error_weights;
+}
+
+void NewtonMethod::SetMaxIterations(int max_iterations)
+{
+    if (max_iterations <= 0)
+        throw std::invalid_argument("Maximum number of iterations must be positive");
+    this->max_iterations = max_iterations;
+}
+
+void NewtonMethod::SetIterationMatrix(const Eigen::PartialPivLU<Eigen::MatrixXd>* iteration_matrix)
+{
+    this->iteration_matrix = iteration_matrix;
+}
+
+int NewtonMethod::GetIterations() const
+{
+    return iterations;
+}
+
+double NewtonMethod::GetContractionRate() const
+{
+    return contraction_rate;
 }
 
 Eigen::VectorXd NewtonMethod::Solve()
 {
-    Eigen::VectorXd y = y0;
-    Eigen::VectorXd y_new = y0;
-    Eigen::VectorXd f = function.BuildRightHandSide(t, y);
-    Eigen::MatrixXd J = function.BuildJacobian(t, y);
+    Eigen::VectorXd y;
+    NewtonStatus status = Solve(y);
+    if (status != CONVERGED)
+        throw std::runtime_error("Newton method did not converge at time " + std::to_string(t));
+    return y;
+}
 
-    f = alpha * y - y0 - step_size * (beta * f + constant_term);
-    J = alpha * Eigen::MatrixXd::Identity(y.size(), y.size()) - step_size * beta * function.BuildJacobian(t, y);
+NewtonStatus NewtonMethod::Solve(Eigen::VectorXd& solution)
+{
+    int n = y0.size();
+    Eigen::VectorXd weights = error_weights;
+    if (weights.size() != n)
+        weights = Eigen::VectorXd::Constant(n, 1.0 / tol);
 
-    Eigen::VectorXd delta_y = J.colPivHouseholderQr().solve(-f);
-    y_new += delta_y;
-    while (delta_y.norm() > tol)
+    Eigen::VectorXd y = (initial_guess.size() == n) ? initial_guess : y0;
+    double norm_old = 0.0;
+    iterations = 0;
+    contraction_rate = 0.0;
+    NewtonStatus status = MAX_ITERATIONS;
+
+    while (iterations < max_iterations)
     {
-        y = y_new;
-        f = function.BuildRightHandSide(t,y);
-        J = function.BuildJacobian(t,y);
-        f = alpha * y - y0 - step_size * (beta * f + constant_term);
-        J = alpha * Eigen::MatrixXd::Identity(y.size(), y.size()) - step_size * beta * function.BuildJacobian(t, y);
-        delta_y = J.colPivHouseholderQr().solve(-f);
-        y_new += delta_y;
+        Eigen::VectorXd f = alpha * y - y0 - step_size * (beta * function.BuildRightHandSide(t, y) + constant_term);
+        Eigen::VectorXd delta_y;
+        if (iteration_matrix != nullptr)
+        {
+            delta_y = iteration_matrix->solve(-f);
+        }
+        else
+        {
+            Eigen::MatrixXd J = alpha * Eigen::MatrixXd::Identity(n, n) - step_size * beta * function.BuildJacobian(t, y);
+            // A blocked LU, whose updates are matrix products that Eigen can spread over threads.
+            delta_y = J.partialPivLu().solve(-f);
+        }
+        y += delta_y;
+        iterations++;
+
+        double norm = WeightedRmsNorm(delta_y, weights);
+        if (iterations == 1)
+        {
+            if (norm <= 1.0)
+            {
+                status = CONVERGED;
+                break;
+            }
+        }
+        else
+        {
+            contraction_rate = norm / norm_old;
+            if (contraction_rate >= 1.0)
+            {
+                status = DIVERGED;
+                break;
+            }
+            double error_estimate = contraction_rate / (1.0 - contraction_rate) * norm;
+            if (error_estimate <= 1.0)
+            {
+                status = CONVERGED;
+                break;
+            }
+            // At the observed rate the remaining iterations cannot reach the tolerance.
+            if (std::pow(contraction_rate, max_iterations - iterations) * error_estimate > 1.0)
+            {
+                status = SLOW_CONVERGENCE;
+                break;
+            }
+        }
+        norm_old = norm;
     }
-    return y_new;
+    solution = y;
+    return status;
 }
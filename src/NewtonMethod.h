@@ -10,11 +10,34 @@
 #include <Eigen/Dense>
 #include "Function.h"
 
+/**
+ * @brief An enumeration for the outcome of a Newton solve.
+ * 
+ * - CONVERGED: the estimated error of the iterate is within the tolerance.
+ * - DIVERGED: the corrections grew from one iteration to the next.
+ * - SLOW_CONVERGENCE: the observed contraction rate cannot reach the tolerance within the iteration budget.
+ * - MAX_ITERATIONS: the iteration budget was exhausted.
+ */
+enum NewtonStatus { CONVERGED, DIVERGED, SLOW_CONVERGENCE, MAX_ITERATIONS };
+
 /**
  * @brief A class for solving nonlinear equations using Newton's method.
  * 
  * This class implements a Newton solver, particularly for use in implicit
  * ODE solvers.
+ * 
+ * The size of each correction \f$ \Delta y_k \f$ is measured in the weighted root mean square norm
+ * 
+ * \f[
+ * \| \Delta y \|_w = \sqrt{\frac{1}{n} \sum_{i=1}^{n} (w_i \Delta y_i)^2},
+ * \f]
+ * 
+ * where the weights \f$ w_i \f$ are usually supplied by the integrator as \f$ 1 / (atol + rtol |y_i|) \f$,
+ * so that a norm of one corresponds to the requested accuracy. The contraction rate
+ * \f$ \theta_k = \| \Delta y_k \|_w / \| \Delta y_{k-1} \|_w \f$ is monitored after each iteration: the
+ * iteration stops as converged when \f$ \frac{\theta_k}{1 - \theta_k} \| \Delta y_k \|_w \le 1 \f$, and stops
+ * early as a failure when \f$ \theta_k \ge 1 \f$ or when the remaining iterations cannot reach the tolerance at the
+ * observed rate.
  */
 class NewtonMethod
 {
@@ -71,20 +94,92 @@ public:
     /**
      * @brief Set the initial guess for the NewtonMethod.
      * 
-     * @param y0 The initial guess as a vector.
+     * The guess only changes the starting point of the iteration, the vector y0 given to the
+     * constructor still enters the nonlinear system. Without a guess the iteration starts from y0.
+     * 
+     * @param initial_guess The initial guess as a vector.
+     */
+    void SetInitialGuess(Eigen::VectorXd initial_guess);
+
+    /**
+     * @brief Set a uniform absolute tolerance for the solver.
+     * 
+     * It is only used when no error weights are provided.
+     * 
+     * @param tol The absolute tolerance on the correction.
+     * @throws std::invalid_argument If the tolerance is not positive.
+     */
+    void SetTolerance(double tol);
+
+    /**
+     * @brief Set the error weights used to measure the corrections.
+     * 
+     * @param error_weights The weights \f$ w_i \f$, one per equation. A weighted norm of one is the convergence threshold.
+     */
+    void SetErrorWeights(Eigen::VectorXd error_weights);
+
+    /**
+     * @brief Set the maximum number of iterations.
+     * 
+     * @param max_iterations The maximum number of Newton iterations.
+     * @throws std::invalid_argument If the number of iterations is not positive.
+     */
+    void SetMaxIterations(int max_iterations);
+
+    /**
+     * @brief Use a fixed, already factorized iteration matrix (simplified Newton).
+     * 
+     * The Jacobian is then not rebuilt at each iteration and every correction is solved with the
+     * given LU factorization of \f$ \alpha I - h \beta J \f$, so that several nonlinear systems can
+     * share one factorization. The factorization is not copied and must outlive the calls to Solve().
+     * 
+     * @param iteration_matrix The factorized iteration matrix, or nullptr to go back to the full Newton method.
      */
-    void SetInitialGuess(Eigen::VectorXd y0);
+    void SetIterationMatrix(const Eigen::PartialPivLU<Eigen::MatrixXd>* iteration_matrix);
 
     /**
      * @brief Solve the nonlinear system using Newton's method.
      * 
      * @return Eigen::VectorXd The solution of the nonlinear system.
+     * @throws std::runtime_error If the iteration does not converge.
      */
     Eigen::VectorXd Solve();
+
+    /**
+     * @brief Solve the nonlinear system using Newton's method and report the outcome.
+     * 
+     * Unlike Solve(), a failed iteration does not throw, so that the caller can reduce the step
+     * size or refresh the Jacobian and try again.
+     * 
+     * @param solution The last iterate, which is the solution of the nonlinear system if the status is CONVERGED.
+     * @return NewtonStatus The outcome of the iteration.
+     */
+    NewtonStatus Solve(Eigen::VectorXd& solution);
+
+    /**
+     * @brief Get the number of iterations performed by the last solve.
+     * 
+     * @return int The number of iterations.
+     */
+    int GetIterations() const;
+
+    /**
+     * @brief Get the last contraction rate observed by the last solve.
+     * 
+     * @return double The ratio between the last two correction norms, zero if only one iteration was performed.
+     */
+    double GetContractionRate() const;
+
 private:
     Function function;  //< The function object representing the system.
-    Eigen::VectorXd y0;  //< The initial guess for the solution.
-    double tol = 1e-4;   //< The tolerance for the solver.
+    Eigen::VectorXd y0;  //< The constant vector of the nonlinear system, also the default initial guess.
+    Eigen::VectorXd initial_guess;  //< The starting point of the iteration, if set.
+    double tol = 1e-4;   //< The absolute tolerance used when no error weights are provided.
+    Eigen::VectorXd error_weights;  //< The weights used to measure the corrections.
+    int max_iterations = 10;  //< The maximum number of iterations.
+    const Eigen::PartialPivLU<Eigen::MatrixXd>* iteration_matrix = nullptr;  //< The fixed iteration matrix, if set.
+    int iterations = 0;  //< The number of iterations performed by the last solve.
+    double contraction_rate = 0.0;  //< The last contraction rate observed by the last solve.
     double t;  //< The current time value.
     double h = 0.01;  //< The step size for numerical differentiation.
     double step_size;  //< The time step size for the solver.
@@ -1,4 +1,11 @@
 #include "OdeSolver.h"
+#include <cmath>
+#include <string>
+
+SolveCancelled::SolveCancelled(double time) : std::runtime_error("The solve was cancelled at time " + std::to_string(time))
+{
+
+}
 
 OdeSolver::OdeSolver()
 {
@@ -47,4 +54,167 @@ void OdeSolver::SetFunction(Function function)
     this->function = function;
 }
 
+double OdeSolver::GetStepSize() const
+{
+    return step_size;
+}
+
+double OdeSolver::GetInitialTime() const
+{
+    return initial_time;
+}
+
+double OdeSolver::GetFinalTime() const
+{
+    return final_time;
+}
+
+const Eigen::MatrixXd& OdeSolver::GetInitialCondition() const
+{
+    return initial_condition;
+}
+
+const Function& OdeSolver::GetFunction() const
+{
+    return function;
+}
+
+void OdeSolver::SetTolerances(double rel_tol, double abs_tol)
+{
+    if (rel_tol < 0 || abs_tol < 0 || (rel_tol == 0 && abs_tol == 0))
+        throw std::invalid_argument("Tolerances must be non-negative and not both zero");
+    this->rel_tol = rel_tol;
+    this->abs_tol = abs_tol;
+}
+
+double OdeSolver::GetRelativeTolerance() const
+{
+    return rel_tol;
+}
+
+double OdeSolver::GetAbsoluteTolerance() const
+{
+    return abs_tol;
+}
+
+void OdeSolver::SetControl(std::shared_ptr<SolveControl> control)
+{
+    this->control = control;
+}
+
+const std::shared_ptr<SolveControl>& OdeSolver::GetControl() const
+{
+    return control;
+}
+
+void OdeSolver::ReportStep(double t)
+{
+    if (!control)
+        return;
+    control->time.store(t, std::memory_order_relaxed);
+    control->steps.fetch_add(1, std::memory_order_relaxed);
+    if (control->cancelled.load(std::memory_order_relaxed))
+        throw SolveCancelled(t);
+}
+
+void OdeSolver::SetCheckpointFile(const std::string& filename, long every_points, double every_seconds)
+{
+    if (every_points < 0 || every_seconds < 0)
+        throw std::invalid_argument("Checkpoint intervals must not be negative");
+    checkpoint_file = filename;
+    checkpoint_points = every_points;
+    checkpoint_seconds = every_seconds;
+}
+
+void OdeSolver::SetRestart(const SolverCheckpoint& checkpoint)
+{
+    restart = std::make_shared<const SolverCheckpoint>(checkpoint);
+}
 
+bool OdeSolver::SupportsEvents() const
+{
+    return false;
+}
+
+int OdeSolver::AddEvent(const SolverEvent& event)
+{
+    if (!SupportsEvents())
+        throw std::runtime_error("Events are only supported by the one-step methods");
+    return events.Add(event);
+}
+
+void OdeSolver::ClearEvents()
+{
+    events.Clear();
+}
+
+const std::vector<EventOccurrence>& OdeSolver::GetEventOccurrences() const
+{
+    return events.GetOccurrences();
+}
+
+std::shared_ptr<const SolverCheckpoint> OdeSolver::StartSolve(int history_columns)
+{
+    points_since_checkpoint = 0;
+    last_checkpoint = std::chrono::steady_clock::now();
+    std::shared_ptr<const SolverCheckpoint> checkpoint = restart;
+    restart.reset();
+    if (!checkpoint)
+        return checkpoint;
+    if (checkpoint->initial_time != initial_time || checkpoint->final_time != final_time || checkpoint->output_step != step_size
+        || checkpoint->history.rows() != initial_condition.rows())
+        throw std::runtime_error("The checkpoint belongs to another problem");
+    if (checkpoint->next_point < history_columns || checkpoint->next_point > GetNumTimePoints() || checkpoint->history.cols() < history_columns)
+        throw std::runtime_error("The checkpoint does not hold the state of this method");
+    return checkpoint;
+}
+
+bool OdeSolver::CheckpointDue()
+{
+    if (checkpoint_file.empty())
+        return false;
+    points_since_checkpoint++;
+    if (checkpoint_points > 0 && points_since_checkpoint >= checkpoint_points)
+        return true;
+    return checkpoint_seconds > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - last_checkpoint).count() >= checkpoint_seconds;
+}
+
+SolverCheckpoint OdeSolver::NewCheckpoint(long next_point, double time) const
+{
+    SolverCheckpoint checkpoint;
+    checkpoint.initial_time = initial_time;
+    checkpoint.final_time = final_time;
+    checkpoint.output_step = step_size;
+    checkpoint.next_point = next_point;
+    checkpoint.time = time;
+    checkpoint.step_size = step_size;
+    return checkpoint;
+}
+
+void OdeSolver::SaveCheckpoint(const SolverCheckpoint& checkpoint)
+{
+    WriteCheckpoint(checkpoint_file, checkpoint);
+    points_since_checkpoint = 0;
+    last_checkpoint = std::chrono::steady_clock::now();
+}
+
+int OdeSolver::GetNumTimePoints() const
+{
+    return (int)std::floor((final_time - initial_time) / step_size + 1e-9) + 1;
+}
+
+Eigen::VectorXd OdeSolver::ErrorWeights(const Eigen::VectorXd& y) const
+{
+    return (abs_tol + rel_tol * y.array().abs()).inverse().matrix();
+}
+
+void OdeSolver::SolveTo(TrajectorySink& sink)
+{
+    Eigen::MatrixXd approximations = Solve();
+    sink.Begin(approximations.rows(), approximations.cols());
+    for (int n = 0; n < approximations.cols(); n++)
+    {
+        sink.Append(approximations.col(n));
+    }
+    sink.End();
+}
@@ -22,9 +22,41 @@
 
 #pragma once
 #include <Eigen/Dense>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <stdexcept>
+#include "Checkpoint.h"
+#include "EventMonitor.h"
 #include "Function.h"
+#include "TrajectorySink.h"
+
+/**
+ * @brief The progress of a solve and its cancellation flag, shared between the solving thread and its observers.
+ * 
+ * The members are atomic, so that they are read and written from several threads without locking.
+ */
+struct SolveControl
+{
+    std::atomic<double> time{0.0};  ///< The time reached by the last step.
+    std::atomic<long> steps{0};  ///< The number of steps taken.
+    std::atomic<bool> cancelled{false};  ///< Whether the solve should stop after the current step.
+};
+
+/**
+ * @brief The exception thrown by a solve that was cancelled through its SolveControl.
+ */
+class SolveCancelled : public std::runtime_error
+{
+public:
+    /**
+     * @brief Construct a new SolveCancelled object.
+     * @param time The time reached by the last step before the cancellation.
+     */
+    explicit SolveCancelled(double time);
+};
 
 /**
  * @brief A class for solving ordinary differential equations (ODEs).
@@ -37,6 +69,75 @@ protected:
     double final_time;   ///< The final time of the problem.
     Eigen::MatrixXd initial_condition;  ///< The initial condition of the problem.
     Function function;   ///< A Function object that includes the actual function of the problem and optionally its derivative (needed if the method is implicit).
+    double rel_tol = 1e-6;  ///< The relative tolerance used to scale errors and Newton corrections.
+    double abs_tol = 1e-6;  ///< The absolute tolerance used to scale errors and Newton corrections.
+
+    /**
+     * @brief Compute the error weights for a given state.
+     * 
+     * The weights are \f$ w_i = 1 / (atol + rtol |y_i|) \f$, so that a weighted norm of one corresponds to the requested accuracy.
+     * 
+     * @param y The state at which the weights are computed.
+     * @return Eigen::VectorXd The error weights.
+     */
+    Eigen::VectorXd ErrorWeights(const Eigen::VectorXd& y) const;
+
+    std::shared_ptr<SolveControl> control;  ///< The progress and cancellation flag of the solve, if any.
+
+    /**
+     * @brief Report a completed step and stop the solve if it was cancelled.
+     * 
+     * Called by Solve() after every step.
+     * 
+     * @param t The time reached by the step.
+     * @throws SolveCancelled If the cancellation flag of the control is set.
+     */
+    void ReportStep(double t);
+
+    std::string checkpoint_file;  ///< The file receiving the checkpoints, empty to write none.
+    long checkpoint_points = 0;  ///< The number of time points between two checkpoints, zero for no limit.
+    double checkpoint_seconds = 0.0;  ///< The wall time between two checkpoints in seconds, zero for no limit.
+    long points_since_checkpoint = 0;  ///< The number of time points produced since the last checkpoint.
+    std::chrono::steady_clock::time_point last_checkpoint;  ///< The wall time of the last checkpoint.
+    std::shared_ptr<const SolverCheckpoint> restart;  ///< The state the next solve resumes from, if any.
+
+    /**
+     * @brief Start the checkpoint intervals and take the state the solve resumes from.
+     * 
+     * Called by Solve() before the first step. The restart is only used once: the next solve starts from the
+     * initial condition again.
+     * 
+     * @param history_columns The number of solutions the method needs to continue.
+     * @return std::shared_ptr<const SolverCheckpoint> The state to resume from, or a null pointer to start from the initial condition.
+     * @throws std::runtime_error If the state belongs to another problem or lacks solutions the method needs.
+     */
+    std::shared_ptr<const SolverCheckpoint> StartSolve(int history_columns);
+
+    /**
+     * @brief Check whether a checkpoint is due after a new time point.
+     * 
+     * Called by Solve() after every time point, at which it saves a checkpoint if this returns true.
+     * 
+     * @return true if a checkpoint file is set and the number of points or the wall time since the last checkpoint reached its interval.
+     */
+    bool CheckpointDue();
+
+    /**
+     * @brief Create a checkpoint of the problem, for the state reached at a time point.
+     * @param next_point The index of the time point after the state.
+     * @param time The time of the state.
+     * @return SolverCheckpoint A checkpoint with the problem and the position filled in.
+     */
+    SolverCheckpoint NewCheckpoint(long next_point, double time) const;
+
+    /**
+     * @brief Write a checkpoint to the checkpoint file and restart the intervals.
+     * @param checkpoint The checkpoint.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void SaveCheckpoint(const SolverCheckpoint& checkpoint);
+
+    EventMonitor events;  ///< The events watched after every step, and their occurrences in the last solve.
 public:
 
     /**
@@ -87,6 +188,140 @@ public:
      * @param function A Function object that includes the actual function of the problem and optionally its derivative (needed if the method is implicit).
      */
     void SetFunction(Function function);
+
+    /**
+     * @brief Get the step size of the solver.
+     * @return double The step size.
+     */
+    double GetStepSize() const;
+
+    /**
+     * @brief Get the initial time of the problem.
+     * @return double The initial time.
+     */
+    double GetInitialTime() const;
+
+    /**
+     * @brief Get the final time of the problem.
+     * @return double The final time.
+     */
+    double GetFinalTime() const;
+
+    /**
+     * @brief Get the initial condition of the problem.
+     * @return const Eigen::MatrixXd& The initial condition of the problem.
+     */
+    const Eigen::MatrixXd& GetInitialCondition() const;
+
+    /**
+     * @brief Get the Function object of the problem.
+     * @return const Function& The Function object of the problem.
+     */
+    const Function& GetFunction() const;
+
+    /**
+     * @brief Set the tolerances of the solver.
+     * 
+     * Implicit methods use them to decide when the Newton iteration has converged.
+     * 
+     * @param rel_tol The relative tolerance.
+     * @param abs_tol The absolute tolerance.
+     * @throws std::invalid_argument If a tolerance is negative or both are zero.
+     */
+    void SetTolerances(double rel_tol, double abs_tol);
+
+    /**
+     * @brief Get the relative tolerance of the solver.
+     * @return double The relative tolerance.
+     */
+    double GetRelativeTolerance() const;
+
+    /**
+     * @brief Get the absolute tolerance of the solver.
+     * @return double The absolute tolerance.
+     */
+    double GetAbsoluteTolerance() const;
+
+    /**
+     * @brief Attach a control that receives the progress of Solve() and can cancel it.
+     * 
+     * Solve() updates the time and the step count after every step, and stops with SolveCancelled after the
+     * first step that sees the cancellation flag. Copies of the solver share the control.
+     * 
+     * @param control The control, or a null pointer to detach it.
+     */
+    void SetControl(std::shared_ptr<SolveControl> control);
+
+    /**
+     * @brief Get the control attached to the solver.
+     * @return const std::shared_ptr<SolveControl>& The control, or a null pointer.
+     */
+    const std::shared_ptr<SolveControl>& GetControl() const;
+
+    /**
+     * @brief Save the state of the solve to a file at regular intervals.
+     * 
+     * A checkpoint is written after a time point once either interval has elapsed since the previous one, so
+     * that an interrupted solve can be resumed with SetRestart(). Copies of the solver write to the same file.
+     * 
+     * @param filename The file receiving the checkpoints, or an empty string to write none.
+     * @param every_points The number of time points between two checkpoints, zero for no limit.
+     * @param every_seconds The wall time between two checkpoints in seconds, zero for no limit.
+     * @throws std::invalid_argument If an interval is negative.
+     */
+    void SetCheckpointFile(const std::string& filename, long every_points, double every_seconds = 0.0);
+
+    /**
+     * @brief Resume the next solve from a checkpoint.
+     * 
+     * The solve continues with the same steps as the interrupted one, so its results are identical bit for bit.
+     * It only returns the time points from the next point of the checkpoint on, the points before it having been
+     * produced by the interrupted solve.
+     * 
+     * @param checkpoint The state written by a solver of the same method on the same problem.
+     */
+    void SetRestart(const SolverCheckpoint& checkpoint);
+
+    /**
+     * @brief Check whether the method watches events.
+     * @return true for the one-step methods, which can shorten a step to end it at an event, false otherwise.
+     */
+    virtual bool SupportsEvents() const;
+
+    /**
+     * @brief Watch an event during the next solves.
+     * 
+     * After every step the event function is evaluated, and its root is located when it changes sign (see
+     * EventMonitor). A stopping event ends the solve before the next time point: Solve() then returns fewer
+     * columns than GetNumTimePoints(), and SolveTo() appends fewer points than announced to its sink.
+     * 
+     * @param event The event.
+     * @return int The index of the event in the occurrences.
+     * @throws std::invalid_argument If the event is invalid (see EventMonitor::Add()).
+     * @throws std::runtime_error If the method does not support events.
+     */
+    int AddEvent(const SolverEvent& event);
+
+    /**
+     * @brief Stop watching every event.
+     */
+    void ClearEvents();
+
+    /**
+     * @brief Get the events that occurred during the last solve.
+     * @return const std::vector<EventOccurrence>& The occurrences, in the order of their times; the last one ended the solve if its event stops.
+     */
+    const std::vector<EventOccurrence>& GetEventOccurrences() const;
+
+    /**
+     * @brief Get the number of time points of the solution.
+     * 
+     * The solution is returned at the initial time and at every multiple of the step size up to the final time.
+     * A ratio between the interval length and the step size that is an integer up to rounding errors is treated as that integer.
+     * 
+     * @return int The number of columns of the matrix returned by Solve().
+     */
+    int GetNumTimePoints() const;
     
     /**
      * @brief Solve the ODE problem.
@@ -98,6 +333,18 @@ public:
      * @return Eigen::MatrixXd A matrix containing the solution of the ODE at each time step.
      */
     virtual Eigen::MatrixXd Solve() = 0;
+
+    /**
+     * @brief Solve the ODE problem into a sink, one time point at a time.
+     * 
+     * One-step methods override this function to hand every time point to the sink as soon as it is computed,
+     * so that the solution never has to fit in memory. The multistep methods also hand over every point as it is
+     * computed, so that a checkpoint follows the points it flushes, but keep the whole solution in memory. The
+     * default implementation calls Solve() and appends the columns of its result.
+     * 
+     * @param sink The sink receiving the solution at each time point.
+     */
+    virtual void SolveTo(TrajectorySink& sink);
 };
 
 #endif //ODESOLVER_H
\ No newline at end of file
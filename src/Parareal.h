@@ -0,0 +1,209 @@
+/**
+ * @file Parareal.h
+ * @brief Defines the Parareal class for integrating one ODE problem in parallel in time.
+ */
+
+#ifndef PARAREAL_H
+#define PARAREAL_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "OdeSolver.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief A class implementing the Parareal algorithm with a coarse and a fine one-step propagator.
+ *
+ * The time interval of the fine prototype is split into slices made of whole fine steps. A serial sweep of the
+ * coarse propagator gives a first value at the start of every slice; then, at every iteration, the fine propagator
+ * is run on all the slices at the same time and the start values are corrected with a serial coarse sweep,
+ * \f[
+ * U_{k+1}^{j+1} = G(U_k^{j+1}) + F(U_k^j) - G(U_k^j).
+ * \f]
+ * The iteration stops when no start value changes by more than the tolerance, relative to its size. After as many
+ * iterations as slices the start values are those of a serial fine solve, so the number of iterations is at most
+ * the number of slices and the speed-up comes from converging in fewer.
+ *
+ * The propagators are copied for every slice with their time interval and initial condition replaced, so they must
+ * be one-step methods (such as ForwardEuler or any RungeKutta). The coarse step size is shortened, if needed, to
+ * divide every slice exactly.
+ *
+ * @tparam Coarse The class of the cheap propagator.
+ * @tparam Fine The class of the accurate propagator.
+ */
+template <typename Coarse, typename Fine>
+class Parareal
+{
+public:
+    /**
+     * @brief Construct a new Parareal object.
+     * @param coarse The cheap propagator, which only provides the method and the step size.
+     * @param fine The accurate propagator, which also provides the problem, the time interval and the output grid.
+     * @param num_slices The number of time slices.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     * @throws std::invalid_argument If the number of slices is not positive or exceeds the number of fine steps.
+     */
+    Parareal(const Coarse& coarse, const Fine& fine, int num_slices, int num_threads = 0) : coarse(coarse), fine(fine), pool(num_threads)
+    {
+        int num_steps = fine.GetNumTimePoints() - 1;
+        if (num_slices <= 0 || num_slices > num_steps)
+            throw std::invalid_argument("The number of slices must be between 1 and the number of fine steps (" + std::to_string(num_steps) + ")");
+        for (int k = 0; k <= num_slices; k++)
+        {
+            boundaries.push_back((int)std::round((double)num_steps * k / num_slices));
+        }
+        max_iterations = num_slices;
+    }
+
+    /**
+     * @brief Set the tolerance on the change of the slice start values.
+     * @param tolerance The largest change, relative to \f$ 1 + \| U_k \|_\infty \f$, at which the iteration stops.
+     * @throws std::invalid_argument If the tolerance is negative.
+     */
+    void SetTolerance(double tolerance)
+    {
+        if (tolerance < 0)
+            throw std::invalid_argument("The tolerance must not be negative");
+        this->tolerance = tolerance;
+    }
+
+    /**
+     * @brief Set the maximum number of iterations.
+     * @param max_iterations The maximum number of fine sweeps; the default is the number of slices.
+     * @throws std::invalid_argument If the number is not positive.
+     */
+    void SetMaxIterations(int max_iterations)
+    {
+        if (max_iterations <= 0)
+            throw std::invalid_argument("The maximum number of iterations must be positive");
+        this->max_iterations = max_iterations;
+    }
+
+    /**
+     * @brief Get the number of iterations of the last call to Solve().
+     * @return int The number of fine sweeps.
+     */
+    int GetIterations() const
+    {
+        return iterations;
+    }
+
+    /**
+     * @brief Get the number of time slices.
+     * @return int The number of time slices.
+     */
+    int GetNumSlices() const
+    {
+        return boundaries.size() - 1;
+    }
+
+    /**
+     * @brief Solve the problem of the fine propagator.
+     * @return Eigen::MatrixXd The solution at each time point of the fine propagator.
+     * @throws std::runtime_error If a propagator fails or the iteration does not converge within the maximum number of iterations.
+     */
+    Eigen::MatrixXd Solve()
+    {
+        int num_slices = GetNumSlices();
+        double h = fine.GetStepSize();
+        double t0 = fine.GetInitialTime();
+        std::vector<double> times(num_slices + 1);
+        for (int k = 0; k <= num_slices; k++)
+        {
+            times[k] = t0 + boundaries[k] * h;
+        }
+
+        Eigen::MatrixXd results(fine.GetInitialCondition().rows(), fine.GetNumTimePoints());
+        std::vector<Eigen::VectorXd> start(num_slices + 1);
+        std::vector<Eigen::VectorXd> coarse_end(num_slices);
+        std::vector<Eigen::VectorXd> fine_end(num_slices);
+        std::vector<std::exception_ptr> errors(num_slices);
+        start[0] = fine.GetInitialCondition().col(0);
+        for (int k = 0; k < num_slices; k++)
+        {
+            coarse_end[k] = PropagateCoarse(times[k], times[k + 1], start[k]);
+            start[k + 1] = coarse_end[k];
+        }
+
+        // Slices before the iteration index start from an exact value and need no further fine solve.
+        for (iterations = 1; iterations <= max_iterations; iterations++)
+        {
+            int first = iterations - 1;
+            pool.ParallelFor(first, num_slices, [&](int begin, int end) {
+                for (int k = begin; k < end; k++)
+                {
+                    try
+                    {
+                        Fine solver = fine;
+                        solver.SetTimeInterval(times[k], times[k + 1]);
+                        solver.SetInitialCondition(start[k]);
+                        Eigen::MatrixXd slice = solver.Solve();
+                        // The last column of a slice is the first of the next one, which writes it from its
+                        // corrected start value; only the last slice writes its final column.
+                        int num_cols = (k == num_slices - 1) ? slice.cols() : slice.cols() - 1;
+                        results.middleCols(boundaries[k], num_cols) = slice.leftCols(num_cols);
+                        fine_end[k] = slice.col(slice.cols() - 1);
+                    }
+                    catch (...)
+                    {
+                        errors[k] = std::current_exception();
+                    }
+                }
+            }, 1);
+            for (int k = first; k < num_slices; k++)
+            {
+                if (errors[k])
+                    std::rethrow_exception(errors[k]);
+            }
+
+            double change = 0.0;
+            for (int k = first; k < num_slices; k++)
+            {
+                Eigen::VectorXd coarse_new = PropagateCoarse(times[k], times[k + 1], start[k]);
+                Eigen::VectorXd corrected = coarse_new + fine_end[k] - coarse_end[k];
+                change = std::max(change, (corrected - start[k + 1]).lpNorm<Eigen::Infinity>() / (1.0 + corrected.lpNorm<Eigen::Infinity>()));
+                coarse_end[k] = coarse_new;
+                start[k + 1] = corrected;
+            }
+            if (change <= tolerance || iterations == num_slices)
+                return results;
+        }
+        iterations = max_iterations;
+        throw std::runtime_error("Parareal did not converge in " + std::to_string(max_iterations) + " iterations");
+    }
+
+private:
+    Coarse coarse;  ///< The cheap propagator.
+    Fine fine;  ///< The accurate propagator.
+    ThreadPool pool;  ///< The worker threads running the fine solves.
+    std::vector<int> boundaries;  ///< The index of the fine time point at the start of every slice, followed by the last index.
+    double tolerance = 1e-8;  ///< The tolerance on the change of the slice start values.
+    int max_iterations;  ///< The maximum number of fine sweeps.
+    int iterations = 0;  ///< The number of fine sweeps of the last solve.
+
+    /**
+     * @brief Run the coarse propagator over one slice.
+     * @param begin The start of the slice.
+     * @param end The end of the slice.
+     * @param y The value at the start of the slice.
+     * @return Eigen::VectorXd The value at the end of the slice.
+     */
+    Eigen::VectorXd PropagateCoarse(double begin, double end, const Eigen::VectorXd& y) const
+    {
+        int num_steps = std::max(1, (int)std::ceil((end - begin) / coarse.GetStepSize() - 1e-9));
+        Coarse solver = coarse;
+        solver.SetStepSize((end - begin) / num_steps);
+        solver.SetTimeInterval(begin, end);
+        solver.SetInitialCondition(y);
+        Eigen::MatrixXd solution = solver.Solve();
+        return solution.col(solution.cols() - 1);
+    }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "Philox.h"
+#include <cmath>
+
+namespace
+{
+// The multipliers and the key increments (Weyl constants) of Philox4x32.
+const std::uint32_t kMultiplier0 = 0xD2511F53;
+const std::uint32_t kMultiplier1 = 0xCD9E8D57;
+const std::uint32_t kWeyl0 = 0x9E3779B9;
+const std::uint32_t kWeyl1 = 0xBB67AE85;
+const int kRounds = 10;
+const double kTwoPi = 6.283185307179586;
+
+// A uniform number in the open interval (0, 1) from 64 random bits, of which the upper 53 are used.
+double OpenUniform(std::uint32_t high, std::uint32_t low)
+{
+    std::uint64_t bits = ((std::uint64_t)high << 32 | low) >> 11;
+    return (bits + 0.5) * (1.0 / 9007199254740992.0);
+}
+}
+
+Philox::Philox(std::uint64_t seed)
+{
+    key = {(std::uint32_t)seed, (std::uint32_t)(seed >> 32)};
+}
+
+std::uint64_t Philox::GetSeed() const
+{
+    return (std::uint64_t)key[1] << 32 | key[0];
+}
+
+Philox::Counter Philox::Generate(Counter counter, Key key)
+{
+    for (int round = 0; round < kRounds; round++)
+    {
+        std::uint64_t product0 = (std::uint64_t)kMultiplier0 * counter[0];
+        std::uint64_t product1 = (std::uint64_t)kMultiplier1 * counter[2];
+        counter = {(std::uint32_t)(product1 >> 32) ^ counter[1] ^ key[0], (std::uint32_t)product1,
+                   (std::uint32_t)(product0 >> 32) ^ counter[3] ^ key[1], (std::uint32_t)product0};
+        key[0] += kWeyl0;
+        key[1] += kWeyl1;
+    }
+    return counter;
+}
+
+void Philox::Normals(std::uint64_t stream, std::uint64_t first, Eigen::Ref<Eigen::VectorXd> normals) const
+{
+    double pair[2];
+    for (int i = 0; i < normals.size(); i++)
+    {
+        std::uint64_t position = first + i;
+        if (i == 0 || position % 2 == 0)
+            NormalPair(stream, position / 2, pair);
+        normals(i) = pair[position % 2];
+    }
+}
+
+void Philox::NormalPair(std::uint64_t stream, std::uint64_t block, double normals[2]) const
+{
+    Counter bits = Generate({(std::uint32_t)block, (std::uint32_t)(block >> 32), (std::uint32_t)stream, (std::uint32_t)(stream >> 32)}, key);
+    double radius = std::sqrt(-2.0 * std::log(OpenUniform(bits[0], bits[1])));
+    double angle = kTwoPi * OpenUniform(bits[2], bits[3]);
+    normals[0] = radius * std::cos(angle);
+    normals[1] = radius * std::sin(angle);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file Philox.h
+ * @brief Defines the Philox class, a counter-based random number generator for reproducible parallel streams.
+ */
+
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief The Philox4x32-10 counter-based random number generator.
+ *
+ * The generator is a keyed bijection of a 128-bit counter: the random numbers are a pure function of the key
+ * (the seed) and of the counter, and there is no state to advance. Every stream, for example every path of an
+ * ensemble, therefore draws its numbers independently of the others and of the order in which the threads run,
+ * and any number of a stream can be computed directly from its position.
+ *
+ * The counter is made of the stream in its upper 64 bits and of a block index in its lower 64 bits. Each block
+ * gives 128 random bits, that is two uniform doubles with 53 random bits each, turned into two standard normal
+ * numbers by the Box-Muller transform.
+ */
+class Philox
+{
+public:
+    typedef std::array<std::uint32_t, 4> Counter;  ///< A 128-bit counter, or a block of 128 random bits.
+    typedef std::array<std::uint32_t, 2> Key;  ///< A 64-bit key.
+
+    /**
+     * @brief Construct a new Philox object.
+     * @param seed The seed, used as the key of the generator.
+     */
+    explicit Philox(std::uint64_t seed = 0);
+
+    /**
+     * @brief Get the seed of the generator.
+     * @return std::uint64_t The seed.
+     */
+    std::uint64_t GetSeed() const;
+
+    /**
+     * @brief Apply the ten rounds of the bijection to a counter.
+     * @param counter The counter.
+     * @param key The key.
+     * @return Counter The 128 random bits of the counter.
+     */
+    static Counter Generate(Counter counter, Key key);
+
+    /**
+     * @brief Get consecutive standard normal numbers of a stream.
+     * @param stream The stream.
+     * @param first The position of the first number in the stream.
+     * @param normals The vector receiving the numbers at positions first, first + 1, ...; its size is kept.
+     */
+    void Normals(std::uint64_t stream, std::uint64_t first, Eigen::Ref<Eigen::VectorXd> normals) const;
+
+private:
+    Key key;  ///< The key built from the seed.
+
+    /**
+     * @brief Get the two standard normal numbers of a block of a stream.
+     * @param stream The stream.
+     * @param block The index of the block.
+     * @param normals The array receiving the numbers at positions 2 block and 2 block + 1.
+     */
+    void NormalPair(std::uint64_t stream, std::uint64_t block, double normals[2]) const;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "PipelinedTrajectory.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+PipelinedTrajectory::PipelinedTrajectory(TrajectorySink& sink, long block_points) : sink(sink), block_points(block_points)
+{
+    if (block_points <= 0)
+        throw std::invalid_argument("The number of time points of a block must be positive");
+}
+
+PipelinedTrajectory::~PipelinedTrajectory()
+{
+    Stop();
+}
+
+void PipelinedTrajectory::Begin(int dimension, long num_points)
+{
+    Stop();
+    sink.Begin(dimension, num_points);
+
+    long block = std::max(1L, std::min(block_points, num_points));
+    filling.resize(dimension, block);
+    pending.resize(dimension, block);
+    filled = 0;
+    has_pending = false;
+    finished = false;
+    stalls = 0;
+    error = nullptr;
+    worker = std::thread(&PipelinedTrajectory::Run, this);
+}
+
+void PipelinedTrajectory::Append(const Eigen::VectorXd& y)
+{
+    if (y.size() != filling.rows())
+        throw std::invalid_argument("Expected a state of dimension " + std::to_string(filling.rows()) + ", got " + std::to_string(y.size()));
+    // Fewer points than announced make the first block smaller; more make it grow to the block size.
+    if (filled == filling.cols())
+    {
+        if (filling.cols() < block_points)
+        {
+            filling.conservativeResize(Eigen::NoChange, block_points);
+            pending.resize(Eigen::NoChange, block_points);
+        }
+        else
+        {
+            Submit();
+        }
+    }
+    filling.col(filled++) = y;
+}
+
+void PipelinedTrajectory::Flush()
+{
+    if (filled > 0)
+        Submit();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return !has_pending || error; });
+        if (error)
+            std::rethrow_exception(error);
+    }
+    // The writer thread waits for the next block, so the wrapped sink is not in use.
+    sink.Flush();
+}
+
+void PipelinedTrajectory::End()
+{
+    if (filled > 0)
+        Submit();
+    Stop();
+    std::exception_ptr failure = error;
+    error = nullptr;
+    if (failure)
+        std::rethrow_exception(failure);
+    sink.End();
+}
+
+long PipelinedTrajectory::GetStalls() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stalls;
+}
+
+void PipelinedTrajectory::Submit()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (has_pending)
+        stalls++;
+    condition.wait(lock, [this] { return !has_pending || error; });
+    if (error)
+        std::rethrow_exception(error);
+    filling.swap(pending);
+    pending_points = filled;
+    has_pending = true;
+    filled = 0;
+    condition.notify_all();
+}
+
+void PipelinedTrajectory::Run()
+{
+    Eigen::VectorXd y(pending.rows());
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return has_pending || finished; });
+        if (!has_pending)
+            return;
+        // The solver does not touch the pending block until it is released, so it is written unlocked.
+        lock.unlock();
+        std::exception_ptr failure;
+        try
+        {
+            for (long i = 0; i < pending_points; i++)
+            {
+                y = pending.col(i);
+                sink.Append(y);
+            }
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+        lock.lock();
+        has_pending = false;
+        error = failure;
+        condition.notify_all();
+        if (failure)
+            return;
+    }
+}
+
+void PipelinedTrajectory::Stop()
+{
+    if (!worker.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    condition.notify_all();
+    worker.join();
+}
@@ -0,0 +1,112 @@
+/**
+ * @file PipelinedTrajectory.h
+ * @brief Defines the PipelinedTrajectory class, a sink that hands the solution to another sink on a writer thread.
+ */
+
+#ifndef PIPELINEDTRAJECTORY_H
+#define PIPELINEDTRAJECTORY_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "TrajectorySink.h"
+
+/**
+ * @brief A sink that writes the solution to another sink on a dedicated writer thread.
+ *
+ * Formatting and writing a solution usually happen on the thread of the solver, so that a run takes the time of
+ * the integration plus the time of the output. This sink gathers the time points into a block while the writer
+ * thread drains the previous block into the wrapped sink, such as a CsvTrajectory or a MappedTrajectory, so that
+ * the run takes the longer of the two times instead. When the writer thread falls behind, the solver waits for it
+ * before handing over the next block, so that at most two blocks are held in memory.
+ *
+ * Begin(), Flush() and End() of the wrapped sink are called on the thread of the solver, and Append() on the writer
+ * thread; the wrapped sink must not be used elsewhere in between.
+ */
+class PipelinedTrajectory : public TrajectorySink
+{
+public:
+    /**
+     * @brief Construct a new PipelinedTrajectory object.
+     * @param sink The sink the solution is written to, which must outlive this one.
+     * @param block_points The number of time points of a block.
+     * @throws std::invalid_argument If the number of time points of a block is not positive.
+     */
+    explicit PipelinedTrajectory(TrajectorySink& sink, long block_points = 1024);
+
+    /**
+     * @brief Stop the writer thread, leaving the wrapped sink unfinished if End() was not called.
+     */
+    ~PipelinedTrajectory();
+
+    PipelinedTrajectory(const PipelinedTrajectory&) = delete;
+    PipelinedTrajectory& operator=(const PipelinedTrajectory&) = delete;
+
+    /**
+     * @brief Start the wrapped sink and the writer thread.
+     * @param dimension The dimension of the problem.
+     * @param num_points The number of time points that will be appended.
+     */
+    void Begin(int dimension, long num_points) override;
+
+    /**
+     * @brief Add the solution at the next time point to the current block.
+     * @param y The solution.
+     * @throws std::invalid_argument If the solution does not have the dimension given to Begin().
+     * @throws std::exception The error of the wrapped sink, if it failed to write a previous block.
+     */
+    void Append(const Eigen::VectorXd& y) override;
+
+    /**
+     * @brief Write the current block, wait for the writer thread and flush the wrapped sink.
+     * @throws std::exception The error of the wrapped sink, if it failed to write a block or to flush.
+     */
+    void Flush() override;
+
+    /**
+     * @brief Write the last block, wait for the writer thread and finish the wrapped sink.
+     * @throws std::exception The error of the wrapped sink, if it failed to write a block or to finish.
+     */
+    void End() override;
+
+    /**
+     * @brief Get the number of times the solver waited for the writer thread.
+     * @return long The number of blocks handed over while the writer thread was still writing the previous one.
+     */
+    long GetStalls() const;
+
+private:
+    TrajectorySink& sink;  ///< The sink the solution is written to.
+    long block_points;  ///< The number of time points of a block.
+    Eigen::MatrixXd filling;  ///< The block receiving the time points.
+    long filled = 0;  ///< The number of time points in the block being filled.
+    Eigen::MatrixXd pending;  ///< The block handed to the writer thread.
+    long pending_points = 0;  ///< The number of time points in the pending block.
+    bool has_pending = false;  ///< Whether the pending block is waiting to be written.
+    bool finished = false;  ///< Whether the writer thread should stop once the pending block is written.
+    long stalls = 0;  ///< The number of times Submit() waited for the writer thread.
+    std::exception_ptr error;  ///< The error of the writer thread, if any.
+    std::thread worker;  ///< The writer thread.
+    mutable std::mutex mutex;  ///< The mutex protecting the pending block and the flags.
+    std::condition_variable condition;  ///< Signaled when a block is handed over or written.
+
+    /**
+     * @brief Hand the block being filled to the writer thread, once it has written the previous one.
+     */
+    void Submit();
+
+    /**
+     * @brief The loop run by the writer thread.
+     */
+    void Run();
+
+    /**
+     * @brief Stop the writer thread and wait for it.
+     */
+    void Stop();
+};
+
+#endif // PIPELINEDTRAJECTORY_H
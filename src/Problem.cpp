@@ -0,0 +1,420 @@
+#include "Problem.h"
+#include <stdexcept>
+#include <string>
+#include "ForwardEuler.h"
+#include "OdeSolver.h"
+#include "RungeKutta.h"
+#include "Function.h"
+#include "AdamBashforth.h"
+#include "AdamMoulton.h"
+#include "BDF.h"
+#include "MultiStep.h"
+#include "AdamBashforthOneStep.h"
+#include "AdamBashforthTwoSteps.h"
+#include "AdamBashforthThreeSteps.h"
+#include "AdamBashforthFourSteps.h"
+#include "BackwardEuler.h"
+#include "Ros2.h"
+#include "Ros3p.h"
+#include "Ros3.h"
+#include "Rodas3.h"
+#include "Rodas4.h"
+#include "Sdirk2.h"
+#include "Sdirk4.h"
+#include "Kvaerno3.h"
+#include "Esdirk4.h"
+#include "RadauIIA.h"
+#include "Gbs.h"
+#include "Seulex.h"
+#include "EulerMaruyama.h"
+#include "Milstein.h"
+
+namespace {
+
+/**
+ * @brief Solves a problem into a sink, with the tolerances, the checkpoint options and the events of the parameters.
+ * 
+ * @param solver The solver of the problem.
+ * @param params The parameters, with the checkpoint file, the checkpoint to resume from and the events, if any.
+ * @param sink The sink receiving the approximation of the solution.
+ * @param occurrences Set to the events that occurred, if not null.
+ * @throws std::runtime_error If the parameters have events and the method does not support them.
+ */
+void Run(OdeSolver& solver, const InputParameters& params, TrajectorySink& sink, std::vector<EventOccurrence>* occurrences) {
+    solver.SetTolerances(params.rel_tol, params.abs_tol);
+    solver.SetCheckpointFile(params.checkpoint_file, params.checkpoint_points, params.checkpoint_seconds);
+    if (params.restart){
+        solver.SetRestart(*params.restart);
+    }
+    for (const SolverEvent& event : params.events){
+        solver.AddEvent(event);
+    }
+    solver.SolveTo(sink);
+    if (occurrences != nullptr){
+        *occurrences = solver.GetEventOccurrences();
+    }
+}
+
+/**
+ * @brief Checks that a multistep method can start from the initial condition of a problem.
+ * 
+ * @param solver The solver of the problem.
+ * @param params The parameters of the problem.
+ * @param history The number of time points the first step depends on, which the initial condition provides.
+ * @throws std::runtime_error If the initial condition or the solution has fewer time points than the history.
+ */
+void CheckHistory(const OdeSolver& solver, const InputParameters& params, int history) {
+    if (params.initial_condition.cols() < history){
+        throw std::runtime_error("The " + GetMethodName(params.method) + " needs " + std::to_string(history) + " steps in the initial condition, which has " + std::to_string(params.initial_condition.cols()) + ".");
+    }
+    if (solver.GetNumTimePoints() < history){
+        throw std::runtime_error("The " + GetMethodName(params.method) + " needs at least " + std::to_string(history) + " time points.");
+    }
+}
+
+}
+
+std::string GetMethodName(int method) {
+    static const char* const names[] = {
+        "Forward Euler method",
+        "Adam-Bashforth one-step",
+        "Adam-Bashforth two-steps",
+        "Adam-Bashforth three-steps",
+        "Adam-Bashforth four-steps",
+        "Backward Euler method",
+        "Runge Kutta Method",
+        "Backward Differentiation Formula",
+        "Adam Moulton Method",
+        "Generic Adam-Bashforth Method",
+        "ROS2 Rosenbrock method",
+        "ROS3P Rosenbrock method",
+        "ROS3 Rosenbrock method",
+        "RODAS3 Rosenbrock method",
+        "RODAS4 Rosenbrock method",
+        "SDIRK2 method",
+        "SDIRK4 method",
+        "Kvaerno 3 method",
+        "ESDIRK4 method",
+        "Radau IIA method",
+        "Gragg-Bulirsch-Stoer extrapolation method",
+        "SEULEX extrapolation method",
+        "Euler-Maruyama method",
+        "Milstein method"
+    };
+    if (method < 1 || method > (int)(sizeof(names) / sizeof(names[0]))){
+        throw std::runtime_error("Invalid method: " + std::to_string(method));
+    }
+    return names[method - 1];
+}
+
+Function BuildFunction(const InputParameters& params) {
+    bool sparse = !params.function_terms.empty();
+    if (params.function_matrix.size() == 0 && !sparse){
+        throw std::runtime_error("Function matrix is not provided.");
+    }
+    if (sparse){
+        if (params.function_matrix.size() != 0 || params.derivative_matrix[0][0] != ""){
+            throw std::runtime_error("Function and derivative terms cannot be combined with function and derivative matrices.");
+        }
+        if (params.derivative_terms.empty()){
+            return Function(params.num_equations, params.function_terms);
+        }
+        return Function(params.num_equations, params.function_terms, params.derivative_terms);
+    }
+    if (params.function_matrix.size() != params.num_equations){
+        throw std::runtime_error("Invalid row dimension in the function matrix.");
+    }
+    if (!params.derivative_terms.empty()){
+        throw std::runtime_error("Function and derivative terms cannot be combined with function and derivative matrices.");
+    }
+    Function function(params.function_matrix);
+    if (params.derivative_matrix[0][0] != ""){
+        function.SetDerivativeCombination(params.derivative_matrix);
+    }
+    return function;
+}
+
+Function BuildDiffusion(const InputParameters& params) {
+    if (params.diffusion_matrix.size() != params.num_equations){
+        throw std::runtime_error("Invalid row dimension in the diffusion matrix.");
+    }
+    if (params.diffusion_derivative_matrix.empty()){
+        return Function(params.diffusion_matrix);
+    }
+    return Function(params.diffusion_matrix, params.diffusion_derivative_matrix);
+}
+
+bool ProvidesDerivative(const InputParameters& params) {
+    if (params.function){
+        return params.function->HasJacobian();
+    }
+    return params.derivative_matrix[0][0] != "" || !params.derivative_terms.empty();
+}
+
+Eigen::MatrixXd SolveProblem(const InputParameters& params, std::string& method_name, std::vector<EventOccurrence>* occurrences) {
+    MatrixSink sink;
+    SolveProblem(params, method_name, sink, occurrences);
+    return sink.Release();
+}
+
+void SolveProblem(const InputParameters& params, std::string& method_name, TrajectorySink& sink, std::vector<EventOccurrence>* occurrences) {
+    if (params.num_equations == -1){
+        throw std::runtime_error("Number of equations is not provided.");
+    }
+
+    if (params.method == -1){
+        throw std::runtime_error("Method is not provided.");
+    }
+
+    if (params.initial_time == -1){
+        throw std::runtime_error("Initial time is not provided.");
+    }
+
+    if (params.final_time == -1){
+        throw std::runtime_error("Final time is not provided.");
+    }
+
+    if (params.step_size == -1){
+        throw std::runtime_error("Step size is not provided.");
+    }
+
+    if (params.rel_tol < 0 || params.abs_tol < 0 || (params.rel_tol == 0 && params.abs_tol == 0)){
+        throw std::runtime_error("Invalid tolerances, they must be non-negative and not both zero.");
+    }
+
+    Function function = params.function ? *params.function : BuildFunction(params);
+    bool provided_derivative = function.HasJacobian();
+
+    double step_size = params.step_size;
+    double initial_time = params.initial_time;
+    double final_time = params.final_time;
+    if (params.num_equations != params.initial_condition.rows()){
+        throw std::runtime_error("Invalid row dimension in the initial condition matrix, it should match the number of equations.");
+    }
+    if (params.num_steps!= params.initial_condition.cols()){
+        throw std::runtime_error("Invalid column dimension in the initial condition matrix, it should match the number of steps.");
+    }
+    Eigen::MatrixXd initial_condition = params.initial_condition;
+
+    method_name = GetMethodName(params.method);
+    switch(params.method){
+        case 1:
+            {
+            ForwardEuler solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+            
+        case 2:
+            {
+            AdamBashforthOneStep solver(step_size, initial_time, final_time, initial_condition, function);
+            CheckHistory(solver, params, 1);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 3:
+            {
+            AdamBashforthTwoSteps solver(step_size, initial_time, final_time, initial_condition, function);
+            CheckHistory(solver, params, 2);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 4:
+            {
+            AdamBashforthThreeSteps solver(step_size, initial_time, final_time, initial_condition, function);
+            CheckHistory(solver, params, 3);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 5:
+            {
+            AdamBashforthFourSteps solver(step_size, initial_time, final_time, initial_condition, function);
+            CheckHistory(solver, params, 4);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 6:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the Backward Euler method");
+            }
+            BackwardEuler solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 7:
+            {
+            Eigen::MatrixXd a = params.a;
+            Eigen::VectorXd b = params.b;
+            Eigen::VectorXd c = params.c;
+            if (a.size() == 0 || b.size() == 0 || c.size() == 0){
+                throw std::runtime_error("Invalid Runge-Kutta method parameters. You should provide the matrix A, vector b, and vector c in the input file.");
+            }
+            if (!a.diagonal().isZero(0.0) && !provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the diagonally implicit Runge-Kutta method");
+            }
+            RungeKutta solver(step_size, initial_time, final_time, initial_condition, function, a, b, c);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 8:
+            {
+            Eigen::VectorXd alpha = params.alpha;
+            if (alpha.size() == 0){
+                throw std::runtime_error("Invalid BDF method parameters. You should provide the vector alpha in the input file.");
+            }
+            BDF solver(step_size, initial_time, final_time, initial_condition, function, alpha);
+            CheckHistory(solver, params, alpha.size() - 1);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 9:
+            {
+            Eigen::VectorXd beta = params.beta;
+            if (beta.size() == 0){
+                throw std::runtime_error("Invalid Adam-Moulton method parameters. You should provide the vector beta in the input file.");
+            }
+            AdamMoulton solver(step_size, initial_time, final_time, initial_condition, function, beta);
+            CheckHistory(solver, params, beta.size() - 1);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 10:
+            {
+            Eigen::VectorXd beta = params.beta;
+            if (beta.size() == 0){
+                throw std::runtime_error("Invalid Adam-Bashforth method parameters. You should provide the vector beta in the input file.");
+            }            
+            AdamBashforth solver(step_size, initial_time, final_time, initial_condition, function, beta);
+            CheckHistory(solver, params, beta.size());
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 11:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the ROS2 method");
+            }
+            Ros2 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 12:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the ROS3P method");
+            }
+            Ros3p solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 13:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the ROS3 method");
+            }
+            Ros3 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 14:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the RODAS3 method");
+            }
+            Rodas3 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 15:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the RODAS4 method");
+            }
+            Rodas4 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 16:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the SDIRK2 method");
+            }
+            Sdirk2 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 17:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the SDIRK4 method");
+            }
+            Sdirk4 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 18:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the Kvaerno 3 method");
+            }
+            Kvaerno3 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 19:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the ESDIRK4 method");
+            }
+            Esdirk4 solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 20:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the Radau IIA method");
+            }
+            RadauIIA solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 21:
+            {
+            Gbs solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 22:
+            {
+            if (!provided_derivative){
+                throw std::runtime_error("Derivative matrix is not provided for the SEULEX method");
+            }
+            Seulex solver(step_size, initial_time, final_time, initial_condition, function);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 23:
+            {
+            Function diffusion = params.diffusion ? *params.diffusion : BuildDiffusion(params);
+            EulerMaruyama solver(step_size, initial_time, final_time, initial_condition, function, diffusion);
+            solver.SetSeed(params.seed);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        case 24:
+            {
+            Function diffusion = params.diffusion ? *params.diffusion : BuildDiffusion(params);
+            if (!diffusion.HasJacobian()){
+                throw std::runtime_error("Diffusion derivative matrix is not provided for the Milstein method");
+            }
+            Milstein solver(step_size, initial_time, final_time, initial_condition, function, diffusion);
+            solver.SetSeed(params.seed);
+            Run(solver, params, sink, occurrences);
+            return;
+            }
+        default:
+            throw std::runtime_error("Invalid method: " + std::to_string(params.method));
+    }
+}
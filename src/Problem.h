@@ -0,0 +1,87 @@
+/**
+ * @file Problem.h
+ * @brief Declares the function solving the problem described by an input file.
+ */
+#ifndef PROBLEM_H
+#define PROBLEM_H
+
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+#include "Function.h"
+#include "TrajectorySink.h"
+#include "utils.h"
+
+/**
+ * @brief Gets the name of a method.
+ * 
+ * @param method The method number, as in the "Method" entry of an input file.
+ * @return std::string The name of the method.
+ * @throws std::runtime_error If the method is invalid.
+ */
+std::string GetMethodName(int method);
+
+/**
+ * @brief Compiles the function and derivative matrices, or their terms, of parsed input parameters.
+ * 
+ * @param params The parameters parsed by ParseInputFile().
+ * @return Function The right-hand side of the system, with its Jacobian if a derivative matrix is provided.
+ * @throws std::runtime_error If the function matrix is not provided or has the wrong dimension.
+ * @throws std::runtime_error If terms are combined with matrices.
+ * @throws std::invalid_argument If an entry is invalid.
+ */
+Function BuildFunction(const InputParameters& params);
+
+/**
+ * @brief Compiles the diffusion matrices of parsed input parameters.
+ * 
+ * @param params The parameters parsed by ParseInputFile().
+ * @return Function The diffusion of the system, with its Jacobian if a diffusion derivative matrix is provided.
+ * @throws std::runtime_error If the diffusion matrix is not provided or has the wrong dimension.
+ * @throws std::invalid_argument If an entry is invalid.
+ */
+Function BuildDiffusion(const InputParameters& params);
+
+/**
+ * @brief Checks whether parsed input parameters provide the Jacobian that implicit methods need.
+ * 
+ * @param params The parameters parsed by ParseInputFile().
+ * @return true if a derivative matrix or derivative terms are provided, or a compiled function with a Jacobian.
+ */
+bool ProvidesDerivative(const InputParameters& params);
+
+/**
+ * @brief Solves the problem described by parsed input parameters with the method they select.
+ * 
+ * The function does not write to the console, so that several problems can be solved at the same time.
+ * The functions compiled by a ProblemCache are used as they are, instead of being built from the matrices.
+ * When the parameters hold a checkpoint to resume from, only the time points after it are returned. When they
+ * hold events, a stopping event ends the solution before the final time.
+ * 
+ * @param params The parameters parsed by ParseInputFile().
+ * @param method_name Set to the name of the selected method.
+ * @param occurrences Set to the events that occurred during the solve, if not null.
+ * @return Eigen::MatrixXd The approximation of the solution at each time step.
+ * @throws std::runtime_error If a mandatory parameter is not provided or has the wrong dimension.
+ * @throws std::runtime_error If the selected method needs parameters that are not provided.
+ * @throws std::runtime_error If the method is invalid, or does not support the events of the parameters.
+ */
+Eigen::MatrixXd SolveProblem(const InputParameters& params, std::string& method_name, std::vector<EventOccurrence>* occurrences = nullptr);
+
+/**
+ * @brief Solves the problem described by parsed input parameters into a sink.
+ * 
+ * The one-step methods hand every time point to the sink as soon as it is computed, so that the solution does
+ * not have to fit in memory with a sink that writes it out (see MappedTrajectory).
+ * 
+ * @param params The parameters parsed by ParseInputFile().
+ * @param method_name Set to the name of the selected method.
+ * @param sink The sink receiving the approximation of the solution at each time step.
+ * @param occurrences Set to the events that occurred during the solve, if not null.
+ * @throws std::runtime_error If a mandatory parameter is not provided or has the wrong dimension.
+ * @throws std::runtime_error If the selected method needs parameters that are not provided.
+ * @throws std::runtime_error If the method is invalid, or does not support the events of the parameters.
+ */
+void SolveProblem(const InputParameters& params, std::string& method_name, TrajectorySink& sink, std::vector<EventOccurrence>* occurrences = nullptr);
+
+#endif // PROBLEM_H
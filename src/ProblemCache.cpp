@@ -0,0 +1,143 @@
+#include "ProblemCache.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Problem.h"
+
+namespace
+{
+const char kMagic[8] = {'O', 'D', 'E', 'C', 'A', 'C', 'H', 'E'};
+const std::uint32_t kVersion = 1;
+// Written in the byte order of the host, so that files from another byte order are rejected.
+const std::uint32_t kByteOrderMark = 0x01020304;
+
+// Numbers the temporary files, so that the threads of a process storing the same system do not share one.
+std::atomic<unsigned> temporary_count(0);
+
+// The fixed header of a cache file, followed by the compiled function and, if flagged, the compiled diffusion.
+struct CacheHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t key;
+    std::uint32_t has_diffusion;
+    std::uint32_t reserved;
+};
+}
+
+ProblemCache::ProblemCache(const std::string& directory) : directory(directory)
+{
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+        throw std::runtime_error("Could not create cache directory: " + directory);
+}
+
+const std::string& ProblemCache::GetDirectory() const
+{
+    return directory;
+}
+
+std::string ProblemCache::GetCacheFile(unsigned long long key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.odecache", key);
+    return directory + "/" + name;
+}
+
+bool ProblemCache::Load(unsigned long long key, InputParameters& params) const
+{
+    std::ifstream in(GetCacheFile(key), std::ios::binary);
+    if (!in.is_open())
+        return false;
+    CacheHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0
+        || header.version != kVersion || header.byte_order != kByteOrderMark || header.key != key)
+        return false;
+    try
+    {
+        auto function = std::make_shared<const Function>(Function::Load(in));
+        std::shared_ptr<const Function> diffusion;
+        if (header.has_diffusion)
+            diffusion = std::make_shared<const Function>(Function::Load(in));
+        params.function = function;
+        params.diffusion = diffusion;
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool ProblemCache::Store(unsigned long long key, InputParameters& params) const
+{
+    std::shared_ptr<const Function> function, diffusion;
+    try
+    {
+        function = std::make_shared<const Function>(BuildFunction(params));
+        if (!params.diffusion_matrix.empty())
+            diffusion = std::make_shared<const Function>(BuildDiffusion(params));
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    params.function = function;
+    params.diffusion = diffusion;
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    header.key = key;
+    header.has_diffusion = diffusion != nullptr;
+
+    std::string filename = GetCacheFile(key);
+    std::string temporary = filename + "." + std::to_string(getpid()) + "." + std::to_string(temporary_count++) + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        function->Save(out);
+        if (diffusion)
+            diffusion->Save(out);
+        if (!out.flush())
+        {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+int ProblemCache::Clear() const
+{
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr)
+        return 0;
+    const std::string extension = ".odecache";
+    int count = 0;
+    while (dirent* entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name.size() > extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0
+            && std::remove((directory + "/" + name).c_str()) == 0)
+            count++;
+    }
+    closedir(dir);
+    return count;
+}
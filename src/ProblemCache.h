@@ -0,0 +1,77 @@
+/**
+ * @file ProblemCache.h
+ * @brief Defines the ProblemCache class, an on-disk cache of the compiled systems of input files.
+ */
+
+#ifndef PROBLEMCACHE_H
+#define PROBLEMCACHE_H
+
+#pragma once
+#include <string>
+#include "SystemCache.h"
+#include "utils.h"
+
+/**
+ * @brief A directory of compiled systems, so that repeated runs of the same input file skip parsing it.
+ *
+ * Every file of the cache holds the compiled terms and coefficients of the function and diffusion of one system,
+ * keyed by a hash of the sections of the input file that define the system (see ParseInputFile()). Reading them
+ * back costs a few reads instead of the tokenization and the compilation of the entries.
+ *
+ * The files are written in the byte order of the host and are only meant to be read on the same machine. They
+ * are written under a temporary name and renamed, so that several processes can share the cache. An unreadable
+ * or invalid file counts as a miss and is replaced.
+ */
+class ProblemCache : public SystemCache
+{
+public:
+    /**
+     * @brief Open a cache, creating its directory if it does not exist.
+     * @param directory The directory of the cache files.
+     * @throws std::runtime_error If the directory cannot be created.
+     */
+    explicit ProblemCache(const std::string& directory);
+
+    /**
+     * @brief Get the directory of the cache files.
+     * @return const std::string& The directory.
+     */
+    const std::string& GetDirectory() const;
+
+    /**
+     * @brief Get the file holding the system of a key.
+     * @param key The hash of the sections that define the system.
+     * @return std::string The path of the file, which may not exist.
+     */
+    std::string GetCacheFile(unsigned long long key) const;
+
+    /**
+     * @brief Attach the compiled system of a key to parameters.
+     * @param key The hash of the sections that define the system.
+     * @param params The parameters, whose function and diffusion are set on a hit.
+     * @return true if the cache holds a valid system for the key, false otherwise.
+     */
+    bool Load(unsigned long long key, InputParameters& params) const override;
+
+    /**
+     * @brief Compile the system of parsed parameters, attach it to them and add it to the cache.
+     *
+     * Nothing is stored if the system cannot be compiled: the error is then reported when the problem is solved.
+     *
+     * @param key The hash of the sections that define the system.
+     * @param params The parameters, whose function and diffusion are set if the system compiles.
+     * @return true if the system was written to the cache, false otherwise.
+     */
+    bool Store(unsigned long long key, InputParameters& params) const override;
+
+    /**
+     * @brief Remove every cache file of the directory.
+     * @return int The number of files removed.
+     */
+    int Clear() const;
+
+private:
+    std::string directory;  //< The directory of the cache files.
+};
+
+#endif // PROBLEMCACHE_H
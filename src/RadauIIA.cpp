@@ -0,0 +1,213 @@
+#include "RadauIIA.h"
+#include "utils.h"
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+RadauIIA::RadauIIA()
+{
+
+}
+
+RadauIIA::RadauIIA(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : AdaptiveSolver(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetCoefficients();
+}
+
+RadauIIA::~RadauIIA()
+{
+
+}
+
+void RadauIIA::SetMaxNewtonIterations(int max_newton_iterations)
+{
+    if (max_newton_iterations <= 0)
+        throw std::invalid_argument("Maximum number of Newton iterations must be positive");
+    this->max_newton_iterations = max_newton_iterations;
+}
+
+int RadauIIA::GetJacobianEvaluations() const
+{
+    return jacobian_evaluations;
+}
+
+int RadauIIA::ErrorOrder() const
+{
+    return 3;
+}
+
+void RadauIIA::StartIntegration()
+{
+    jacobian.resize(0, 0);
+    reuse_jacobian = false;
+    jacobian_evaluations = 0;
+}
+
+void RadauIIA::SaveControllerState(SolverCheckpoint& checkpoint) const
+{
+    checkpoint.controller = {reuse_jacobian ? 1.0 : 0.0, (double)jacobian_evaluations};
+    if (jacobian.size() == 0)
+        return;
+    checkpoint.jacobian_time = jacobian_time;
+    checkpoint.jacobian_state = jacobian_state;
+    checkpoint.jacobian = jacobian;
+}
+
+void RadauIIA::RestoreControllerState(const SolverCheckpoint& checkpoint)
+{
+    if (checkpoint.controller.size() != 2)
+        throw std::runtime_error("The checkpoint does not hold the state of this method");
+    reuse_jacobian = checkpoint.controller[0] != 0.0;
+    jacobian_evaluations = (int)checkpoint.controller[1];
+    jacobian_time = checkpoint.jacobian_time;
+    jacobian_state = checkpoint.jacobian_state;
+    jacobian = checkpoint.jacobian;
+}
+
+void RadauIIA::SetCoefficients()
+{
+    const double s6 = std::sqrt(6.0);
+    c << (4.0 - s6) / 10.0, (4.0 + s6) / 10.0, 1.0;
+    Eigen::Matrix3d a;
+    a << (88.0 - 7.0 * s6) / 360.0, (296.0 - 169.0 * s6) / 1800.0, (-2.0 + 3.0 * s6) / 225.0,
+         (296.0 + 169.0 * s6) / 1800.0, (88.0 + 7.0 * s6) / 360.0, (-2.0 - 3.0 * s6) / 225.0,
+         (16.0 - s6) / 36.0, (16.0 + s6) / 36.0, 1.0 / 9.0;
+    Eigen::Matrix3d a_inverse = a.inverse();
+
+    // Columns of T: the real eigenvector, then the real and imaginary parts of one complex eigenvector.
+    Eigen::EigenSolver<Eigen::Matrix3d> eigen_solver(a_inverse);
+    int real_index = 0;
+    int complex_index = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        if (std::abs(eigen_solver.eigenvalues()(i).imag()) < 1e-12)
+            real_index = i;
+        else if (eigen_solver.eigenvalues()(i).imag() > 0)
+            complex_index = i;
+    }
+    transform.col(0) = eigen_solver.eigenvectors().col(real_index).real();
+    transform.col(1) = eigen_solver.eigenvectors().col(complex_index).real();
+    transform.col(2) = eigen_solver.eigenvectors().col(complex_index).imag();
+    transform_inverse = transform.inverse();
+
+    // T^{-1} A^{-1} T = [gamma 0 0; 0 alpha beta; 0 -beta alpha]
+    Eigen::Matrix3d block = transform_inverse * a_inverse * transform;
+    gamma_hat = block(0, 0);
+    alpha_hat = block(1, 1);
+    beta_hat = block(1, 2);
+
+    error_coefficients << -(13.0 + 7.0 * s6) / 3.0, (-13.0 + 7.0 * s6) / 3.0, -1.0 / 3.0;
+}
+
+NewtonStatus RadauIIA::SolveStages(double t, double h, const Eigen::VectorXd& y, const Eigen::PartialPivLU<Eigen::MatrixXd>& real_lu, const Eigen::PartialPivLU<Eigen::MatrixXcd>& complex_lu, Eigen::MatrixXd& z, double& contraction_rate)
+{
+    int n = y.size();
+    const double kappa = std::max(10 * std::numeric_limits<double>::epsilon() / rel_tol, std::min(0.03, std::sqrt(rel_tol)));
+    Eigen::VectorXd weights = ErrorWeights(y).replicate(3, 1);
+    Eigen::MatrixXd w = Eigen::MatrixXd::Zero(n, 3);
+    Eigen::MatrixXd rhs(n, 3);
+    z = Eigen::MatrixXd::Zero(n, 3);
+    contraction_rate = 0.0;
+    double norm_old = 0.0;
+
+    for (int k = 1; k <= max_newton_iterations; k++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            rhs.col(i) = function.BuildRightHandSide(t + c(i) * h, y + z.col(i));
+        }
+        if (!rhs.allFinite())
+            return DIVERGED;
+
+        // Residual of the transformed system (Lambda / h - J) dW = -Lambda / h W + T^{-1} F.
+        Eigen::MatrixXd residual = rhs * transform_inverse.transpose();
+        residual.col(0) -= (gamma_hat / h) * w.col(0);
+        residual.col(1) -= (alpha_hat * w.col(1) + beta_hat * w.col(2)) / h;
+        residual.col(2) -= (-beta_hat * w.col(1) + alpha_hat * w.col(2)) / h;
+
+        Eigen::MatrixXd delta(n, 3);
+        delta.col(0) = real_lu.solve(residual.col(0));
+        Eigen::VectorXcd complex_residual = residual.col(1).cast<std::complex<double>>() + std::complex<double>(0.0, 1.0) * residual.col(2).cast<std::complex<double>>();
+        Eigen::VectorXcd complex_delta = complex_lu.solve(complex_residual);
+        delta.col(1) = complex_delta.real();
+        delta.col(2) = complex_delta.imag();
+
+        w += delta;
+        z = w * transform.transpose();
+
+        Eigen::Map<Eigen::VectorXd> flat_delta(delta.data(), 3 * n);
+        double norm = WeightedRmsNorm(flat_delta, weights);
+        if (!std::isfinite(norm))
+            return DIVERGED;
+        if (k == 1)
+        {
+            if (norm <= kappa)
+                return CONVERGED;
+        }
+        else
+        {
+            contraction_rate = norm / norm_old;
+            if (contraction_rate >= 1.0)
+                return DIVERGED;
+            double error_estimate = contraction_rate / (1.0 - contraction_rate) * norm;
+            if (error_estimate <= kappa)
+                return CONVERGED;
+            if (std::pow(contraction_rate, max_newton_iterations - k) * error_estimate > kappa)
+                return SLOW_CONVERGENCE;
+        }
+        norm_old = norm;
+    }
+    return MAX_ITERATIONS;
+}
+
+bool RadauIIA::AttemptStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new, double& error)
+{
+    int n = y.size();
+    Eigen::MatrixXd identity = Eigen::MatrixXd::Identity(n, n);
+    Eigen::MatrixXd z;
+    double contraction_rate = 0.0;
+    Eigen::PartialPivLU<Eigen::MatrixXd> real_lu;
+
+    while (true)
+    {
+        bool current = (jacobian.rows() == n && jacobian_time == t && jacobian_state == y);
+        if (!current && !(reuse_jacobian && jacobian.rows() == n))
+        {
+            jacobian = function.BuildJacobian(t, y);
+            jacobian_time = t;
+            jacobian_state = y;
+            jacobian_evaluations++;
+            current = true;
+        }
+
+        real_lu.compute((gamma_hat / h) * identity - jacobian);
+        Eigen::PartialPivLU<Eigen::MatrixXcd> complex_lu(std::complex<double>(alpha_hat, -beta_hat) / h * identity.cast<std::complex<double>>() - jacobian.cast<std::complex<double>>());
+
+        if (SolveStages(t, h, y, real_lu, complex_lu, z, contraction_rate) == CONVERGED)
+            break;
+        reuse_jacobian = false;
+        // A failure with an old Jacobian is retried once with a fresh one, otherwise the step size must shrink.
+        if (current)
+            return false;
+    }
+    // Keep the Jacobian for the next step only if the iteration contracted fast.
+    reuse_jacobian = (contraction_rate < 1e-3);
+
+    // The last node is c = 1, so the solution is the last stage.
+    y_new = y + z.col(2);
+
+    Eigen::VectorXd rhs_start = function.BuildRightHandSide(t, y);
+    Eigen::VectorXd correction = z * error_coefficients / h;
+    Eigen::VectorXd error_vector = real_lu.solve(rhs_start + correction);
+    Eigen::VectorXd scale = y.cwiseAbs().cwiseMax(y_new.cwiseAbs());
+    error = WeightedRmsNorm(error_vector, ErrorWeights(scale));
+    if (error >= 1.0)
+    {
+        // A second filtering through the stiff part avoids rejecting steps because of stiff components.
+        error_vector = real_lu.solve(function.BuildRightHandSide(t, y + error_vector) + correction);
+        error = WeightedRmsNorm(error_vector, ErrorWeights(scale));
+    }
+    return y_new.allFinite();
+}
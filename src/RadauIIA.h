@@ -0,0 +1,147 @@
+/**
+ * @file RadauIIA.h
+ * @brief Defines the RadauIIA class for solving stiff ordinary differential equations (ODEs) using the three-stage Radau IIA method.
+ */
+
+#ifndef RADAUIIA_H
+#define RADAUIIA_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <complex>
+#include "AdaptiveSolver.h"
+#include "NewtonMethod.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the three-stage Radau IIA method.
+ *
+ * The Radau IIA method with three stages is a fully implicit, L-stable Runge-Kutta method of order five:
+ *
+ * \f[
+ * \begin{array}{c|ccc}
+ * \frac{4 - \sqrt{6}}{10} & \frac{88 - 7\sqrt{6}}{360} & \frac{296 - 169\sqrt{6}}{1800} & \frac{-2 + 3\sqrt{6}}{225} \\
+ * \frac{4 + \sqrt{6}}{10} & \frac{296 + 169\sqrt{6}}{1800} & \frac{88 + 7\sqrt{6}}{360} & \frac{-2 - 3\sqrt{6}}{225} \\
+ * 1 & \frac{16 - \sqrt{6}}{36} & \frac{16 + \sqrt{6}}{36} & \frac{1}{9} \\
+ * \hline
+ *      & \frac{16 - \sqrt{6}}{36} & \frac{16 + \sqrt{6}}{36} & \frac{1}{9}
+ * \end{array}
+ * \f]
+ *
+ * The stage increments \f$ Z_i = Y_i - y_n \f$ solve \f$ Z = h (A \otimes I) F(Z) \f$, a system of size \f$ 3N \f$.
+ * It is solved with a simplified Newton iteration in the coordinates \f$ W = (T^{-1} \otimes I) Z \f$, where
+ * \f$ T^{-1} A^{-1} T \f$ has one real eigenvalue \f$ \hat\gamma \f$ and one complex pair \f$ \hat\alpha \pm i \hat\beta \f$.
+ * The linear system then splits into one real \f$ N \times N \f$ system with \f$ \hat\gamma / h \, I - J \f$ and one complex
+ * \f$ N \times N \f$ system with \f$ (\hat\alpha - i \hat\beta) / h \, I - J \f$, which are factorized once per step.
+ * The Jacobian is kept from one step to the next while the Newton iteration contracts fast.
+ *
+ * The local error is estimated as in RADAU5 of Hairer and Wanner, with an embedded formula of order three filtered by
+ * \f$ (\hat\gamma / h \, I - J)^{-1} \f$ so that it stays bounded for stiff components.
+ *
+ * The Jacobian of the system must be provided in the Function object.
+ */
+class RadauIIA : public AdaptiveSolver
+{
+public:
+    /**
+     * @brief Construct a new RadauIIA object.
+     */
+    RadauIIA();
+
+    /**
+     * @brief Construct a new RadauIIA object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    RadauIIA(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the RadauIIA object.
+     */
+    ~RadauIIA();
+
+    /**
+     * @brief Set the maximum number of simplified Newton iterations per step.
+     * @param max_newton_iterations The maximum number of iterations.
+     * @throws std::invalid_argument If the number of iterations is not positive.
+     */
+    void SetMaxNewtonIterations(int max_newton_iterations);
+
+    /**
+     * @brief Get the number of Jacobian evaluations of the last solve.
+     * @return int The number of Jacobian evaluations.
+     */
+    int GetJacobianEvaluations() const;
+
+protected:
+    /**
+     * @brief Attempt a single Radau IIA step.
+     *
+     * If the Newton iteration fails with a Jacobian kept from a previous step, the Jacobian is refreshed
+     * and the step is retried once with the same step size.
+     */
+    bool AttemptStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new, double& error) override;
+
+    /**
+     * @brief Get the order of the embedded solution.
+     * @return int Three.
+     */
+    int ErrorOrder() const override;
+
+    /**
+     * @brief Discard the cached Jacobian and reset the statistics.
+     */
+    void StartIntegration() override;
+
+    /**
+     * @brief Save the cached Jacobian, whether it is reused by the next step and the statistics.
+     * @param checkpoint The checkpoint.
+     */
+    void SaveControllerState(SolverCheckpoint& checkpoint) const override;
+
+    /**
+     * @brief Restore the cached Jacobian, whether it is reused by the next step and the statistics.
+     * @param checkpoint The checkpoint.
+     * @throws std::runtime_error If the checkpoint does not hold the state of the method.
+     */
+    void RestoreControllerState(const SolverCheckpoint& checkpoint) override;
+
+private:
+    Eigen::Vector3d c;  ///< The nodes of the method.
+    Eigen::Matrix3d transform;  ///< The matrix \f$ T \f$.
+    Eigen::Matrix3d transform_inverse;  ///< The matrix \f$ T^{-1} \f$.
+    double gamma_hat;  ///< The real eigenvalue of \f$ A^{-1} \f$.
+    double alpha_hat;  ///< The real part of the complex eigenvalues of \f$ A^{-1} \f$.
+    double beta_hat;  ///< The imaginary part of the complex eigenvalues of \f$ A^{-1} \f$.
+    Eigen::Vector3d error_coefficients;  ///< The coefficients of the embedded error estimate.
+    int max_newton_iterations = 7;  ///< The maximum number of simplified Newton iterations per step.
+
+    double jacobian_time;  ///< The time at which the cached Jacobian was evaluated.
+    Eigen::VectorXd jacobian_state;  ///< The state at which the cached Jacobian was evaluated.
+    Eigen::MatrixXd jacobian;  ///< The cached Jacobian.
+    bool reuse_jacobian = false;  ///< Whether the last Newton iteration contracted fast enough to keep the Jacobian.
+    int jacobian_evaluations = 0;  ///< The number of Jacobian evaluations of the last solve.
+
+    /**
+     * @brief Compute the transformation of the coefficient matrix.
+     */
+    void SetCoefficients();
+
+    /**
+     * @brief Run the simplified Newton iteration for the stage increments.
+     *
+     * @param t The time at the beginning of the step.
+     * @param h The step size.
+     * @param y The solution at the beginning of the step.
+     * @param real_lu The factorization of \f$ \hat\gamma / h \, I - J \f$.
+     * @param complex_lu The factorization of \f$ (\hat\alpha - i \hat\beta) / h \, I - J \f$.
+     * @param z The stage increments, one per column.
+     * @param contraction_rate The last observed contraction rate.
+     * @return NewtonStatus The outcome of the iteration.
+     */
+    NewtonStatus SolveStages(double t, double h, const Eigen::VectorXd& y, const Eigen::PartialPivLU<Eigen::MatrixXd>& real_lu, const Eigen::PartialPivLU<Eigen::MatrixXcd>& complex_lu, Eigen::MatrixXd& z, double& contraction_rate);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "Rodas3.h"
+
+Rodas3::Rodas3()
+{
+
+}
+
+Rodas3::Rodas3(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : Rosenbrock(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetCoefficients();
+}
+
+Rodas3::~Rodas3()
+{
+
+}
+
+void Rodas3::SetCoefficients()
+{
+    gamma = 0.5;
+    a = Eigen::MatrixXd::Zero(4, 4);
+    a(2, 0) = 2.0;
+    a(3, 0) = 2.0;
+    a(3, 2) = 1.0;
+    c = Eigen::MatrixXd::Zero(4, 4);
+    c(1, 0) = 4.0;
+    c(2, 0) = 1.0;
+    c(2, 1) = -1.0;
+    c(3, 0) = 1.0;
+    c(3, 1) = -1.0;
+    c(3, 2) = -8.0 / 3.0;
+    m = Eigen::VectorXd(4);
+    m << 2.0, 0.0, 1.0, 1.0;
+    e = Eigen::VectorXd(4);
+    e << 0.0, 0.0, 0.0, 1.0;
+    alpha = Eigen::VectorXd(4);
+    alpha << 0.0, 0.0, 1.0, 1.0;
+    gamma_sum = Eigen::VectorXd(4);
+    gamma_sum << 0.5, 1.5, 0.0, 0.0;
+    order = 3;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+/**
+ * @file Rodas3.h
+ * @brief Defines the Rodas3 class for solving stiff ordinary differential equations (ODEs) using the RODAS3 Rosenbrock method.
+ */
+
+#ifndef RODAS3_H
+#define RODAS3_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Rosenbrock.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the RODAS3 Rosenbrock method.
+ * 
+ * The four-stage, third-order stiffly accurate method of Sandu et al. with \f$ \gamma = 1/2 \f$ and an embedded second-order solution.
+ */
+class Rodas3 : public Rosenbrock
+{
+public:
+    /**
+     * @brief Construct a new Rodas3 object.
+     */
+    Rodas3();
+
+    /**
+     * @brief Construct a new Rodas3 object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Rodas3(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Rodas3 object.
+     */
+    ~Rodas3();
+
+private:
+    /**
+     * @brief Set the coefficients of the RODAS3 method.
+     * 
+     * This method sets the coefficients of the RODAS3 method. It is not intended for external use as the behavior is fixed for this solver.
+     */
+    void SetCoefficients();
+};
+
+#endif
\ No newline at end of file
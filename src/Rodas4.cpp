@@ -0,0 +1,59 @@
+#include "Rodas4.h"
+
+Rodas4::Rodas4()
+{
+
+}
+
+Rodas4::Rodas4(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : Rosenbrock(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetCoefficients();
+}
+
+Rodas4::~Rodas4()
+{
+
+}
+
+void Rodas4::SetCoefficients()
+{
+    gamma = 0.25;
+    a = Eigen::MatrixXd::Zero(6, 6);
+    a(1, 0) = 1.544;
+    a(2, 0) = 0.9466785280815826;
+    a(2, 1) = 0.2557011698983284;
+    a(3, 0) = 3.314825187068521;
+    a(3, 1) = 2.896124015972201;
+    a(3, 2) = 0.9986419139977817;
+    a(4, 0) = 1.221224509226641;
+    a(4, 1) = 6.019134481288629;
+    a(4, 2) = 12.53708332932087;
+    a(4, 3) = -0.6878860361058950;
+    a.row(5) = a.row(4);
+    a(5, 4) = 1.0;
+    c = Eigen::MatrixXd::Zero(6, 6);
+    c(1, 0) = -5.6688;
+    c(2, 0) = -2.430093356833875;
+    c(2, 1) = -0.2063599157091915;
+    c(3, 0) = -0.1073529058151375;
+    c(3, 1) = -9.594562251023355;
+    c(3, 2) = -20.47028614809616;
+    c(4, 0) = 7.496443313967647;
+    c(4, 1) = -10.24680431464352;
+    c(4, 2) = -33.99990352819905;
+    c(4, 3) = 11.70890893206160;
+    c(5, 0) = 8.083246795921522;
+    c(5, 1) = -7.981132988064893;
+    c(5, 2) = -31.52159432874371;
+    c(5, 3) = 16.31930543123136;
+    c(5, 4) = -6.058818238834054;
+    m = Eigen::VectorXd(6);
+    m << a(4, 0), a(4, 1), a(4, 2), a(4, 3), 1.0, 1.0;
+    e = Eigen::VectorXd::Zero(6);
+    e(5) = 1.0;
+    alpha = Eigen::VectorXd(6);
+    alpha << 0.0, 0.386, 0.21, 0.63, 1.0, 1.0;
+    gamma_sum = Eigen::VectorXd(6);
+    gamma_sum << 0.25, -0.1043, 0.1035, -0.0362, 0.0, 0.0;
+    order = 4;
+}
\ No newline at end of file
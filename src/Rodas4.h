@@ -0,0 +1,50 @@
+/**
+ * @file Rodas4.h
+ * @brief Defines the Rodas4 class for solving stiff ordinary differential equations (ODEs) using the RODAS4 Rosenbrock method.
+ */
+
+#ifndef RODAS4_H
+#define RODAS4_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Rosenbrock.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the RODAS4 Rosenbrock method.
+ * 
+ * The six-stage, fourth-order stiffly accurate method of Hairer and Wanner with \f$ \gamma = 1/4 \f$ and an embedded third-order solution.
+ */
+class Rodas4 : public Rosenbrock
+{
+public:
+    /**
+     * @brief Construct a new Rodas4 object.
+     */
+    Rodas4();
+
+    /**
+     * @brief Construct a new Rodas4 object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Rodas4(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Rodas4 object.
+     */
+    ~Rodas4();
+
+private:
+    /**
+     * @brief Set the coefficients of the RODAS4 method.
+     * 
+     * This method sets the coefficients of the RODAS4 method. It is not intended for external use as the behavior is fixed for this solver.
+     */
+    void SetCoefficients();
+};
+
+#endif
\ No newline at end of file
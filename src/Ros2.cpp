@@ -0,0 +1,36 @@
+#include "Ros2.h"
+#include <cmath>
+
+Ros2::Ros2()
+{
+
+}
+
+Ros2::Ros2(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : Rosenbrock(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetCoefficients();
+}
+
+Ros2::~Ros2()
+{
+
+}
+
+void Ros2::SetCoefficients()
+{
+    const double g = 1.0 + 1.0 / std::sqrt(2.0);
+    gamma = g;
+    a = Eigen::MatrixXd::Zero(2, 2);
+    a(1, 0) = 1.0 / g;
+    c = Eigen::MatrixXd::Zero(2, 2);
+    c(1, 0) = -2.0 / g;
+    m = Eigen::VectorXd(2);
+    m << 3.0 / (2.0 * g), 1.0 / (2.0 * g);
+    e = Eigen::VectorXd(2);
+    e << 1.0 / (2.0 * g), 1.0 / (2.0 * g);
+    alpha = Eigen::VectorXd(2);
+    alpha << 0.0, 1.0;
+    gamma_sum = Eigen::VectorXd(2);
+    gamma_sum << g, -g;
+    order = 2;
+}
\ No newline at end of file
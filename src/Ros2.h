@@ -0,0 +1,50 @@
+/**
+ * @file Ros2.h
+ * @brief Defines the Ros2 class for solving stiff ordinary differential equations (ODEs) using the ROS2 Rosenbrock method.
+ */
+
+#ifndef ROS2_H
+#define ROS2_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Rosenbrock.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the ROS2 Rosenbrock method.
+ * 
+ * The two-stage, second-order L-stable method of Verwer et al. with \f$ \gamma = 1 + 1/\sqrt{2} \f$ and an embedded first-order solution.
+ */
+class Ros2 : public Rosenbrock
+{
+public:
+    /**
+     * @brief Construct a new Ros2 object.
+     */
+    Ros2();
+
+    /**
+     * @brief Construct a new Ros2 object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Ros2(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Ros2 object.
+     */
+    ~Ros2();
+
+private:
+    /**
+     * @brief Set the coefficients of the ROS2 method.
+     * 
+     * This method sets the coefficients of the ROS2 method. It is not intended for external use as the behavior is fixed for this solver.
+     */
+    void SetCoefficients();
+};
+
+#endif
\ No newline at end of file
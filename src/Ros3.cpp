@@ -0,0 +1,37 @@
+#include "Ros3.h"
+
+Ros3::Ros3()
+{
+
+}
+
+Ros3::Ros3(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : Rosenbrock(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetCoefficients();
+}
+
+Ros3::~Ros3()
+{
+
+}
+
+void Ros3::SetCoefficients()
+{
+    gamma = 0.43586652150845899941601945119356;
+    a = Eigen::MatrixXd::Zero(3, 3);
+    a(1, 0) = 1.0;
+    a(2, 0) = 1.0;
+    c = Eigen::MatrixXd::Zero(3, 3);
+    c(1, 0) = -1.0156171083877702091975600115545;
+    c(2, 0) = 4.0759956452537699824805835358067;
+    c(2, 1) = 9.2076794298330791242156818474003;
+    m = Eigen::VectorXd(3);
+    m << 1.0, 6.1697947043828245592553615689730, -0.42772256543218573326238373806514;
+    e = Eigen::VectorXd(3);
+    e << 0.5, -2.9079558716805469821718236208017, 0.22354069897811569627360909276199;
+    alpha = Eigen::VectorXd(3);
+    alpha << 0.0, 0.43586652150845899941601945119356, 0.43586652150845899941601945119356;
+    gamma_sum = Eigen::VectorXd(3);
+    gamma_sum << 0.43586652150845899941601945119356, 0.24291996454816804366592249683314, 2.1851380027664058511513169485832;
+    order = 3;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+/**
+ * @file Ros3.h
+ * @brief Defines the Ros3 class for solving stiff ordinary differential equations (ODEs) using the ROS3 Rosenbrock method.
+ */
+
+#ifndef ROS3_H
+#define ROS3_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Rosenbrock.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the ROS3 Rosenbrock method.
+ * 
+ * The three-stage, third-order L-stable method of Sandu et al. with \f$ \gamma = 0.43586652150845899942 \f$ and an embedded second-order solution.
+ */
+class Ros3 : public Rosenbrock
+{
+public:
+    /**
+     * @brief Construct a new Ros3 object.
+     */
+    Ros3();
+
+    /**
+     * @brief Construct a new Ros3 object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Ros3(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Ros3 object.
+     */
+    ~Ros3();
+
+private:
+    /**
+     * @brief Set the coefficients of the ROS3 method.
+     * 
+     * This method sets the coefficients of the ROS3 method. It is not intended for external use as the behavior is fixed for this solver.
+     */
+    void SetCoefficients();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "Ros3p.h"
+
+Ros3p::Ros3p()
+{
+
+}
+
+Ros3p::Ros3p(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : Rosenbrock(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetCoefficients();
+}
+
+Ros3p::~Ros3p()
+{
+
+}
+
+void Ros3p::SetCoefficients()
+{
+    gamma = 7.886751345948129e-01;
+    a = Eigen::MatrixXd::Zero(3, 3);
+    a(1, 0) = 1.267949192431123;
+    a(2, 0) = 1.267949192431123;
+    c = Eigen::MatrixXd::Zero(3, 3);
+    c(1, 0) = -1.607695154586736;
+    c(2, 0) = -3.464101615137755;
+    c(2, 1) = -1.732050807568877;
+    m = Eigen::VectorXd(3);
+    m << 2.0, 5.773502691896258e-01, 4.226497308103742e-01;
+    e = Eigen::VectorXd(3);
+    e << 2.0 - 2.113248654051871, 5.773502691896258e-01 - 1.0, 0.0;
+    alpha = Eigen::VectorXd(3);
+    alpha << 0.0, 1.0, 1.0;
+    gamma_sum = Eigen::VectorXd(3);
+    gamma_sum << 7.886751345948129e-01, -2.113248654051871e-01, -1.077350269189626;
+    order = 3;
+}
\ No newline at end of file
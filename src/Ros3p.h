@@ -0,0 +1,51 @@
+/**
+ * @file Ros3p.h
+ * @brief Defines the Ros3p class for solving stiff ordinary differential equations (ODEs) using the ROS3P Rosenbrock method.
+ */
+
+#ifndef ROS3P_H
+#define ROS3P_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Rosenbrock.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the ROS3P Rosenbrock method.
+ * 
+ * The three-stage, third-order method of Lang and Verwer with \f$ \gamma = 1/2 + \sqrt{3}/6 \f$ and an embedded second-order solution.
+ * It does not suffer from order reduction on parabolic problems.
+ */
+class Ros3p : public Rosenbrock
+{
+public:
+    /**
+     * @brief Construct a new Ros3p object.
+     */
+    Ros3p();
+
+    /**
+     * @brief Construct a new Ros3p object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Ros3p(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Ros3p object.
+     */
+    ~Ros3p();
+
+private:
+    /**
+     * @brief Set the coefficients of the ROS3P method.
+     * 
+     * This method sets the coefficients of the ROS3P method. It is not intended for external use as the behavior is fixed for this solver.
+     */
+    void SetCoefficients();
+};
+
+#endif
\ No newline at end of file
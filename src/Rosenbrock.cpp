@@ -0,0 +1,112 @@
+#include "Rosenbrock.h"
+#include "utils.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+bool IsStrictlyLowerTriangular(const Eigen::MatrixXd& matrix)
+{
+    return IsLowerTriangular(matrix) && matrix.diagonal().isZero(0.0);
+}
+}
+
+Rosenbrock::Rosenbrock()
+{
+
+}
+
+Rosenbrock::Rosenbrock(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, double gamma, Eigen::MatrixXd a, Eigen::MatrixXd c, Eigen::VectorXd m, Eigen::VectorXd e, Eigen::VectorXd alpha, Eigen::VectorXd gamma_sum, int order) : AdaptiveSolver(step_size, initial_time, final_time, initial_condition, function)
+{
+    int s = m.size();
+    if (a.rows() != s || c.rows() != s || e.size() != s || alpha.size() != s || gamma_sum.size() != s)
+        throw std::invalid_argument("Rosenbrock coefficients must all have the same number of stages");
+    if (!IsStrictlyLowerTriangular(a) || !IsStrictlyLowerTriangular(c))
+        throw std::invalid_argument("Matrices A and C of a Rosenbrock method must be strictly lower triangular");
+    if (gamma <= 0 || order <= 1)
+        throw std::invalid_argument("Rosenbrock method requires a positive gamma and an order of at least two");
+    this->gamma = gamma;
+    this->a = a;
+    this->c = c;
+    this->m = m;
+    this->e = e;
+    this->alpha = alpha;
+    this->gamma_sum = gamma_sum;
+    this->order = order;
+}
+
+Rosenbrock::Rosenbrock(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : AdaptiveSolver(step_size, initial_time, final_time, initial_condition, function)
+{
+
+}
+
+Rosenbrock::~Rosenbrock()
+{
+
+}
+
+int Rosenbrock::ErrorOrder() const
+{
+    return order - 1;
+}
+
+void Rosenbrock::StartIntegration()
+{
+    jacobian.resize(0, 0);
+}
+
+bool Rosenbrock::AttemptStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new, double& error)
+{
+    int n = y.size();
+    int s = m.size();
+    bool autonomous = function.IsAutonomous();
+
+    if (jacobian.rows() != n || jacobian_time != t || jacobian_state != y)
+    {
+        jacobian = function.BuildJacobian(t, y);
+        rhs_start = function.BuildRightHandSide(t, y);
+        if (autonomous)
+        {
+            time_derivative = Eigen::VectorXd::Zero(n);
+        }
+        else
+        {
+            double delta = std::sqrt(std::numeric_limits<double>::epsilon()) * std::max(1e-5, std::abs(t));
+            time_derivative = (function.BuildRightHandSide(t + delta, y) - rhs_start) / delta;
+        }
+        jacobian_time = t;
+        jacobian_state = y;
+    }
+
+    Eigen::PartialPivLU<Eigen::MatrixXd> lu(Eigen::MatrixXd::Identity(n, n) / (h * gamma) - jacobian);
+    Eigen::MatrixXd k = Eigen::MatrixXd::Zero(n, s);
+    Eigen::VectorXd stage_rhs = rhs_start;
+
+    for (int i = 0; i < s; i++)
+    {
+        // A stage with the same argument as the previous one reuses its function value.
+        if (i > 0 && (alpha(i) != alpha(i - 1) || a.row(i) != a.row(i - 1)))
+        {
+            Eigen::VectorXd y_stage = y;
+            for (int j = 0; j < i; j++)
+            {
+                y_stage += a(i, j) * k.col(j);
+            }
+            stage_rhs = function.BuildRightHandSide(t + alpha(i) * h, y_stage);
+        }
+        Eigen::VectorXd rhs = stage_rhs;
+        for (int j = 0; j < i; j++)
+        {
+            rhs += (c(i, j) / h) * k.col(j);
+        }
+        if (!autonomous)
+            rhs += h * gamma_sum(i) * time_derivative;
+        k.col(i) = lu.solve(rhs);
+    }
+
+    y_new = y + k * m;
+    Eigen::VectorXd scale = y.cwiseAbs().cwiseMax(y_new.cwiseAbs());
+    error = WeightedRmsNorm(k * e, ErrorWeights(scale));
+    return y_new.allFinite();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file Rosenbrock.h
+ * @brief Defines the Rosenbrock class for solving stiff ordinary differential equations (ODEs) using linearly implicit Runge-Kutta methods.
+ */
+
+#ifndef ROSENBROCK_H
+#define ROSENBROCK_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "AdaptiveSolver.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using Rosenbrock methods.
+ *
+ * Rosenbrock methods are linearly implicit: each step needs the Jacobian \f$ J = \partial f / \partial y \f$ and a single
+ * LU factorization, and no Newton iteration. In the form used here, an \f$ s \f$-stage method computes
+ *
+ * \f[
+ * \left( \frac{1}{h \gamma} I - J \right) k_i = f\left(t_n + \alpha_i h, y_n + \sum_{j=1}^{i-1} a_{ij} k_j\right) + \sum_{j=1}^{i-1} \frac{c_{ij}}{h} k_j + h \gamma_i \frac{\partial f}{\partial t}, \quad i = 1, \dots, s
+ * \f]
+ *
+ * \f[
+ * y_{n+1} = y_n + \sum_{i=1}^{s} m_i k_i, \qquad err = \sum_{i=1}^{s} e_i k_i,
+ * \f]
+ *
+ * where \f$ err \f$ is the difference between the solution and an embedded solution of one order less, used for step size control.
+ * The time derivative \f$ \partial f / \partial t \f$ is approximated by a finite difference and skipped for autonomous problems.
+ *
+ * The Jacobian of the system must be provided in the Function object.
+ */
+class Rosenbrock : public AdaptiveSolver
+{
+public:
+    /**
+     * @brief Construct a new Rosenbrock object.
+     */
+    Rosenbrock();
+
+    /**
+     * @brief Construct a new Rosenbrock object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     * @param gamma The diagonal coefficient \f$ \gamma \f$.
+     * @param a The strictly lower triangular matrix of coefficients \f$ a_{ij} \f$ of the stage arguments.
+     * @param c The strictly lower triangular matrix of coefficients \f$ c_{ij} \f$ of the stage couplings.
+     * @param m The vector of weights \f$ m_i \f$ of the solution.
+     * @param e The vector of weights \f$ e_i \f$ of the error estimate.
+     * @param alpha The vector of time nodes \f$ \alpha_i \f$.
+     * @param gamma_sum The vector of coefficients \f$ \gamma_i \f$ of the time derivative.
+     * @param order The order of the method; the embedded solution has one order less.
+     * @throws std::invalid_argument If the sizes of the coefficients do not match or a and c are not strictly lower triangular.
+     */
+    Rosenbrock(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, double gamma, Eigen::MatrixXd a, Eigen::MatrixXd c, Eigen::VectorXd m, Eigen::VectorXd e, Eigen::VectorXd alpha, Eigen::VectorXd gamma_sum, int order);
+
+    /**
+     * @brief Construct a new Rosenbrock object with no coefficients.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Rosenbrock(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Rosenbrock object.
+     */
+    ~Rosenbrock();
+
+protected:
+    double gamma;  ///< The diagonal coefficient.
+    Eigen::MatrixXd a;  ///< The coefficients of the stage arguments.
+    Eigen::MatrixXd c;  ///< The coefficients of the stage couplings.
+    Eigen::VectorXd m;  ///< The weights of the solution.
+    Eigen::VectorXd e;  ///< The weights of the error estimate.
+    Eigen::VectorXd alpha;  ///< The time nodes.
+    Eigen::VectorXd gamma_sum;  ///< The coefficients of the time derivative.
+    int order;  ///< The order of the method.
+
+    /**
+     * @brief Attempt a single Rosenbrock step.
+     *
+     * The Jacobian, the time derivative and the function value at the beginning of the step are kept, so that
+     * a rejected step is retried with a new factorization only.
+     */
+    bool AttemptStep(double t, double h, const Eigen::VectorXd& y, Eigen::VectorXd& y_new, double& error) override;
+
+    /**
+     * @brief Get the order of the embedded solution.
+     * @return int The order of the method minus one.
+     */
+    int ErrorOrder() const override;
+
+    /**
+     * @brief Discard the cached Jacobian.
+     */
+    void StartIntegration() override;
+
+private:
+    double jacobian_time;  ///< The time at which the cached Jacobian was evaluated.
+    Eigen::VectorXd jacobian_state;  ///< The state at which the cached Jacobian was evaluated.
+    Eigen::MatrixXd jacobian;  ///< The cached Jacobian.
+    Eigen::VectorXd rhs_start;  ///< The cached function value at the beginning of the step.
+    Eigen::VectorXd time_derivative;  ///< The cached time derivative of the function.
+};
+
+#endif
@@ -1,5 +1,8 @@
 #include "RungeKutta.h"
+#include "NewtonMethod.h"
 #include "utils.h"
+#include <stdexcept>
+#include <string>
 
 RungeKutta::RungeKutta()
 {
@@ -8,8 +11,8 @@ RungeKutta::RungeKutta()
 
 RungeKutta::RungeKutta(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, Eigen::MatrixXd a, Eigen::VectorXd b, Eigen::VectorXd c) : OdeSolver(step_size, initial_time, final_time, initial_condition, function) 
 {
-    if (!IsLowerTriangular(a))
-        throw std::invalid_argument("Matrix A must be lower triangular since only explicit solver is suported");
+    if (!IsLowerTriangular(a) || !HasConstantDiagonal(a))
+        throw std::invalid_argument("Matrix A must be lower triangular with a constant diagonal since only explicit and diagonally implicit solvers are supported");
     if (b.size() != a.rows() || c.size() != a.rows())
         throw std::invalid_argument("Vectors b and c must have the same size as the number of rows of matrix A");
     this->a = a;
@@ -29,11 +32,31 @@ RungeKutta::~RungeKutta()
 
 void RungeKutta::SetA(Eigen::MatrixXd a)
 {
-    if (!IsLowerTriangular(a))
-        throw std::invalid_argument("Matrix A must be lower triangular since only explicit solver is suported");
+    if (!IsLowerTriangular(a) || !HasConstantDiagonal(a))
+        throw std::invalid_argument("Matrix A must be lower triangular with a constant diagonal since only explicit and diagonally implicit solvers are supported");
     this->a = a;
 }
 
+const Eigen::MatrixXd& RungeKutta::GetA() const
+{
+    return a;
+}
+
+const Eigen::VectorXd& RungeKutta::GetB() const
+{
+    return b;
+}
+
+const Eigen::VectorXd& RungeKutta::GetC() const
+{
+    return c;
+}
+
+bool RungeKutta::IsImplicit() const
+{
+    return !a.diagonal().isZero(0.0);
+}
+
 void RungeKutta::SetB(Eigen::VectorXd b)
 {
     this->b = b;
@@ -45,40 +68,113 @@ void RungeKutta::SetC(Eigen::VectorXd c)
 }
 
 Eigen::MatrixXd RungeKutta::Solve()
-{    
-    auto y0 = initial_condition;
-    Eigen::MatrixXd approximations = Eigen::MatrixXd::Zero(y0.col(0).size(), (int)((final_time - initial_time) / step_size) + 1);
-    int current_col= 0;    
-    approximations.col(current_col) = y0.col(0);
-    current_col++;
-    int n_max = approximations.cols();
-
-    for (int n = 1; n < n_max; n++)
+{
+    MatrixSink sink;
+    SolveTo(sink);
+    return sink.Release();
+}
+
+void RungeKutta::SolveTo(TrajectorySink& sink)
+{
+    int n_max = GetNumTimePoints();
+    int dim = initial_condition.rows();
+    Eigen::VectorXd y_prev = initial_condition.col(0);
+    int first = 1;
+    std::shared_ptr<const SolverCheckpoint> checkpoint = StartSolve(1);
+    if (checkpoint)
+    {
+        first = checkpoint->next_point;
+        y_prev = checkpoint->history.rightCols(1);
+        sink.Begin(dim, n_max - first);
+    }
+    else
     {
-        int s = b.size();
-        Eigen::MatrixXd k = Eigen::MatrixXd::Zero(y0.col(0).size(), s);
+        sink.Begin(dim, n_max);
+        sink.Append(y_prev);
+    }
+    double gamma = 0.0;
+    for (int i = 0; i < a.rows(); i++)
+    {
+        if (a(i, i) != 0)
+            gamma = a(i, i);
+    }
+    if (!events.IsEmpty())
+        events.Start(initial_time + (first - 1) * step_size, y_prev);
 
-        for (int i = 0; i < s; i++)
+    for (int n = first; n < n_max; n++)
+    {
+        double t = initial_time + (n-1)*step_size;
+        double t_out = t + step_size;
+        Eigen::VectorXd y_next = Step(t, step_size, y_prev, gamma);
+
+        // Cut the step at every stopping or restarting event, then complete it from there.
+        double t_event;
+        while (!events.IsEmpty() && t < t_out && events.Check(function, t, y_prev, t_out, y_next, t_event))
         {
-            double time_step = (initial_time + (n-1)*step_size) + c(i) * step_size;
-            Eigen::VectorXd y_step = approximations.col(current_col - 1);
-            for (int j = 0; j < i; j++)
+            y_next = Step(t, t_event - t, y_prev, gamma);
+            if (events.Apply(t_event, y_next))
             {
-                y_step = y_step + (step_size * a(i, j) * k.col(j));
+                sink.End();
+                return;
             }
-            auto new_rhs = function.BuildRightHandSide(time_step, y_step);
-            k.col(i) = new_rhs;
+            t = t_event;
+            y_prev = y_next;
+            if (t < t_out)
+                y_next = Step(t, t_out - t, y_prev, gamma);
         }
-        auto y1 = approximations.col(current_col - 1) + step_size * k * b;
-        approximations.col(current_col) = y1;
-        current_col++;
-
+        y_prev = y_next;
+        sink.Append(y_prev);
+        if (CheckpointDue())
+        {
+            sink.Flush();
+            SolverCheckpoint state = NewCheckpoint(n + 1, t_out);
+            state.history = y_prev;
+            SaveCheckpoint(state);
+        }
+        ReportStep(t_out);
     }
-    
-
-    return approximations;
+    sink.End();
 }
+Eigen::VectorXd RungeKutta::Step(double t, double h, const Eigen::VectorXd& y, double gamma) const
+{
+    int dim = y.size();
+    int s = b.size();
+    Eigen::MatrixXd k = Eigen::MatrixXd::Zero(dim, s);
 
+    // All implicit stages share the same iteration matrix, factorized once per step.
+    Eigen::PartialPivLU<Eigen::MatrixXd> iteration_matrix;
+    if (gamma != 0.0)
+        iteration_matrix.compute(Eigen::MatrixXd::Identity(dim, dim) - h * gamma * function.BuildJacobian(t, y));
 
+    for (int i = 0; i < s; i++)
+    {
+        double time_step = t + c(i) * h;
+        Eigen::VectorXd y_step = y;
+        for (int j = 0; j < i; j++)
+        {
+            y_step = y_step + (h * a(i, j) * k.col(j));
+        }
+        if (a(i, i) == 0)
+        {
+            k.col(i) = function.BuildRightHandSide(time_step, y_step);
+            continue;
+        }
 
+        // Solve Y = y_step + h * gamma * f(t_i, Y), starting from the previous stage derivative.
+        NewtonMethod newton_solver(function, y_step, time_step, gamma, Eigen::VectorXd::Zero(dim), h);
+        if (i > 0)
+            newton_solver.SetInitialGuess(y_step + h * gamma * k.col(i - 1));
+        newton_solver.SetErrorWeights(ErrorWeights(y));
+        newton_solver.SetIterationMatrix(&iteration_matrix);
+        Eigen::VectorXd y_stage;
+        if (newton_solver.Solve(y_stage) != CONVERGED)
+            throw std::runtime_error("Newton method did not converge at time " + std::to_string(time_step) + ", try a smaller step size");
+        k.col(i) = (y_stage - y_step) / (h * gamma);
+    }
+    return y + h * k * b;
+}
 
+bool RungeKutta::SupportsEvents() const
+{
+    return true;
+}
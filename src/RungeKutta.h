@@ -14,7 +14,7 @@
  * 
  * The Runge-Kutta methods are numerical solver of ordinary 
  * differential equations (ODEs). The generic formulation of an explicit 
- * Runge-Kutta method of order \f$ s \f$ is given by:
+ * or diagonally implicit Runge-Kutta method with \f$ s \f$ stages is given by:
  * 
  * \f[
  * y_{n+1} = y_n + h \sum_{i=1}^{s} b_i k_i
@@ -23,16 +23,16 @@
  * where the stages \f$ k_i \f$ are defined as:
  * 
  * \f[
- * k_i = f\left(t_n + c_i h, y_n + h \sum_{j=1}^{i-1} a_{ij} k_j\right), \quad i = 1, \dots, s
+ * k_i = f\left(t_n + c_i h, y_n + h \sum_{j=1}^{i} a_{ij} k_j\right), \quad i = 1, \dots, s
  * \f]
  * 
  * The coefficients \f$ a_{ij} \f$, \f$ b_i \f$, and \f$ c_i \f$ are represented by:
  * 
  * \f[
  * \begin{array}{c|cccc}
- * c_1 & 0      & 0      & 0      & \cdots \\
- * c_2 & a_{21} & 0      & 0      & \cdots \\
- * c_3 & a_{31} & a_{32} & 0      & \cdots \\
+ * c_1 & a_{11} & 0      & 0      & \cdots \\
+ * c_2 & a_{21} & a_{22} & 0      & \cdots \\
+ * c_3 & a_{31} & a_{32} & a_{33} & \cdots \\
  * \vdots & \vdots & \vdots & \vdots & \ddots \\
  * c_s & a_{s1} & a_{s2} & a_{s3} & \cdots \\
  * \hline
@@ -40,6 +40,10 @@
  * \end{array}
  * \f]
  * 
+ * The method is explicit if the diagonal of \f$ A \f$ is zero. Otherwise every non-zero diagonal entry must be
+ * the same \f$ \gamma \f$ (SDIRK, or ESDIRK if some stages stay explicit): each implicit stage is then solved with
+ * a simplified Newton iteration, and all of them share one LU factorization of \f$ I - h \gamma J(t_n, y_n) \f$
+ * per step. Diagonally implicit methods require the Jacobian of the system in the Function object.
  */
 class RungeKutta: public OdeSolver
 {
@@ -59,7 +63,7 @@ public:
      * @param a The matrix of coefficients for the Runge-Kutta method.
      * @param b The vector of coefficients for the Runge-Kutta method.
      * @param c The vector of coefficients for the Runge-Kutta method.
-     * @throws std::invalid_argument If matrix a is not lower triangular.
+     * @throws std::invalid_argument If matrix a is not lower triangular or its non-zero diagonal entries differ.
      * @throws std::invalid_argument If the size of b and c are different from the number of rows of a.
      */
     RungeKutta(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, Eigen::MatrixXd a, Eigen::VectorXd b, Eigen::VectorXd c);
@@ -83,7 +87,7 @@ public:
     /**
      * @brief Set the matrix of coefficients for the Runge-Kutta method.
      * @param a The matrix of coefficients for the Runge-Kutta method.
-     * @throws std::invalid_argument If matrix a is not lower triangular.
+     * @throws std::invalid_argument If matrix a is not lower triangular or its non-zero diagonal entries differ.
      */
     void SetA(Eigen::MatrixXd a);
 
@@ -99,11 +103,48 @@ public:
      */
     void SetC(Eigen::VectorXd c);
 
+    /**
+     * @brief Get the matrix of coefficients for the Runge-Kutta method.
+     * @return const Eigen::MatrixXd& The matrix a.
+     */
+    const Eigen::MatrixXd& GetA() const;
+
+    /**
+     * @brief Get the weights of the Runge-Kutta method.
+     * @return const Eigen::VectorXd& The vector b.
+     */
+    const Eigen::VectorXd& GetB() const;
+
+    /**
+     * @brief Get the nodes of the Runge-Kutta method.
+     * @return const Eigen::VectorXd& The vector c.
+     */
+    const Eigen::VectorXd& GetC() const;
+
+    /**
+     * @brief Check whether the method has implicit stages.
+     * @return true if the diagonal of matrix a is not zero, false otherwise.
+     */
+    bool IsImplicit() const;
+
     /**
      * @brief Solve the ODE using the Runge-Kutta method.
      * @return An Eigen::MatrixXd containing the solution of the ODE at each time step.
+     * @throws std::runtime_error If the Newton iteration of an implicit stage does not converge.
      */
     Eigen::MatrixXd Solve() override;
+
+    /**
+     * @brief Solve the ODE using the Runge-Kutta method, handing every time point to a sink as soon as it is computed.
+     * @param sink The sink receiving the solution at each time point.
+     */
+    void SolveTo(TrajectorySink& sink) override;
+
+    /**
+     * @brief Check whether the method watches events.
+     * @return true, since every step can be shortened to end at an event.
+     */
+    bool SupportsEvents() const override;
     
 protected: 
     /**
@@ -118,6 +159,18 @@ protected:
      * @brief The vector of coefficients for the Runge-Kutta method.
      */
     Eigen::VectorXd c;
+
+private:
+    /**
+     * @brief Take one step of the method.
+     * @param t The time at the start of the step.
+     * @param h The length of the step.
+     * @param y The solution at the start of the step.
+     * @param gamma The diagonal coefficient of the implicit stages, zero for an explicit method.
+     * @return Eigen::VectorXd The solution at the end of the step.
+     * @throws std::runtime_error If the Newton iteration of an implicit stage does not converge.
+     */
+    Eigen::VectorXd Step(double t, double h, const Eigen::VectorXd& y, double gamma) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+/**
+ * @file SdeEnsemble.h
+ * @brief Defines the SdeEnsemble class for solving many paths of a stochastic differential equation in parallel.
+ */
+
+#ifndef SDEENSEMBLE_H
+#define SDEENSEMBLE_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ThreadPool.h"
+
+/**
+ * @brief A class for solving an ensemble of paths of one SDE problem.
+ *
+ * Member \f$ m \f$ is the path with index \f$ p_0 + m \f$ of the prototype (see SdeSolver::SetPath()), where
+ * \f$ p_0 \f$ is the path of the prototype. Since the Wiener increments of a path only depend on the seed and on
+ * its index, the results do not depend on the number of threads nor on the order in which the paths are solved,
+ * and any member can be reproduced alone by a solver with the same seed and path.
+ *
+ * The results have the same layout as those of EnsembleSolver: member \f$ m \f$ occupies the columns
+ * \f$ [m T, (m + 1) T) \f$, where \f$ T \f$ is the number of time points.
+ *
+ * @tparam Solver The concrete SdeSolver class, which must be copyable.
+ */
+template <typename Solver>
+class SdeEnsemble
+{
+public:
+    /**
+     * @brief Construct a new SdeEnsemble object.
+     * @param prototype The solver that every member copies.
+     * @param num_paths The number of paths.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     * @throws std::invalid_argument If the number of paths is not positive.
+     */
+    SdeEnsemble(const Solver& prototype, int num_paths, int num_threads = 0) : prototype(prototype), num_paths(num_paths), pool(num_threads)
+    {
+        if (num_paths <= 0)
+            throw std::invalid_argument("The number of paths must be positive");
+    }
+
+    /**
+     * @brief Get the number of paths.
+     * @return int The number of members.
+     */
+    int GetNumPaths() const
+    {
+        return num_paths;
+    }
+
+    /**
+     * @brief Get the dimension of the problem.
+     * @return int The number of rows of the results.
+     */
+    int GetDimension() const
+    {
+        return prototype.GetInitialCondition().rows();
+    }
+
+    /**
+     * @brief Get the number of time points of every path.
+     * @return int The number of columns of each path's block of the results.
+     */
+    int GetNumTimePoints() const
+    {
+        return prototype.GetNumTimePoints();
+    }
+
+    /**
+     * @brief Solve every path into a new matrix.
+     * @return Eigen::MatrixXd The results, laid out as described in the class documentation.
+     */
+    Eigen::MatrixXd Solve()
+    {
+        Eigen::MatrixXd results(GetDimension(), num_paths * GetNumTimePoints());
+        Solve(results);
+        return results;
+    }
+
+    /**
+     * @brief Solve every path into a preallocated matrix.
+     * @param results The matrix receiving the results, of size dimension by paths times time points.
+     * @throws std::invalid_argument If the matrix does not have the expected size.
+     * @throws std::runtime_error If the solve of a path fails, with the error of the first failing path.
+     */
+    void Solve(Eigen::MatrixXd& results)
+    {
+        int num_points = GetNumTimePoints();
+        if (results.rows() != GetDimension() || results.cols() != num_paths * num_points)
+            throw std::invalid_argument("The results matrix must have " + std::to_string(GetDimension()) + " rows and " + std::to_string(num_paths * num_points) + " columns");
+
+        std::uint64_t first_path = prototype.GetPath();
+        std::vector<std::exception_ptr> errors(num_paths);
+        pool.ParallelFor(0, num_paths, [&](int begin, int end) {
+            Solver solver = prototype;
+            for (int m = begin; m < end; m++)
+            {
+                try
+                {
+                    solver.SetPath(first_path + m);
+                    results.middleCols(m * num_points, num_points) = solver.Solve();
+                }
+                catch (...)
+                {
+                    errors[m] = std::current_exception();
+                }
+            }
+        });
+        for (const auto& error : errors)
+        {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+private:
+    Solver prototype;  ///< The solver that every member copies.
+    int num_paths;  ///< The number of paths.
+    ThreadPool pool;  ///< The worker threads.
+};
+
+#endif
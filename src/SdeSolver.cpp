@@ -0,0 +1,97 @@
+#include "SdeSolver.h"
+#include <cmath>
+
+SdeSolver::SdeSolver()
+{
+
+}
+
+SdeSolver::SdeSolver(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function drift, Function diffusion) : OdeSolver(step_size, initial_time, final_time, initial_condition, drift), diffusion(diffusion)
+{
+
+}
+
+SdeSolver::~SdeSolver()
+{
+
+}
+
+void SdeSolver::SetDiffusion(Function diffusion)
+{
+    this->diffusion = diffusion;
+}
+
+const Function& SdeSolver::GetDiffusion() const
+{
+    return diffusion;
+}
+
+void SdeSolver::SetSeed(std::uint64_t seed)
+{
+    generator = Philox(seed);
+}
+
+std::uint64_t SdeSolver::GetSeed() const
+{
+    return generator.GetSeed();
+}
+
+void SdeSolver::SetPath(std::uint64_t path)
+{
+    this->path = path;
+}
+
+std::uint64_t SdeSolver::GetPath() const
+{
+    return path;
+}
+
+Eigen::VectorXd SdeSolver::GetWienerIncrement(int step) const
+{
+    int dim = initial_condition.rows();
+    Eigen::VectorXd dw(dim);
+    generator.Normals(path, (std::uint64_t)(step - 1) * dim, dw);
+    return std::sqrt(step_size) * dw;
+}
+
+Eigen::MatrixXd SdeSolver::Solve()
+{
+    MatrixSink sink;
+    SolveTo(sink);
+    return sink.Release();
+}
+
+void SdeSolver::SolveTo(TrajectorySink& sink)
+{
+    int n_max = GetNumTimePoints();
+    Eigen::VectorXd y = initial_condition.col(0);
+    int first = 1;
+    // The increments are drawn from the step index, so resuming only needs the state.
+    std::shared_ptr<const SolverCheckpoint> checkpoint = StartSolve(1);
+    if (checkpoint)
+    {
+        first = checkpoint->next_point;
+        y = checkpoint->history.rightCols(1);
+        sink.Begin(y.size(), n_max - first);
+    }
+    else
+    {
+        sink.Begin(y.size(), n_max);
+        sink.Append(y);
+    }
+    for (int n = first; n < n_max; n++)
+    {
+        double t = initial_time + (n - 1) * step_size;
+        y = Step(t, y, GetWienerIncrement(n));
+        sink.Append(y);
+        if (CheckpointDue())
+        {
+            sink.Flush();
+            SolverCheckpoint state = NewCheckpoint(n + 1, t + step_size);
+            state.history = y;
+            SaveCheckpoint(state);
+        }
+        ReportStep(t + step_size);
+    }
+    sink.End();
+}
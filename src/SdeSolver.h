@@ -0,0 +1,128 @@
+/**
+ * @file SdeSolver.h
+ * @brief Defines the SdeSolver class for solving stochastic differential equations (SDEs) driven by Wiener noise.
+ */
+
+#ifndef SDESOLVER_H
+#define SDESOLVER_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <cstdint>
+#include "Function.h"
+#include "OdeSolver.h"
+#include "Philox.h"
+
+/**
+ * @brief A class for solving Itô stochastic differential equations with diagonal noise.
+ *
+ * The system is
+ * \f[
+ * dy_i = f_i(t, y) \, dt + g_i(t, y) \, dW_i,
+ * \f]
+ * where every equation has its own independent Wiener process \f$ W_i \f$. The drift \f$ f \f$ is the Function
+ * of the solver and the diffusion \f$ g \f$ is a second Function written in the same term syntax, with one row per
+ * equation.
+ *
+ * The Wiener increments are drawn from a Philox counter-based generator: the increment of equation \f$ i \f$ over
+ * step \f$ n \f$ of path \f$ p \f$ is a pure function of the seed, \f$ p \f$, \f$ n \f$ and \f$ i \f$. A path is
+ * therefore reproduced exactly by any copy of the solver with the same seed and path index, whatever the thread
+ * it runs on, which is how SdeEnsemble generates its members in parallel.
+ */
+class SdeSolver : public OdeSolver
+{
+public:
+    /**
+     * @brief Construct a new SdeSolver object.
+     */
+    SdeSolver();
+
+    /**
+     * @brief Construct a new SdeSolver object.
+     * @param step_size The step size for the solver.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem; only its first column is used.
+     * @param drift A Function object with the drift of the problem.
+     * @param diffusion A Function object with the diffusion of the problem, one row per equation.
+     * @throws std::invalid_argument If the step size is not positive.
+     * @throws std::invalid_argument If the final time is smaller than initial time.
+     */
+    SdeSolver(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function drift, Function diffusion);
+
+    /**
+     * @brief Destroy the SdeSolver object.
+     */
+    ~SdeSolver();
+
+    /**
+     * @brief Set the diffusion of the problem.
+     * @param diffusion A Function object with the diffusion of the problem, one row per equation.
+     */
+    void SetDiffusion(Function diffusion);
+
+    /**
+     * @brief Get the diffusion of the problem.
+     * @return const Function& The Function object with the diffusion.
+     */
+    const Function& GetDiffusion() const;
+
+    /**
+     * @brief Set the seed of the random number generator.
+     * @param seed The seed.
+     */
+    void SetSeed(std::uint64_t seed);
+
+    /**
+     * @brief Get the seed of the random number generator.
+     * @return std::uint64_t The seed.
+     */
+    std::uint64_t GetSeed() const;
+
+    /**
+     * @brief Set the index of the path, which selects the stream of random numbers.
+     * @param path The index of the path.
+     */
+    void SetPath(std::uint64_t path);
+
+    /**
+     * @brief Get the index of the path.
+     * @return std::uint64_t The index of the path.
+     */
+    std::uint64_t GetPath() const;
+
+    /**
+     * @brief Get the Wiener increments of one step of the path.
+     * @param step The step, from 1 for the step that leads to the second time point.
+     * @return Eigen::VectorXd The increments \f$ \Delta W_i \f$, normal with variance equal to the step size.
+     */
+    Eigen::VectorXd GetWienerIncrement(int step) const;
+
+    /**
+     * @brief Solve the SDE problem along the path.
+     * @return Eigen::MatrixXd A matrix containing the solution at each time point.
+     */
+    Eigen::MatrixXd Solve();
+
+    /**
+     * @brief Solve the SDE problem along the path, handing every time point to a sink as soon as it is computed.
+     * @param sink The sink receiving the solution at each time point.
+     */
+    void SolveTo(TrajectorySink& sink);
+
+protected:
+    Function diffusion;  ///< The diffusion of the problem.
+    Philox generator;  ///< The generator of the Wiener increments.
+    std::uint64_t path = 0;  ///< The index of the path.
+
+    /**
+     * @brief Advance the solution by one step.
+     * @param t The time at the start of the step.
+     * @param y The solution at the start of the step.
+     * @param dw The Wiener increments of the step.
+     * @return Eigen::VectorXd The solution at the end of the step.
+     */
+    virtual Eigen::VectorXd Step(double t, const Eigen::VectorXd& y, const Eigen::VectorXd& dw) const = 0;
+};
+
+#endif
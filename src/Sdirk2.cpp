@@ -0,0 +1,42 @@
+#include "Sdirk2.h"
+#include "OdeSolver.h"
+#include <cmath>
+
+Sdirk2::Sdirk2()
+{
+
+}
+
+Sdirk2::~Sdirk2()
+{
+
+}
+
+Sdirk2::Sdirk2(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : RungeKutta(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetA();
+    SetB();
+    SetC();
+}
+
+void Sdirk2::SetA()
+{
+    const double gamma = 1.0 - 1.0 / std::sqrt(2.0);
+    this->a = Eigen::MatrixXd::Zero(2, 2);
+    this->a << gamma, 0,
+               1.0 - gamma, gamma;
+}
+
+void Sdirk2::SetB()
+{
+    const double gamma = 1.0 - 1.0 / std::sqrt(2.0);
+    this->b = Eigen::VectorXd(2);
+    this->b << 1.0 - gamma, gamma;
+}
+
+void Sdirk2::SetC()
+{
+    const double gamma = 1.0 - 1.0 / std::sqrt(2.0);
+    this->c = Eigen::VectorXd(2);
+    this->c << gamma, 1.0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/**
+ * @file Sdirk2.h
+ * @brief Defines the Sdirk2 class for solving stiff ordinary differential equations (ODEs) using the SDIRK2 method.
+ */
+#ifndef SDIRK2_H
+#define SDIRK2_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "OdeSolver.h"
+#include "RungeKutta.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the two-stage SDIRK2.
+ * 
+ * The SDIRK2 method is a two-stage, second-order, L-stable singly diagonally implicit Runge-Kutta method with
+ * \f$ \gamma = 1 - 1/\sqrt{2} \f$. It is stiffly accurate: the solution is the last stage.
+ * 
+ * In this setting, the coefficients \f$ a_{ij} \f$, \f$ b_i \f$, and \f$ c_i \f$  are:
+ * 
+ * \f[
+ * \begin{array}{c|cc}
+ * \gamma & \gamma & 0 \\
+ * 1 & 1 - \gamma & \gamma \\
+ * \hline
+ *      & 1 - \gamma & \gamma
+ * \end{array}
+ * \f]
+ * 
+ * The Jacobian of the system must be provided in the Function object.
+ */
+class Sdirk2 : public RungeKutta
+{
+public:
+    /**
+     * @brief Construct a new Sdirk2 object.
+     */
+    Sdirk2();
+    /**
+     * @brief Construct a new Sdirk2 object.
+     * @param step_size The step size for the solver.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Sdirk2(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+    /**
+     * @brief Destroy the Sdirk2 object.
+     */
+    ~Sdirk2();
+
+private:
+    /**
+     * @brief Set the A matrix for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's A matrix for
+     * the SDIRK2 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetA();
+    /**
+     * @brief Set the B vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's B vector for
+     * the SDIRK2 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetB();
+    /**
+     * @brief Set the C vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's C vector for
+     * the SDIRK2 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetC();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "Sdirk4.h"
+#include "OdeSolver.h"
+
+Sdirk4::Sdirk4()
+{
+
+}
+
+Sdirk4::~Sdirk4()
+{
+
+}
+
+Sdirk4::Sdirk4(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : RungeKutta(step_size, initial_time, final_time, initial_condition, function)
+{
+    SetA();
+    SetB();
+    SetC();
+}
+
+void Sdirk4::SetA()
+{
+    this->a = Eigen::MatrixXd::Zero(5, 5);
+    this->a << 1.0/4.0, 0, 0, 0, 0,
+               1.0/2.0, 1.0/4.0, 0, 0, 0,
+               17.0/50.0, -1.0/25.0, 1.0/4.0, 0, 0,
+               371.0/1360.0, -137.0/2720.0, 15.0/544.0, 1.0/4.0, 0,
+               25.0/24.0, -49.0/48.0, 125.0/16.0, -85.0/12.0, 1.0/4.0;
+}
+
+void Sdirk4::SetB()
+{
+    this->b = Eigen::VectorXd(5);
+    this->b << 25.0/24.0, -49.0/48.0, 125.0/16.0, -85.0/12.0, 1.0/4.0;
+}
+
+void Sdirk4::SetC()
+{
+    this->c = Eigen::VectorXd(5);
+    this->c << 1.0/4.0, 3.0/4.0, 11.0/20.0, 1.0/2.0, 1.0;
+}
\ No newline at end of file
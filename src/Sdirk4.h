@@ -0,0 +1,83 @@
+/**
+ * @file Sdirk4.h
+ * @brief Defines the Sdirk4 class for solving stiff ordinary differential equations (ODEs) using the SDIRK4 method.
+ */
+#ifndef SDIRK4_H
+#define SDIRK4_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "OdeSolver.h"
+#include "RungeKutta.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) using the five-stage SDIRK4.
+ * 
+ * The SDIRK4 method of Hairer and Wanner is a five-stage, fourth-order, L-stable singly diagonally implicit
+ * Runge-Kutta method with \f$ \gamma = 1/4 \f$. It is stiffly accurate: the solution is the last stage.
+ * 
+ * In this setting, the coefficients \f$ a_{ij} \f$, \f$ b_i \f$, and \f$ c_i \f$  are:
+ * 
+ * \f[
+ * \begin{array}{c|ccccc}
+ * 1/4 & 1/4 & & & & \\
+ * 3/4 & 1/2 & 1/4 & & & \\
+ * 11/20 & 17/50 & -1/25 & 1/4 & & \\
+ * 1/2 & 371/1360 & -137/2720 & 15/544 & 1/4 & \\
+ * 1 & 25/24 & -49/48 & 125/16 & -85/12 & 1/4 \\
+ * \hline
+ *      & 25/24 & -49/48 & 125/16 & -85/12 & 1/4
+ * \end{array}
+ * \f]
+ * 
+ * The Jacobian of the system must be provided in the Function object.
+ */
+class Sdirk4 : public RungeKutta
+{
+public:
+    /**
+     * @brief Construct a new Sdirk4 object.
+     */
+    Sdirk4();
+    /**
+     * @brief Construct a new Sdirk4 object.
+     * @param step_size The step size for the solver.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Sdirk4(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+    /**
+     * @brief Destroy the Sdirk4 object.
+     */
+    ~Sdirk4();
+
+private:
+    /**
+     * @brief Set the A matrix for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's A matrix for
+     * the SDIRK4 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetA();
+    /**
+     * @brief Set the B vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's B vector for
+     * the SDIRK4 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetB();
+    /**
+     * @brief Set the C vector for the Runge-Kutta method.
+     * 
+     * This method sets the coefficients of the Butcher tableau's C vector for
+     * the SDIRK4 method. It is not intended for external use as the
+     * behavior is fixed for this solver.
+     */
+    void SetC();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "Seulex.h"
+
+namespace
+{
+const int kSequence[] = {1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+}
+
+Seulex::Seulex()
+{
+    max_columns = 12;
+}
+
+Seulex::Seulex(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function) : Extrapolation(step_size, initial_time, final_time, initial_condition, function)
+{
+    max_columns = 12;
+}
+
+Seulex::~Seulex()
+{
+
+}
+
+int Seulex::Sequence(int j) const
+{
+    return kSequence[j];
+}
+
+int Seulex::NumSequences() const
+{
+    return sizeof(kSequence) / sizeof(kSequence[0]);
+}
+
+int Seulex::Power() const
+{
+    return 1;
+}
+
+double Seulex::Cost(int j) const
+{
+    // Every sequence factorizes its own matrix, and the first one also pays for the Jacobian.
+    return (j == 0) ? Sequence(j) + 2 : Sequence(j) + 1;
+}
+
+void Seulex::PrepareStep(double t, const Eigen::VectorXd& y)
+{
+    jacobian = function.BuildJacobian(t, y);
+}
+
+bool Seulex::ComputeSequence(double t, double h, const Eigen::VectorXd& y, const Eigen::VectorXd& f0, int n, Eigen::VectorXd& result) const
+{
+    double substep = h / n;
+    Eigen::PartialPivLU<Eigen::MatrixXd> lu(Eigen::MatrixXd::Identity(y.size(), y.size()) - substep * jacobian);
+    result = y + lu.solve(substep * f0);
+    for (int m = 1; m < n; m++)
+    {
+        result += lu.solve(substep * function.BuildRightHandSide(t + m * substep, result));
+    }
+    return result.allFinite();
+}
@@ -0,0 +1,61 @@
+/**
+ * @file Seulex.h
+ * @brief Defines the Seulex class for solving stiff ordinary differential equations (ODEs) with linearly implicit Euler extrapolation.
+ */
+
+#ifndef SEULEX_H
+#define SEULEX_H
+
+#pragma once
+#include <Eigen/Dense>
+#include "Extrapolation.h"
+
+/**
+ * @brief A class for solving stiff ordinary differential equations (ODEs) with extrapolation of the linearly implicit Euler method.
+ *
+ * The basic method is the linearly implicit Euler method with \f$ n \f$ substeps of size \f$ h = H / n \f$,
+ * \f[
+ * (I - h J) (z_{m+1} - z_m) = h f(t_0 + m h, z_m),
+ * \f]
+ * where \f$ J \f$ is the Jacobian at the beginning of the step. Its error has an expansion in powers of \f$ h \f$, so
+ * that \f$ k \f$ columns give a method of order \f$ k \f$. The step numbers are those of SEULEX,
+ * \f$ 1, 2, 3, 4, 6, 8, 12, \ldots \f$; every sequence factorizes its own matrix \f$ I - h J \f$.
+ *
+ * The Jacobian of the system must be provided in the Function object. By default at most 12 columns are used.
+ */
+class Seulex : public Extrapolation
+{
+public:
+    /**
+     * @brief Construct a new Seulex object.
+     */
+    Seulex();
+
+    /**
+     * @brief Construct a new Seulex object with full parameters.
+     * @param step_size The distance between two output times, and the step size in fixed mode.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     * @param initial_condition The initial condition of the problem.
+     * @param function A Function object that includes the actual function of the problem and its Jacobian.
+     */
+    Seulex(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function);
+
+    /**
+     * @brief Destroy the Seulex object.
+     */
+    ~Seulex();
+
+protected:
+    int Sequence(int j) const override;
+    int NumSequences() const override;
+    int Power() const override;
+    double Cost(int j) const override;
+    void PrepareStep(double t, const Eigen::VectorXd& y) override;
+    bool ComputeSequence(double t, double h, const Eigen::VectorXd& y, const Eigen::VectorXd& f0, int n, Eigen::VectorXd& result) const override;
+
+private:
+    Eigen::MatrixXd jacobian;  ///< The Jacobian at the beginning of the current step.
+};
+
+#endif
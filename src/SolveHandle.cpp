@@ -0,0 +1,77 @@
+#include "SolveHandle.h"
+#include <algorithm>
+#include <chrono>
+
+SolveHandle::SolveHandle(std::shared_ptr<SolveControl> control, std::future<Eigen::MatrixXd> result, double initial_time, double final_time) : control(control), result(std::move(result)), initial_time(initial_time), final_time(final_time)
+{
+
+}
+
+SolveHandle::~SolveHandle()
+{
+    Stop();
+}
+
+SolveHandle& SolveHandle::operator=(SolveHandle&& other)
+{
+    if (this != &other)
+    {
+        // Dropping the future of a running solve would block on it without cancelling it.
+        Stop();
+        control = std::move(other.control);
+        result = std::move(other.result);
+        initial_time = other.initial_time;
+        final_time = other.final_time;
+    }
+    return *this;
+}
+
+void SolveHandle::Stop()
+{
+    if (result.valid() && !IsReady())
+    {
+        Cancel();
+        result.wait();
+    }
+}
+
+double SolveHandle::GetTime() const
+{
+    if (!control)
+        return initial_time;
+    return control->time.load(std::memory_order_relaxed);
+}
+
+long SolveHandle::GetSteps() const
+{
+    if (!control)
+        return 0;
+    return control->steps.load(std::memory_order_relaxed);
+}
+
+double SolveHandle::GetProgress() const
+{
+    return std::min(1.0, std::max(0.0, (GetTime() - initial_time) / (final_time - initial_time)));
+}
+
+void SolveHandle::Cancel()
+{
+    if (!control)
+        return;
+    control->cancelled.store(true, std::memory_order_relaxed);
+}
+
+bool SolveHandle::IsReady() const
+{
+    return WaitFor(0.0);
+}
+
+bool SolveHandle::WaitFor(double seconds) const
+{
+    return !result.valid() || result.wait_for(std::chrono::duration<double>(seconds)) == std::future_status::ready;
+}
+
+Eigen::MatrixXd SolveHandle::Get()
+{
+    return result.get();
+}
@@ -0,0 +1,128 @@
+/**
+ * @file SolveHandle.h
+ * @brief Defines the SolveHandle class and the SolveAsync() function for running a solve in the background.
+ */
+
+#ifndef SOLVEHANDLE_H
+#define SOLVEHANDLE_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <future>
+#include <memory>
+#include "OdeSolver.h"
+
+/**
+ * @brief A handle on a solve running in the background, returned by SolveAsync().
+ *
+ * The progress is read from the SolveControl of the solve without locking, and Cancel() stops the solve after
+ * its current step. A handle that is destroyed or assigned to before its solve has finished cancels it, so that an
+ * abandoned run does not keep a core busy. A moved-from handle has no solve: it reports no progress and Cancel()
+ * does nothing.
+ */
+class SolveHandle
+{
+public:
+    /**
+     * @brief Construct a new SolveHandle object.
+     * @param control The control attached to the solver.
+     * @param result The future result of the solve.
+     * @param initial_time The initial time of the problem.
+     * @param final_time The final time of the problem.
+     */
+    SolveHandle(std::shared_ptr<SolveControl> control, std::future<Eigen::MatrixXd> result, double initial_time, double final_time);
+
+    /**
+     * @brief Cancel the solve if it is still running and wait for it to stop.
+     */
+    ~SolveHandle();
+
+    SolveHandle(SolveHandle&&) = default;
+
+    /**
+     * @brief Cancel the current solve if it is still running, wait for it to stop, then take over another handle.
+     * @param other The handle to move from.
+     * @return SolveHandle& This handle.
+     */
+    SolveHandle& operator=(SolveHandle&& other);
+
+    /**
+     * @brief Get the time reached by the last step.
+     * @return double The time, the initial time before the first step or without a solve.
+     */
+    double GetTime() const;
+
+    /**
+     * @brief Get the number of steps taken.
+     * @return long The number of steps, zero without a solve.
+     */
+    long GetSteps() const;
+
+    /**
+     * @brief Get the fraction of the time interval that has been solved.
+     * @return double The fraction, between zero and one.
+     */
+    double GetProgress() const;
+
+    /**
+     * @brief Ask the solve to stop after its current step.
+     */
+    void Cancel();
+
+    /**
+     * @brief Check whether the solve has finished, successfully or not.
+     * @return true if Get() will not block, false otherwise.
+     */
+    bool IsReady() const;
+
+    /**
+     * @brief Wait for the solve to finish, for at most a given time.
+     * @param seconds The longest time to wait.
+     * @return true if the solve has finished, false otherwise.
+     */
+    bool WaitFor(double seconds) const;
+
+    /**
+     * @brief Wait for the solve and get its result.
+     * 
+     * The result can only be taken once.
+     * 
+     * @return Eigen::MatrixXd The solution at each time point.
+     * @throws SolveCancelled If the solve was cancelled.
+     * @throws std::exception Any exception thrown by the solve.
+     */
+    Eigen::MatrixXd Get();
+
+private:
+    std::shared_ptr<SolveControl> control;  ///< The progress and cancellation flag of the solve.
+    std::future<Eigen::MatrixXd> result;  ///< The future result of the solve.
+    double initial_time;  ///< The initial time of the problem.
+    double final_time;  ///< The final time of the problem.
+
+    /**
+     * @brief Cancel the solve if it is still running and wait for it to stop.
+     */
+    void Stop();
+};
+
+/**
+ * @brief Start solving a copy of a solver on its own thread.
+ *
+ * The copy gets a new SolveControl, replacing any control of the solver.
+ *
+ * @tparam Solver The concrete solver class, which must be copyable.
+ * @param solver The solver to copy.
+ * @return SolveHandle The handle on the solve.
+ */
+template <typename Solver>
+SolveHandle SolveAsync(const Solver& solver)
+{
+    auto control = std::make_shared<SolveControl>();
+    control->time = solver.GetInitialTime();
+    Solver copy = solver;
+    copy.SetControl(control);
+    std::future<Eigen::MatrixXd> result = std::async(std::launch::async, [copy]() mutable { return copy.Solve(); });
+    return SolveHandle(control, std::move(result), solver.GetInitialTime(), solver.GetFinalTime());
+}
+
+#endif
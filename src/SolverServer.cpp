@@ -0,0 +1,357 @@
+#include "SolverServer.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Problem.h"
+#include "utils.h"
+
+namespace
+{
+const char kRequestMagic[4] = {'O', 'D', 'E', 'Q'};
+const char kResponseMagic[4] = {'O', 'D', 'E', 'R'};
+const std::size_t kFrameHeaderSize = 24;
+const std::uint64_t kMaxInputBytes = 256ULL << 20;
+
+// The fields of a frame header, whatever its direction.
+struct FrameHeader
+{
+    std::uint32_t word;  // The layout of a request or the status of a response.
+    std::uint64_t id;
+    std::uint64_t length;
+};
+
+void PutUint32(char* out, std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out[i] = static_cast<char>(value >> (8 * i));
+}
+
+void PutUint64(char* out, std::uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        out[i] = static_cast<char>(value >> (8 * i));
+}
+
+std::uint64_t GetUint(const char* in, int bytes)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    return value;
+}
+
+// Reads up to length bytes, fewer only if the stream ends. Returns the number of bytes read.
+std::size_t ReadFully(int fd, char* data, std::size_t length)
+{
+    std::size_t done = 0;
+    while (done < length)
+    {
+        ssize_t count = read(fd, data + done, length - done);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0)
+            throw std::runtime_error(std::string("Could not read the stream: ") + std::strerror(errno));
+        if (count == 0)
+            break;
+        done += count;
+    }
+    return done;
+}
+
+// Writes every byte, without raising SIGPIPE when the other end of a socket is closed.
+void WriteFully(int fd, const char* data, std::size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t count = send(fd, data, length, MSG_NOSIGNAL);
+        if (count < 0 && errno == ENOTSOCK)
+            count = write(fd, data, length);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            throw std::runtime_error(std::string("Could not write the stream: ") + std::strerror(errno));
+        data += count;
+        length -= count;
+    }
+}
+
+void WriteFrame(int fd, const char* magic, const FrameHeader& frame, const std::string& payload)
+{
+    char header[kFrameHeaderSize];
+    std::memcpy(header, magic, 4);
+    PutUint32(header + 4, frame.word);
+    PutUint64(header + 8, frame.id);
+    PutUint64(header + 16, frame.length);
+    WriteFully(fd, header, sizeof(header));
+    WriteFully(fd, payload.data(), payload.size());
+}
+
+bool ReadFrame(int fd, const char* magic, FrameHeader& frame, std::string& payload, std::uint64_t max_length)
+{
+    char header[kFrameHeaderSize];
+    std::size_t count = ReadFully(fd, header, sizeof(header));
+    if (count == 0)
+        return false;
+    if (count < sizeof(header))
+        throw std::runtime_error("Truncated frame header");
+    if (std::memcmp(header, magic, 4) != 0)
+        throw std::runtime_error("Invalid frame header");
+    frame.word = static_cast<std::uint32_t>(GetUint(header + 4, 4));
+    frame.id = GetUint(header + 8, 8);
+    frame.length = GetUint(header + 16, 8);
+    if (frame.length > max_length)
+        throw std::runtime_error("Frame too large: " + std::to_string(frame.length) + " bytes");
+    payload.resize(frame.length);
+    if (ReadFully(fd, &payload[0], payload.size()) < payload.size())
+        throw std::runtime_error("Truncated frame");
+    return true;
+}
+
+// The state shared by the reader of a stream and the workers answering its requests.
+struct ResponseStream
+{
+    std::mutex mutex;  // Protects the fields and keeps the responses from interleaving.
+    std::condition_variable done;  // Signaled when the last pending response is written.
+    int pending = 0;  // The number of requests read and not answered yet.
+    bool broken = false;  // Whether a response could not be written, so that the next ones are dropped.
+};
+}
+
+void WriteServerRequest(int fd, const ServerRequest& request)
+{
+    WriteFrame(fd, kRequestMagic, {static_cast<std::uint32_t>(request.layout), request.id, request.input.size()}, request.input);
+}
+
+bool ReadServerRequest(int fd, ServerRequest& request)
+{
+    FrameHeader frame;
+    if (!ReadFrame(fd, kRequestMagic, frame, request.input, kMaxInputBytes))
+        return false;
+    if (frame.word > XOR_COMPRESSED)
+        throw std::runtime_error("Invalid trajectory layout: " + std::to_string(frame.word));
+    request.id = frame.id;
+    request.layout = static_cast<TrajectoryLayout>(frame.word);
+    return true;
+}
+
+void WriteServerResponse(int fd, const ServerResponse& response)
+{
+    WriteFrame(fd, kResponseMagic, {response.success ? 0u : 1u, response.id, response.payload.size()}, response.payload);
+}
+
+bool ReadServerResponse(int fd, ServerResponse& response)
+{
+    FrameHeader frame;
+    if (!ReadFrame(fd, kResponseMagic, frame, response.payload, ~0ULL))
+        return false;
+    response.id = frame.id;
+    response.success = (frame.word == 0);
+    return true;
+}
+
+SolverServer::SolverServer(int num_threads, std::size_t cache_size) : cache(cache_size), pool(num_threads)
+{
+
+}
+
+SolverServer::~SolverServer()
+{
+    Stop();
+    JoinConnections(true);
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+    }
+}
+
+ServerResponse SolverServer::Handle(const ServerRequest& request) const
+{
+    ServerResponse response;
+    response.id = request.id;
+    try
+    {
+        InputParameters params = ParseInputText(request.input, cache);
+        TrajectoryHeader header;
+        Eigen::MatrixXd approximations = SolveProblem(params, header.method);
+        header.initial_time = params.initial_time;
+        header.final_time = params.final_time;
+        header.step_size = params.step_size;
+        header.rel_tol = params.rel_tol;
+        header.abs_tol = params.abs_tol;
+        header.layout = request.layout;
+        std::ostringstream out(std::ios::binary);
+        WriteTrajectory(out, approximations, header);
+        response.payload = out.str();
+        response.success = true;
+    }
+    catch (const std::exception& e)
+    {
+        response.payload = e.what();
+    }
+    return response;
+}
+
+void SolverServer::Serve(int in_fd, int out_fd)
+{
+    auto stream = std::make_shared<ResponseStream>();
+    std::exception_ptr error;
+    try
+    {
+        ServerRequest request;
+        while (ReadServerRequest(in_fd, request))
+        {
+            {
+                std::lock_guard<std::mutex> lock(stream->mutex);
+                if (stream->broken)
+                    break;
+                stream->pending++;
+            }
+            auto shared = std::make_shared<const ServerRequest>(std::move(request));
+            pool.Enqueue([this, stream, shared, out_fd] {
+                ServerResponse response = Handle(*shared);
+                std::lock_guard<std::mutex> lock(stream->mutex);
+                if (!stream->broken)
+                {
+                    try
+                    {
+                        WriteServerResponse(out_fd, response);
+                    }
+                    catch (const std::runtime_error&)
+                    {
+                        stream->broken = true;
+                    }
+                }
+                if (--stream->pending == 0)
+                    stream->done.notify_all();
+            });
+        }
+    }
+    catch (const std::runtime_error&)
+    {
+        error = std::current_exception();
+    }
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    stream->done.wait(lock, [&stream] { return stream->pending == 0; });
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void SolverServer::Listen(const std::string& socket_path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Invalid socket path: " + socket_path);
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (listen_fd >= 0)
+        throw std::runtime_error("The server is already listening on " + this->socket_path);
+    // Replace the socket of a server that did not exit cleanly, but never another kind of file.
+    struct stat info;
+    if (lstat(socket_path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+        unlink(socket_path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw std::runtime_error(std::string("Could not create socket: ") + std::strerror(errno));
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+    {
+        std::string reason = std::strerror(errno);
+        close(fd);
+        throw std::runtime_error("Could not listen on " + socket_path + ": " + reason);
+    }
+    listen_fd = fd;
+    this->socket_path = socket_path;
+    stopping = false;
+}
+
+void SolverServer::ServeConnections()
+{
+    int fd_listen;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (listen_fd < 0)
+            throw std::runtime_error("The server is not listening");
+        fd_listen = listen_fd;
+    }
+    while (true)
+    {
+        int fd = accept(fd_listen, nullptr, nullptr);
+        if (fd < 0 && (errno == EINTR || errno == ECONNABORTED))
+            continue;
+        JoinConnections(false);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0 || stopping)
+        {
+            if (fd >= 0)
+                close(fd);
+            break;
+        }
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        connections.push_back({fd, std::thread([this, fd, finished] {
+            try
+            {
+                Serve(fd, fd);
+            }
+            catch (const std::runtime_error&)
+            {
+                // An invalid frame closes the connection; the requests before it were answered.
+            }
+            *finished = true;
+        }), finished});
+    }
+
+    // accept() only fails for good on Stop() or when the process runs out of resources: close the connections too.
+    Stop();
+    JoinConnections(true);
+    std::lock_guard<std::mutex> lock(mutex);
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    listen_fd = -1;
+    socket_path.clear();
+}
+
+void SolverServer::Stop()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+    // Wakes up accept() and the readers of the connections, which then answer the requests they have read.
+    if (listen_fd >= 0)
+        shutdown(listen_fd, SHUT_RDWR);
+    for (const Connection& connection : connections)
+        shutdown(connection.fd, SHUT_RD);
+}
+
+const MemoryProblemCache& SolverServer::GetCache() const
+{
+    return cache;
+}
+
+void SolverServer::JoinConnections(bool all)
+{
+    std::list<Connection> closed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = connections.begin(); it != connections.end();)
+        {
+            auto next = std::next(it);
+            if (all || *it->finished)
+                closed.splice(closed.end(), connections, it);
+            it = next;
+        }
+    }
+    for (Connection& connection : closed)
+    {
+        connection.thread.join();
+        close(connection.fd);
+    }
+}
@@ -0,0 +1,194 @@
+/**
+ * @file SolverServer.h
+ * @brief Defines the SolverServer class, a resident process solving the problems sent to it over a stream, and
+ * the functions reading and writing the frames of its protocol.
+ *
+ * A client sends requests and receives responses over a byte stream, such as a pipe to the standard input and
+ * output of the server or a connection to its Unix domain socket. Every frame starts with a little-endian header:
+ *
+ * | Offset | Type        | Request field                         | Response field                          |
+ * |--------|-------------|---------------------------------------|-----------------------------------------|
+ * | 0      | char[4]     | "ODEQ"                                | "ODER"                                  |
+ * | 4      | uint32      | The layout of the result (see TrajectoryLayout) | 0 if the problem was solved, 1 otherwise |
+ * | 8      | uint64      | An identifier chosen by the client    | The identifier of the request           |
+ * | 16     | uint64      | The number of bytes of the input      | The number of bytes of the result       |
+ * | 24     | char[]      | The input, in the format of ParseInputFile() | A trajectory file (see TrajectoryFile.h), or the error message |
+ *
+ * The requests of a stream are solved concurrently and their responses are written as they finish, so that a
+ * client with several requests in flight matches the responses by their identifier.
+ */
+
+#ifndef SOLVERSERVER_H
+#define SOLVERSERVER_H
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MemoryProblemCache.h"
+#include "ThreadPool.h"
+#include "TrajectoryFile.h"
+
+/**
+ * @brief A request to a SolverServer.
+ */
+struct ServerRequest
+{
+    std::uint64_t id = 0;  ///< The identifier of the request, returned with its response.
+    TrajectoryLayout layout = TIME_MAJOR;  ///< The layout of the trajectory returned.
+    std::string input;  ///< The problem, in the format of ParseInputFile().
+};
+
+/**
+ * @brief A response of a SolverServer.
+ */
+struct ServerResponse
+{
+    std::uint64_t id = 0;  ///< The identifier of the request.
+    bool success = false;  ///< Whether the problem was solved.
+    std::string payload;  ///< The solution as a trajectory file if the problem was solved, the error message otherwise.
+};
+
+/**
+ * @brief Writes a request frame.
+ * @param fd The file descriptor of the stream to the server.
+ * @param request The request.
+ * @throws std::runtime_error If the stream cannot be written.
+ */
+void WriteServerRequest(int fd, const ServerRequest& request);
+
+/**
+ * @brief Reads a request frame.
+ * @param fd The file descriptor of the stream from the client.
+ * @param request Set to the request.
+ * @return true if a request was read, false if the stream ended before its first byte.
+ * @throws std::runtime_error If the frame is truncated or invalid, or if its input is larger than 256 MiB.
+ */
+bool ReadServerRequest(int fd, ServerRequest& request);
+
+/**
+ * @brief Writes a response frame.
+ * @param fd The file descriptor of the stream to the client.
+ * @param response The response.
+ * @throws std::runtime_error If the stream cannot be written.
+ */
+void WriteServerResponse(int fd, const ServerResponse& response);
+
+/**
+ * @brief Reads a response frame.
+ * @param fd The file descriptor of the stream from the server.
+ * @param response Set to the response.
+ * @return true if a response was read, false if the stream ended before its first byte.
+ * @throws std::runtime_error If the frame is truncated or invalid.
+ */
+bool ReadServerResponse(int fd, ServerResponse& response);
+
+/**
+ * @brief A server that stays resident and solves the problems sent to it.
+ *
+ * Running the program once per problem pays for its start, for parsing the whole input file and for formatting
+ * the solution as text every time. The server pays for its start once, keeps the compiled systems of the
+ * problems it has seen in a MemoryProblemCache, so that a known system is not parsed again, and returns the
+ * solution in the binary trajectory format. The requests are solved on a ThreadPool, so that the requests of one
+ * stream, and of several connections, are solved concurrently.
+ */
+class SolverServer
+{
+public:
+    /**
+     * @brief Construct a new SolverServer object.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     * @param cache_size The number of compiled systems kept in memory.
+     * @throws std::invalid_argument If the number of compiled systems is zero.
+     */
+    explicit SolverServer(int num_threads = 0, std::size_t cache_size = 256);
+
+    /**
+     * @brief Stop the server and wait for its connections.
+     */
+    ~SolverServer();
+
+    SolverServer(const SolverServer&) = delete;
+    SolverServer& operator=(const SolverServer&) = delete;
+
+    /**
+     * @brief Solve the problem of a request on the calling thread.
+     * @param request The request.
+     * @return ServerResponse The solution, or the error message if the problem cannot be parsed or solved.
+     */
+    ServerResponse Handle(const ServerRequest& request) const;
+
+    /**
+     * @brief Answer the requests of a stream until it ends.
+     *
+     * The requests are read on the calling thread and solved on the worker threads, which write the responses.
+     * The function returns once the response of every request read has been written.
+     *
+     * @param in_fd The file descriptor the requests are read from.
+     * @param out_fd The file descriptor the responses are written to.
+     * @throws std::runtime_error If a request frame is invalid; the requests before it are still answered.
+     */
+    void Serve(int in_fd, int out_fd);
+
+    /**
+     * @brief Create a Unix domain socket and listen for connections on it.
+     * @param socket_path The path of the socket; a socket left at this path by a previous server is replaced.
+     * @throws std::runtime_error If the server is already listening or the socket cannot be created.
+     */
+    void Listen(const std::string& socket_path);
+
+    /**
+     * @brief Accept connections on the socket until Stop() is called, serving every connection on its own thread.
+     *
+     * The function returns once every connection has been served, and removes the socket.
+     *
+     * @throws std::runtime_error If Listen() was not called.
+     */
+    void ServeConnections();
+
+    /**
+     * @brief Stop accepting connections and stop reading the requests of the open ones.
+     *
+     * The requests already read are still answered. The function may be called from any thread.
+     */
+    void Stop();
+
+    /**
+     * @brief Get the cache of compiled systems.
+     * @return const MemoryProblemCache& The cache.
+     */
+    const MemoryProblemCache& GetCache() const;
+
+private:
+    /**
+     * @brief The thread serving a connection.
+     */
+    struct Connection
+    {
+        int fd;  ///< The socket of the connection.
+        std::thread thread;  ///< The thread serving it.
+        std::shared_ptr<std::atomic<bool>> finished;  ///< Set by the thread when the connection is closed.
+    };
+
+    MemoryProblemCache cache;  ///< The compiled systems of the problems seen so far.
+    ThreadPool pool;  ///< The worker threads solving the requests.
+    std::string socket_path;  ///< The path of the socket, empty if the server is not listening.
+    int listen_fd = -1;  ///< The listening socket, -1 if the server is not listening.
+    bool stopping = false;  ///< Whether Stop() was called.
+    std::list<Connection> connections;  ///< The connections that have not been joined yet.
+    std::mutex mutex;  ///< The mutex protecting the connections and the stop flag.
+
+    /**
+     * @brief Join the threads of the closed connections.
+     * @param all Whether to wait for the open connections too.
+     */
+    void JoinConnections(bool all);
+};
+
+#endif // SOLVERSERVER_H
@@ -0,0 +1,45 @@
+/**
+ * @file SystemCache.h
+ * @brief Defines the SystemCache interface, a cache of compiled systems consulted while parsing input files.
+ */
+
+#ifndef SYSTEMCACHE_H
+#define SYSTEMCACHE_H
+
+#pragma once
+
+struct InputParameters;
+
+/**
+ * @brief A cache of the compiled function and diffusion of systems, keyed by a hash of the sections of the
+ * input that define them (see ParseInputFile()).
+ *
+ * The parser calls Load() before parsing the system sections and Store() after parsing them on a miss. The
+ * methods may be called by several threads at the same time.
+ */
+class SystemCache
+{
+public:
+    virtual ~SystemCache() = default;
+
+    /**
+     * @brief Attach the compiled system of a key to parameters.
+     * @param key The hash of the sections that define the system.
+     * @param params The parameters, whose function and diffusion are set on a hit.
+     * @return true if the cache holds a valid system for the key, false otherwise.
+     */
+    virtual bool Load(unsigned long long key, InputParameters& params) const = 0;
+
+    /**
+     * @brief Compile the system of parsed parameters, attach it to them and add it to the cache.
+     *
+     * Nothing is stored if the system cannot be compiled: the error is then reported when the problem is solved.
+     *
+     * @param key The hash of the sections that define the system.
+     * @param params The parameters, whose function and diffusion are set if the system compiles.
+     * @return true if the system was added to the cache, false otherwise.
+     */
+    virtual bool Store(unsigned long long key, InputParameters& params) const = 0;
+};
+
+#endif // SYSTEMCACHE_H
@@ -0,0 +1,393 @@
+#include "TextWriter.h"
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+// Enough for a sign, 17 digits, a point, an exponent and the terminating zero.
+const std::size_t kMaxValueLength = 32;
+
+// Format a value with a number of significant digits, as %g does, and return the number of characters.
+int FormatValue(char* destination, double value, int digits)
+{
+    return std::snprintf(destination, kMaxValueLength, "%.*g", digits, value);
+}
+
+// The shortest round-trip digits are generated with the Grisu2 algorithm of Florian Loitsch ("Printing
+// floating-point numbers quickly and accurately with integers", PLDI 2010): the value and its rounding boundaries
+// are scaled by a cached power of ten into 64-bit integers, and digits are produced until the result is inside the
+// boundaries. The result always reads back to the same double, and is the shortest such string for nearly all values.
+
+// A floating-point number f * 2^e with a 64-bit significand.
+struct DiyFp
+{
+    std::uint64_t f;
+    int e;
+};
+
+const int kSignificandBits = 52;
+const std::uint64_t kHiddenBit = 1ULL << kSignificandBits;
+const int kExponentBias = 1023 + kSignificandBits;
+
+// The normalized significands and binary exponents of 10^-348, 10^-340, ..., 10^340.
+const std::uint64_t kCachedPowersF[] = {
+    0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76, 0xcf42894a5dce35ea,
+    0x9a6bb0aa55653b2d, 0xe61acf033d1a45df, 0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f,
+    0xbe5691ef416bd60c, 0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+    0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57, 0xc21094364dfb5637,
+    0x9096ea6f3848984f, 0xd77485cb25823ac7, 0xa086cfcd97bf97f4, 0xef340a98172aace5,
+    0xb23867fb2a35b28e, 0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+    0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126, 0xb5b5ada8aaff80b8,
+    0x87625f056c7c4a8b, 0xc9bcff6034c13053, 0x964e858c91ba2655, 0xdff9772470297ebd,
+    0xa6dfbd9fb8e5b88f, 0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+    0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06, 0xaa242499697392d3,
+    0xfd87b5f28300ca0e, 0xbce5086492111aeb, 0x8cbccc096f5088cc, 0xd1b71758e219652c,
+    0x9c40000000000000, 0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+    0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068, 0x9f4f2726179a2245,
+    0xed63a231d4c4fb27, 0xb0de65388cc8ada8, 0x83c7088e1aab65db, 0xc45d1df942711d9a,
+    0x924d692ca61be758, 0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+    0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d, 0x952ab45cfa97a0b3,
+    0xde469fbd99a05fe3, 0xa59bc234db398c25, 0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece,
+    0x88fcf317f22241e2, 0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+    0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410, 0x8bab8eefb6409c1a,
+    0xd01fef10a657842c, 0x9b10a4e5e9913129, 0xe7109bfba19c0c9d, 0xac2820d9623bf429,
+    0x80444b5e7aa7cf85, 0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+    0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b
+};
+const int kCachedPowersE[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066
+};
+
+const std::uint64_t kPowersOfTen[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+DiyFp Multiply(const DiyFp& x, const DiyFp& y)
+{
+    const std::uint64_t mask = 0xFFFFFFFFULL;
+    std::uint64_t a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+    std::uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    std::uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + (1ULL << 31);
+    return {ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64};
+}
+
+DiyFp Normalize(DiyFp x)
+{
+    while (!(x.f & (1ULL << 63)))
+    {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+int CountDigits(std::uint32_t n)
+{
+    int digits = 1;
+    while (digits < 10 && n >= kPowersOfTen[digits])
+    {
+        digits++;
+    }
+    return digits;
+}
+
+void GrisuRound(char* buffer, int length, std::uint64_t delta, std::uint64_t rest, std::uint64_t ten_kappa, std::uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+    {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+// Generate the digits of w, within delta of the upper boundary mp; k receives the decimal exponent of the last digit.
+void GenerateDigits(const DiyFp& w, const DiyFp& mp, std::uint64_t delta, char* buffer, int& length, int& k)
+{
+    const DiyFp one = {1ULL << -mp.e, mp.e};
+    const std::uint64_t wp_w = mp.f - w.f;
+    std::uint32_t p1 = (std::uint32_t)(mp.f >> -one.e);
+    std::uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = CountDigits(p1);
+    length = 0;
+    while (kappa > 0)
+    {
+        std::uint32_t divisor = (std::uint32_t)kPowersOfTen[kappa - 1];
+        std::uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+        if (digit || length)
+            buffer[length++] = (char)('0' + digit);
+        kappa--;
+        std::uint64_t rest = ((std::uint64_t)p1 << -one.e) + p2;
+        if (rest <= delta)
+        {
+            k += kappa;
+            GrisuRound(buffer, length, delta, rest, kPowersOfTen[kappa] << -one.e, wp_w);
+            return;
+        }
+    }
+    for (;;)
+    {
+        p2 *= 10;
+        delta *= 10;
+        char digit = (char)(p2 >> -one.e);
+        if (digit || length)
+            buffer[length++] = (char)('0' + digit);
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta)
+        {
+            k += kappa;
+            int index = -kappa;
+            GrisuRound(buffer, length, delta, p2, one.f, wp_w * (index < 20 ? kPowersOfTen[index] : 0));
+            return;
+        }
+    }
+}
+
+// The shortest digits of a finite positive value, and the decimal exponent of the last digit.
+void Grisu2(double value, char* buffer, int& length, int& k)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    int biased_exponent = (int)((bits >> kSignificandBits) & 0x7FF);
+    std::uint64_t significand = bits & (kHiddenBit - 1);
+    DiyFp v = biased_exponent ? DiyFp{significand + kHiddenBit, biased_exponent - kExponentBias} : DiyFp{significand, 1 - kExponentBias};
+
+    // The boundaries halfway to the neighbouring doubles, with the upper one normalized.
+    DiyFp plus = {(v.f << 1) + 1, v.e - 1};
+    while (!(plus.f & (kHiddenBit << 1)))
+    {
+        plus.f <<= 1;
+        plus.e--;
+    }
+    plus.f <<= 64 - kSignificandBits - 2;
+    plus.e -= 64 - kSignificandBits - 2;
+    DiyFp minus = (v.f == kHiddenBit) ? DiyFp{(v.f << 2) - 1, v.e - 2} : DiyFp{(v.f << 1) - 1, v.e - 1};
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    // Scale by a cached power of ten that brings the exponent of the upper boundary into [-60, -32].
+    double dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+    int cached = (int)dk;
+    if (dk - cached > 0.0)
+        cached++;
+    int index = (cached >> 3) + 1;
+    k = -(-348 + index * 8);
+    DiyFp power = {kCachedPowersF[index], kCachedPowersE[index]};
+
+    DiyFp w = Multiply(Normalize(v), power);
+    DiyFp w_plus = Multiply(plus, power);
+    DiyFp w_minus = Multiply(minus, power);
+    w_minus.f++;
+    w_plus.f--;
+    GenerateDigits(w, w_plus, w_plus.f - w_minus.f, buffer, length, k);
+}
+
+void AppendExponent(char* destination, int& position, int exponent)
+{
+    destination[position++] = 'e';
+    destination[position++] = exponent < 0 ? '-' : '+';
+    exponent = std::abs(exponent);
+    if (exponent >= 100)
+    {
+        destination[position++] = (char)('0' + exponent / 100);
+        exponent %= 100;
+    }
+    destination[position++] = (char)('0' + exponent / 10);
+    destination[position++] = (char)('0' + exponent % 10);
+}
+
+// Write the shortest round-trip representation, in the notation %g would choose with 17 digits.
+int FormatShortest(char* destination, double value)
+{
+    if (!std::isfinite(value))
+        return std::snprintf(destination, kMaxValueLength, "%g", value);
+    int position = 0;
+    if (std::signbit(value))
+    {
+        destination[position++] = '-';
+        value = -value;
+    }
+    if (value == 0.0)
+    {
+        destination[position++] = '0';
+        return position;
+    }
+
+    char digits[24];
+    int length, k;
+    Grisu2(value, digits, length, k);
+    int exponent = length + k - 1;
+    if (exponent < -4 || exponent >= 17)
+    {
+        destination[position++] = digits[0];
+        if (length > 1)
+        {
+            destination[position++] = '.';
+            std::memcpy(destination + position, digits + 1, length - 1);
+            position += length - 1;
+        }
+        AppendExponent(destination, position, exponent);
+    }
+    else if (exponent >= length - 1)
+    {
+        std::memcpy(destination + position, digits, length);
+        position += length;
+        std::memset(destination + position, '0', exponent - length + 1);
+        position += exponent - length + 1;
+    }
+    else if (exponent >= 0)
+    {
+        std::memcpy(destination + position, digits, exponent + 1);
+        position += exponent + 1;
+        destination[position++] = '.';
+        std::memcpy(destination + position, digits + exponent + 1, length - exponent - 1);
+        position += length - exponent - 1;
+    }
+    else
+    {
+        destination[position++] = '0';
+        destination[position++] = '.';
+        std::memset(destination + position, '0', -exponent - 1);
+        position += -exponent - 1;
+        std::memcpy(destination + position, digits, length);
+        position += length;
+    }
+    return position;
+}
+}
+
+TextWriter::TextWriter(std::ostream& out, std::size_t buffer_size) : out(out)
+{
+    if (buffer_size < 2 * kMaxValueLength)
+        throw std::invalid_argument("The buffer must hold at least " + std::to_string(2 * kMaxValueLength) + " bytes");
+    buffer.resize(buffer_size);
+    locale_point = *std::localeconv()->decimal_point;
+}
+
+TextWriter::~TextWriter()
+{
+    try
+    {
+        Flush();
+    }
+    catch (...)
+    {
+        // A destructor must not throw; call Flush() to see write errors.
+    }
+}
+
+void TextWriter::SetPrecision(int digits)
+{
+    if (digits < 0 || digits > 17)
+        throw std::invalid_argument("The precision must be between 0 and 17 digits");
+    precision = digits;
+}
+
+void TextWriter::SetDelimiter(const std::string& delimiter)
+{
+    this->delimiter = delimiter;
+}
+
+const std::string& TextWriter::GetDelimiter() const
+{
+    return delimiter;
+}
+
+void TextWriter::Write(double value)
+{
+    Reserve(kMaxValueLength);
+    char* destination = buffer.data() + used;
+    int length;
+    if (precision > 0)
+    {
+        length = FormatValue(destination, value, precision);
+        if (locale_point != '.')
+        {
+            char* point = static_cast<char*>(std::memchr(destination, locale_point, length));
+            if (point)
+                *point = '.';
+        }
+    }
+    else
+    {
+        length = FormatShortest(destination, value);
+    }
+    used += length;
+}
+
+void TextWriter::Write(const std::string& text)
+{
+    if (text.size() > buffer.size())
+    {
+        Drain();
+        out.write(text.data(), text.size());
+        return;
+    }
+    Reserve(text.size());
+    std::memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+}
+
+void TextWriter::WriteValues(const Eigen::VectorXd& values)
+{
+    for (int i = 0; i < values.size(); i++)
+    {
+        if (i > 0)
+            Write(delimiter);
+        Write(values(i));
+    }
+}
+
+void TextWriter::WriteRow(const Eigen::VectorXd& values)
+{
+    WriteValues(values);
+    Reserve(1);
+    buffer[used++] = '\n';
+}
+
+void TextWriter::WriteRow(double time, const Eigen::VectorXd& values)
+{
+    Write(time);
+    if (values.size() > 0)
+        Write(delimiter);
+    WriteRow(values);
+}
+
+void TextWriter::Flush()
+{
+    Drain();
+    out.flush();
+    if (!out)
+        throw std::runtime_error("Could not write the text output");
+}
+
+void TextWriter::Drain()
+{
+    if (used > 0)
+        out.write(buffer.data(), used);
+    used = 0;
+    if (!out)
+        throw std::runtime_error("Could not write the text output");
+}
+
+void TextWriter::Reserve(std::size_t bytes)
+{
+    if (used + bytes > buffer.size())
+        Drain();
+}
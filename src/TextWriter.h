@@ -0,0 +1,124 @@
+/**
+ * @file TextWriter.h
+ * @brief Defines the TextWriter class for fast, buffered text output of floating-point values.
+ */
+
+#ifndef TEXTWRITER_H
+#define TEXTWRITER_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A class for writing floating-point values as text through a large buffer.
+ *
+ * The values are formatted into a buffer that is handed to the stream in one write when it is full, instead of
+ * going through the formatting and flushing of the stream for every value. The output does not depend on the
+ * locale: the decimal separator is always a point.
+ *
+ * By default every value is written with as few significant digits as needed to read it back to the same double,
+ * generated with integer arithmetic by the Grisu2 algorithm and laid out as %g would with 17 digits. A fixed
+ * number of significant digits can be chosen instead with SetPrecision(); those values are formatted by the C
+ * library, which is slower.
+ */
+class TextWriter
+{
+public:
+    /**
+     * @brief Construct a new TextWriter object.
+     * @param out The stream to write to, which must outlive the writer.
+     * @param buffer_size The number of bytes buffered before a write to the stream.
+     * @throws std::invalid_argument If the buffer size is smaller than 64 bytes.
+     */
+    explicit TextWriter(std::ostream& out, std::size_t buffer_size = 1 << 20);
+
+    /**
+     * @brief Flush the buffer and destroy the TextWriter object.
+     */
+    ~TextWriter();
+
+    TextWriter(const TextWriter&) = delete;
+    TextWriter& operator=(const TextWriter&) = delete;
+
+    /**
+     * @brief Set the number of significant digits of the values.
+     * @param digits The number of significant digits, from 1 to 17, or zero for the shortest round-trip representation.
+     * @throws std::invalid_argument If the number is out of range.
+     */
+    void SetPrecision(int digits);
+
+    /**
+     * @brief Set the text written between two values of a row.
+     * @param delimiter The delimiter, a comma by default.
+     */
+    void SetDelimiter(const std::string& delimiter);
+
+    /**
+     * @brief Get the text written between two values of a row.
+     * @return const std::string& The delimiter.
+     */
+    const std::string& GetDelimiter() const;
+
+    /**
+     * @brief Write one value.
+     * @param value The value.
+     */
+    void Write(double value);
+
+    /**
+     * @brief Write some text as is.
+     * @param text The text.
+     */
+    void Write(const std::string& text);
+
+    /**
+     * @brief Write values separated by the delimiter, without ending the line.
+     * @param values The values.
+     */
+    void WriteValues(const Eigen::VectorXd& values);
+
+    /**
+     * @brief Write one line of values separated by the delimiter.
+     * @param values The values.
+     */
+    void WriteRow(const Eigen::VectorXd& values);
+
+    /**
+     * @brief Write one line with a time column followed by values, all separated by the delimiter.
+     * @param time The time.
+     * @param values The values at that time.
+     */
+    void WriteRow(double time, const Eigen::VectorXd& values);
+
+    /**
+     * @brief Hand the buffered text to the stream and flush it.
+     * @throws std::runtime_error If the stream cannot be written.
+     */
+    void Flush();
+
+private:
+    std::ostream& out;  ///< The stream to write to.
+    std::vector<char> buffer;  ///< The buffered text.
+    std::size_t used = 0;  ///< The number of bytes of the buffer in use.
+    int precision = 0;  ///< The number of significant digits, zero for the shortest round-trip representation.
+    std::string delimiter = ",";  ///< The text between two values of a row.
+    char locale_point;  ///< The decimal separator of the C locale, replaced by a point.
+
+    /**
+     * @brief Hand the buffered text to the stream, without flushing the stream.
+     * @throws std::runtime_error If the stream cannot be written.
+     */
+    void Drain();
+
+    /**
+     * @brief Make room in the buffer.
+     * @param bytes The number of bytes needed.
+     */
+    void Reserve(std::size_t bytes);
+};
+
+#endif
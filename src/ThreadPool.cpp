@@ -0,0 +1,185 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace
+{
+// The pool and the index of the worker running on this thread, if any.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local int current_worker = -1;
+}
+
+ThreadPool::ThreadPool(int num_threads)
+{
+    if (num_threads <= 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 0; i < num_threads; i++)
+    {
+        queues.emplace_back(new WorkerQueue);
+    }
+    for (int i = 0; i < num_threads; i++)
+    {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    Wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int ThreadPool::GetNumThreads() const
+{
+    return workers.size();
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    int index = (current_pool == this) ? current_worker : next_queue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        active_tasks++;
+        unclaimed_tasks++;
+    }
+    task_available.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    all_done.wait(lock, [this] { return active_tasks == 0; });
+}
+
+void ThreadPool::ParallelFor(int begin, int end, const std::function<void(int, int)>& body, int grain)
+{
+    if (end <= begin)
+        return;
+    if (grain <= 0)
+        grain = std::max(1, (end - begin) / (4 * GetNumThreads()));
+    TaskGroup group;
+    group.remaining = (end - begin + grain - 1) / grain;
+    for (int chunk = begin; chunk < end; chunk += grain)
+    {
+        int chunk_end = std::min(end, chunk + grain);
+        Enqueue([this, &body, &group, chunk, chunk_end] {
+            std::exception_ptr error;
+            try
+            {
+                body(chunk, chunk_end);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error && !group.error)
+                group.error = error;
+            if (--group.remaining == 0)
+            {
+                group_done.notify_all();
+                // A worker waiting for its own chunks waits for new tasks as well.
+                task_available.notify_all();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (current_pool == this)
+    {
+        // Blocking a worker could leave no thread to run the chunks, so help with the queued tasks instead.
+        while (group.remaining > 0)
+        {
+            if (unclaimed_tasks > 0)
+            {
+                unclaimed_tasks--;
+                lock.unlock();
+                RunTask(TakeTask(current_worker));
+                lock.lock();
+            }
+            else
+            {
+                task_available.wait(lock);
+            }
+        }
+    }
+    else
+    {
+        group_done.wait(lock, [&group] { return group.remaining == 0; });
+    }
+    if (group.error)
+        std::rethrow_exception(group.error);
+}
+
+std::function<void()> ThreadPool::TakeTask(int index)
+{
+    // The caller has claimed a task, so one is in some queue even if another worker got to this one first.
+    int num_queues = queues.size();
+    while (true)
+    {
+        for (int k = 0; k < num_queues; k++)
+        {
+            WorkerQueue& queue = *queues[(index + k) % num_queues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            std::function<void()> task;
+            if (k == 0)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            return task;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void ThreadPool::WorkerLoop(int index)
+{
+    current_pool = this;
+    current_worker = index;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task_available.wait(lock, [this] { return stopping || unclaimed_tasks > 0; });
+            if (stopping && unclaimed_tasks == 0)
+                return;
+            unclaimed_tasks--;
+        }
+        RunTask(TakeTask(index));
+    }
+}
+
+void ThreadPool::RunTask(const std::function<void()>& task)
+{
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+        // Tasks handle their own errors; an escaped exception must not terminate the worker.
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    active_tasks--;
+    if (active_tasks == 0)
+        all_done.notify_all();
+}
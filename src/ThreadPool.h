@@ -0,0 +1,131 @@
+/**
+ * @file ThreadPool.h
+ * @brief Defines the ThreadPool class for running independent tasks on a fixed set of worker threads.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed-size pool of worker threads with work stealing.
+ *
+ * Every worker owns a queue of tasks. Tasks queued with Enqueue() from outside the pool are dealt to the queues
+ * in turn, and tasks queued by a running task go to the queue of its worker. A worker runs the newest task of
+ * its own queue and, once that queue is empty, steals the oldest task of another one, so that uneven tasks do not
+ * leave workers idle. Wait() blocks until every queued task has finished. ParallelFor() splits a range of indices
+ * into chunks, so that the cost of queueing stays small compared to the work when the range is large.
+ *
+ * ParallelFor() waits only for its own chunks, so that callers sharing the pool do not wait for each other, and
+ * rethrows the first exception thrown by one of them. When it is called from a task of the same pool, the worker
+ * runs queued tasks while it waits instead of blocking. An exception thrown by a task queued with Enqueue() is not
+ * propagated: such tasks are expected to handle their own errors.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Construct a new ThreadPool object.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     */
+    explicit ThreadPool(int num_threads = 0);
+
+    /**
+     * @brief Wait for the queued tasks and stop the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Get the number of worker threads.
+     * @return int The number of worker threads.
+     */
+    int GetNumThreads() const;
+
+    /**
+     * @brief Queue a task.
+     * @param task The task to run on a worker thread.
+     */
+    void Enqueue(std::function<void()> task);
+
+    /**
+     * @brief Block until every queued task has finished.
+     */
+    void Wait();
+
+    /**
+     * @brief Run a function on every index of a range and wait for the result.
+     *
+     * Returns once every chunk has run, even when one of them throws.
+     *
+     * @param begin The first index.
+     * @param end One past the last index.
+     * @param body The function to run, called with the first and one past the last index of a chunk.
+     * @param grain The number of indices per chunk, or zero to make about four chunks per worker.
+     * @throws The first exception thrown by a chunk.
+     */
+    void ParallelFor(int begin, int end, const std::function<void(int, int)>& body, int grain = 0);
+
+private:
+    /**
+     * @brief The queue of tasks owned by one worker.
+     */
+    struct WorkerQueue
+    {
+        std::mutex mutex;  ///< The mutex protecting the tasks.
+        std::deque<std::function<void()>> tasks;  ///< The tasks, the newest at the back.
+    };
+
+    /**
+     * @brief The chunks of one call to ParallelFor(), protected by the mutex of the pool.
+     */
+    struct TaskGroup
+    {
+        int remaining = 0;  ///< The number of chunks that have not finished.
+        std::exception_ptr error;  ///< The first exception thrown by a chunk.
+    };
+
+    std::vector<std::thread> workers;  ///< The worker threads.
+    std::vector<std::unique_ptr<WorkerQueue>> queues;  ///< The queue of every worker.
+    std::atomic<unsigned> next_queue{0};  ///< The queue receiving the next task queued from outside the pool.
+    std::mutex mutex;  ///< The mutex protecting the counters.
+    std::condition_variable task_available;  ///< Signaled when a task is queued or the pool stops.
+    std::condition_variable all_done;  ///< Signaled when the last running task finishes.
+    std::condition_variable group_done;  ///< Signaled when the last chunk of a ParallelFor() finishes.
+    int active_tasks = 0;  ///< The number of queued or running tasks.
+    int unclaimed_tasks = 0;  ///< The number of queued tasks that no worker has claimed yet.
+    bool stopping = false;  ///< Whether the workers should exit.
+
+    /**
+     * @brief The loop run by every worker thread.
+     * @param index The index of the worker.
+     */
+    void WorkerLoop(int index);
+
+    /**
+     * @brief Run a claimed task and count it as finished.
+     * @param task The task.
+     */
+    void RunTask(const std::function<void()>& task);
+
+    /**
+     * @brief Take a task, from the back of the worker's own queue or else from the front of another queue.
+     * @param index The index of the worker.
+     * @return std::function<void()> The task.
+     */
+    std::function<void()> TakeTask(int index);
+};
+
+#endif
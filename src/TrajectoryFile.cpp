@@ -0,0 +1,226 @@
+#include "TrajectoryFile.h"
+#include <algorithm>
+#include "CompressedTrajectory.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+const char kMagic[8] = {'O', 'D', 'E', 'T', 'R', 'A', 'J', '\0'};
+const std::uint32_t kVersion = 1;
+const std::uint64_t kFixedHeaderSize = 88;
+
+// The number of values converted at once on big-endian hosts.
+const std::size_t kSwapBlock = 4096;
+
+void AppendLittleEndian(std::vector<char>& buffer, std::uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        buffer.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+}
+
+void AppendDouble(std::vector<char>& buffer, double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    AppendLittleEndian(buffer, bits, 8);
+}
+
+std::uint64_t LoadLittleEndian(const char* bytes, int count)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < count; i++)
+    {
+        value |= (std::uint64_t)(unsigned char)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+double LoadDouble(const char* bytes)
+{
+    std::uint64_t bits = LoadLittleEndian(bytes, 8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::uint64_t SwapBytes(std::uint64_t value)
+{
+    std::uint64_t swapped = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        swapped = (swapped << 8) | ((value >> (8 * i)) & 0xff);
+    }
+    return swapped;
+}
+
+// Reverse the bytes of every value in place, which converts between the host order and little-endian on big-endian hosts.
+void SwapDoubles(double* values, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        bits = SwapBytes(bits);
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+}
+
+// Write an array of doubles as little-endian values, in one call on little-endian hosts.
+void WriteDoubles(std::ostream& out, const double* values, std::size_t count)
+{
+    if (IsLittleEndianHost())
+    {
+        out.write(reinterpret_cast<const char*>(values), count * sizeof(double));
+        return;
+    }
+    std::vector<double> block;
+    for (std::size_t first = 0; first < count; first += kSwapBlock)
+    {
+        block.assign(values + first, values + std::min(count, first + kSwapBlock));
+        SwapDoubles(block.data(), block.size());
+        out.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(double));
+    }
+}
+
+std::uint64_t PaddedLength(std::uint64_t length)
+{
+    return (length + 7) / 8 * 8;
+}
+}
+
+bool IsLittleEndianHost()
+{
+    const std::uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+void WriteTrajectoryHeader(std::ostream& out, TrajectoryHeader& header)
+{
+    header.data_offset = kFixedHeaderSize + PaddedLength(header.method.size());
+
+    std::vector<char> buffer(kMagic, kMagic + sizeof(kMagic));
+    AppendLittleEndian(buffer, kVersion, 4);
+    AppendLittleEndian(buffer, header.layout, 4);
+    AppendLittleEndian(buffer, header.dimension, 8);
+    AppendLittleEndian(buffer, header.num_points, 8);
+    AppendDouble(buffer, header.initial_time);
+    AppendDouble(buffer, header.final_time);
+    AppendDouble(buffer, header.step_size);
+    AppendDouble(buffer, header.rel_tol);
+    AppendDouble(buffer, header.abs_tol);
+    AppendLittleEndian(buffer, header.data_offset, 8);
+    AppendLittleEndian(buffer, header.method.size(), 8);
+    buffer.insert(buffer.end(), header.method.begin(), header.method.end());
+    buffer.resize(header.data_offset, '\0');
+    out.write(buffer.data(), buffer.size());
+}
+
+void WriteTrajectory(std::ostream& out, const Eigen::MatrixXd& results, TrajectoryHeader header)
+{
+    header.dimension = results.rows();
+    header.num_points = results.cols();
+    WriteTrajectoryHeader(out, header);
+
+    if (header.layout == TIME_MAJOR)
+    {
+        WriteDoubles(out, results.data(), results.size());
+    }
+    else if (header.layout == XOR_COMPRESSED)
+    {
+        WriteCompressedValues(out, results);
+    }
+    else
+    {
+        Eigen::VectorXd series(results.cols());
+        for (int i = 0; i < results.rows(); i++)
+        {
+            series = results.row(i).transpose();
+            WriteDoubles(out, series.data(), series.size());
+        }
+    }
+    if (!out)
+        throw std::runtime_error("Could not write the trajectory");
+}
+
+void WriteTrajectory(const std::string& filename, const Eigen::MatrixXd& results, const TrajectoryHeader& header)
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("Could not open file: " + filename);
+    WriteTrajectory(out, results, header);
+    out.close();
+    if (!out)
+        throw std::runtime_error("Could not write file: " + filename);
+}
+
+TrajectoryHeader ReadTrajectoryHeader(std::istream& in)
+{
+    char fixed[kFixedHeaderSize];
+    if (!in.read(fixed, sizeof(fixed)) || std::memcmp(fixed, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("Not a trajectory file");
+    std::uint32_t version = LoadLittleEndian(fixed + 8, 4);
+    if (version != kVersion)
+        throw std::runtime_error("Unsupported trajectory file version: " + std::to_string(version));
+    std::uint32_t layout = LoadLittleEndian(fixed + 12, 4);
+    if (layout != TIME_MAJOR && layout != COMPONENT_MAJOR && layout != XOR_COMPRESSED)
+        throw std::runtime_error("Invalid trajectory layout: " + std::to_string(layout));
+
+    TrajectoryHeader header;
+    header.layout = (TrajectoryLayout)layout;
+    header.dimension = LoadLittleEndian(fixed + 16, 8);
+    header.num_points = LoadLittleEndian(fixed + 24, 8);
+    header.initial_time = LoadDouble(fixed + 32);
+    header.final_time = LoadDouble(fixed + 40);
+    header.step_size = LoadDouble(fixed + 48);
+    header.rel_tol = LoadDouble(fixed + 56);
+    header.abs_tol = LoadDouble(fixed + 64);
+    header.data_offset = LoadLittleEndian(fixed + 72, 8);
+    std::uint64_t method_length = LoadLittleEndian(fixed + 80, 8);
+    if (header.data_offset != kFixedHeaderSize + PaddedLength(method_length))
+        throw std::runtime_error("Invalid trajectory header");
+
+    std::vector<char> method(header.data_offset - kFixedHeaderSize);
+    if (!in.read(method.data(), method.size()))
+        throw std::runtime_error("Truncated trajectory header");
+    header.method.assign(method.data(), method_length);
+    return header;
+}
+
+Eigen::MatrixXd ReadTrajectory(const std::string& filename, TrajectoryHeader& header)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+        throw std::runtime_error("Could not open file: " + filename);
+    try
+    {
+        return ReadTrajectory(in, header);
+    }
+    catch (const std::runtime_error& e)
+    {
+        throw std::runtime_error(std::string(e.what()) + ": " + filename);
+    }
+}
+
+Eigen::MatrixXd ReadTrajectory(std::istream& in, TrajectoryHeader& header)
+{
+    header = ReadTrajectoryHeader(in);
+    if (header.layout == XOR_COMPRESSED)
+        return ReadCompressedValues(in, header);
+
+    Eigen::MatrixXd values(header.layout == TIME_MAJOR ? header.dimension : header.num_points,
+                           header.layout == TIME_MAJOR ? header.num_points : header.dimension);
+    if (!in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double)))
+        throw std::runtime_error("Truncated trajectory file");
+    if (!IsLittleEndianHost())
+        SwapDoubles(values.data(), values.size());
+    if (header.layout == TIME_MAJOR)
+        return values;
+    return values.transpose();
+}
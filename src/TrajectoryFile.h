@@ -0,0 +1,137 @@
+/**
+ * @file TrajectoryFile.h
+ * @brief Declares the binary trajectory file format and the functions writing and reading it.
+ *
+ * A trajectory file starts with a self-describing header, followed by the values of the solution as raw
+ * little-endian doubles. All the fields of the header are little-endian:
+ *
+ * | Offset | Type        | Field                                           |
+ * |--------|-------------|-------------------------------------------------|
+ * | 0      | char[8]     | The magic string "ODETRAJ" and a zero byte      |
+ * | 8      | uint32      | The version of the format, currently 1          |
+ * | 12     | uint32      | The layout: 0 for time-major, 1 for component-major, 2 for compressed |
+ * | 16     | uint64      | The dimension of the problem                    |
+ * | 24     | uint64      | The number of time points                       |
+ * | 32     | double      | The initial time                                |
+ * | 40     | double      | The final time                                  |
+ * | 48     | double      | The step size                                   |
+ * | 56     | double      | The relative tolerance                          |
+ * | 64     | double      | The absolute tolerance                          |
+ * | 72     | uint64      | The offset of the values from the start of the file |
+ * | 80     | uint64      | The length of the method name                   |
+ * | 88     | char[]      | The method name, zero-padded to a multiple of 8 bytes |
+ *
+ * The offset of the values is a multiple of 8, so a mapped file can be read in place as an array of doubles.
+ * Compressed files hold blocks of encoded values instead (see CompressedTrajectory.h), and cannot be mapped.
+ */
+
+#ifndef TRAJECTORYFILE_H
+#define TRAJECTORYFILE_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief An enumeration for the order of the values in a trajectory file.
+ *
+ * TIME_MAJOR stores the whole state at the first time point, then at the second one, and so on: this is the
+ * column-major order of the results of Solve(). COMPONENT_MAJOR stores the whole time series of the first
+ * variable, then of the second one, and so on. XOR_COMPRESSED stores blocks of time points, in which the time
+ * series of every variable is encoded losslessly by XOR with a prediction (see CompressedTrajectory.h).
+ */
+enum TrajectoryLayout { TIME_MAJOR, COMPONENT_MAJOR, XOR_COMPRESSED };
+
+/**
+ * @brief The header of a trajectory file.
+ */
+struct TrajectoryHeader
+{
+    std::uint64_t dimension = 0;  ///< The dimension of the problem.
+    std::uint64_t num_points = 0;  ///< The number of time points.
+    double initial_time = 0.0;  ///< The initial time.
+    double final_time = 0.0;  ///< The final time.
+    double step_size = 0.0;  ///< The step size between two time points.
+    double rel_tol = 1e-6;  ///< The relative tolerance of the solver.
+    double abs_tol = 1e-6;  ///< The absolute tolerance of the solver.
+    std::string method;  ///< The name of the method.
+    TrajectoryLayout layout = TIME_MAJOR;  ///< The order of the values.
+    std::uint64_t data_offset = 0;  ///< The offset of the values from the start of the file.
+};
+
+/**
+ * @brief Checks whether the host stores numbers in little-endian byte order.
+ *
+ * On such hosts the values of a trajectory file are the in-memory representation of doubles.
+ *
+ * @return true if the host is little-endian, false otherwise.
+ */
+bool IsLittleEndianHost();
+
+/**
+ * @brief Writes the header of a trajectory file.
+ *
+ * @param out The binary stream to write to, at the start of the file.
+ * @param header The header; its data offset is set from the length of the method name.
+ */
+void WriteTrajectoryHeader(std::ostream& out, TrajectoryHeader& header);
+
+/**
+ * @brief Writes a solution in the binary trajectory format.
+ *
+ * The values are written in large blocks, without formatting, so that writing is limited by the bandwidth of
+ * the stream.
+ *
+ * @param out The binary stream to write to.
+ * @param results The solution, one row per variable and one column per time point.
+ * @param header The description of the solution; its dimension, number of time points and data offset are
+ *               taken from the results and the method name.
+ * @throws std::runtime_error If the stream cannot be written.
+ */
+void WriteTrajectory(std::ostream& out, const Eigen::MatrixXd& results, TrajectoryHeader header);
+
+/**
+ * @brief Writes a solution to a file in the binary trajectory format.
+ *
+ * @param filename The name of the file, which is replaced if it exists.
+ * @param results The solution, one row per variable and one column per time point.
+ * @param header The description of the solution (see WriteTrajectory(std::ostream&, const Eigen::MatrixXd&, TrajectoryHeader)).
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void WriteTrajectory(const std::string& filename, const Eigen::MatrixXd& results, const TrajectoryHeader& header);
+
+/**
+ * @brief Reads the header of a trajectory file.
+ *
+ * The stream is left at the end of the header, which is the start of the values.
+ *
+ * @param in The binary stream to read from, at the start of the file.
+ * @return TrajectoryHeader The header.
+ * @throws std::runtime_error If the stream does not start with a valid header.
+ */
+TrajectoryHeader ReadTrajectoryHeader(std::istream& in);
+
+/**
+ * @brief Reads a trajectory file.
+ *
+ * @param filename The name of the file.
+ * @param header Set to the header of the file.
+ * @return Eigen::MatrixXd The solution, one row per variable and one column per time point, whatever the layout of the file.
+ * @throws std::runtime_error If the file cannot be opened, has an invalid header or is truncated.
+ */
+Eigen::MatrixXd ReadTrajectory(const std::string& filename, TrajectoryHeader& header);
+
+/**
+ * @brief Reads a trajectory from a stream, such as a response of a SolverServer.
+ *
+ * @param in The binary stream to read from, at the start of the trajectory.
+ * @param header Set to the header of the trajectory.
+ * @return Eigen::MatrixXd The solution, one row per variable and one column per time point, whatever the layout.
+ * @throws std::runtime_error If the stream has an invalid header or is truncated.
+ */
+Eigen::MatrixXd ReadTrajectory(std::istream& in, TrajectoryHeader& header);
+
+#endif // TRAJECTORYFILE_H
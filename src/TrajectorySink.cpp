@@ -0,0 +1,64 @@
+#include "TrajectorySink.h"
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+TrajectorySink::~TrajectorySink()
+{
+
+}
+
+void TrajectorySink::Flush()
+{
+
+}
+
+void MatrixSink::Begin(int dimension, long num_points)
+{
+    results.resize(dimension, num_points);
+    count = 0;
+}
+
+void MatrixSink::Append(const Eigen::VectorXd& y)
+{
+    if (count >= results.cols())
+        throw std::out_of_range("More time points appended than announced");
+    results.col(count++) = y;
+}
+
+void MatrixSink::End()
+{
+    // A solve stopped by an event appends fewer points than announced.
+    results.conservativeResize(Eigen::NoChange, count);
+}
+
+Eigen::MatrixXd MatrixSink::Release()
+{
+    count = 0;
+    return std::move(results);
+}
+
+BlockSink::BlockSink(Eigen::MatrixXd& target, long first_col, long num_cols) : target(target), first_col(first_col), num_cols(num_cols)
+{
+
+}
+
+void BlockSink::Begin(int dimension, long num_points)
+{
+    if (dimension != target.rows() || num_points > num_cols)
+        throw std::invalid_argument("The solution does not fit in a block of " + std::to_string(target.rows()) + " rows and " + std::to_string(num_cols) + " columns");
+    count = 0;
+}
+
+void BlockSink::Append(const Eigen::VectorXd& y)
+{
+    if (count >= num_cols)
+        throw std::out_of_range("More time points appended than the block holds");
+    target.col(first_col + count++) = y;
+}
+
+void BlockSink::End()
+{
+    target.middleCols(first_col + count, num_cols - count).setConstant(std::numeric_limits<double>::quiet_NaN());
+}
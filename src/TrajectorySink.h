@@ -0,0 +1,132 @@
+/**
+ * @file TrajectorySink.h
+ * @brief Defines the TrajectorySink interface, which receives the solution of a solver one time point at a time.
+ */
+
+#ifndef TRAJECTORYSINK_H
+#define TRAJECTORYSINK_H
+
+#pragma once
+#include <Eigen/Dense>
+
+/**
+ * @brief An interface for the storage of a solution that is produced one time point at a time.
+ *
+ * A solver calls Begin() once, then Append() for every time point in order, then End(). Sinks that write the
+ * solution out as it is produced let the solver run without keeping the whole solution in memory (see
+ * OdeSolver::SolveTo()). Before saving a checkpoint, a solver calls Flush(), so that a solve resumed from the
+ * checkpoint can append to the output instead of producing it again.
+ */
+class TrajectorySink
+{
+public:
+    /**
+     * @brief Destroy the TrajectorySink object.
+     */
+    virtual ~TrajectorySink();
+
+    /**
+     * @brief Start a new solution.
+     * @param dimension The dimension of the problem.
+     * @param num_points The number of time points that will be appended, fewer if the solve is stopped by an event.
+     */
+    virtual void Begin(int dimension, long num_points) = 0;
+
+    /**
+     * @brief Append the solution at the next time point.
+     * @param y The solution, of the dimension given to Begin().
+     */
+    virtual void Append(const Eigen::VectorXd& y) = 0;
+
+    /**
+     * @brief Write the time points appended so far to the output. Does nothing by default.
+     */
+    virtual void Flush();
+
+    /**
+     * @brief Finish the solution after its last time point.
+     */
+    virtual void End() = 0;
+};
+
+/**
+ * @brief A sink that stores the solution in a matrix, one column per time point.
+ */
+class MatrixSink : public TrajectorySink
+{
+public:
+    /**
+     * @brief Allocate the matrix.
+     * @param dimension The dimension of the problem.
+     * @param num_points The number of time points.
+     */
+    void Begin(int dimension, long num_points) override;
+
+    /**
+     * @brief Store the solution at the next time point.
+     * @param y The solution.
+     * @throws std::out_of_range If more time points are appended than announced.
+     */
+    void Append(const Eigen::VectorXd& y) override;
+
+    /**
+     * @brief Finish the solution.
+     */
+    void End() override;
+
+    /**
+     * @brief Move the matrix out of the sink.
+     * @return Eigen::MatrixXd The solution at each time point; the sink is left empty.
+     */
+    Eigen::MatrixXd Release();
+
+private:
+    Eigen::MatrixXd results;  ///< The solution, one column per time point.
+    long count = 0;  ///< The number of time points appended.
+};
+
+/**
+ * @brief A sink that stores the solution in a block of columns of an existing matrix, one column per time point.
+ *
+ * Lets several solves write into disjoint blocks of one preallocated matrix, as the members of an EnsembleSolver do,
+ * without building a matrix per solve.
+ */
+class BlockSink : public TrajectorySink
+{
+public:
+    /**
+     * @brief Construct a new BlockSink object.
+     * @param target The matrix holding the block, which must outlive the sink.
+     * @param first_col The first column of the block.
+     * @param num_cols The number of columns of the block.
+     */
+    BlockSink(Eigen::MatrixXd& target, long first_col, long num_cols);
+
+    /**
+     * @brief Start filling the block.
+     * @param dimension The dimension of the problem.
+     * @param num_points The number of time points.
+     * @throws std::invalid_argument If the solution does not fit in the block.
+     */
+    void Begin(int dimension, long num_points) override;
+
+    /**
+     * @brief Store the solution at the next time point.
+     * @param y The solution.
+     * @throws std::out_of_range If more time points are appended than the block holds.
+     */
+    void Append(const Eigen::VectorXd& y) override;
+
+    /**
+     * @brief Finish the solution, setting the columns that were not reached (after an event stopped the solve) to NaN.
+     */
+    void End() override;
+
+private:
+    Eigen::MatrixXd& target;  ///< The matrix holding the block.
+    long first_col;  ///< The first column of the block.
+    long num_cols;  ///< The number of columns of the block.
+    long count = 0;  ///< The number of time points appended.
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "TrajectoryView.h"
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TrajectoryView::TrajectoryView(const std::string& filename)
+{
+    if (!IsLittleEndianHost())
+        throw std::runtime_error("Trajectory files can only be mapped on little-endian hosts");
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+        throw std::runtime_error("Could not open file: " + filename);
+    header = ReadTrajectoryHeader(in);
+    in.close();
+    if (header.layout == XOR_COMPRESSED)
+        throw std::runtime_error("Compressed trajectory files cannot be mapped: " + filename);
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    length = info.st_size;
+    if (length < header.data_offset + header.dimension * header.num_points * sizeof(double))
+    {
+        close(fd);
+        throw std::runtime_error("Truncated trajectory file: " + filename);
+    }
+    mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        throw std::runtime_error("Could not map file: " + filename);
+    }
+}
+
+TrajectoryView::~TrajectoryView()
+{
+    if (mapping)
+        munmap(mapping, length);
+}
+
+TrajectoryView::TrajectoryView(TrajectoryView&& other) : header(other.header), mapping(other.mapping), length(other.length)
+{
+    other.mapping = nullptr;
+    other.length = 0;
+}
+
+const TrajectoryHeader& TrajectoryView::GetHeader() const
+{
+    return header;
+}
+
+TrajectoryView::Values TrajectoryView::GetValues() const
+{
+    const double* data = reinterpret_cast<const double*>(static_cast<const char*>(mapping) + header.data_offset);
+    // Entry (i, n) is at n * dimension + i in time-major order and at i * num_points + n in component-major order.
+    Eigen::Index outer = header.layout == TIME_MAJOR ? header.dimension : 1;
+    Eigen::Index inner = header.layout == TIME_MAJOR ? 1 : header.num_points;
+    return Values(data, header.dimension, header.num_points, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(outer, inner));
+}
@@ -0,0 +1,68 @@
+/**
+ * @file TrajectoryView.h
+ * @brief Defines the TrajectoryView class, a read-only memory-mapped view of a trajectory file.
+ */
+
+#ifndef TRAJECTORYVIEW_H
+#define TRAJECTORYVIEW_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <string>
+#include "TrajectoryFile.h"
+
+/**
+ * @brief A read-only view of the values of a trajectory file, mapped into memory.
+ *
+ * The file is mapped as a whole but only the pages that are read are loaded, by the operating system, so a
+ * trajectory larger than the physical memory can be read without being copied.
+ */
+class TrajectoryView
+{
+public:
+    /**
+     * @brief The values of a trajectory, one row per variable and one column per time point, whatever the layout of the file.
+     */
+    typedef Eigen::Map<const Eigen::MatrixXd, Eigen::Unaligned, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>> Values;
+
+    /**
+     * @brief Map a trajectory file.
+     * @param filename The name of the file.
+     * @throws std::runtime_error If the file cannot be opened or mapped, has an invalid header, is truncated or compressed, or the host is not little-endian.
+     */
+    explicit TrajectoryView(const std::string& filename);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~TrajectoryView();
+
+    TrajectoryView(const TrajectoryView&) = delete;
+    TrajectoryView& operator=(const TrajectoryView&) = delete;
+
+    /**
+     * @brief Move the mapping of another view.
+     * @param other The view, left without mapping.
+     */
+    TrajectoryView(TrajectoryView&& other);
+
+    /**
+     * @brief Get the header of the file.
+     * @return const TrajectoryHeader& The header.
+     */
+    const TrajectoryHeader& GetHeader() const;
+
+    /**
+     * @brief Get the values of the trajectory.
+     * @return Values The values, which stay valid as long as the view.
+     */
+    Values GetValues() const;
+
+private:
+    TrajectoryHeader header;  ///< The header of the file.
+    void* mapping = nullptr;  ///< The start of the mapped file.
+    std::size_t length = 0;  ///< The length of the mapping.
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "WaveformRelaxation.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+WaveformRelaxation::WaveformRelaxation(const RungeKutta& prototype, int num_threads) : pool(num_threads)
+{
+    if (prototype.IsImplicit())
+        throw std::invalid_argument("Waveform relaxation only supports explicit methods");
+    a = prototype.GetA();
+    b = prototype.GetB();
+    c = prototype.GetC();
+    step_size = prototype.GetStepSize();
+    initial_time = prototype.GetInitialTime();
+    num_points = prototype.GetNumTimePoints();
+    initial_condition = prototype.GetInitialCondition().col(0);
+    function = prototype.GetFunction();
+
+    // Group the variables that depend on each other, directly or not.
+    int dim = initial_condition.size();
+    std::vector<int> parent(dim);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&](int i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    auto dependencies = function.GetDependencies(dim);
+    for (int i = 0; i < dim; i++)
+    {
+        for (int j : dependencies[i])
+            parent[root(i)] = root(j);
+    }
+    std::vector<int> block_of(dim, -1);
+    for (int i = 0; i < dim; i++)
+    {
+        int r = root(i);
+        if (block_of[r] < 0)
+        {
+            block_of[r] = blocks.size();
+            blocks.emplace_back();
+        }
+        blocks[block_of[r]].push_back(i);
+    }
+}
+
+void WaveformRelaxation::SetBlocks(const std::vector<std::vector<int>>& blocks)
+{
+    int dim = initial_condition.size();
+    std::vector<bool> seen(dim, false);
+    int count = 0;
+    for (const auto& block : blocks)
+    {
+        if (block.empty())
+            throw std::invalid_argument("Blocks must not be empty");
+        for (int i : block)
+        {
+            if (i < 0 || i >= dim || seen[i])
+                throw std::invalid_argument("Blocks must contain every variable from 0 to " + std::to_string(dim - 1) + " exactly once");
+            seen[i] = true;
+            count++;
+        }
+    }
+    if (count != dim)
+        throw std::invalid_argument("Blocks must contain every variable from 0 to " + std::to_string(dim - 1) + " exactly once");
+    this->blocks = blocks;
+}
+
+const std::vector<std::vector<int>>& WaveformRelaxation::GetBlocks() const
+{
+    return blocks;
+}
+
+void WaveformRelaxation::SetWindowSize(int num_steps)
+{
+    if (num_steps < 0)
+        throw std::invalid_argument("The window size must not be negative");
+    window_size = num_steps;
+}
+
+void WaveformRelaxation::SetTolerance(double tolerance)
+{
+    if (tolerance < 0)
+        throw std::invalid_argument("The tolerance must not be negative");
+    this->tolerance = tolerance;
+}
+
+void WaveformRelaxation::SetMaxSweeps(int max_sweeps)
+{
+    if (max_sweeps <= 0)
+        throw std::invalid_argument("The maximum number of sweeps must be positive");
+    this->max_sweeps = max_sweeps;
+}
+
+int WaveformRelaxation::GetSweeps() const
+{
+    return sweeps;
+}
+
+Eigen::MatrixXd WaveformRelaxation::Solve()
+{
+    int dim = initial_condition.size();
+    int num_steps = num_points - 1;
+    int window = (window_size > 0) ? window_size : num_steps;
+    Eigen::MatrixXd solution = Eigen::MatrixXd::Zero(dim, num_points);
+    solution.col(0) = initial_condition;
+    std::vector<Eigen::MatrixXd> previous(b.size(), Eigen::MatrixXd::Zero(dim, num_steps));
+    std::vector<Eigen::MatrixXd> current = previous;
+    sweeps = 0;
+
+    for (int first = 0; first < num_steps; first += window)
+    {
+        int last = std::min(num_steps, first + window);
+        // The first guess of every waveform is constant over the window.
+        for (auto& stage : previous)
+        {
+            stage.middleCols(first, last - first).colwise() = solution.col(first);
+        }
+        for (int sweep = 1; ; sweep++)
+        {
+            if (sweep > max_sweeps)
+                throw std::runtime_error("Waveform relaxation did not converge in " + std::to_string(max_sweeps) + " sweeps in the window starting at time " + std::to_string(initial_time + first * step_size));
+            Eigen::MatrixXd before = solution.middleCols(first + 1, last - first);
+            pool.ParallelFor(0, blocks.size(), [&](int begin, int end) {
+                for (int block = begin; block < end; block++)
+                    SweepBlock(block, first, last, previous, current, solution);
+            }, 1);
+            sweeps++;
+            std::swap(previous, current);
+
+            // A single block does not depend on any guess and is exact after one sweep.
+            auto after = solution.middleCols(first + 1, last - first);
+            double change = (after - before).lpNorm<Eigen::Infinity>() / (1.0 + after.lpNorm<Eigen::Infinity>());
+            if (blocks.size() == 1 || (sweep > 1 && change <= tolerance))
+                break;
+        }
+    }
+    return solution;
+}
+
+void WaveformRelaxation::SweepBlock(int block, int first, int last, const std::vector<Eigen::MatrixXd>& previous, std::vector<Eigen::MatrixXd>& current, Eigen::MatrixXd& solution) const
+{
+    const auto& rows = blocks[block];
+    int size = rows.size();
+    int s = b.size();
+    Eigen::VectorXd y(size);
+    for (int r = 0; r < size; r++)
+        y(r) = solution(rows[r], first);
+    Eigen::MatrixXd k(size, s);
+
+    for (int n = first; n < last; n++)
+    {
+        double t = initial_time + n * step_size;
+        for (int i = 0; i < s; i++)
+        {
+            Eigen::VectorXd own = y;
+            for (int j = 0; j < i; j++)
+            {
+                if (a(i, j) != 0)
+                    own += step_size * a(i, j) * k.col(j);
+            }
+            Eigen::VectorXd stage = previous[i].col(n);
+            for (int r = 0; r < size; r++)
+            {
+                stage(rows[r]) = own(r);
+                current[i](rows[r], n) = own(r);
+            }
+            k.col(i) = function.BuildRightHandSide(t + c(i) * step_size, stage, rows);
+        }
+        y += step_size * k * b;
+        for (int r = 0; r < size; r++)
+            solution(rows[r], n + 1) = y(r);
+    }
+}
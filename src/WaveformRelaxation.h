@@ -0,0 +1,116 @@
+/**
+ * @file WaveformRelaxation.h
+ * @brief Defines the WaveformRelaxation class for integrating weakly coupled subsystems in parallel.
+ */
+
+#ifndef WAVEFORMRELAXATION_H
+#define WAVEFORMRELAXATION_H
+
+#pragma once
+#include <Eigen/Dense>
+#include <vector>
+#include "Function.h"
+#include "RungeKutta.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief A class implementing Jacobi waveform relaxation with an explicit Runge-Kutta method.
+ *
+ * The variables are split into blocks. Over a window of steps, every block is integrated on its own thread, with
+ * the variables of the other blocks taken from the previous sweep; the sweeps are repeated until the block
+ * trajectories stop changing, then the next window starts from the converged state.
+ *
+ * The coupling goes through the stage values of the previous sweep: block \f$ B \f$ evaluates its stage \f$ i \f$
+ * of step \f$ n \f$ with the other blocks' stage \f$ i \f$ of step \f$ n \f$. A converged window is therefore
+ * the solution of the Runge-Kutta method on the whole system, without interpolation error.
+ *
+ * By default the blocks are the groups of variables that do not depend on each other in the function
+ * combination, which converge in two sweeps; weakly coupled subsystems are given with SetBlocks().
+ */
+class WaveformRelaxation
+{
+public:
+    /**
+     * @brief Construct a new WaveformRelaxation object.
+     * @param prototype The explicit Runge-Kutta solver that describes the method and the problem.
+     * @param num_threads The number of worker threads, or zero to use one per hardware thread.
+     * @throws std::invalid_argument If the method of the prototype has implicit stages.
+     */
+    WaveformRelaxation(const RungeKutta& prototype, int num_threads = 0);
+
+    /**
+     * @brief Set the blocks of variables.
+     * @param blocks The indices of the variables of every block, which must together contain every variable once.
+     * @throws std::invalid_argument If the blocks are not a partition of the variables.
+     */
+    void SetBlocks(const std::vector<std::vector<int>>& blocks);
+
+    /**
+     * @brief Get the blocks of variables.
+     * @return const std::vector<std::vector<int>>& The indices of the variables of every block.
+     */
+    const std::vector<std::vector<int>>& GetBlocks() const;
+
+    /**
+     * @brief Set the number of steps of a window.
+     * @param num_steps The number of steps, or zero to use the whole time interval as one window.
+     * @throws std::invalid_argument If the number is negative.
+     */
+    void SetWindowSize(int num_steps);
+
+    /**
+     * @brief Set the tolerance on the change of the trajectories between two sweeps.
+     * @param tolerance The largest change, relative to \f$ 1 + \| y \|_\infty \f$, at which a window is converged.
+     * @throws std::invalid_argument If the tolerance is negative.
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * @brief Set the maximum number of sweeps per window.
+     * @param max_sweeps The maximum number of sweeps.
+     * @throws std::invalid_argument If the number is not positive.
+     */
+    void SetMaxSweeps(int max_sweeps);
+
+    /**
+     * @brief Get the number of sweeps of the last call to Solve().
+     * @return int The number of sweeps, summed over the windows.
+     */
+    int GetSweeps() const;
+
+    /**
+     * @brief Solve the problem of the prototype.
+     * @return Eigen::MatrixXd The solution at each time point of the prototype.
+     * @throws std::runtime_error If a window does not converge within the maximum number of sweeps.
+     */
+    Eigen::MatrixXd Solve();
+
+private:
+    Eigen::MatrixXd a;  ///< The matrix of coefficients of the method.
+    Eigen::VectorXd b;  ///< The weights of the method.
+    Eigen::VectorXd c;  ///< The nodes of the method.
+    double step_size;  ///< The step size.
+    double initial_time;  ///< The initial time.
+    int num_points;  ///< The number of time points.
+    Eigen::VectorXd initial_condition;  ///< The initial condition.
+    Function function;  ///< The right-hand side of the problem.
+    std::vector<std::vector<int>> blocks;  ///< The indices of the variables of every block.
+    int window_size = 0;  ///< The number of steps of a window, zero for the whole interval.
+    double tolerance = 1e-10;  ///< The tolerance on the change of the trajectories.
+    int max_sweeps = 50;  ///< The maximum number of sweeps per window.
+    int sweeps = 0;  ///< The number of sweeps of the last solve.
+    ThreadPool pool;  ///< The worker threads.
+
+    /**
+     * @brief Integrate one block over a window with the other blocks frozen.
+     * @param block The index of the block.
+     * @param first The first step of the window.
+     * @param last One past the last step of the window.
+     * @param previous The stage values of the previous sweep, one matrix per stage with one column per step.
+     * @param current The stage values of this sweep, of which only the rows of the block are written.
+     * @param solution The solution, of which only the rows of the block are written.
+     */
+    void SweepBlock(int block, int first, int last, const std::vector<Eigen::MatrixXd>& previous, std::vector<Eigen::MatrixXd>& current, Eigen::MatrixXd& solution) const;
+};
+
+#endif
@@ -12,200 +12,354 @@
 #include <sstream>
 #include <stdexcept>
 #include <regex>
+#include <cstdio>
+#include <limits>
+#include <csignal>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
-#include "ForwardEuler.h"
-#include "OdeSolver.h"
-#include "RungeKutta.h"
-#include "Function.h"
-#include "AdamBashforth.h"
-#include "AdamMoulton.h"
-#include "BDF.h"
-#include "MultiStep.h"
-#include "NewtonMethod.h"
-#include "AdamBashforthOneStep.h"
-#include "AdamBashforthTwoSteps.h"
-#include "AdamBashforthThreeSteps.h"
-#include "AdamBashforthFourSteps.h"
-#include "BackwardEuler.h"
+#include "BatchRunner.h"
+#include "CompressedTrajectory.h"
+#include "CsvTrajectory.h"
+#include "MappedTrajectory.h"
+#include "PipelinedTrajectory.h"
+#include "Problem.h"
+#include "ProblemCache.h"
+#include "SolverServer.h"
+#include "TrajectoryFile.h"
 #include "utils.h"
 
 /**
- * @brief Parse the input file and Prints the solution of the required ODE with the specified method.
+ * @brief Solve a batch of input files and print a report with the timing of every problem.
  * 
- * @param filename The name of the input file.
- * @throws std::runtime_error If the number of equations is not provided.
- * @throws std::runtime_error If the method is not provided.
- * @throws std::runtime_error If the initial time is not provided.
- * @throws std::runtime_error If the final time is not provided.
- * @throws std::runtime_error If the step size is not provided.
- * @throws std::runtime_error If the function matrix is not provided.
- * @throws std::runtime_error If the function matrix has a different number of rows than the number of equations.
- * @throws std::runtime_error If the initial condition matrix has a different number of rows than the number of equations.
- * @throws std::runtime_error If the initial condition matrix has a different number of columns than the number of steps.
+ * The arguments are a directory of input files or a manifest listing them, then optionally
+ * "--output <directory>" for the result files, "--threads <n>" for the number of worker threads and
+ * "--cache <directory>" for a cache of compiled systems shared by the problems.
+ * 
+ * @param argc The number of arguments.
+ * @param argv The arguments, starting with the program name and "--batch".
+ * @return int Zero if every problem was solved, one otherwise.
+ * @throws std::runtime_error If the arguments are invalid or the inputs cannot be listed.
  */
-int main(int argc, char** argv) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
+int RunBatch(int argc, char** argv) {
+    if (argc < 3) {
+        throw std::runtime_error("Usage: " + std::string(argv[0]) + " --batch <directory|manifest> [--output <directory>] [--threads <n>] [--cache <directory>]");
+    }
+    std::string source = argv[2];
+    std::string output_directory;
+    std::string cache_directory;
+    int num_threads = 0;
+    for (int i = 3; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--output" && i + 1 < argc) {
+            output_directory = argv[++i];
+        }
+        else if (option == "--threads" && i + 1 < argc) {
+            num_threads = std::stoi(argv[++i]);
+        }
+        else if (option == "--cache" && i + 1 < argc) {
+            cache_directory = argv[++i];
+        }
+        else {
+            throw std::runtime_error("Invalid batch option: " + option);
+        }
     }
-    std::string filename = argv[1];
-    InputParameters params = ParseInputFile(filename);
 
-    if (params.num_equations == -1){
-        throw std::runtime_error("Number of equations is not provided.");
+    BatchRunner runner(num_threads);
+    struct stat info;
+    if (stat(source.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+        runner.AddDirectory(source);
     }
+    else {
+        runner.AddManifest(source);
+    }
+    runner.SetOutputDirectory(output_directory);
+    runner.SetCacheDirectory(cache_directory);
+    std::vector<BatchResult> results = runner.Run();
+    BatchRunner::WriteReport(results, std::cout);
+    for (const auto& result : results) {
+        if (!result.success) {
+            return 1;
+        }
+    }
+    return 0;
+}
 
-    if (params.method == -1){
-        throw std::runtime_error("Method is not provided.");
+/**
+ * @brief Stay resident and solve the problems sent over the standard input or a Unix domain socket.
+ * 
+ * The requests and responses are the frames of SolverServer.h. Without options, the requests are read from the
+ * standard input and the responses written to the standard output until the input ends. With
+ * "--socket <path>", the server accepts connections on the socket until it is killed. "--threads <n>" sets the
+ * number of worker threads and "--cache-size <n>" the number of compiled systems kept in memory.
+ * 
+ * @param argc The number of arguments.
+ * @param argv The arguments, starting with the program name and "--serve".
+ * @return int Zero once the standard input ends.
+ * @throws std::runtime_error If the arguments are invalid, the socket cannot be created or a request is invalid.
+ */
+int RunServer(int argc, char** argv) {
+    std::string socket_path;
+    int num_threads = 0;
+    size_t cache_size = 256;
+    for (int i = 2; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        }
+        else if (option == "--threads" && i + 1 < argc) {
+            num_threads = std::stoi(argv[++i]);
+        }
+        else if (option == "--cache-size" && i + 1 < argc) {
+            cache_size = std::stoul(argv[++i]);
+        }
+        else {
+            throw std::runtime_error("Invalid server option: " + option);
+        }
     }
 
-    if (params.initial_time == -1){
-        throw std::runtime_error("Initial time is not provided.");
+    // A client that goes away must not kill the server when it writes the response.
+    std::signal(SIGPIPE, SIG_IGN);
+    SolverServer server(num_threads, cache_size);
+    if (socket_path.empty()) {
+        server.Serve(STDIN_FILENO, STDOUT_FILENO);
+        return 0;
     }
+    server.Listen(socket_path);
+    std::cerr << "Listening on " << socket_path << std::endl;
+    server.ServeConnections();
+    return 0;
+}
 
-    if (params.final_time == -1){
-        throw std::runtime_error("Final time is not provided.");
+/**
+ * @brief Remove the checkpoint file of a solve that ended, so that the next run starts from the beginning.
+ * 
+ * @param filename The name of the checkpoint file, or an empty string if there is none.
+ */
+void RemoveCheckpoint(const std::string& filename) {
+    if (!filename.empty()) {
+        std::remove(filename.c_str());
     }
+}
 
-    if (params.step_size == -1){
-        throw std::runtime_error("Step size is not provided.");
+/**
+ * @brief Cut a delimited text file after its row of column names and a number of time points.
+ * 
+ * A resumed solve appends to the file the time points after its checkpoint, so the rows written after the
+ * checkpoint by the interrupted run are dropped.
+ * 
+ * @param filename The name of the file.
+ * @param num_points The number of time points to keep.
+ * @throws std::runtime_error If the file cannot be read or cut, or holds fewer time points.
+ */
+void KeepCsvRows(const std::string& filename, long num_points) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    for (long row = 0; row <= num_points; row++) {
+        if (!in.ignore(std::numeric_limits<std::streamsize>::max(), '\n') || in.eof()) {
+            throw std::runtime_error("The file holds fewer than the " + std::to_string(num_points) + " time points before the checkpoint: " + filename);
+        }
+    }
+    off_t length = in.tellg();
+    in.close();
+    if (truncate(filename.c_str(), length) != 0) {
+        throw std::runtime_error("Could not resize file: " + filename);
     }
+}
 
-    if (params.function_matrix.size() == 0){
-        throw std::runtime_error("Function matrix is not provided.");
+/**
+ * @brief Print the events that occurred during a solve.
+ * 
+ * @param occurrences The events, in the order of their times.
+ * @param params The parameters, whose events give the actions.
+ */
+void PrintEvents(const std::vector<EventOccurrence>& occurrences, const InputParameters& params) {
+    for (const auto& occurrence : occurrences) {
+        std::cout << "Event " << occurrence.event + 1 << " at time " << occurrence.time;
+        if (params.events[occurrence.event].action == STOP_AT_EVENT) {
+            std::cout << ", solve stopped";
+        }
+        std::cout << std::endl;
     }
-    bool provided_derivative = false;
-    if (params.function_matrix.size() != params.num_equations){
-        throw std::runtime_error("Invalid row dimension in the function matrix.");
+}
+
+/**
+ * @brief Parse the input file and Prints the solution of the required ODE with the specified method.
+ * 
+ * With "--binary <file>" after the input file, the solution is written to a binary trajectory file instead of
+ * being printed, in the layout given by "--layout time|component|compressed" (time-major by default). The
+ * compressed layout is encoded losslessly on a background thread while the solver runs (see CompressedTrajectory).
+ * With "--csv <file>", it is written as delimited text with a time column, with the shortest round-trip digits
+ * unless "--precision <digits>" is given, and comma-separated unless "--delimiter <text>" is given.
+ * The time-major and the delimited text files are written on a writer thread while the solver runs (see
+ * PipelinedTrajectory).
+ * With "--cache <directory>", the compiled system is read from or added to a cache (see ProblemCache).
+ * With "--checkpoint <file>", the state of the solver is saved to the file every "--checkpoint-steps <n>" time
+ * points and/or every "--checkpoint-seconds <s>" seconds (every 60 seconds by default). If the file exists, the
+ * solve resumes from it and only the time points after it are computed: they are appended to the time-major or
+ * delimited text file of the interrupted run, which is cut at the checkpoint, or printed. The compressed and
+ * component layouts are only written at the end, so they cannot be checkpointed. The file is removed once the
+ * solve ends.
+ * With "--batch" as first argument, solves a batch of input files instead (see RunBatch()).
+ * With "--serve" as first argument, serves the requests of other processes instead (see RunServer()).
+ * 
+ * @param filename The name of the input file.
+ * @throws std::runtime_error If the input file is invalid (see SolveProblem()).
+ */
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::string(argv[1]) == "--batch") {
+        return RunBatch(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "--serve") {
+        return RunServer(argc, argv);
+    }
+    std::string binary_file;
+    std::string csv_file;
+    TrajectoryLayout layout = TIME_MAJOR;
+    int precision = 0;
+    std::string delimiter = ",";
+    std::string cache_directory;
+    std::string checkpoint_file;
+    long checkpoint_points = 0;
+    double checkpoint_seconds = 0.0;
+    bool valid_options = argc >= 2;
+    for (int i = 2; i < argc && valid_options; i++) {
+        std::string option = argv[i];
+        std::string value = i + 1 < argc ? argv[++i] : "";
+        if (option == "--binary" && !value.empty()) {
+            binary_file = value;
+        }
+        else if (option == "--layout" && (value == "time" || value == "component" || value == "compressed")) {
+            layout = value == "time" ? TIME_MAJOR : value == "component" ? COMPONENT_MAJOR : XOR_COMPRESSED;
+        }
+        else if (option == "--csv" && !value.empty()) {
+            csv_file = value;
+        }
+        else if (option == "--precision" && !value.empty()) {
+            precision = std::stoi(value);
+        }
+        else if (option == "--delimiter" && !value.empty()) {
+            delimiter = value;
+        }
+        else if (option == "--cache" && !value.empty()) {
+            cache_directory = value;
+        }
+        else if (option == "--checkpoint" && !value.empty()) {
+            checkpoint_file = value;
+        }
+        else if (option == "--checkpoint-steps" && !value.empty()) {
+            checkpoint_points = std::stol(value);
+        }
+        else if (option == "--checkpoint-seconds" && !value.empty()) {
+            checkpoint_seconds = std::stod(value);
+        }
+        else {
+            valid_options = false;
+        }
+    }
+    if (!binary_file.empty() && !csv_file.empty()) {
+        valid_options = false;
+    }
+    if (!checkpoint_file.empty() && !binary_file.empty() && layout != TIME_MAJOR) {
+        valid_options = false;
+    }
+    if (!valid_options) {
+        std::cerr << "Usage: " << argv[0] << " <input_file> [--binary <file> [--layout time|component|compressed]] [--cache <directory>]" << std::endl;
+        std::cerr << "       " << argv[0] << " <input_file> [--binary <file> [--layout time]] [--cache <directory>] [--checkpoint <file> [--checkpoint-steps <n>] [--checkpoint-seconds <s>]]" << std::endl;
+        std::cerr << "       " << argv[0] << " <input_file> --csv <file> [--precision <digits>] [--delimiter <text>] [--cache <directory>] [--checkpoint <file> ...]" << std::endl;
+        std::cerr << "       " << argv[0] << " --batch <directory|manifest> [--output <directory>] [--threads <n>] [--cache <directory>]" << std::endl;
+        std::cerr << "       " << argv[0] << " --serve [--socket <path>] [--threads <n>] [--cache-size <n>]" << std::endl;
+        return 1;
     }
+    std::string filename = argv[1];
+    InputParameters params = cache_directory.empty() ? ParseInputFile(filename) : ParseInputFile(filename, ProblemCache(cache_directory));
 
-    Function function(params.function_matrix);
-    if (params.derivative_matrix[0][0] == ""){
+    if (!ProvidesDerivative(params)){
         std::cout << "Derivative matrix is not provided. Be aware that only explicit methods can be employed." << std::endl;
     }
-    else{
-        function.SetDerivativeCombination(params.derivative_matrix);
-        provided_derivative = true;
+    double output_time = params.initial_time;
+    if (!checkpoint_file.empty()) {
+        params.checkpoint_file = checkpoint_file;
+        params.checkpoint_points = checkpoint_points;
+        params.checkpoint_seconds = checkpoint_points == 0 && checkpoint_seconds == 0.0 ? 60.0 : checkpoint_seconds;
+        std::ifstream existing(checkpoint_file);
+        if (existing.good()) {
+            params.restart = std::make_shared<const SolverCheckpoint>(ReadCheckpoint(checkpoint_file));
+            output_time = params.initial_time + params.restart->next_point * params.step_size;
+            std::cout << "Resuming from " << checkpoint_file << " at time " << output_time << std::endl;
+        }
     }
-
-    double step_size = params.step_size;
-    double initial_time = params.initial_time;
-    double final_time = params.final_time;
-    if (params.num_equations != params.initial_condition.rows()){
-        throw std::runtime_error("Invalid row dimension in the initial condition matrix, it should match the number of equations.");
+    std::string method_name;
+    std::vector<EventOccurrence> occurrences;
+    TrajectoryHeader header;
+    header.initial_time = params.initial_time;
+    header.final_time = params.final_time;
+    header.step_size = params.step_size;
+    header.rel_tol = params.rel_tol;
+    header.abs_tol = params.abs_tol;
+    header.method = GetMethodName(params.method);
+    header.layout = layout;
+    if (!binary_file.empty() && layout == TIME_MAJOR) {
+        // The time-major file is written while the solver runs, so the solution never has to fit in memory.
+        MappedTrajectory trajectory(binary_file, header);
+        if (params.restart) {
+            // Append to the file of the interrupted run, which holds the points flushed before the checkpoint.
+            trajectory.Resume(params.restart->next_point);
+        }
+        PipelinedTrajectory pipeline(trajectory);
+        SolveProblem(params, method_name, pipeline, &occurrences);
+        RemoveCheckpoint(checkpoint_file);
+        std::cout << method_name << std::endl;
+        PrintEvents(occurrences, params);
+        TrajectoryView view = trajectory.GetView();
+        std::cout << "Approximations (" << view.GetHeader().dimension << "x" << view.GetHeader().num_points << ") written to " << binary_file << std::endl;
+        return 0;
     }
-    if (params.num_steps!= params.initial_condition.cols()){
-        throw std::runtime_error("Invalid column dimension in the initial condition matrix, it should match the number of steps.");
+    if (!binary_file.empty() && layout == XOR_COMPRESSED) {
+        CompressedTrajectory trajectory(binary_file, header);
+        SolveProblem(params, method_name, trajectory, &occurrences);
+        RemoveCheckpoint(checkpoint_file);
+        std::cout << method_name << std::endl;
+        PrintEvents(occurrences, params);
+        const TrajectoryHeader& written = trajectory.GetHeader();
+        std::cout << "Approximations (" << written.dimension << "x" << written.num_points << ") compressed to " << trajectory.GetFileSize() << " bytes in " << binary_file << std::endl;
+        return 0;
     }
-    Eigen::MatrixXd initial_condition = params.initial_condition;
-    int num_steps = params.num_steps;
-
-    switch(params.method){
-        case 1:
-            {
-            std::cout << "Forward Euler method" << std::endl;
-            ForwardEuler solver(step_size, initial_time, final_time, initial_condition, function);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-            
-        case 2:
-            {
-            std::cout << "Adam-Bashforth one-step" << std::endl;
-            AdamBashforthOneStep solver(step_size, initial_time, final_time, initial_condition, function);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 3:
-            {
-            std::cout << "Adam-Bashforth two-steps" << std::endl;
-            AdamBashforthTwoSteps solver(step_size, initial_time, final_time, initial_condition, function);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 4:
-            {
-            std::cout << "Adam-Bashforth three-steps" << std::endl;
-            AdamBashforthThreeSteps solver(step_size, initial_time, final_time, initial_condition, function);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 5:
-            {
-            std::cout << "Adam-Bashforth four-steps" << std::endl;
-            AdamBashforthFourSteps solver(step_size, initial_time, final_time, initial_condition, function);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 6:
-            {
-            if (!provided_derivative){
-                throw std::runtime_error("Derivative matrix is not provided for the Backward Euler method");
-            }
-            std::cout << "Backward Euler method" << std::endl; 
-            BackwardEuler solver(step_size, initial_time, final_time, initial_condition, function);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 7:
-            {
-            Eigen::MatrixXd a = params.a;
-            Eigen::VectorXd b = params.b;
-            Eigen::VectorXd c = params.c;
-            if (a.size() == 0 || b.size() == 0 || c.size() == 0){
-                throw std::runtime_error("Invalid Runge-Kutta method parameters. You should provide the matrix A, vector b, and vector c in the input file.");
-            }
-            std::cout << "Runge Kutta Method" << std::endl;
-            RungeKutta solver(step_size, initial_time, final_time, initial_condition, function, a, b, c);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 8:
-            {
-            std::cout << "Backward Differentiation Formula" << std::endl;
-            Eigen::VectorXd alpha = params.alpha;
-            if (alpha.size() == 0){
-                throw std::runtime_error("Invalid BDF method parameters. You should provide the vector alpha in the input file.");
-            }
-            BDF solver(step_size, initial_time, final_time, initial_condition, function, alpha);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 9:
-            {
-            Eigen::VectorXd beta = params.beta;
-            if (beta.size() == 0){
-                throw std::runtime_error("Invalid Adam-Moulton method parameters. You should provide the vector beta in the input file.");
-            }
-            std::cout << "Adam Moulton Method" << std::endl;
-            AdamMoulton solver(step_size, initial_time, final_time, initial_condition, function, beta);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        case 10:
-            {
-            Eigen::VectorXd beta = params.beta;
-            if (beta.size() == 0){
-                throw std::runtime_error("Invalid Adam-Bashforth method parameters. You should provide the vector beta in the input file.");
-            }            
-            std::cout << "Generic Adam-Bashforth Method" << std::endl;
-            AdamBashforth solver(step_size, initial_time, final_time, initial_condition, function, beta);
-            Eigen::MatrixXd approximations = solver.Solve();
-            PrintMatrix(approximations, "Approximations");
-            break;
-            }
-        default:
-            std::cout << "Invalid method" << std::endl;
-            break;
+    if (!csv_file.empty()) {
+        if (params.restart) {
+            KeepCsvRows(csv_file, params.restart->next_point);
+        }
+        std::ofstream file(csv_file, std::ios::binary | (params.restart ? std::ios::app : std::ios::trunc));
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + csv_file);
+        }
+        // The times are counted from the initial time, so that the resumed rows match those of an uninterrupted run.
+        CsvTrajectory trajectory(file, params.initial_time, params.step_size);
+        if (params.restart) {
+            trajectory.Resume(params.restart->next_point);
+        }
+        trajectory.GetWriter().SetPrecision(precision);
+        trajectory.GetWriter().SetDelimiter(delimiter);
+        PipelinedTrajectory pipeline(trajectory);
+        SolveProblem(params, method_name, pipeline, &occurrences);
+        RemoveCheckpoint(checkpoint_file);
+        std::cout << method_name << std::endl;
+        PrintEvents(occurrences, params);
+        std::cout << "Approximations written to " << csv_file << std::endl;
+        return 0;
     }
-
+    Eigen::MatrixXd approximations = SolveProblem(params, method_name, &occurrences);
+    RemoveCheckpoint(checkpoint_file);
+    std::cout << method_name << std::endl;
+    PrintEvents(occurrences, params);
+    if (binary_file.empty()) {
+        PrintMatrix(approximations, "Approximations");
+        return 0;
+    }
+    WriteTrajectory(binary_file, approximations, header);
+    std::cout << "Approximations (" << approximations.rows() << "x" << approximations.cols() << ") written to " << binary_file << std::endl;
+    return 0;
 }
@@ -3,11 +3,17 @@
 #include <vector>
 #include <cmath>
 #include <string>
-#include <fstream>
-#include <sstream>
-#include <map>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <stdexcept>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SystemCache.h"
+#include "TextWriter.h"
 #include "utils.h"
 
 double ParseFraction(const std::string& fraction) {
@@ -37,6 +43,20 @@ bool IsLowerTriangular(const Eigen::MatrixXd& matrix) {
     return true;
 }
 
+bool HasConstantDiagonal(const Eigen::MatrixXd& matrix) {
+    double gamma = 0.0;
+    for (int i = 0; i < std::min(matrix.rows(), matrix.cols()); ++i) {
+        if (matrix(i, i) == 0) {
+            continue;
+        }
+        if (gamma != 0 && matrix(i, i) != gamma) {
+            return false;
+        }
+        gamma = matrix(i, i);
+    }
+    return true;
+}
+
 bool IsSquareMatrix(const std::vector<std::vector<std::string>>& matrix) {
     size_t numRows = matrix.size();
     if (numRows == 0) {
@@ -51,189 +71,459 @@ bool IsSquareMatrix(const std::vector<std::vector<std::string>>& matrix) {
     return true;
 }
 
+double WeightedRmsNorm(const Eigen::VectorXd& vec, const Eigen::VectorXd& weights) {
+    if (vec.size() == 0) {
+        return 0.0;
+    }
+    return std::sqrt(vec.cwiseProduct(weights).squaredNorm() / vec.size());
+}
+
+Eigen::VectorXd AdamsBashforthCoefficients(int steps) {
+    if (steps <= 0) {
+        throw std::invalid_argument("Number of steps must be positive");
+    }
+    // Node j sits at s = -j in units of the step size, measured from t_n.
+    Eigen::VectorXd coefficients(steps);
+    for (int j = 0; j < steps; ++j) {
+        std::vector<double> polynomial = {1.0}; // Monomial coefficients, lowest degree first
+        for (int m = 0; m < steps; ++m) {
+            if (m == j) continue;
+            std::vector<double> product(polynomial.size() + 1, 0.0);
+            for (size_t d = 0; d < polynomial.size(); ++d) {
+                product[d] += polynomial[d] * m / (m - j);
+                product[d + 1] += polynomial[d] / (m - j);
+            }
+            polynomial = product;
+        }
+        double integral = 0.0;
+        for (size_t d = 0; d < polynomial.size(); ++d) {
+            integral += polynomial[d] / (d + 1);
+        }
+        coefficients(j) = integral;
+    }
+    return coefficients;
+}
+
+Eigen::VectorXd ExtrapolationCoefficients(int points) {
+    if (points <= 0) {
+        throw std::invalid_argument("Number of points must be positive");
+    }
+    // e_j = (-1)^j * binomial(k, j + 1)
+    Eigen::VectorXd coefficients(points);
+    double binomial = points;
+    for (int j = 0; j < points; ++j) {
+        coefficients(j) = (j % 2 == 0) ? binomial : -binomial;
+        binomial = binomial * (points - j - 1) / (j + 2);
+    }
+    return coefficients;
+}
+
 // Function to print Eigen vectors
 void PrintVector(const Eigen::VectorXd& vec, const std::string& name) {
-    std::cout.precision(4);
-    std::cout << name << " (" << vec.size() << "): [ ";
-    for (int i = 0; i < vec.size(); ++i) {
-        std::cout << vec[i];
-        if (i != vec.size() - 1) std::cout << ", ";
-    }
-    std::cout << " ]" << std::endl;
+    TextWriter writer(std::cout);
+    writer.SetPrecision(4);
+    writer.SetDelimiter(", ");
+    writer.Write(name + " (" + std::to_string(vec.size()) + "): [ ");
+    writer.WriteValues(vec);
+    writer.Write(" ]\n");
 }
 
 // Function to print Eigen matrices
 void PrintMatrix(const Eigen::MatrixXd& mat, const std::string& name) {
     std::cout.precision(4);
-    std::cout << name << " (" << mat.rows() << "x" << mat.cols() << "):" << std::endl;
+    WriteMatrix(std::cout, mat, name);
+}
+
+void WriteMatrix(std::ostream& out, const Eigen::MatrixXd& mat, const std::string& name) {
+    TextWriter writer(out);
+    writer.SetPrecision(std::min<int>(17, std::max<int>(1, out.precision())));
+    writer.SetDelimiter(", ");
+    writer.Write(name + " (" + std::to_string(mat.rows()) + "x" + std::to_string(mat.cols()) + "):\n");
     for (int i = 0; i < mat.rows(); ++i) {
-        std::cout << "[ ";
-        for (int j = 0; j < mat.cols(); ++j) {
-            std::cout << mat(i, j);
-            if (j != mat.cols() - 1) std::cout << ", ";
-        }
-        std::cout << " ]" << std::endl;
+        writer.Write("[ ");
+        writer.WriteValues(mat.row(i).transpose());
+        writer.Write(" ]\n");
     }
 }
 
-InputParameters ParseInputFile(const std::string& filename) {
-    InputParameters params;
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file: " + filename);
+namespace {
+
+// A range of characters of the input file, which is never copied.
+struct TextSpan {
+    const char* begin;
+    const char* end;
+
+    bool empty() const { return begin == end; }
+    std::string str() const { return std::string(begin, end); }
+    bool operator==(const char* text) const {
+        size_t length = std::strlen(text);
+        return (size_t)(end - begin) == length && std::memcmp(begin, text, length) == 0;
     }
+};
 
-    std::string line;
-    std::string current_key; // Tracks the current key
-    std::map<std::string, std::vector<std::string>> data; // Map to store parsed lines for each key
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    // Helper function to trim leading/trailing whitespace
-    auto trim = [](const std::string& str) {
-        size_t first = str.find_first_not_of(" \t");
-        size_t last = str.find_last_not_of(" \t");
-        return (first == std::string::npos || last == std::string::npos) ? "" : str.substr(first, last - first + 1);
+TextSpan Trim(TextSpan span) {
+    while (span.begin != span.end && IsBlank(*span.begin)) span.begin++;
+    while (span.end != span.begin && IsBlank(span.end[-1])) span.end--;
+    return span;
+}
+
+// Takes the next whitespace-separated token off the front of a line.
+bool NextToken(TextSpan& line, TextSpan& token) {
+    while (line.begin != line.end && IsBlank(*line.begin)) line.begin++;
+    if (line.begin == line.end) return false;
+    token.begin = line.begin;
+    while (line.begin != line.end && !IsBlank(*line.begin)) line.begin++;
+    token.end = line.begin;
+    return true;
+}
+
+// Parses a number or a fraction. Plain numbers are converted in place; fractions and invalid tokens go
+// through ParseFraction(), which also reports the errors.
+double ParseValue(TextSpan token) {
+    char buffer[64];
+    size_t length = token.end - token.begin;
+    if (length >= sizeof(buffer)) return ParseFraction(token.str());
+    std::memcpy(buffer, token.begin, length);
+    buffer[length] = '\0';
+    char* end;
+    double value = std::strtod(buffer, &end);
+    if (end != buffer && *end == '\0') return value;
+    return ParseFraction(buffer);
+}
+
+unsigned long long ParseUnsigned(TextSpan token, const char* key) {
+    unsigned long long value = 0;
+    const char* p = token.begin;
+    for (; p != token.end && *p >= '0' && *p <= '9'; p++) value = 10 * value + (*p - '0');
+    if (p == token.begin || p != token.end) {
+        throw std::runtime_error(std::string("Invalid value for ") + key + ": " + token.str());
+    }
+    return value;
+}
+
+int ParseInteger(TextSpan token, const char* key) {
+    bool negative = token.begin != token.end && *token.begin == '-';
+    if (negative || (token.begin != token.end && *token.begin == '+')) token.begin++;
+    int value = (int)ParseUnsigned(token, key);
+    return negative ? -value : value;
+}
+
+// The input file mapped in memory, so that it is tokenized without being copied.
+class MappedInputFile {
+public:
+    explicit MappedInputFile(const std::string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0) {
+            if (fd >= 0) close(fd);
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+        length = info.st_size;
+        if (length > 0) {
+            mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Could not map file: " + filename);
+        }
+    }
+
+    ~MappedInputFile() {
+        if (mapping != nullptr) munmap(mapping, length);
+    }
+
+    MappedInputFile(const MappedInputFile&) = delete;
+    MappedInputFile& operator=(const MappedInputFile&) = delete;
+
+    TextSpan GetText() const {
+        const char* begin = static_cast<const char*>(mapping);
+        return {begin, begin + (mapping != nullptr ? length : 0)};
+    }
+
+private:
+    void* mapping = nullptr;
+    size_t length = 0;
+};
+
+enum InputKey {
+    NUM_EQUATIONS, FUNCTION_COMBINATION, FUNCTION_TERMS, DERIVATIVE_COMBINATION, DERIVATIVE_TERMS,
+    DIFFUSION_COMBINATION, DIFFUSION_DERIVATIVE_COMBINATION, SEED, METHOD, INITIAL_TIME, FINAL_TIME, STEP_SIZE,
+    NUM_STEPS, INITIAL_CONDITION, NUM_STAGES, A, B, C, ALPHA, BETA, EVENTS, RELATIVE_TOLERANCE, ABSOLUTE_TOLERANCE,
+    NUM_INPUT_KEYS
+};
+
+const char* const kInputKeys[NUM_INPUT_KEYS] = {
+    "Number of equations", "Function combination", "Function terms", "Derivative combination", "Derivative terms",
+    "Diffusion combination", "Diffusion derivative combination", "Seed", "Method", "Initial Time", "Final Time",
+    "Step Size", "Number of Steps", "Initial Condition", "Number of Stages", "A", "B", "C", "Alpha", "Beta", "Events",
+    "Relative Tolerance", "Absolute Tolerance"
+};
+
+// The sections that define the system, which the problem cache is keyed by.
+const InputKey kSystemKeys[] = {
+    NUM_EQUATIONS, FUNCTION_COMBINATION, FUNCTION_TERMS, DERIVATIVE_COMBINATION, DERIVATIVE_TERMS,
+    DIFFUSION_COMBINATION, DIFFUSION_DERIVATIVE_COMBINATION
+};
+
+// Hashes the trimmed lines of the sections that define the system with 64-bit FNV-1a.
+unsigned long long HashSystem(const std::vector<TextSpan>* lines) {
+    unsigned long long hash = 14695981039346656037ULL;
+    auto add = [&hash](unsigned char byte) {
+        hash = (hash ^ byte) * 1099511628211ULL;
     };
+    for (InputKey key : kSystemKeys) {
+        add((unsigned char)key);
+        for (TextSpan line : lines[key]) {
+            line = Trim(line);
+            for (const char* p = line.begin; p != line.end; p++) add((unsigned char)*p);
+            add('\n');
+        }
+        add(0);
+    }
+    return hash;
+}
+
+InputParameters ParseInput(TextSpan text, const SystemCache* cache) {
+    InputParameters params;
 
-    // Read the file and parse into a map
-    while (std::getline(file, line)) {
-        line = trim(line);
+    // Split the file into lines and record the value lines of every key. Lines of unknown keys are skipped.
+    std::vector<TextSpan> lines[NUM_INPUT_KEYS];
+    std::vector<TextSpan>* current = nullptr;
+    bool has_key = false;
+    for (const char* p = text.begin; p != text.end;) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', text.end - p));
+        TextSpan line = Trim({p, newline != nullptr ? newline : text.end});
+        p = newline != nullptr ? newline + 1 : text.end;
 
         if (line.empty()) continue; // Skip empty lines
 
-        if (std::isalpha(line[0])) {
+        if (std::isalpha(static_cast<unsigned char>(*line.begin))) {
             // New key starts with an alphabetic character
-            size_t colonPos = line.find(":");
-            if (colonPos == std::string::npos) {
-                throw std::runtime_error("Invalid format: Missing colon in line: " + line);
+            const char* colon = static_cast<const char*>(std::memchr(line.begin, ':', line.end - line.begin));
+            if (colon == nullptr) {
+                throw std::runtime_error("Invalid format: Missing colon in line: " + line.str());
             }
-            current_key = trim(line.substr(0, colonPos));
-            data[current_key].push_back(line.substr(colonPos + 1));
-        } else if (!current_key.empty()) {
+            TextSpan key = Trim({line.begin, colon});
+            current = nullptr;
+            has_key = true;
+            for (int k = 0; k < NUM_INPUT_KEYS; k++) {
+                if (key == kInputKeys[k]) current = &lines[k];
+            }
+            if (current != nullptr) current->push_back({colon + 1, line.end});
+        } else if (has_key) {
             // Continuation of the previous key
-            data[current_key].push_back(trim(line));
+            if (current != nullptr) current->push_back(line);
         } else {
-            throw std::runtime_error("Invalid format: Value without a key: " + line);
+            throw std::runtime_error("Invalid format: Value without a key: " + line.str());
         }
     }
 
-    file.close();
-
-    // Process the parsed map into InputParameters
-    if (data.count("Number of equations")) {
-        params.num_equations = std::stoi(data["Number of equations"][0]);
-    }
-
-    if (data.count("Function combination")) {
-        for (const auto& line : data["Function combination"]) {
-            std::istringstream iss(line);
+    auto provided = [&](InputKey key) {
+        return !lines[key].empty() && !(Trim(lines[key][0]) == "NA");
+    };
+    auto first_token = [&](InputKey key) {
+        TextSpan line = lines[key][0], token;
+        if (!NextToken(line, token)) {
+            throw std::runtime_error(std::string("Missing value for ") + kInputKeys[key]);
+        }
+        return token;
+    };
+    auto parse_values = [&](InputKey key) {
+        std::vector<double> values;
+        for (TextSpan line : lines[key]) {
+            TextSpan token;
+            while (NextToken(line, token)) values.push_back(ParseValue(token));
+        }
+        return values;
+    };
+    auto parse_combination = [&](InputKey key) {
+        std::vector<std::vector<std::string>> matrix;
+        matrix.reserve(lines[key].size());
+        for (TextSpan line : lines[key]) {
             std::vector<std::string> row;
-            std::string entry;
-            while (iss >> entry) {
-                row.push_back(entry);
+            TextSpan token;
+            while (NextToken(line, token)) row.emplace_back(token.begin, token.end);
+            matrix.push_back(std::move(row));
+        }
+        return matrix;
+    };
+    // Terms are triplets "equation column entry", with the equations and the variables counted from one.
+    auto parse_terms = [&](InputKey key, int first_column) {
+        std::vector<FunctionTerm> terms;
+        TextSpan row, column, entry;
+        for (TextSpan line : lines[key]) {
+            while (NextToken(line, row)) {
+                if (!NextToken(line, column) || !NextToken(line, entry)) {
+                    throw std::runtime_error(std::string("Invalid format: Incomplete term in ") + kInputKeys[key]);
+                }
+                terms.push_back({ParseInteger(row, kInputKeys[key]) - 1, ParseInteger(column, kInputKeys[key]) - first_column, entry.str()});
             }
-            params.function_matrix.push_back(row);
         }
+        return terms;
+    };
+    auto parse_vector = [&](InputKey key) {
+        std::vector<double> values = parse_values(key);
+        return Eigen::VectorXd(Eigen::Map<Eigen::VectorXd>(values.data(), values.size()));
+    };
+
+    // Process the parsed lines into InputParameters
+    if (!lines[NUM_EQUATIONS].empty()) {
+        params.num_equations = ParseInteger(first_token(NUM_EQUATIONS), kInputKeys[NUM_EQUATIONS]);
     }
 
-    if (data.count("Derivative combination") && trim(data["Derivative combination"][0]) != "NA") {
-        for (const auto& line : data["Derivative combination"]) {
-            std::istringstream iss(line);
-            std::vector<std::string> row;
-            std::string entry;
-            while (iss >> entry) {
-                row.push_back(entry);
-            }
-            params.derivative_matrix.push_back(row);
-        }
+    unsigned long long key = 0;
+    bool cached = false;
+    if (cache != nullptr) {
+        key = HashSystem(lines);
+        cached = cache->Load(key, params);
     }
-    else {
+
+    if (cached) {
         params.derivative_matrix = {{""}};
     }
+    else {
+        if (!lines[FUNCTION_COMBINATION].empty()) {
+            params.function_matrix = parse_combination(FUNCTION_COMBINATION);
+        }
+
+        if (provided(FUNCTION_TERMS)) {
+            params.function_terms = parse_terms(FUNCTION_TERMS, 0);
+        }
+
+        if (provided(DERIVATIVE_COMBINATION)) {
+            params.derivative_matrix = parse_combination(DERIVATIVE_COMBINATION);
+        }
+        else {
+            params.derivative_matrix = {{""}};
+        }
+
+        if (provided(DERIVATIVE_TERMS)) {
+            params.derivative_terms = parse_terms(DERIVATIVE_TERMS, 1);
+        }
+
+        if (provided(DIFFUSION_COMBINATION)) {
+            params.diffusion_matrix = parse_combination(DIFFUSION_COMBINATION);
+        }
+
+        if (provided(DIFFUSION_DERIVATIVE_COMBINATION)) {
+            params.diffusion_derivative_matrix = parse_combination(DIFFUSION_DERIVATIVE_COMBINATION);
+        }
+    }
 
-    if (data.count("Method")) {
-        params.method = std::stoi(data["Method"][0]);
+    if (provided(SEED)) {
+        params.seed = ParseUnsigned(first_token(SEED), kInputKeys[SEED]);
     }
 
-    if (data.count("Initial Time") && data.count("Final Time") && data.count("Step Size")) {
-        params.initial_time = ParseFraction(data["Initial Time"][0]);
-        params.final_time = ParseFraction(data["Final Time"][0]);
-        params.step_size = ParseFraction(data["Step Size"][0]);
+    if (!lines[METHOD].empty()) {
+        params.method = ParseInteger(first_token(METHOD), kInputKeys[METHOD]);
     }
 
-    if (data.count("Number of Steps")) {
-        params.num_steps = std::stoi(data["Number of Steps"][0]);
+    if (!lines[INITIAL_TIME].empty() && !lines[FINAL_TIME].empty() && !lines[STEP_SIZE].empty()) {
+        params.initial_time = ParseValue(first_token(INITIAL_TIME));
+        params.final_time = ParseValue(first_token(FINAL_TIME));
+        params.step_size = ParseValue(first_token(STEP_SIZE));
     }
 
-    if (data.count("Initial Condition") && trim(data["Initial Condition"][0]) != "NA") {
-        std::vector<double> flat_matrix;
-        for (const auto& line : data["Initial Condition"]) {
-            std::istringstream iss(line);
-            double value;
-            while (iss >> value) {
-                flat_matrix.push_back(value);
-            }
+    if (!lines[NUM_STEPS].empty()) {
+        params.num_steps = ParseInteger(first_token(NUM_STEPS), kInputKeys[NUM_STEPS]);
+    }
+
+    if (provided(INITIAL_CONDITION)) {
+        std::vector<double> flat_matrix = parse_values(INITIAL_CONDITION);
+        if (params.num_equations < 0 || params.num_steps < 0 || flat_matrix.size() != (size_t)params.num_equations * params.num_steps) {
+            throw std::runtime_error("Invalid format: The initial condition must have one row per step and one column per equation.");
         }
         params.initial_condition = Eigen::Map<Eigen::MatrixXd>(flat_matrix.data(), params.num_equations, params.num_steps);
     }
 
-    if (data.count("Number of Stages")) {
-        params.num_stage = std::stoi(data["Number of Stages"][0]);
+    if (!lines[NUM_STAGES].empty()) {
+        params.num_stage = ParseInteger(first_token(NUM_STAGES), kInputKeys[NUM_STAGES]);
     }
 
-    if (data.count("A") && trim(data["A"][0]) != "NA") {
-        std::vector<double> flat_matrix;
-        for (const auto& line : data["A"]) {
-            std::istringstream iss(line);
-            std::string value;
-            while (iss >> value) {
-                flat_matrix.push_back(ParseFraction(value));
-            }
+    if (provided(A)) {
+        std::vector<double> flat_matrix = parse_values(A);
+        if (params.num_stage < 0 || flat_matrix.size() != (size_t)params.num_stage * params.num_stage) {
+            throw std::runtime_error("Invalid format: A must be a square matrix with one row per stage.");
         }
         params.a = Eigen::Map<Eigen::MatrixXd>(flat_matrix.data(), params.num_stage, params.num_stage).transpose();
     }
 
-    if (data.count("B") && trim(data["B"][0]) != "NA") {
-        std::istringstream iss(data["B"][0]);
-        std::vector<double> vector;
-        std::string value;
-        while (iss >> value) {
-            vector.push_back(ParseFraction(value));
-        }
-        params.b = Eigen::Map<Eigen::VectorXd>(vector.data(), vector.size());
+    if (provided(B)) {
+        params.b = parse_vector(B);
     }
 
-    if (data.count("C") && trim(data["C"][0]) != "NA") {
-        std::istringstream iss(data["C"][0]);
-        std::vector<double> vector;
-        std::string value;
-        while (iss >> value) {
-            vector.push_back(ParseFraction(value));
-        }
-        params.c = Eigen::Map<Eigen::VectorXd>(vector.data(), vector.size());
-        PrintVector(params.c, "C");
+    if (provided(C)) {
+        params.c = parse_vector(C);
     }
 
-    if (data.count("Alpha") && trim(data["Alpha"][0]) != "NA") {
-        std::cout << data["Alpha"][0] << std::endl;
-        std::istringstream iss(data["Alpha"][0]);
-        std::vector<double> vector;
-        std::string value;
-        while (iss >> value) {
-            vector.push_back(ParseFraction(value));
-        }
-        params.alpha = Eigen::Map<Eigen::VectorXd>(vector.data(), vector.size());
+    if (provided(ALPHA)) {
+        params.alpha = parse_vector(ALPHA);
+    }
+
+    if (provided(BETA)) {
+        params.beta = parse_vector(BETA);
+    }
+
+    if (provided(RELATIVE_TOLERANCE)) {
+        params.rel_tol = ParseValue(first_token(RELATIVE_TOLERANCE));
+    }
 
+    if (provided(ABSOLUTE_TOLERANCE)) {
+        params.abs_tol = ParseValue(first_token(ABSOLUTE_TOLERANCE));
     }
 
-    if (data.count("Beta") && trim(data["Beta"][0]) != "NA") {
-        std::istringstream iss(data["Beta"][0]);
-        std::vector<double> vector;
-        std::string value;
-        while (iss >> value) {
-            vector.push_back(ParseFraction(value));
+    if (provided(EVENTS)) {
+        for (TextSpan line : lines[EVENTS]) {
+            TextSpan variable, threshold, token;
+            if (!NextToken(line, variable)) continue;
+            if (!NextToken(line, threshold)) {
+                throw std::runtime_error("Invalid format: Incomplete event in Events");
+            }
+            int index = ParseInteger(variable, kInputKeys[EVENTS]);
+            if (index < 1) {
+                throw std::runtime_error("Invalid value for Events: " + variable.str());
+            }
+            int direction = 0;
+            EventAction action = RECORD_EVENT;
+            while (NextToken(line, token)) {
+                if (token == "rising") direction = 1;
+                else if (token == "falling") direction = -1;
+                else if (token == "any") direction = 0;
+                else if (token == "record") action = RECORD_EVENT;
+                else if (token == "stop") action = STOP_AT_EVENT;
+                else throw std::runtime_error("Invalid value for Events: " + token.str());
+            }
+            params.events.push_back(ThresholdEvent(index - 1, ParseValue(threshold), direction, action));
         }
-        params.beta = Eigen::Map<Eigen::VectorXd>(vector.data(), vector.size());
+    }
+
+    if (cache != nullptr && !cached) {
+        cache->Store(key, params);
     }
 
     return params;
 }
+
+} // namespace
+
+InputParameters ParseInputFile(const std::string& filename) {
+    MappedInputFile file(filename);
+    return ParseInput(file.GetText(), nullptr);
+}
+
+InputParameters ParseInputFile(const std::string& filename, const SystemCache& cache) {
+    MappedInputFile file(filename);
+    return ParseInput(file.GetText(), &cache);
+}
+
+InputParameters ParseInputText(const std::string& text) {
+    return ParseInput({text.data(), text.data() + text.size()}, nullptr);
+}
+
+InputParameters ParseInputText(const std::string& text, const SystemCache& cache) {
+    return ParseInput({text.data(), text.data() + text.size()}, &cache);
+}
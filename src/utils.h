@@ -6,6 +6,15 @@
 #define UTILS_H
 
 #include <Eigen/Dense>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Checkpoint.h"
+#include "EventMonitor.h"
+#include "Function.h"
+
+class SystemCache;
 
 /**
  * @brief Parses a string potentially representing a fraction and returns the result as a double.
@@ -31,6 +40,17 @@ double ParseFraction(const std::string& fraction);
  */
 bool IsLowerTriangular(const Eigen::MatrixXd& matrix);
 
+/**
+ * @brief Checks if the non-zero diagonal entries of a matrix are all equal.
+ * 
+ * This is the structure of the Butcher tableau of an SDIRK or ESDIRK method, where
+ * every implicit stage has the same diagonal coefficient \f$ \gamma \f$.
+ * 
+ * @param matrix The matrix to check.
+ * @return true if all non-zero diagonal entries are equal (or the diagonal is zero), false otherwise.
+ */
+bool HasConstantDiagonal(const Eigen::MatrixXd& matrix);
+
 /**
  * @brief Checks if a given 2D vector represents a square matrix.
  * 
@@ -41,10 +61,46 @@ bool IsLowerTriangular(const Eigen::MatrixXd& matrix);
  */
 bool IsSquareMatrix(const std::vector<std::vector<std::string>>& matrix);
 
+/**
+ * @brief Computes the weighted root mean square norm of a vector.
+ * 
+ * The norm is \f$ \sqrt{\frac{1}{n} \sum_i (w_i v_i)^2} \f$. With weights \f$ w_i = 1 / (atol + rtol |y_i|) \f$
+ * a norm of one corresponds to the requested accuracy.
+ * 
+ * @param vec The vector to measure.
+ * @param weights The weights, one per entry of the vector.
+ * @return double The weighted root mean square norm, zero for an empty vector.
+ */
+double WeightedRmsNorm(const Eigen::VectorXd& vec, const Eigen::VectorXd& weights);
+
+/**
+ * @brief Computes the coefficients of the explicit Adams-Bashforth method with a given number of steps.
+ * 
+ * The coefficients \f$ \beta_j \f$ satisfy \f$ y_{n+1} = y_n + h \sum_{j=0}^{k-1} \beta_j f(t_{n-j}, y_{n-j}) \f$
+ * and are obtained by integrating the Lagrange basis polynomials over \f$ [t_n, t_{n+1}] \f$.
+ * 
+ * @param steps The number of steps \f$ k \f$.
+ * @return Eigen::VectorXd The coefficients \f$ \beta_0, \ldots, \beta_{k-1} \f$.
+ * @throws std::invalid_argument If the number of steps is not positive.
+ */
+Eigen::VectorXd AdamsBashforthCoefficients(int steps);
+
+/**
+ * @brief Computes the coefficients of polynomial extrapolation on an equally spaced grid.
+ * 
+ * The coefficients \f$ e_j \f$ satisfy \f$ y_{n+1} \approx \sum_{j=0}^{k-1} e_j y_{n-j} \f$, which is exact for
+ * polynomials of degree \f$ k - 1 \f$.
+ * 
+ * @param points The number of points \f$ k \f$.
+ * @return Eigen::VectorXd The coefficients \f$ e_0, \ldots, e_{k-1} \f$.
+ * @throws std::invalid_argument If the number of points is not positive.
+ */
+Eigen::VectorXd ExtrapolationCoefficients(int points);
+
 /**
  * @brief Prints a vector to the console.
  * 
- * Useful for debugging or displaying vector contents.
+ * Useful for debugging or displaying vector contents. The values are written with 4 significant digits through a TextWriter.
  * 
  * @param vec The vector to print.
  * @param name The name or label of the vector.
@@ -61,6 +117,18 @@ void PrintVector(const Eigen::VectorXd& vec, const std::string& name);
  */
 void PrintMatrix(const Eigen::MatrixXd& mat, const std::string& name);
 
+/**
+ * @brief Writes a matrix to a stream, in the format of PrintMatrix().
+ * 
+ * The values are written with the current precision of the stream, through a TextWriter that hands the text to
+ * the stream in large blocks and flushes it once at the end.
+ * 
+ * @param out The stream to write to.
+ * @param mat The matrix to write.
+ * @param name The name or label of the matrix.
+ */
+void WriteMatrix(std::ostream& out, const Eigen::MatrixXd& mat, const std::string& name);
+
 /**
  * @brief A structure to hold input parameters for numerical methods.
  * 
@@ -72,6 +140,20 @@ struct InputParameters {
     int num_equations = 0; ///< Number of equations in the ODE system.
     std::vector<std::vector<std::string>> function_matrix; ///< Function matrix (mandatory).
     std::vector<std::vector<std::string>> derivative_matrix; ///< Derivative matrix (optional).
+    std::vector<FunctionTerm> function_terms; ///< Non-zero entries of the function matrix, instead of the matrix (optional).
+    std::vector<FunctionTerm> derivative_terms; ///< Non-zero entries of the derivative matrix, instead of the matrix (optional).
+    std::vector<std::vector<std::string>> diffusion_matrix; ///< Diffusion matrix of stochastic methods (optional).
+    std::vector<std::vector<std::string>> diffusion_derivative_matrix; ///< Derivative matrix of the diffusion (optional).
+    unsigned long long seed = 0; ///< The seed of the random numbers of stochastic methods.
+    std::shared_ptr<const Function> function; ///< The compiled function and derivative matrices, set by a SystemCache (optional).
+    std::shared_ptr<const Function> diffusion; ///< The compiled diffusion matrices, set by a SystemCache (optional).
+    std::string checkpoint_file; ///< The file receiving the checkpoints of the solve, empty to write none (optional).
+    long checkpoint_points = 0; ///< The number of time points between two checkpoints, zero for no limit.
+    double checkpoint_seconds = 0.0; ///< The wall time between two checkpoints in seconds, zero for no limit.
+    std::shared_ptr<const SolverCheckpoint> restart; ///< The checkpoint the solve resumes from (optional).
+    std::vector<SolverEvent> events; ///< The threshold events watched during the solve (optional).
+    double rel_tol = 1e-6; ///< The relative tolerance of the adaptive and implicit methods (optional).
+    double abs_tol = 1e-6; ///< The absolute tolerance of the adaptive and implicit methods (optional).
     int method = -1; ///< The method to use for solving the ODEs (e.g., RK, AB, AM, BDF).
     double initial_time = -1; ///< The initial time for the simulation.
     double final_time = -1; ///< The final time for the simulation.
@@ -91,11 +173,54 @@ struct InputParameters {
  * 
  * Reads an input file and extracts the parameters needed for solving ODEs.
  * 
+ * The file is mapped in memory and tokenized in place, so that the input of large systems is read without
+ * copying every line. Large sparse systems can list the non-zero entries of the function and derivative matrices
+ * as "equation column entry" triplets under "Function terms" and "Derivative terms" (see FunctionTerm).
+ * Every line of "Events" is a threshold event "variable threshold [rising|falling|any] [record|stop]", with the
+ * variables counted from one, watched in both directions and recorded by default (see ThresholdEvent()).
+ * "Relative Tolerance" and "Absolute Tolerance" set the tolerances of the solver (see OdeSolver::SetTolerances()).
+ * 
  * @param filename The name of the input file.
  * @return InputParameters A structure containing the parsed parameters.
  * @throws std::runtime_error If the input file is not found or if there is an error in the input file.
  */
 InputParameters ParseInputFile(const std::string& filename);
 
+/**
+ * @brief Parses an input file, taking the compiled system from a cache when it was compiled before.
+ * 
+ * The sections that define the system (the number of equations and the function, derivative and diffusion
+ * matrices or terms) are hashed instead of parsed. When the cache holds the system of that hash, the compiled
+ * functions are attached to the parameters and the matrices are left empty. Otherwise the file is parsed as by
+ * ParseInputFile() and the compiled system is added to the cache. The other sections, such as the initial
+ * condition or the step size, are always parsed, so that they can change between runs without a cache miss.
+ * 
+ * @param filename The name of the input file.
+ * @param cache The cache of compiled systems, such as a ProblemCache or a MemoryProblemCache.
+ * @return InputParameters A structure containing the parsed parameters.
+ * @throws std::runtime_error If the input file is not found or if there is an error in the input file.
+ */
+InputParameters ParseInputFile(const std::string& filename, const SystemCache& cache);
+
+/**
+ * @brief Parses the content of an input file held in memory.
+ * 
+ * @param text The content, in the format of ParseInputFile().
+ * @return InputParameters A structure containing the parsed parameters.
+ * @throws std::runtime_error If there is an error in the input.
+ */
+InputParameters ParseInputText(const std::string& text);
+
+/**
+ * @brief Parses the content of an input file held in memory, taking the compiled system from a cache when it
+ * was compiled before (see ParseInputFile(const std::string&, const SystemCache&)).
+ * 
+ * @param text The content, in the format of ParseInputFile().
+ * @param cache The cache of compiled systems.
+ * @return InputParameters A structure containing the parsed parameters.
+ * @throws std::runtime_error If there is an error in the input.
+ */
+InputParameters ParseInputText(const std::string& text, const SystemCache& cache);
+
 
 #endif // UTILS_H
\ No newline at end of file
@@ -5,7 +5,19 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <limits>
 #include <stdexcept>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include <gtest/gtest.h>
 
 
@@ -23,6 +35,44 @@
 #include "../src/AdamBashforthThreeSteps.h"
 #include "../src/AdamBashforthFourSteps.h"
 #include "../src/BackwardEuler.h"
+#include "../src/Rosenbrock.h"
+#include "../src/Ros2.h"
+#include "../src/Ros3p.h"
+#include "../src/Ros3.h"
+#include "../src/Rodas3.h"
+#include "../src/Rodas4.h"
+#include "../src/Sdirk2.h"
+#include "../src/Sdirk4.h"
+#include "../src/Kvaerno3.h"
+#include "../src/Esdirk4.h"
+#include "../src/RadauIIA.h"
+#include "../src/Gbs.h"
+#include "../src/Seulex.h"
+#include "../src/EulerMaruyama.h"
+#include "../src/Milstein.h"
+#include "../src/Philox.h"
+#include "../src/SdeEnsemble.h"
+#include "../src/EnsembleSolver.h"
+#include "../src/EnsembleRungeKutta.h"
+#include "../src/Parareal.h"
+#include "../src/WaveformRelaxation.h"
+#include "../src/BatchRunner.h"
+#include "../src/SolveHandle.h"
+#include "../src/TrajectoryFile.h"
+#include "../src/TrajectoryView.h"
+#include "../src/MappedTrajectory.h"
+#include "../src/Problem.h"
+#include "../src/ProblemCache.h"
+#include "../src/MemoryProblemCache.h"
+#include "../src/SolverServer.h"
+#include "../src/TextWriter.h"
+#include "../src/CompressedTrajectory.h"
+#include "../src/CsvTrajectory.h"
+#include "../src/PipelinedTrajectory.h"
+#include "../src/Checkpoint.h"
+#include "../src/EventMonitor.h"
+#include "../src/ThreadPool.h"
+#include "../src/utils.h"
 
 
 // **************************** Vector function tests *******************************
@@ -313,6 +363,13 @@ TEST_F(ScalarODETest, AdamBashforth3){
                 1.2357624824905629, 1.3040058793700633, 1.3624904104404907, 1.4123661773042349, 1.4546906424554022, 1.4904209469249723, 1.5204139266758374, 1.5454306713336203, 
                 1.5661434764930962, 1.5831438199015535, 1.5969505269844781, 1.6080176491675773;
     ASSERT_TRUE(approximations.isApprox(expected, 1e-4));
+
+    // The generic method takes one coefficient per initial step.
+    Eigen::VectorXd beta(3);
+    beta << 23.0 / 12.0, -16.0 / 12.0, 5.0 / 12.0;
+    AdamBashforth generic(step_size, initial_time, final_time, initial_condition, function, beta);
+    ASSERT_EQ(generic.Solve(), approximations);
+    ASSERT_THROW(AdamBashforth(step_size, initial_time, final_time, initial_condition.leftCols(2), function, beta), std::invalid_argument);
 }
 
 TEST_F(ScalarODETest, AdamBashforth4){
@@ -399,4 +456,2057 @@ TEST_F(ScalarODETest, BDF3){
                 1.2396958737495392, 1.3075831161625928, 1.365705338703422, 1.415229145413565, 1.4572235580035846, 1.4926517829524633, 1.5223726638627837, 1.5471468451004382, 
                 1.56764448888212478, 1.5844559572828016, 1.5980963727660995, 1.6090177087207407;
     ASSERT_TRUE(approximations.isApprox(expected, 1e-4));
-}
\ No newline at end of file
+}
+
+// **************************** Newton method tests *******************************
+
+TEST(NewtonMethodTest, ConvergesAndReportsStatus){
+    Function function({{"+1_3_-1", "1_2_1"}}, {{"-1_1_1"}});
+    Eigen::VectorXd y0 = Eigen::VectorXd::Zero(1);
+    NewtonMethod newton_solver(function, y0, 0.1, 1.0, 0.1);
+    Eigen::VectorXd y;
+
+    ASSERT_EQ(newton_solver.Solve(y), CONVERGED);
+    ASSERT_LE(newton_solver.GetIterations(), 4);
+    double residual = y(0) - y0(0) - 0.1 * function.BuildRightHandSide(0.1, y)(0);
+    ASSERT_NEAR(residual, 0.0, 1e-6);
+}
+
+TEST(NewtonMethodTest, StopsAtIterationCap){
+    Function function({{"+1_3_-1", "1_2_1"}}, {{"-1_1_1"}});
+    NewtonMethod newton_solver(function, Eigen::VectorXd::Zero(1), 0.1, 1.0, 0.1);
+    newton_solver.SetTolerance(1e-14);
+    newton_solver.SetMaxIterations(1);
+    Eigen::VectorXd y;
+
+    ASSERT_EQ(newton_solver.Solve(y), MAX_ITERATIONS);
+    ASSERT_EQ(newton_solver.GetIterations(), 1);
+    ASSERT_THROW(newton_solver.Solve(), std::runtime_error);
+}
+
+TEST(NewtonMethodTest, FailsEarlyWithWrongJacobian){
+    // The Jacobian has the wrong sign, so the iteration cannot contract.
+    Function function({{"0", "-1_4_3"}}, {{"+3_4_2"}});
+    NewtonMethod newton_solver(function, Eigen::VectorXd::Constant(1, 1.0), 0.0, 1.0, 1.0);
+    newton_solver.SetMaxIterations(50);
+    Eigen::VectorXd y;
+
+    NewtonStatus status = newton_solver.Solve(y);
+    ASSERT_TRUE(status == DIVERGED || status == SLOW_CONVERGENCE);
+    ASSERT_LT(newton_solver.GetIterations(), 50);
+}
+
+
+// **************************** Predictor tests *******************************
+
+TEST(PredictorTest, AdamsBashforthCoefficients){
+    Eigen::VectorXd expected(4);
+    expected << 55.0/24.0, -59.0/24.0, 37.0/24.0, -9.0/24.0;
+    ASSERT_TRUE(AdamsBashforthCoefficients(4).isApprox(expected, 1e-12));
+    ASSERT_NEAR(AdamsBashforthCoefficients(1)(0), 1.0, 1e-12);
+}
+
+TEST(PredictorTest, ExtrapolationCoefficients){
+    Eigen::VectorXd expected(3);
+    expected << 3.0, -3.0, 1.0;
+    ASSERT_TRUE(ExtrapolationCoefficients(3).isApprox(expected, 1e-12));
+}
+
+TEST_F(ScalarODETest, AdamMoulton3Predictors){
+    Eigen::MatrixXd initial_condition(1, 3);
+    initial_condition << 0.0, 0.2, 0.3884;
+    Eigen::VectorXd beta(4);
+    beta << 5.0/12.0, 2.0/3.0, -1.0/12.0, 0.0;
+    AdamMoulton reference(step_size, initial_time, final_time, initial_condition, function, beta);
+    reference.SetPredictor(PREVIOUS_VALUE);
+    Eigen::MatrixXd expected = reference.Solve();
+
+    for (PredictorType predictor : {EXTRAPOLATION, ADAMS_BASHFORTH})
+    {
+        AdamMoulton adam_moulton(step_size, initial_time, final_time, initial_condition, function, beta);
+        adam_moulton.SetPredictor(predictor);
+        ASSERT_TRUE(adam_moulton.Solve().isApprox(expected, 1e-6));
+    }
+}
+
+TEST_F(ScalarODETest, AdamMoulton3PECE){
+    Eigen::MatrixXd initial_condition(1, 3);
+    initial_condition << 0.0, 0.2, 0.3884;
+    Eigen::VectorXd beta(4);
+    beta << 5.0/12.0, 2.0/3.0, -1.0/12.0, 0.0;
+    AdamMoulton adam_moulton(step_size, initial_time, final_time, initial_condition, function, beta);
+    Eigen::MatrixXd expected = adam_moulton.Solve();
+
+    adam_moulton.SetCorrector(PECE);
+    ASSERT_TRUE(adam_moulton.Solve().isApprox(expected, 1e-3));
+}
+
+TEST_F(ScalarODETest, BDF3Predictors){
+    Eigen::MatrixXd initial_condition(1, 3);
+    initial_condition << 0.0, 0.2, 0.3884;
+    Eigen::VectorXd alpha(4);
+    alpha << 11.0/6.0, 3.0, -3.0/2.0, 1.0/3.0;
+    BDF reference(step_size, initial_time, final_time, initial_condition, function, alpha);
+    reference.SetPredictor(PREVIOUS_VALUE);
+    Eigen::MatrixXd expected = reference.Solve();
+
+    for (PredictorType predictor : {EXTRAPOLATION, ADAMS_BASHFORTH})
+    {
+        BDF bdf(step_size, initial_time, final_time, initial_condition, function, alpha);
+        bdf.SetPredictor(predictor);
+        ASSERT_TRUE(bdf.Solve().isApprox(expected, 1e-6));
+    }
+}
+
+
+TEST_F(ScalarODETest, BackwardEulerPredictors){
+    Eigen::MatrixXd initial_condition(1, 1);
+    initial_condition(0) = 0.0;
+    BackwardEuler reference(step_size, initial_time, final_time, initial_condition, function);
+    reference.SetPredictor(PREVIOUS_VALUE);
+    Eigen::MatrixXd expected = reference.Solve();
+
+    for (PredictorType predictor : {EXTRAPOLATION, ADAMS_BASHFORTH})
+    {
+        BackwardEuler backward_euler(step_size, initial_time, final_time, initial_condition, function);
+        backward_euler.SetPredictor(predictor);
+        ASSERT_TRUE(backward_euler.Solve().isApprox(expected, 1e-6));
+    }
+}
+
+// **************************** Rosenbrock tests *******************************
+
+// Solve a problem with every built-in Rosenbrock method.
+template <typename Method>
+Eigen::MatrixXd SolveRosenbrock(double step_size, double initial_time, double final_time, Eigen::MatrixXd initial_condition, Function function, bool adaptive)
+{
+    Method method(step_size, initial_time, final_time, initial_condition, function);
+    method.SetAdaptive(adaptive);
+    return method.Solve();
+}
+
+TEST_F(VectorODETest, RosenbrockMethods){
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1, 0;
+    Eigen::MatrixXd expected(2, 11);
+    expected << 1.0, 1.0001665972309022, 1.0013282001538013, 1.0044599127395124, 1.0104973370103312, 1.0203175639544333, 1.0347210435984937, 1.0544146089718227, 1.0799959132880477, 1.111939520775678, 1.150584869443273, // y1 values
+             0.0, -0.0950083300352802, -0.1801330842168526, -0.2556720178652363, -0.3221164262191257, -0.38014376857174277, -0.43060748124373477, -0.4745241115682504, -0.5130579510566569, -0.5475033670759601, -0.5792650736367019; // y2 values
+
+    ASSERT_TRUE(SolveRosenbrock<Ros2>(step_size, initial_time, final_time, initial_condition, function, true).isApprox(expected, 1e-4));
+    ASSERT_TRUE(SolveRosenbrock<Ros3p>(step_size, initial_time, final_time, initial_condition, function, true).isApprox(expected, 1e-4));
+    ASSERT_TRUE(SolveRosenbrock<Ros3>(step_size, initial_time, final_time, initial_condition, function, true).isApprox(expected, 1e-4));
+    ASSERT_TRUE(SolveRosenbrock<Rodas3>(step_size, initial_time, final_time, initial_condition, function, true).isApprox(expected, 1e-4));
+    ASSERT_TRUE(SolveRosenbrock<Rodas4>(step_size, initial_time, final_time, initial_condition, function, true).isApprox(expected, 1e-4));
+}
+
+TEST_F(ScalarODETest, RosenbrockMethods){
+    // Non-autonomous problem, compared against RK4.
+    Eigen::MatrixXd initial_condition(1, 1);
+    initial_condition(0) = 0.0;
+    Eigen::MatrixXd expected(1, 21);
+    expected << 0.0, 0.19452361355176226, 0.3764184202146631, 0.5437708163551102, 
+                0.6955221892676562, 0.8314092300472722, 0.9518080266149732, 
+                1.0575457718904404, 1.1497249399321867, 1.229581976886883, 
+                1.2983854600589206, 1.3573693143277177, 1.4076932380013931, 
+                1.450422427082619, 1.4865200545578507, 1.516847644862736, 
+                1.5421699809651503, 1.5631623389942326, 1.5804186707982457, 
+                1.5944599125095782, 1.6057419588721633;
+
+    ASSERT_TRUE(SolveRosenbrock<Ros3p>(step_size, initial_time, final_time, initial_condition, function, true).isApprox(expected, 1e-4));
+    ASSERT_TRUE(SolveRosenbrock<Rodas4>(step_size, initial_time, final_time, initial_condition, function, true).isApprox(expected, 1e-4));
+    ASSERT_TRUE(SolveRosenbrock<Rodas4>(step_size, initial_time, final_time, initial_condition, function, false).isApprox(expected, 1e-4));
+}
+
+TEST(RosenbrockTest, ConvergenceOrder){
+    // y' = -y, y(0) = 1
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    auto observed_order = [&](Eigen::MatrixXd (*solve)(double, double, double, Eigen::MatrixXd, Function, bool)) {
+        double error_coarse = std::abs(solve(0.1, 0.0, 1.0, initial_condition, function, false)(0, 10) - std::exp(-1.0));
+        double error_fine = std::abs(solve(0.05, 0.0, 1.0, initial_condition, function, false)(0, 20) - std::exp(-1.0));
+        return std::log2(error_coarse / error_fine);
+    };
+
+    ASSERT_NEAR(observed_order(SolveRosenbrock<Ros2>), 2.0, 0.3);
+    ASSERT_NEAR(observed_order(SolveRosenbrock<Ros3p>), 3.0, 0.3);
+    ASSERT_NEAR(observed_order(SolveRosenbrock<Ros3>), 3.0, 0.3);
+    ASSERT_NEAR(observed_order(SolveRosenbrock<Rodas3>), 3.0, 0.3);
+    ASSERT_NEAR(observed_order(SolveRosenbrock<Rodas4>), 4.0, 0.3);
+}
+
+TEST(RosenbrockTest, StiffAdaptive){
+    // y1' = -y1, y2' = 999 y1 - 1000 y2 with the exact solution y1 = exp(-t), y2 = exp(-t) + exp(-1000 t).
+    Function function({{"0", "-1_6_1", "0"}, {"0", "+999_6_1", "-1000_6_1"}}, {{"-1_7_1", "0"}, {"+999_7_1", "-1000_7_1"}});
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1.0, 2.0;
+    Rodas4 method(0.1, 0.0, 1.0, initial_condition, function);
+    Eigen::MatrixXd approximations = method.Solve();
+
+    for (int n = 1; n <= 10; n++)
+    {
+        double t = 0.1 * n;
+        ASSERT_NEAR(approximations(0, n), std::exp(-t), 1e-5);
+        ASSERT_NEAR(approximations(1, n), std::exp(-t) + std::exp(-1000 * t), 1e-5);
+    }
+    // An explicit method would need more than a thousand steps for stability alone.
+    ASSERT_LT(method.GetAcceptedSteps(), 100);
+    ASSERT_GT(method.GetAcceptedSteps(), 10);
+}
+
+TEST(RosenbrockTest, InvalidCoefficients){
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    Eigen::MatrixXd a = Eigen::MatrixXd::Identity(2, 2);
+    Eigen::MatrixXd c = Eigen::MatrixXd::Zero(2, 2);
+    Eigen::VectorXd m = Eigen::VectorXd::Ones(2);
+    ASSERT_THROW(Rosenbrock(0.1, 0.0, 1.0, initial_condition, function, 0.5, a, c, m, m, m, m, 2), std::invalid_argument);
+}
+
+
+// **************************** Diagonally implicit Runge-Kutta tests *******************************
+
+TEST_F(VectorODETest, DiagonallyImplicitRK){
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1, 0;
+    Eigen::MatrixXd expected(2, 11);
+    expected << 1.0, 1.0001665972309022, 1.0013282001538013, 1.0044599127395124, 1.0104973370103312, 1.0203175639544333, 1.0347210435984937, 1.0544146089718227, 1.0799959132880477, 1.111939520775678, 1.150584869443273, // y1 values
+             0.0, -0.0950083300352802, -0.1801330842168526, -0.2556720178652363, -0.3221164262191257, -0.38014376857174277, -0.43060748124373477, -0.4745241115682504, -0.5130579510566569, -0.5475033670759601, -0.5792650736367019; // y2 values
+
+    Sdirk4 sdirk4(step_size, initial_time, final_time, initial_condition, function);
+    ASSERT_TRUE(sdirk4.Solve().isApprox(expected, 1e-4));
+    Esdirk4 esdirk4(step_size, initial_time, final_time, initial_condition, function);
+    ASSERT_TRUE(esdirk4.Solve().isApprox(expected, 1e-4));
+}
+
+TEST_F(ScalarODETest, DiagonallyImplicitRK){
+    // A user-defined SDIRK2 tableau matches the built-in one.
+    Eigen::MatrixXd initial_condition(1, 1);
+    initial_condition(0) = 0.0;
+    double gamma = 1.0 - 1.0 / std::sqrt(2.0);
+    Eigen::MatrixXd a(2, 2);
+    a << gamma, 0,
+         1.0 - gamma, gamma;
+    Eigen::VectorXd b(2);
+    b << 1.0 - gamma, gamma;
+    Eigen::VectorXd c(2);
+    c << gamma, 1.0;
+    RungeKutta method(step_size, initial_time, final_time, initial_condition, function, a, b, c);
+    ASSERT_TRUE(method.IsImplicit());
+    Sdirk2 sdirk2(step_size, initial_time, final_time, initial_condition, function);
+    ASSERT_TRUE(method.Solve().isApprox(sdirk2.Solve(), 1e-12));
+}
+
+TEST(DiagonallyImplicitRKTest, ConvergenceOrder){
+    // y' = -y, y(0) = 1
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    auto observed_order = [&](RungeKutta coarse, RungeKutta fine) {
+        double error_coarse = std::abs(coarse.Solve()(0, 10) - std::exp(-1.0));
+        double error_fine = std::abs(fine.Solve()(0, 20) - std::exp(-1.0));
+        return std::log2(error_coarse / error_fine);
+    };
+
+    ASSERT_NEAR(observed_order(Sdirk2(0.1, 0.0, 1.0, initial_condition, function), Sdirk2(0.05, 0.0, 1.0, initial_condition, function)), 2.0, 0.3);
+    ASSERT_NEAR(observed_order(Sdirk4(0.1, 0.0, 1.0, initial_condition, function), Sdirk4(0.05, 0.0, 1.0, initial_condition, function)), 4.0, 0.3);
+    ASSERT_NEAR(observed_order(Kvaerno3(0.1, 0.0, 1.0, initial_condition, function), Kvaerno3(0.05, 0.0, 1.0, initial_condition, function)), 3.0, 0.3);
+    ASSERT_NEAR(observed_order(Esdirk4(0.1, 0.0, 1.0, initial_condition, function), Esdirk4(0.05, 0.0, 1.0, initial_condition, function)), 4.0, 0.3);
+}
+
+TEST(DiagonallyImplicitRKTest, StiffProblem){
+    // y1' = -y1, y2' = 999 y1 - 1000 y2 with the exact solution y1 = exp(-t), y2 = exp(-t) + exp(-1000 t).
+    Function function({{"0", "-1_6_1", "0"}, {"0", "+999_6_1", "-1000_6_1"}}, {{"-1_7_1", "0"}, {"+999_7_1", "-1000_7_1"}});
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1.0, 2.0;
+    // The step size is fifty times the explicit stability limit; L-stability damps the fast mode within a few steps.
+    Esdirk4 method(0.1, 0.0, 1.0, initial_condition, function);
+    Eigen::MatrixXd approximations = method.Solve();
+
+    for (int n = 1; n <= 10; n++)
+    {
+        double t = 0.1 * n;
+        ASSERT_NEAR(approximations(0, n), std::exp(-t), 1e-5);
+        ASSERT_NEAR(approximations(1, n), std::exp(-t) + std::exp(-1000 * t), n < 3 ? 5e-2 : 1e-4);
+    }
+}
+
+TEST(DiagonallyImplicitRKTest, RejectsNonConstantDiagonal){
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    Eigen::MatrixXd a(2, 2);
+    a << 0.25, 0,
+         0.5, 0.5;
+    Eigen::VectorXd b(2);
+    b << 0.5, 0.5;
+    Eigen::VectorXd c(2);
+    c << 0.25, 1.0;
+    ASSERT_THROW(RungeKutta(0.1, 0.0, 1.0, initial_condition, function, a, b, c), std::invalid_argument);
+}
+
+
+// **************************** Radau IIA tests *******************************
+
+TEST_F(VectorODETest, RadauIIA){
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1, 0;
+    Eigen::MatrixXd expected(2, 11);
+    expected << 1.0, 1.0001665972309022, 1.0013282001538013, 1.0044599127395124, 1.0104973370103312, 1.0203175639544333, 1.0347210435984937, 1.0544146089718227, 1.0799959132880477, 1.111939520775678, 1.150584869443273, // y1 values
+             0.0, -0.0950083300352802, -0.1801330842168526, -0.2556720178652363, -0.3221164262191257, -0.38014376857174277, -0.43060748124373477, -0.4745241115682504, -0.5130579510566569, -0.5475033670759601, -0.5792650736367019; // y2 values
+
+    RadauIIA method(step_size, initial_time, final_time, initial_condition, function);
+    ASSERT_TRUE(method.Solve().isApprox(expected, 1e-4));
+    method.SetAdaptive(false);
+    ASSERT_TRUE(method.Solve().isApprox(expected, 1e-4));
+}
+
+TEST_F(ScalarODETest, RadauIIA){
+    Eigen::MatrixXd initial_condition(1, 1);
+    initial_condition(0) = 0.0;
+    Eigen::MatrixXd expected(1, 21);
+    expected << 0.0, 0.19452361355176226, 0.3764184202146631, 0.5437708163551102, 
+                0.6955221892676562, 0.8314092300472722, 0.9518080266149732, 
+                1.0575457718904404, 1.1497249399321867, 1.229581976886883, 
+                1.2983854600589206, 1.3573693143277177, 1.4076932380013931, 
+                1.450422427082619, 1.4865200545578507, 1.516847644862736, 
+                1.5421699809651503, 1.5631623389942326, 1.5804186707982457, 
+                1.5944599125095782, 1.6057419588721633;
+
+    RadauIIA method(step_size, initial_time, final_time, initial_condition, function);
+    ASSERT_TRUE(method.Solve().isApprox(expected, 1e-4));
+}
+
+TEST(RadauIIATest, ConvergenceOrder){
+    // y' = -y, y(0) = 1
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    RadauIIA coarse(0.5, 0.0, 2.0, initial_condition, function);
+    coarse.SetAdaptive(false);
+    RadauIIA fine(0.25, 0.0, 2.0, initial_condition, function);
+    fine.SetAdaptive(false);
+    double error_coarse = std::abs(coarse.Solve()(0, 4) - std::exp(-2.0));
+    double error_fine = std::abs(fine.Solve()(0, 8) - std::exp(-2.0));
+    ASSERT_NEAR(std::log2(error_coarse / error_fine), 5.0, 0.3);
+}
+
+TEST(RadauIIATest, StiffAdaptive){
+    // y1' = -y1, y2' = 999 y1 - 1000 y2 with the exact solution y1 = exp(-t), y2 = exp(-t) + exp(-1000 t).
+    Function function({{"0", "-1_6_1", "0"}, {"0", "+999_6_1", "-1000_6_1"}}, {{"-1_7_1", "0"}, {"+999_7_1", "-1000_7_1"}});
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1.0, 2.0;
+    RadauIIA method(0.1, 0.0, 1.0, initial_condition, function);
+    Eigen::MatrixXd approximations = method.Solve();
+
+    for (int n = 1; n <= 10; n++)
+    {
+        double t = 0.1 * n;
+        ASSERT_NEAR(approximations(0, n), std::exp(-t), 1e-5);
+        ASSERT_NEAR(approximations(1, n), std::exp(-t) + std::exp(-1000 * t), 1e-5);
+    }
+    ASSERT_LT(method.GetAcceptedSteps(), 100);
+    // The problem is linear, so the Newton iteration converges at once and the Jacobian is kept.
+    ASSERT_LT(method.GetJacobianEvaluations(), method.GetAcceptedSteps());
+}
+
+
+// **************************** Ensemble tests *******************************
+
+TEST(FunctionTest, CoefficientsAreSharedTermsWithOwnValues){
+    Function function({{"+1_3_-1", "1_2_1"}}, {{"-1_1_1"}});
+    Eigen::VectorXd expected(6);
+    expected << 1, -1, 1, 1, -1, 1;
+    ASSERT_TRUE(function.GetCoefficients().isApprox(expected));
+
+    Function scaled = function;
+    Eigen::VectorXd coefficients = expected;
+    coefficients(0) = 2.0;
+    scaled.SetCoefficients(coefficients);
+    Eigen::VectorXd y = Eigen::VectorXd::Zero(1);
+    ASSERT_NEAR(scaled.BuildRightHandSide(0.0, y)(0), 3.0, 1e-12);
+    ASSERT_NEAR(function.BuildRightHandSide(0.0, y)(0), 2.0, 1e-12);
+    ASSERT_THROW(scaled.SetCoefficients(Eigen::VectorXd::Zero(2)), std::invalid_argument);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce){
+    ThreadPool pool(4);
+    std::vector<int> visits(1000, 0);
+    pool.ParallelFor(0, 1000, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+            visits[i]++;
+    });
+    for (int count : visits)
+        ASSERT_EQ(count, 1);
+}
+
+TEST_F(VectorODETest, EnsembleMatchesSerialSolves){
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1, 0;
+    RadauIIA prototype(step_size, initial_time, final_time, initial_condition, function);
+    std::vector<Eigen::MatrixXd> initial_conditions;
+    for (int m = 0; m < 20; m++)
+    {
+        Eigen::VectorXd member(2);
+        member << 1.0 + 0.1 * m, -0.05 * m;
+        initial_conditions.push_back(member);
+    }
+
+    EnsembleSolver<RadauIIA> ensemble(prototype, 3);
+    ensemble.SetInitialConditions(initial_conditions);
+    Eigen::MatrixXd results = ensemble.Solve();
+    ASSERT_EQ(results.rows(), 2);
+    ASSERT_EQ(results.cols(), 20 * 11);
+    ASSERT_TRUE(ensemble.GetFailedMembers().empty());
+    for (int m = 0; m < 20; m++)
+    {
+        RadauIIA serial(step_size, initial_time, final_time, initial_conditions[m], function);
+        ASSERT_TRUE(ensemble.GetMemberSolution(results, m).isApprox(serial.Solve(), 1e-12));
+    }
+}
+
+TEST(EnsembleTest, ParameterSweep){
+    // y' = k y with k swept over the members.
+    Function function({{"0", "+1_6_1"}}, {{"+1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    RungeKutta prototype(0.01, 0.0, 1.0, initial_condition, function, a, b, c);
+
+    Eigen::MatrixXd coefficients(4, 5);
+    for (int m = 0; m < 5; m++)
+        coefficients.col(m) << 1.0, -0.5 * m, 1.0, -0.5 * m;
+    EnsembleSolver<RungeKutta> ensemble(prototype, 2);
+    ensemble.SetCoefficients(coefficients);
+    Eigen::MatrixXd results(1, 5 * 101);
+    ensemble.Solve(results);
+    for (int m = 0; m < 5; m++)
+        ASSERT_NEAR(results(0, m * 101 + 100), std::exp(-0.5 * m), 1e-8);
+
+    Eigen::MatrixXd wrong_size(1, 10);
+    ASSERT_THROW(ensemble.Solve(wrong_size), std::invalid_argument);
+}
+
+TEST(EnsembleTest, FailedMembersAreReported){
+    // The Newton iteration of a stiff implicit step with a wrong Jacobian fails for the second member only.
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    RadauIIA prototype(0.1, 0.0, 1.0, initial_condition, function);
+    prototype.SetAdaptive(false);
+
+    Eigen::MatrixXd coefficients(4, 2);
+    coefficients.col(0) << 1.0, -1.0, -1.0, 1.0;
+    coefficients.col(1) << 1.0, -1000.0, 1000.0, 1.0;
+    EnsembleSolver<RadauIIA> ensemble(prototype, 2);
+    ensemble.SetCoefficients(coefficients);
+    Eigen::MatrixXd results = ensemble.Solve();
+
+    ASSERT_EQ(ensemble.GetFailedMembers(), std::vector<int>({1}));
+    ASSERT_TRUE(ensemble.GetMemberSolution(results, 0).allFinite());
+    ASSERT_TRUE(std::isnan(results(0, 11)));
+}
+
+TEST(FunctionTest, EnsembleRightHandSideMatchesEachTrajectory){
+    // One term of every function type, plus a time-dependent term.
+    Function function({{"+0.5_1_1", "+2_2_3", "-1_3_(-0.5)"}, {"0", "+1.5_4_2", "+3_5_2"}, {"-1_7_2", "+1_6_(-4)", "0"}});
+    EnsembleState y(3, 11);
+    for (int m = 0; m < 11; m++)
+        y.col(m) << 0.1 + 0.2 * m, 0.3 + 0.05 * m, 1.0 - 0.07 * m;
+    EnsembleState rhs;
+    function.BuildEnsembleRightHandSide(0.7, y, rhs);
+    ASSERT_EQ(rhs.rows(), 3);
+    ASSERT_EQ(rhs.cols(), 11);
+    for (int m = 0; m < 11; m++)
+    {
+        Eigen::VectorXd expected = function.BuildRightHandSide(0.7, y.col(m).matrix());
+        ASSERT_TRUE(rhs.col(m).matrix().isApprox(expected, 1e-14));
+    }
+}
+
+TEST(EnsembleTest, VectorLanesMatchSerialSolves){
+    Function function({{"0","+1_6_2","0"},{"0", "0", "-1_1_1"}}, {{"0","+1_7_2"},{"-1_2_1", "0"}});
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 0;
+    RungeKutta prototype(0.05, 0.0, 2.0, initial_condition, function, a, b, c);
+
+    // An ensemble size that does not divide into the blocks.
+    EnsembleState initial_conditions(2, 37);
+    for (int m = 0; m < 37; m++)
+        initial_conditions.col(m) << 1.0 - 0.05 * m, 0.02 * m;
+    EnsembleRungeKutta ensemble(prototype, 2);
+    ensemble.SetBlockSize(8);
+    ensemble.SetInitialConditions(initial_conditions);
+    Eigen::MatrixXd results = ensemble.Solve();
+    ASSERT_EQ(results.rows(), 2);
+    ASSERT_EQ(results.cols(), 37 * 41);
+    for (int m = 0; m < 37; m++)
+    {
+        RungeKutta serial(0.05, 0.0, 2.0, initial_conditions.col(m).matrix(), function, a, b, c);
+        ASSERT_TRUE(results.middleCols(m * 41, 41).isApprox(serial.Solve(), 1e-12));
+    }
+
+    ASSERT_THROW(ensemble.SetInitialConditions(EnsembleState::Zero(3, 4)), std::invalid_argument);
+    Sdirk2 implicit(0.05, 0.0, 2.0, initial_condition, function);
+    ASSERT_THROW(EnsembleRungeKutta(implicit, 1), std::invalid_argument);
+}
+
+TEST(FunctionTest, ParallelRightHandSideMatchesSerial){
+    // A lower triangular system, so that the equations have very different numbers of terms.
+    int dim = 300;
+    std::vector<std::vector<std::string>> combination(dim, std::vector<std::string>(dim + 1, "0"));
+    for (int i = 0; i < dim; i++)
+    {
+        combination[i][0] = "+0.5_1_1";
+        for (int j = 1; j <= i + 1; j++)
+            combination[i][j] = (j % 2 == 0) ? "-0.001_2_3" : "+0.002_6_1";
+    }
+    Function serial(combination);
+    Function parallel = serial;
+    parallel.SetNumThreads(4);
+    ASSERT_EQ(parallel.GetNumThreads(), 4);
+    ASSERT_EQ(parallel.GetNumTasks(), 4);
+    ASSERT_EQ(serial.GetNumTasks(), 1);
+    ASSERT_THROW(parallel.SetNumThreads(-1), std::invalid_argument);
+
+    Eigen::VectorXd y = Eigen::VectorXd::LinSpaced(dim, -1.0, 1.0);
+    ASSERT_EQ(parallel.BuildRightHandSide(0.3, y), serial.BuildRightHandSide(0.3, y));
+
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    RungeKutta serial_solver(0.1, 0.0, 1.0, y, serial, a, b, c);
+    RungeKutta parallel_solver(0.1, 0.0, 1.0, y, parallel, a, b, c);
+    ASSERT_EQ(parallel_solver.Solve(), serial_solver.Solve());
+}
+
+TEST(FunctionTest, ParallelJacobianMatchesSerial){
+    int dim = 150;
+    std::vector<std::vector<std::string>> combination(dim, std::vector<std::string>(dim + 1, "0"));
+    std::vector<std::vector<std::string>> derivative(dim, std::vector<std::string>(dim, "+0.0001_2_1"));
+    for (int i = 0; i < dim; i++)
+    {
+        combination[i][i + 1] = "-1_6_1";
+        derivative[i][i] = "-1_7_1";
+    }
+    Function serial(combination, derivative);
+    Function parallel = serial;
+    parallel.SetNumThreads(4);
+
+    Eigen::VectorXd y = Eigen::VectorXd::LinSpaced(dim, 0.5, 1.5);
+    ASSERT_EQ(parallel.BuildJacobian(0.0, y), serial.BuildJacobian(0.0, y));
+
+    BackwardEuler serial_solver(0.1, 0.0, 0.5, y, serial);
+    BackwardEuler parallel_solver(0.1, 0.0, 0.5, y, parallel);
+    Eigen::MatrixXd results = parallel_solver.Solve();
+    ASSERT_EQ(results, serial_solver.Solve());
+    ASSERT_NEAR(results(0, 5), 0.5 / std::pow(1.1, 5), 1e-6);
+}
+
+// **************************** Parareal tests *******************************
+
+TEST(PararealTest, ConvergesToTheFineSolution){
+    Function function({{"0","+1_6_2","0"},{"0", "0", "-1_1_1"}}, {{"0","+1_7_2"},{"-1_2_1", "0"}});
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 0;
+    RungeKutta fine(0.01, 0.0, 4.0, initial_condition, function, a, b, c);
+    RungeKutta coarse(0.25, 0.0, 4.0, initial_condition, function, a, b, c);
+    Eigen::MatrixXd serial = fine.Solve();
+
+    Parareal<RungeKutta, RungeKutta> parareal(coarse, fine, 16, 4);
+    parareal.SetTolerance(1e-10);
+    Eigen::MatrixXd results = parareal.Solve();
+    ASSERT_EQ(results.cols(), serial.cols());
+    ASSERT_LE(parareal.GetIterations(), 5);
+    ASSERT_LT((results - serial).lpNorm<Eigen::Infinity>(), 1e-8);
+
+    // Every point within a slice is exactly one fine step from the previous one, whatever the number of threads
+    // and the order in which the slices finish. This includes the first step of a slice, from the boundary point,
+    // which holds the corrected start value of the slice rather than the end of the previous slice. A loose
+    // tolerance stops the iteration while the two still differ.
+    for (int num_threads : {1, 4})
+    {
+        Parareal<RungeKutta, RungeKutta> loose(coarse, fine, 16, num_threads);
+        loose.SetTolerance(1e-3);
+        Eigen::MatrixXd early = loose.Solve();
+        ASSERT_LT(loose.GetIterations(), 16);
+        ASSERT_LT((early - serial).lpNorm<Eigen::Infinity>(), 1e-2);
+        for (int n = 1; n < early.cols(); n++)
+        {
+            if (n % 25 == 0)
+                continue;
+            RungeKutta step(0.01, 0.0, 0.01, early.col(n - 1), function, a, b, c);
+            ASSERT_EQ(step.Solve().col(1), early.col(n)) << "at time point " << n << " with " << num_threads << " threads";
+        }
+    }
+
+    // Without a tolerance, the last iteration reproduces the serial fine solve, whatever the coarse propagator.
+    ForwardEuler euler(0.1, 0.0, 4.0, initial_condition, function);
+    Parareal<ForwardEuler, RungeKutta> euler_parareal(euler, fine, 8, 4);
+    euler_parareal.SetTolerance(0.0);
+    results = euler_parareal.Solve();
+    ASSERT_EQ(euler_parareal.GetIterations(), 8);
+    ASSERT_LT((results - serial).lpNorm<Eigen::Infinity>(), 1e-12);
+
+    euler_parareal.SetMaxIterations(2);
+    ASSERT_THROW(euler_parareal.Solve(), std::runtime_error);
+    ASSERT_THROW((Parareal<ForwardEuler, RungeKutta>(euler, fine, 401, 1)), std::invalid_argument);
+}
+
+// **************************** Waveform relaxation tests *******************************
+
+TEST(FunctionTest, RowsAndDependencies){
+    Function function({{"0", "0", "+1_6_1", "0"}, {"+1_1_1", "-1_6_1", "0", "+0.5_3_1"}, {"0", "0", "0", "-2_6_1"}});
+    Eigen::VectorXd y(3);
+    y << 0.3, -0.2, 0.7;
+    Eigen::VectorXd full = function.BuildRightHandSide(0.4, y);
+    Eigen::VectorXd rows = function.BuildRightHandSide(0.4, y, {2, 0});
+    ASSERT_EQ(rows(0), full(2));
+    ASSERT_EQ(rows(1), full(0));
+    ASSERT_THROW(function.BuildRightHandSide(0.4, y, {3}), std::invalid_argument);
+    ASSERT_EQ(function.GetDependencies(3), std::vector<std::vector<int>>({{1}, {0, 2}, {2}}));
+}
+
+TEST(WaveformRelaxationTest, WeaklyCoupledOscillators){
+    // Two harmonic oscillators with a weak coupling between their positions.
+    Function function({{"0", "0", "+1_6_1", "0", "0"},
+                       {"0", "-1_6_1", "0", "+0.05_6_1", "0"},
+                       {"0", "0", "0", "0", "+1_6_1"},
+                       {"0", "+0.05_6_1", "0", "-4_6_1", "0"}});
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    Eigen::MatrixXd initial_condition(4, 1);
+    initial_condition << 1, 0, 0, 1;
+    RungeKutta prototype(0.01, 0.0, 2.0, initial_condition, function, a, b, c);
+    Eigen::MatrixXd serial = prototype.Solve();
+
+    WaveformRelaxation relaxation(prototype, 2);
+    ASSERT_EQ(relaxation.GetBlocks().size(), 1);
+    relaxation.SetBlocks({{0, 1}, {2, 3}});
+    relaxation.SetWindowSize(20);
+    relaxation.SetTolerance(1e-13);
+    Eigen::MatrixXd results = relaxation.Solve();
+    ASSERT_EQ(results.cols(), serial.cols());
+    ASSERT_LT((results - serial).lpNorm<Eigen::Infinity>(), 1e-11);
+    ASSERT_LT(relaxation.GetSweeps(), 10 * 10);
+
+    relaxation.SetMaxSweeps(1);
+    ASSERT_THROW(relaxation.Solve(), std::runtime_error);
+    ASSERT_THROW(relaxation.SetBlocks({{0, 1}, {1, 2}}), std::invalid_argument);
+    ASSERT_THROW(relaxation.SetBlocks({{0, 1}, {2}}), std::invalid_argument);
+}
+
+TEST(WaveformRelaxationTest, IndependentBlocksFromDependencies){
+    Function function({{"0", "-1_6_1", "0", "0"}, {"0", "0", "0", "+1_6_1"}, {"0", "0", "-1_6_1", "0"}});
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    Eigen::MatrixXd initial_condition(3, 1);
+    initial_condition << 1, 0, 1;
+    RungeKutta prototype(0.1, 0.0, 1.0, initial_condition, function, a, b, c);
+
+    WaveformRelaxation relaxation(prototype, 2);
+    ASSERT_EQ(relaxation.GetBlocks(), std::vector<std::vector<int>>({{0}, {1, 2}}));
+    Eigen::MatrixXd results = relaxation.Solve();
+    ASSERT_EQ(relaxation.GetSweeps(), 2);
+    ASSERT_LT((results - prototype.Solve()).lpNorm<Eigen::Infinity>(), 1e-14);
+}
+
+// **************************** Batch tests *******************************
+
+TEST(ThreadPoolTest, TasksQueuedByTasksAreWaitedFor){
+    ThreadPool pool(3);
+    std::atomic<int> count(0);
+    for (int i = 0; i < 10; i++)
+    {
+        pool.Enqueue([&pool, &count] {
+            for (int j = 0; j < 10; j++)
+                pool.Enqueue([&count] { count++; });
+            count++;
+        });
+    }
+    pool.Wait();
+    ASSERT_EQ(count, 110);
+}
+
+TEST(ThreadPoolTest, ParallelForRethrowsAndNests){
+    ThreadPool pool(2);
+    std::atomic<int> count(0);
+    ASSERT_THROW(pool.ParallelFor(0, 100, [&count](int begin, int end) {
+        count += end - begin;
+        if (begin == 0)
+            throw std::bad_alloc();
+    }, 10), std::bad_alloc);
+    // The call returns only once every chunk has run.
+    ASSERT_EQ(count, 100);
+
+    // Every worker runs a chunk that waits for a nested loop on the same pool.
+    count = 0;
+    pool.ParallelFor(0, 4, [&pool, &count](int begin, int end) {
+        for (int i = begin; i < end; i++)
+            pool.ParallelFor(0, 10, [&count](int inner_begin, int inner_end) { count += inner_end - inner_begin; }, 1);
+    }, 1);
+    ASSERT_EQ(count, 40);
+}
+
+TEST(BatchTest, SolvesEveryFileAndReportsFailures){
+    mkdir("batch_inputs", 0755);
+    mkdir("batch_outputs", 0755);
+    std::string problem = "Number of equations: 1\nFunction combination: +1_3_-1 1_2_1\nDerivative combination: -1_1_1\n"
+                          "Initial Time: 0.0\nFinal Time: 2.0\nStep Size: 0.1\nNumber of Steps: 1\nInitial Condition: 0.0\n";
+    std::ofstream("batch_inputs/euler.txt") << problem << "Method: 1\n";
+    std::ofstream("batch_inputs/ros2.txt") << problem << "Method: 11\n";
+    std::ofstream("batch_inputs/invalid.txt") << problem << "Method: 99\n";
+    std::ofstream("batch_inputs/short_history.txt") << problem << "Method: 4\n";
+    std::ofstream("batch_inputs/manifest") << "# Two of the problems\neuler.txt\n\nros2.txt\n";
+
+    BatchRunner runner(2);
+    runner.AddDirectory("batch_inputs");
+    ASSERT_EQ(runner.GetInputFiles(), std::vector<std::string>({"batch_inputs/euler.txt", "batch_inputs/invalid.txt", "batch_inputs/manifest", "batch_inputs/ros2.txt", "batch_inputs/short_history.txt"}));
+    runner.SetOutputDirectory("batch_outputs");
+    ASSERT_EQ(runner.GetOutputFile("batch_inputs/euler.txt"), "batch_outputs/euler.txt.out");
+    std::vector<BatchResult> results = runner.Run();
+    ASSERT_EQ(results.size(), 5);
+    ASSERT_TRUE(results[0].success);
+    ASSERT_EQ(results[0].method, "Forward Euler method");
+    ASSERT_FALSE(results[1].success);
+    ASSERT_EQ(results[1].error, "Invalid method: 99");
+    ASSERT_FALSE(results[2].success);
+    ASSERT_TRUE(results[3].success);
+    ASSERT_FALSE(results[4].success);
+    ASSERT_EQ(results[4].error, "The Adam-Bashforth three-steps needs 3 steps in the initial condition, which has 1.");
+    for (const auto& result : results)
+        ASSERT_GE(result.seconds, 0.0);
+
+    // The result file holds the full-precision solution.
+    std::ifstream output("batch_outputs/euler.txt.out");
+    std::string method, header, first, second;
+    std::getline(output, method);
+    std::getline(output, header);
+    output >> first >> first >> second;
+    ASSERT_EQ(method, "Forward Euler method");
+    ASSERT_EQ(header, "Approximations (1x21):");
+    ASSERT_EQ(first, "0,");
+    ASSERT_NEAR(std::stod(second), 0.2, 1e-15);
+
+    BatchRunner manifest_runner(1);
+    manifest_runner.AddManifest("batch_inputs/manifest");
+    ASSERT_EQ(manifest_runner.GetInputFiles(), std::vector<std::string>({"batch_inputs/euler.txt", "batch_inputs/ros2.txt"}));
+    ASSERT_EQ(manifest_runner.GetOutputFile("batch_inputs/euler.txt"), "batch_inputs/euler.txt.out");
+    std::stringstream report;
+    BatchRunner::WriteReport(manifest_runner.Run(), report);
+    ASSERT_NE(report.str().find("2 problems, 0 failed"), std::string::npos);
+    ASSERT_THROW(manifest_runner.AddDirectory("batch_missing"), std::runtime_error);
+
+    // Inputs of the same name in different directories cannot share an output directory.
+    BatchRunner colliding(1);
+    colliding.AddInputFile("batch_inputs/euler.txt");
+    colliding.AddInputFile("batch_outputs/euler.txt");
+    ASSERT_EQ(colliding.Run().size(), 2);
+    colliding.SetOutputDirectory("batch_outputs");
+    ASSERT_THROW(colliding.Run(), std::runtime_error);
+}
+
+// **************************** Asynchronous solve tests *******************************
+
+TEST(AsyncTest, ResultAndProgressMatchTheBlockingSolve){
+    Function function({{"0","+1_6_2","0"},{"0", "0", "-1_1_1"}}, {{"0","+1_7_2"},{"-1_2_1", "0"}});
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 0;
+    RungeKutta solver(0.1, 0.0, 2.0, initial_condition, function, a, b, c);
+
+    SolveHandle handle = SolveAsync(solver);
+    ASSERT_TRUE(handle.WaitFor(10.0));
+    ASSERT_EQ(handle.GetSteps(), 20);
+    ASSERT_NEAR(handle.GetTime(), 2.0, 1e-12);
+    ASSERT_NEAR(handle.GetProgress(), 1.0, 1e-12);
+    ASSERT_EQ(handle.Get(), solver.Solve());
+    ASSERT_TRUE(handle.IsReady());
+
+    // Adaptive solvers report their accepted steps.
+    Function stiff({{"0","-1_6_1","0"},{"0","+999_6_1","-1000_6_1"}}, {{"-1_7_1","0"},{"+999_7_1","-1000_7_1"}});
+    Eigen::MatrixXd stiff_initial_condition(2, 1);
+    stiff_initial_condition << 1, 2;
+    RadauIIA radau(0.1, 0.0, 1.0, stiff_initial_condition, stiff);
+    SolveHandle radau_handle = SolveAsync(radau);
+    Eigen::MatrixXd radau_results = radau_handle.Get();
+    ASSERT_EQ(radau_results, radau.Solve());
+    ASSERT_EQ(radau_handle.GetSteps(), radau.GetAcceptedSteps());
+}
+
+TEST(AsyncTest, CancellationStopsTheSolve){
+    Function function({{"0","+1_6_2","0"},{"0", "0", "-1_1_1"}});
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 0;
+    RungeKutta solver(1e-4, 0.0, 100.0, initial_condition, function, a, b, c);
+
+    SolveHandle handle = SolveAsync(solver);
+    while (handle.GetSteps() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    handle.Cancel();
+    ASSERT_THROW(handle.Get(), SolveCancelled);
+    ASSERT_LT(handle.GetSteps(), 1000000);
+    ASSERT_GT(handle.GetProgress(), 0.0);
+    ASSERT_LT(handle.GetProgress(), 1.0);
+
+    // A control can also be attached to a blocking solve.
+    auto control = std::make_shared<SolveControl>();
+    control->cancelled = true;
+    solver.SetControl(control);
+    ASSERT_THROW(solver.Solve(), SolveCancelled);
+    ASSERT_EQ(control->steps, 1);
+
+    // Assigning to a handle cancels its running solve, and a moved-from handle reports no progress.
+    solver.SetControl(nullptr);
+    SolveHandle running = SolveAsync(solver);
+    while (running.GetSteps() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    RungeKutta short_solver(0.1, 0.0, 1.0, initial_condition, function, a, b, c);
+    running = SolveAsync(short_solver);
+    ASSERT_EQ(running.Get(), short_solver.Solve());
+    SolveHandle moved = std::move(running);
+    ASSERT_EQ(running.GetSteps(), 0);
+    ASSERT_EQ(running.GetTime(), 0.0);
+    running.Cancel();
+}
+
+// **************************** Extrapolation tests *******************************
+
+TEST(ExtrapolationTest, GbsReachesTightTolerances){
+    // y1' = y2, y2' = -y1 with y(0) = (1, 0), so that y = (cos t, -sin t).
+    Function function({{"0", "0", "+1_6_1"}, {"0", "-1_6_1", "0"}});
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 0;
+    Gbs solver(1.0, 0.0, 10.0, initial_condition, function);
+    solver.SetTolerances(1e-10, 1e-10);
+    Eigen::MatrixXd results = solver.Solve();
+    for (int n = 0; n < results.cols(); n++)
+    {
+        ASSERT_NEAR(results(0, n), std::cos(n), 1e-8);
+        ASSERT_NEAR(results(1, n), -std::sin(n), 1e-8);
+    }
+    ASSERT_GT(solver.GetColumns(), 3);
+    ASSERT_LT(solver.GetAcceptedSteps(), 60);
+
+    // The sequences computed on a pool give the same steps.
+    Gbs parallel = solver;
+    parallel.SetNumThreads(4);
+    ASSERT_EQ(parallel.Solve(), results);
+    ASSERT_THROW(solver.SetMaxColumns(1), std::invalid_argument);
+}
+
+TEST(ExtrapolationTest, SeulexSolvesStiffProblem){
+    Function function({{"0","-1_6_1","0"},{"0","+999_6_1","-1000_6_1"}}, {{"-1_7_1","0"},{"+999_7_1","-1000_7_1"}});
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 2;
+    Seulex solver(0.1, 0.0, 2.0, initial_condition, function);
+    solver.SetTolerances(1e-6, 1e-8);
+    solver.SetNumThreads(3);
+    Eigen::MatrixXd results = solver.Solve();
+    for (int n = 1; n < results.cols(); n++)
+    {
+        double t = 0.1 * n;
+        ASSERT_NEAR(results(0, n), std::exp(-t), 1e-5);
+        ASSERT_NEAR(results(1, n), std::exp(-t) + std::exp(-1000 * t), 1e-5);
+    }
+    ASSERT_LT(solver.GetAcceptedSteps(), 200);
+
+    // In fixed mode every step uses the given number of columns.
+    solver.SetAdaptive(false);
+    solver.SetMaxColumns(6);
+    results = solver.Solve();
+    ASSERT_EQ(solver.GetColumns(), 6);
+    ASSERT_NEAR(results(0, 20), std::exp(-2.0), 1e-4);
+}
+
+// **************************** Stochastic tests *******************************
+
+TEST(PhiloxTest, MatchesKnownAnswersAndStreams){
+    Philox::Counter zero = Philox::Generate({0, 0, 0, 0}, {0, 0});
+    ASSERT_EQ(zero, (Philox::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    Philox::Counter ones = Philox::Generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+    ASSERT_EQ(ones, (Philox::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+
+    Philox generator(42);
+    ASSERT_EQ(generator.GetSeed(), 42u);
+    Eigen::VectorXd stream(100000);
+    generator.Normals(7, 0, stream);
+    Eigen::VectorXd middle(5);
+    generator.Normals(7, 3, middle);
+    ASSERT_EQ(middle, stream.segment(3, 5));
+    ASSERT_NEAR(stream.mean(), 0.0, 0.01);
+    ASSERT_NEAR(stream.squaredNorm() / stream.size(), 1.0, 0.02);
+
+    Eigen::VectorXd other(5);
+    generator.Normals(8, 3, other);
+    ASSERT_NE(other, middle);
+}
+
+namespace {
+// Geometric Brownian motion dy = 0.5 y dt + sigma y dW, with y(t) = y(0) exp((0.5 - sigma^2 / 2) t + sigma W(t)).
+Function GbmDrift(){
+    return Function(std::vector<std::vector<std::string>>{{"0", "0.5_6_1"}});
+}
+
+Function GbmDiffusion(const std::string& sigma){
+    return Function({{"0", sigma + "_6_1"}}, {{sigma + "_7_1"}});
+}
+}
+
+TEST(SdeTest, MilsteinConvergesStronglyFasterThanEulerMaruyama){
+    Eigen::MatrixXd y0(1, 1);
+    y0 << 1.0;
+    double euler_error = 0.0;
+    double milstein_error = 0.0;
+    for (int path = 0; path < 20; path++)
+    {
+        EulerMaruyama euler(0.001, 0.0, 1.0, y0, GbmDrift(), GbmDiffusion("1"));
+        Milstein milstein(0.001, 0.0, 1.0, y0, GbmDrift(), GbmDiffusion("1"));
+        euler.SetPath(path);
+        milstein.SetPath(path);
+        Eigen::MatrixXd euler_results = euler.Solve();
+        Eigen::MatrixXd milstein_results = milstein.Solve();
+
+        double w = 0.0;
+        for (int n = 1; n < euler.GetNumTimePoints(); n++)
+        {
+            ASSERT_EQ(euler.GetWienerIncrement(n), milstein.GetWienerIncrement(n));
+            w += euler.GetWienerIncrement(n)(0);
+        }
+        double exact = std::exp(w);
+        euler_error += std::abs(euler_results(0, 1000) - exact) / 20;
+        milstein_error += std::abs(milstein_results(0, 1000) - exact) / 20;
+    }
+    ASSERT_LT(milstein_error, 0.2 * euler_error);
+
+    Milstein without_derivative(0.001, 0.0, 1.0, y0, GbmDrift(), Function(std::vector<std::vector<std::string>>{{"0", "0.2_6_1"}}));
+    ASSERT_THROW(without_derivative.Solve(), std::runtime_error);
+}
+
+TEST(SdeTest, EnsemblePathsAreReproducibleAndHaveTheExpectedMean){
+    Eigen::MatrixXd y0(1, 1);
+    y0 << 1.0;
+    EulerMaruyama prototype(0.01, 0.0, 1.0, y0, GbmDrift(), GbmDiffusion("0.2"));
+    prototype.SetSeed(2024);
+    SdeEnsemble<EulerMaruyama> ensemble(prototype, 2000, 4);
+    Eigen::MatrixXd results = ensemble.Solve();
+    ASSERT_EQ(results.cols(), 2000 * 101);
+
+    SdeEnsemble<EulerMaruyama> serial(prototype, 2000, 1);
+    ASSERT_EQ(serial.Solve(), results);
+
+    EulerMaruyama single = prototype;
+    single.SetPath(1234);
+    ASSERT_EQ(single.Solve(), results.middleCols(1234 * 101, 101));
+
+    double mean = 0.0;
+    for (int m = 0; m < 2000; m++)
+    {
+        mean += results(0, m * 101 + 100) / 2000;
+    }
+    ASSERT_NEAR(mean, std::exp(0.5), 0.04);
+}
+
+// **************************** Trajectory file tests *******************************
+
+TEST(TrajectoryFileTest, RoundTripsBothLayouts){
+    Eigen::MatrixXd results(3, 5);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int n = 0; n < 5; n++)
+        {
+            results(i, n) = std::exp(0.1 * n) / (i + 3.0);
+        }
+    }
+    TrajectoryHeader header;
+    header.initial_time = 0.0;
+    header.final_time = 0.4;
+    header.step_size = 0.1;
+    header.rel_tol = 1e-8;
+    header.method = "Runge-Kutta method";
+
+    std::ostringstream time_major;
+    WriteTrajectory(time_major, results, header);
+    std::string bytes = time_major.str();
+    ASSERT_EQ(bytes.substr(0, 8), std::string("ODETRAJ\0", 8));
+    ASSERT_EQ(bytes.size(), 88u + 24u + 15u * 8u);
+    double value;
+    std::memcpy(&value, bytes.data() + 112 + 8 * 3, sizeof(value));
+    ASSERT_EQ(value, results(0, 1));
+
+    header.layout = COMPONENT_MAJOR;
+    std::ostringstream component_major;
+    WriteTrajectory(component_major, results, header);
+    std::memcpy(&value, component_major.str().data() + 112 + 8 * 3, sizeof(value));
+    ASSERT_EQ(value, results(0, 3));
+
+    WriteTrajectory("trajectory_component_major.bin", results, header);
+    TrajectoryHeader read_header;
+    Eigen::MatrixXd read = ReadTrajectory("trajectory_component_major.bin", read_header);
+    ASSERT_EQ(read, results);
+    ASSERT_EQ(read_header.dimension, 3u);
+    ASSERT_EQ(read_header.num_points, 5u);
+    ASSERT_EQ(read_header.final_time, 0.4);
+    ASSERT_EQ(read_header.rel_tol, 1e-8);
+    ASSERT_EQ(read_header.method, "Runge-Kutta method");
+    ASSERT_EQ(read_header.layout, COMPONENT_MAJOR);
+    ASSERT_EQ(read_header.data_offset, 112u);
+
+    std::istringstream garbage("not a trajectory file at all, but long enough to fill a header of eighty-eight bytes......");
+    ASSERT_THROW(ReadTrajectoryHeader(garbage), std::runtime_error);
+}
+
+TEST(TrajectoryFileTest, MappedSinkStreamsTheSolveThroughSmallChunks){
+    Function function({{"0","+1_6_2","0","0"},{"0", "0", "-1_1_1","0"},{"0","0.5_6_1","0","-0.5_6_1"}});
+    Eigen::MatrixXd initial_condition(3, 1);
+    initial_condition << 1, 0, 0.5;
+    ForwardEuler solver(0.001, 0.0, 10.0, initial_condition, function);
+    Eigen::MatrixXd expected = solver.Solve();
+
+    TrajectoryHeader header;
+    header.method = "Forward Euler method";
+    header.layout = COMPONENT_MAJOR;
+    // A state of 24 bytes straddles the boundaries of page-sized chunks.
+    MappedTrajectory trajectory("trajectory_mapped.bin", header, 1);
+    ASSERT_EQ(trajectory.GetChunkSize() % 4096, 0u);
+    ASSERT_LT(trajectory.GetChunkSize(), expected.size() * sizeof(double));
+    ASSERT_THROW(trajectory.GetView(), std::runtime_error);
+    solver.SolveTo(trajectory);
+
+    TrajectoryView view = trajectory.GetView();
+    ASSERT_EQ(view.GetHeader().layout, TIME_MAJOR);
+    ASSERT_EQ(view.GetHeader().method, "Forward Euler method");
+    ASSERT_EQ(view.GetValues(), expected);
+    TrajectoryHeader read_header;
+    ASSERT_EQ(ReadTrajectory("trajectory_mapped.bin", read_header), expected);
+    ASSERT_EQ(read_header.num_points, 10001u);
+
+    // Methods without a streaming solve fall back to the result of Solve().
+    Eigen::MatrixXd two_steps(3, 2);
+    two_steps << expected.col(0), expected.col(10);
+    AdamBashforthTwoSteps multistep(0.01, 0.0, 1.0, two_steps, function);
+    MatrixSink sink;
+    multistep.SolveTo(sink);
+    ASSERT_EQ(sink.Release(), multistep.Solve());
+
+    WriteTrajectory("trajectory_component_view.bin", expected, header);
+    TrajectoryView component_view("trajectory_component_view.bin");
+    ASSERT_EQ(component_view.GetValues(), expected);
+}
+
+TEST(TrajectoryFileTest, CompressedSinkRoundTripsExactly){
+    Function function({{"0","+1_6_2","0","0"},{"0", "0", "-1_1_1","0"},{"0","0.5_6_1","0","-0.5_6_1"}});
+    Eigen::MatrixXd initial_condition(3, 1);
+    initial_condition << 1, 0, 0.5;
+    ForwardEuler solver(0.001, 0.0, 10.0, initial_condition, function);
+    Eigen::MatrixXd expected = solver.Solve();
+
+    TrajectoryHeader header;
+    header.method = "Forward Euler method";
+    // Blocks of 1000 points leave a partial block at the end.
+    CompressedTrajectory trajectory("trajectory_compressed.bin", header, 1000);
+    solver.SolveTo(trajectory);
+    ASSERT_EQ(trajectory.GetHeader().num_points, 10001u);
+    std::uint64_t raw_size = expected.size() * sizeof(double);
+    // The smooth series are predicted to most of their bits.
+    ASSERT_LT(trajectory.GetFileSize() * 5, raw_size);
+    TrajectoryHeader read_header;
+    ASSERT_EQ(ReadTrajectory("trajectory_compressed.bin", read_header), expected);
+    ASSERT_EQ(read_header.layout, XOR_COMPRESSED);
+    ASSERT_EQ(read_header.method, "Forward Euler method");
+    ASSERT_THROW(TrajectoryView("trajectory_compressed.bin"), std::runtime_error);
+
+    // Every bit pattern round-trips, including special values and series that do not compress.
+    Eigen::MatrixXd special(4, 7);
+    special << 0.0, -0.0, 1.0, -1.0, 1e-310, -1e-310, 1e308,
+               std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 0.0, 0.0, 0.0, 0.0,
+               3.0, 3.0, 3.0, 3.0, 3.0, 3.0, 3.0,
+               0.1, -2e5, 7e-12, 42.0, -0.5, 1e100, -1e-100;
+    Eigen::MatrixXd random = Eigen::MatrixXd::Random(5, 3000) * 1e6;
+    header.layout = XOR_COMPRESSED;
+    for (const Eigen::MatrixXd& values : {special, random})
+    {
+        WriteTrajectory("trajectory_compressed.bin", values, header);
+        Eigen::MatrixXd read = ReadTrajectory("trajectory_compressed.bin", read_header);
+        ASSERT_EQ(read.rows(), values.rows());
+        ASSERT_EQ(read.cols(), values.cols());
+        ASSERT_EQ(std::memcmp(read.data(), values.data(), values.size() * sizeof(double)), 0);
+    }
+
+    // More points than announced are accepted, and a truncated file is refused.
+    CompressedTrajectory sink("trajectory_compressed.bin", header, 4);
+    sink.Begin(2, 3);
+    for (int n = 0; n < 10; n++)
+        sink.Append(Eigen::Vector2d(n, -n));
+    ASSERT_THROW(sink.Append(Eigen::Vector3d::Zero()), std::invalid_argument);
+    sink.End();
+    ASSERT_EQ(ReadTrajectory("trajectory_compressed.bin", read_header).row(1), -Eigen::RowVectorXd::LinSpaced(10, 0, 9));
+    std::string contents;
+    {
+        std::ifstream file("trajectory_compressed.bin", std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::ofstream("trajectory_compressed.bin", std::ios::binary) << contents.substr(0, contents.size() - 8);
+    ASSERT_THROW(ReadTrajectory("trajectory_compressed.bin", read_header), std::runtime_error);
+}
+
+// **************************** Text output tests *******************************
+
+TEST(TextWriterTest, ShortestRoundTripAndFixedPrecision){
+    std::ostringstream out;
+    {
+        TextWriter writer(out, 64);
+        writer.WriteRow(Eigen::Vector3d(0.1, 1.0 / 3.0, -2.5e-300));
+        writer.SetPrecision(4);
+        writer.SetDelimiter("; ");
+        writer.WriteRow(1.5, Eigen::Vector2d(std::acos(-1.0), 1e6));
+    }
+    ASSERT_EQ(out.str(), "0.1,0.3333333333333333,-2.5e-300\n1.5; 3.142; 1e+06\n");
+
+    // Every value reads back exactly, through many flushes of a small buffer.
+    Eigen::VectorXd values = Eigen::VectorXd::Random(2000) * 1e3;
+    values.array() *= Eigen::ArrayXd::LinSpaced(2000, -20, 20).exp();
+    std::ostringstream many;
+    {
+        TextWriter writer(many, 100);
+        writer.WriteRow(values);
+    }
+    std::istringstream in(many.str());
+    std::string field;
+    for (int i = 0; i < values.size(); i++)
+    {
+        ASSERT_TRUE(std::getline(in, field, i + 1 < values.size() ? ',' : '\n'));
+        ASSERT_EQ(std::strtod(field.c_str(), nullptr), values(i));
+        ASSERT_LE(field.size(), 24u);
+    }
+
+    // Random bit patterns, subnormals and extremes read back exactly too.
+    std::mt19937_64 random(12345);
+    std::vector<double> patterns = {5e-324, 2.2250738585072014e-308, 1.7976931348623157e308, 9007199254740993.0, 1e16, 1e17, 1e-5, 1e-4, 123456.0};
+    for (int i = 0; i < 200000; i++)
+    {
+        std::uint64_t bits = random();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value))
+            patterns.push_back(value);
+    }
+    std::ostringstream random_out;
+    {
+        TextWriter writer(random_out);
+        for (double value : patterns)
+        {
+            writer.Write(value);
+            writer.Write("\n");
+        }
+    }
+    std::istringstream random_in(random_out.str());
+    for (double value : patterns)
+    {
+        ASSERT_TRUE(std::getline(random_in, field));
+        ASSERT_EQ(std::strtod(field.c_str(), nullptr), value) << field;
+        ASSERT_LE(field.size(), 24u);
+    }
+
+    // The matrix printout keeps the format and the precision of the stream.
+    Eigen::MatrixXd mat(2, 2);
+    mat << 1.0 / 7.0, 2, -3e-5, 4e10;
+    std::ostringstream expected;
+    expected.precision(6);
+    expected << "M (2x2):\n[ " << mat(0, 0) << ", " << mat(0, 1) << " ]\n[ " << mat(1, 0) << ", " << mat(1, 1) << " ]\n";
+    std::ostringstream printed;
+    printed.precision(6);
+    WriteMatrix(printed, mat, "M");
+    ASSERT_EQ(printed.str(), expected.str());
+}
+
+TEST(TextWriterTest, CsvTrajectoryHasATimeColumn){
+    Function function({{"0","+1_6_2","0"},{"0", "0", "-1_1_1"}});
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 0;
+    ForwardEuler solver(0.25, 0.0, 1.0, initial_condition, function);
+    Eigen::MatrixXd expected = solver.Solve();
+
+    std::ostringstream out;
+    CsvTrajectory trajectory(out, 0.0, 0.25);
+    trajectory.GetWriter().SetDelimiter("\t");
+    solver.SolveTo(trajectory);
+
+    std::istringstream in(out.str());
+    std::string line;
+    std::getline(in, line);
+    ASSERT_EQ(line, "t\ty1\ty2");
+    for (int n = 0; n < expected.cols(); n++)
+    {
+        double t, y1, y2;
+        ASSERT_TRUE(in >> t >> y1 >> y2);
+        ASSERT_EQ(t, 0.25 * n);
+        ASSERT_EQ(y1, expected(0, n));
+        ASSERT_EQ(y2, expected(1, n));
+    }
+}
+
+namespace {
+// A sink that fails after a number of time points, like a full disk.
+class FailingSink : public TrajectorySink
+{
+public:
+    explicit FailingSink(long capacity) : capacity(capacity) {}
+    void Begin(int, long) override {}
+    void Append(const Eigen::VectorXd&) override {
+        if (--capacity < 0) throw std::runtime_error("No space left");
+    }
+    void End() override {}
+private:
+    long capacity;
+};
+}
+
+TEST(TextWriterTest, PipelinedSinkWritesTheSameOutput){
+    Function function({{"0","+1_6_2","0"},{"0", "0", "-1_1_1"}});
+    Eigen::MatrixXd initial_condition(2, 1);
+    initial_condition << 1, 0;
+    ForwardEuler solver(0.01, 0.0, 1.0, initial_condition, function);
+    Eigen::MatrixXd expected = solver.Solve();
+    std::ostringstream direct;
+    CsvTrajectory direct_trajectory(direct, 0.0, 0.01);
+    solver.SolveTo(direct_trajectory);
+
+    // Small blocks hand many blocks over, and a last one that is not full.
+    std::ostringstream out;
+    CsvTrajectory trajectory(out, 0.0, 0.01);
+    PipelinedTrajectory pipeline(trajectory, 7);
+    solver.SolveTo(pipeline);
+    ASSERT_EQ(out.str(), direct.str());
+    MatrixSink matrix;
+    PipelinedTrajectory matrix_pipeline(matrix, 7);
+    solver.SolveTo(matrix_pipeline);
+    ASSERT_EQ(matrix.Release(), expected);
+
+    // A solve stopped by an event appends fewer points than announced.
+    solver.AddEvent(ThresholdEvent(0, 1.5, 1, STOP_AT_EVENT));
+    solver.SolveTo(matrix_pipeline);
+    Eigen::MatrixXd stopped = matrix.Release();
+    ASSERT_LT(stopped.cols(), expected.cols());
+    ASSERT_EQ(stopped, expected.leftCols(stopped.cols()));
+}
+
+TEST(TextWriterTest, PipelinedSinkReportsTheErrorsOfItsSink){
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    ForwardEuler solver(0.001, 0.0, 1.0, initial_condition, function);
+    FailingSink sink(100);
+    PipelinedTrajectory pipeline(sink, 16);
+    ASSERT_THROW(solver.SolveTo(pipeline), std::runtime_error);
+    FailingSink last(995);
+    PipelinedTrajectory last_pipeline(last, 16);
+    ASSERT_THROW(solver.SolveTo(last_pipeline), std::runtime_error);
+    ASSERT_THROW(PipelinedTrajectory(sink, 0), std::invalid_argument);
+}
+
+// **************************** Input file tests *******************************
+
+TEST(InputFileTest, ParsesEveryKey){
+    std::ofstream("input_keys.txt") << "Number of equations: 2\r\n"
+                                       "Function combination: +1_6_1 0 1_6_1\r\n"
+                                       "  1_1_1 -1_6_1 0\r\n"
+                                       "Derivative combination: 0 1_7_1\n-1_7_1 0\n"
+                                       "Comment: unknown keys are skipped\n1 2 3\n\n"
+                                       "Method: 9\nInitial Time: 0.0 \nFinal Time: 1/2\nStep Size: 0.1\nSeed: 42\n"
+                                       "Number of Steps: 2\nInitial Condition: 1 0\n\t1 -0.1\n"
+                                       "Number of Stages: 2\nA: 0 0\n1/2 0\nB: 0 1\nC: 0 1/2\nAlpha: NA\nBeta: 5.0/12.0 2.0/3.0 -1.0/12.0";
+    InputParameters params = ParseInputFile("input_keys.txt");
+    ASSERT_EQ(params.num_equations, 2);
+    ASSERT_EQ(params.function_matrix, std::vector<std::vector<std::string>>({{"+1_6_1", "0", "1_6_1"}, {"1_1_1", "-1_6_1", "0"}}));
+    ASSERT_EQ(params.derivative_matrix, std::vector<std::vector<std::string>>({{"0", "1_7_1"}, {"-1_7_1", "0"}}));
+    ASSERT_TRUE(params.function_terms.empty());
+    ASSERT_EQ(params.method, 9);
+    ASSERT_EQ(params.initial_time, 0.0);
+    ASSERT_EQ(params.final_time, 0.5);
+    ASSERT_EQ(params.step_size, 0.1);
+    ASSERT_EQ(params.seed, 42);
+    Eigen::MatrixXd initial_condition(2, 2);
+    initial_condition << 1, 1, 0, -0.1;
+    ASSERT_EQ(params.initial_condition, initial_condition);
+    Eigen::MatrixXd a(2, 2);
+    a << 0, 0, 0.5, 0;
+    ASSERT_EQ(params.a, a);
+    ASSERT_EQ(params.b, Eigen::Vector2d(0, 1));
+    ASSERT_EQ(params.c, Eigen::Vector2d(0, 0.5));
+    ASSERT_EQ(params.alpha.size(), 0);
+    ASSERT_EQ(params.beta, Eigen::Vector3d(5.0 / 12.0, 2.0 / 3.0, -1.0 / 12.0));
+
+    std::ofstream("input_invalid.txt") << "1 2\nNumber of equations: 1\n";
+    ASSERT_THROW(ParseInputFile("input_invalid.txt"), std::runtime_error);
+    std::ofstream("input_invalid.txt") << "Number of equations 1\n";
+    ASSERT_THROW(ParseInputFile("input_invalid.txt"), std::runtime_error);
+    std::ofstream("input_invalid.txt") << "Number of equations: 2\nNumber of Steps: 1\nInitial Condition: 1 2 3\n";
+    ASSERT_THROW(ParseInputFile("input_invalid.txt"), std::runtime_error);
+    ASSERT_THROW(ParseInputFile("input_missing.txt"), std::runtime_error);
+}
+
+TEST(InputFileTest, SparseTermsMatchTheDenseMatrices){
+    std::string problem = "Number of equations: 3\nMethod: 11\nInitial Time: 0\nFinal Time: 1\nStep Size: 0.05\n"
+                          "Number of Steps: 1\nInitial Condition: 1 0 2\n";
+    std::ofstream("input_dense.txt") << problem << "Function combination: 1_2_1 0 1_6_1 0\n0 -1_6_1 0 0\n0 0 0 -2_6_1\n"
+                                     << "Derivative combination: 0 1_7_1 0\n-1_7_1 0 0\n0 0 -2_7_1\n";
+    // The terms may come in any order and several on a line; columns count the time as 0 and the variables from 1.
+    std::ofstream("input_sparse.txt") << problem << "Function terms: 3 3 -2_6_1\n1 0 1_2_1   2 1 -1_6_1\n1 2 1_6_1\n"
+                                      << "Derivative terms:\n2 1 -1_7_1\n1 2 1_7_1\n3 3 -2_7_1\n";
+    InputParameters dense = ParseInputFile("input_dense.txt");
+    InputParameters sparse = ParseInputFile("input_sparse.txt");
+    ASSERT_EQ(sparse.function_terms.size(), 4);
+    ASSERT_EQ(sparse.function_terms[0].row, 2);
+    ASSERT_EQ(sparse.function_terms[0].column, 3);
+    ASSERT_EQ(sparse.function_terms[0].entry, "-2_6_1");
+    ASSERT_EQ(sparse.derivative_terms[0].row, 1);
+    ASSERT_EQ(sparse.derivative_terms[0].column, 0);
+
+    // The terms are compiled in the same order as the entries of the dense matrices.
+    Function dense_function(dense.function_matrix, dense.derivative_matrix);
+    Function sparse_function(sparse.num_equations, sparse.function_terms, sparse.derivative_terms);
+    ASSERT_EQ(sparse_function.GetCoefficients(), dense_function.GetCoefficients());
+    std::string dense_method, sparse_method;
+    Eigen::MatrixXd expected = SolveProblem(dense, dense_method);
+    ASSERT_EQ(SolveProblem(sparse, sparse_method), expected);
+    ASSERT_EQ(sparse_method, dense_method);
+
+    // A derivative given as two terms at the same position is their sum.
+    std::ofstream("input_sparse.txt") << problem << "Function terms: 3 3 -2_6_1\n1 0 1_2_1   2 1 -1_6_1\n1 2 1_6_1\n"
+                                      << "Derivative terms:\n2 1 -1_7_1\n1 2 1_7_1\n3 3 -1_7_1\n3 3 -1_7_1\n";
+    InputParameters split = ParseInputFile("input_sparse.txt");
+    ASSERT_EQ(split.derivative_terms.size(), 4);
+    Function split_function(split.num_equations, split.function_terms, split.derivative_terms);
+    Eigen::Vector3d y(0.3, -1.2, 2.0);
+    ASSERT_EQ(split_function.BuildJacobian(0.5, y), sparse_function.BuildJacobian(0.5, y));
+    ASSERT_EQ(SolveProblem(split, sparse_method), expected);
+
+    ASSERT_THROW(Function(3, {{3, 1, "1_6_1"}}), std::invalid_argument);
+    ASSERT_THROW(Function(3, {{0, 4, "1_6_1"}}), std::invalid_argument);
+    ASSERT_THROW(Function(3, {{0, 1, "1_6_1"}}, {{0, 3, "1_7_1"}}), std::invalid_argument);
+    ASSERT_THROW(Function(3, {{0, 1, "1_6"}}), std::invalid_argument);
+    ASSERT_THROW(Function(3, {{0, 1, "1._6_1"}}), std::invalid_argument);
+    ASSERT_NO_THROW(Function(3, {{0, 1, "-.5_6_(+2)"}}));
+    ASSERT_THROW(Function(3, {{0, 1, "1_6_1"}}).BuildJacobian(0.0, Eigen::Vector3d::Zero()), std::runtime_error);
+    std::ofstream("input_sparse.txt") << problem << "Function terms: 1 0\n";
+    ASSERT_THROW(ParseInputFile("input_sparse.txt"), std::runtime_error);
+    std::ofstream("input_sparse.txt") << problem << "Function terms: 1 2 1_6_1\nDerivative combination: 0 1_7_1 0\n0 0 0\n0 0 0\n";
+    sparse = ParseInputFile("input_sparse.txt");
+    ASSERT_THROW(SolveProblem(sparse, sparse_method), std::runtime_error);
+}
+
+TEST(FunctionTest, SavedTermsLoadWithoutParsing){
+    Function function({{"1_2_1", "0", "1_6_1"}, {"0", "-1_3_(-2)", "2.5_4_2"}}, {{"0", "1_7_1"}, {"-2_3_(-2)", "5_6_1"}});
+    std::stringstream stream;
+    function.Save(stream);
+    Function loaded = Function::Load(stream);
+    ASSERT_EQ(loaded.GetCoefficients(), function.GetCoefficients());
+    ASSERT_TRUE(loaded.HasJacobian());
+    ASSERT_FALSE(loaded.IsAutonomous());
+    Eigen::Vector2d y(0.3, 1.7);
+    ASSERT_EQ(loaded.BuildRightHandSide(0.2, y), function.BuildRightHandSide(0.2, y));
+    ASSERT_EQ(loaded.BuildJacobian(0.2, y), function.BuildJacobian(0.2, y));
+
+    // Replacing one combination keeps the compiled terms of the other.
+    loaded.SetDerivativeCombination({{"0", "0"}, {"0", "1_7_1"}});
+    ASSERT_EQ(loaded.BuildRightHandSide(0.2, y), function.BuildRightHandSide(0.2, y));
+    ASSERT_EQ(loaded.BuildJacobian(0.2, y), Eigen::Matrix2d(Eigen::Vector2d(0, 1).asDiagonal()));
+
+    std::string truncated = stream.str();
+    std::stringstream truncated_stream;
+    function.Save(truncated_stream);
+    truncated = truncated_stream.str();
+    truncated.resize(truncated.size() - 1);
+    std::istringstream in(truncated);
+    ASSERT_THROW(Function::Load(in), std::runtime_error);
+}
+
+TEST(InputFileTest, ProblemCacheSkipsTheSystemSections){
+    std::string system = "Number of equations: 2\nFunction combination: +1_6_1 0 1_6_1\n1_1_1 -1_6_1 0\n"
+                         "Derivative combination: 0 1_7_1\n-1_7_1 0\n";
+    std::string run = "Method: 11\nInitial Time: 0.0\nFinal Time: 1.0\nNumber of Steps: 1\nInitial Condition: 1 0\n";
+    std::ofstream("input_cached.txt") << system << run << "Step Size: 0.1\n";
+    ProblemCache cache("problem_cache");
+    cache.Clear();
+
+    InputParameters uncached = ParseInputFile("input_cached.txt");
+    std::string method;
+    Eigen::MatrixXd expected = SolveProblem(uncached, method);
+
+    // The first parse compiles the system and stores it, the next ones load it instead of parsing the matrices.
+    InputParameters miss = ParseInputFile("input_cached.txt", cache);
+    ASSERT_FALSE(miss.function_matrix.empty());
+    ASSERT_TRUE(miss.function != nullptr);
+    ASSERT_EQ(SolveProblem(miss, method), expected);
+    InputParameters hit = ParseInputFile("input_cached.txt", cache);
+    ASSERT_TRUE(hit.function_matrix.empty());
+    ASSERT_TRUE(hit.function != nullptr);
+    ASSERT_TRUE(ProvidesDerivative(hit));
+    ASSERT_EQ(hit.step_size, 0.1);
+    ASSERT_EQ(SolveProblem(hit, method), expected);
+    ASSERT_EQ(method, "ROS2 Rosenbrock method");
+
+    // Other sections can change without a miss; a change of the system is a new entry.
+    std::ofstream("input_cached.txt") << system << run << "Step Size: 0.05\n";
+    hit = ParseInputFile("input_cached.txt", cache);
+    ASSERT_TRUE(hit.function_matrix.empty());
+    ASSERT_EQ(SolveProblem(hit, method).cols(), 21);
+    std::ofstream("input_cached.txt") << "Number of equations: 2\nFunction combination: +1_6_2 0 1_6_1\n1_1_1 -1_6_1 0\n" << run << "Step Size: 0.1\n";
+    miss = ParseInputFile("input_cached.txt", cache);
+    ASSERT_FALSE(miss.function_matrix.empty());
+    ASSERT_FALSE(ProvidesDerivative(miss));
+
+    // An invalid file is a miss; systems that do not compile are not stored.
+    std::ofstream("input_cached.txt") << system << run << "Step Size: 0.1\n";
+    std::ofstream(cache.GetCacheFile(0), std::ios::binary) << "garbage";
+    ASSERT_FALSE(cache.Load(0, miss));
+    std::ofstream("input_cached.txt") << "Number of equations: 2\nFunction combination: 1_6_1 0 0\n" << run << "Step Size: 0.1\n";
+    miss = ParseInputFile("input_cached.txt", cache);
+    ASSERT_TRUE(miss.function == nullptr);
+    ASSERT_THROW(SolveProblem(miss, method), std::runtime_error);
+    ASSERT_EQ(cache.Clear(), 3);
+}
+
+TEST(InputFileTest, TolerancesReachTheSolver){
+    std::string input = "Number of equations: 2\nFunction combination: 0 0 1_6_1\n0 -1_6_1 0\n"
+                        "Derivative combination: 0 1_7_1\n-1_7_1 0\nMethod: 11\nInitial Time: 0.0\nFinal Time: 3.0\n"
+                        "Step Size: 0.5\nNumber of Steps: 1\nInitial Condition: 1 0\n";
+    InputParameters loose = ParseInputText(input + "Relative Tolerance: 1e-2\nAbsolute Tolerance: 1e-2\n");
+    ASSERT_EQ(loose.rel_tol, 1e-2);
+    ASSERT_EQ(loose.abs_tol, 1e-2);
+    InputParameters tight = ParseInputText(input + "Relative Tolerance: 1e-9\nAbsolute Tolerance: 1e-9\n");
+
+    // The adaptive method is more accurate at the tighter tolerances.
+    std::string method;
+    Eigen::MatrixXd exact(2, 7);
+    for (int n = 0; n < 7; n++){
+        exact(0, n) = std::cos(0.5 * n);
+        exact(1, n) = -std::sin(0.5 * n);
+    }
+    double loose_error = (SolveProblem(loose, method) - exact).cwiseAbs().maxCoeff();
+    double tight_error = (SolveProblem(tight, method) - exact).cwiseAbs().maxCoeff();
+    ASSERT_LT(tight_error, 1e-6);
+    ASSERT_LT(tight_error, loose_error);
+
+    InputParameters invalid = ParseInputText(input + "Relative Tolerance: 0\nAbsolute Tolerance: 0\n");
+    ASSERT_THROW(SolveProblem(invalid, method), std::runtime_error);
+}
+
+// **************************** Checkpoint tests *******************************
+
+namespace {
+// Solve with checkpoints, then resume the solver from the last one: it must reproduce the rest of the solution exactly.
+void ExpectIdenticalRestart(OdeSolver& solver){
+    solver.SetCheckpointFile("checkpoint_test.bin", 30);
+    Eigen::MatrixXd full = solver.Solve();
+    SolverCheckpoint checkpoint = ReadCheckpoint("checkpoint_test.bin");
+    ASSERT_GT(checkpoint.next_point, 30);
+    ASSERT_LT(checkpoint.next_point, full.cols());
+
+    solver.SetCheckpointFile("", 0);
+    solver.SetRestart(checkpoint);
+    Eigen::MatrixXd resumed = solver.Solve();
+    ASSERT_EQ(resumed, full.rightCols(full.cols() - checkpoint.next_point));
+    // The restart is only used once.
+    ASSERT_EQ(solver.Solve(), full);
+    std::remove("checkpoint_test.bin");
+}
+}
+
+TEST(CheckpointTest, ResumedSolvesAreIdentical){
+    Function oscillator({{"0", "0", "+1_6_1"}, {"0", "-1_6_1", "0"}});
+    Function stiff({{"0","-1_6_1","0"},{"0","+999_6_1","-1000_6_1"}}, {{"-1_7_1","0"},{"+999_7_1","-1000_7_1"}});
+    Eigen::MatrixXd y0(2, 1);
+    y0 << 1, 2;
+
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    RungeKutta runge_kutta(0.01, 0.0, 1.0, y0, oscillator, a, b, c);
+    ExpectIdenticalRestart(runge_kutta);
+
+    // The adaptive methods resume with the step size, Jacobian and number of columns they reached.
+    RadauIIA radau(0.02, 0.0, 2.0, y0, stiff);
+    ExpectIdenticalRestart(radau);
+    Rodas4 rodas(0.02, 0.0, 2.0, y0, stiff);
+    ExpectIdenticalRestart(rodas);
+    Seulex seulex(0.02, 0.0, 2.0, y0, stiff);
+    ExpectIdenticalRestart(seulex);
+
+    // The multistep methods resume with the solutions and function values of their history.
+    Function implicit_oscillator({{"0", "0", "+1_6_1"}, {"0", "-1_6_1", "0"}}, {{"0", "+1_7_1"}, {"-1_7_1", "0"}});
+    Eigen::MatrixXd history(2, 3);
+    history << 1, std::cos(0.01), std::cos(0.02),
+               0, -std::sin(0.01), -std::sin(0.02);
+    AdamBashforthThreeSteps adam_bashforth(0.01, 0.0, 1.0, history, oscillator);
+    ExpectIdenticalRestart(adam_bashforth);
+    Eigen::VectorXd beta(4);
+    beta << 5.0/12.0, 2.0/3.0, -1.0/12.0, 0.0;
+    AdamMoulton adam_moulton(0.01, 0.0, 1.0, history, implicit_oscillator, beta);
+    adam_moulton.SetPredictor(ADAMS_BASHFORTH);
+    ExpectIdenticalRestart(adam_moulton);
+    Eigen::VectorXd alpha(4);
+    alpha << 11.0/6.0, 3.0, -3.0/2.0, 1.0/3.0;
+    BDF bdf(0.01, 0.0, 1.0, history, implicit_oscillator, alpha);
+    bdf.SetPredictor(EXTRAPOLATION);
+    ExpectIdenticalRestart(bdf);
+
+    // The stochastic methods draw the same increments after a restart.
+    EulerMaruyama euler(0.01, 0.0, 1.0, y0.topRows(1), GbmDrift(), GbmDiffusion("0.5"));
+    ExpectIdenticalRestart(euler);
+}
+
+namespace {
+// Forwards to another sink until a number of time points, then fails as if the run were preempted.
+class InterruptedSink : public TrajectorySink
+{
+public:
+    InterruptedSink(TrajectorySink& sink, long capacity) : sink(sink), capacity(capacity) {}
+    void Begin(int dimension, long num_points) override { sink.Begin(dimension, num_points); }
+    void Append(const Eigen::VectorXd& y) override {
+        if (--capacity < 0) throw std::runtime_error("Preempted");
+        sink.Append(y);
+    }
+    void Flush() override { sink.Flush(); }
+    void End() override { sink.End(); }
+private:
+    TrajectorySink& sink;
+    long capacity;
+};
+}
+
+TEST(CheckpointTest, ResumedOutputAppendsToTheInterruptedFile){
+    Function oscillator({{"0", "0", "+1_6_1"}, {"0", "-1_6_1", "0"}}, {{"0", "1_7_1"}, {"-1_7_1", "0"}});
+    Eigen::MatrixXd y0(2, 1);
+    y0 << 1, 2;
+    Ros3 solver(0.01, 0.0, 2.0, y0, oscillator);
+    Eigen::MatrixXd full = solver.Solve();
+    TrajectoryHeader header;
+    header.step_size = 0.01;
+    header.method = "ROS3 Rosenbrock method";
+
+    // The interrupted run has flushed the points before its last checkpoint, and written some after it.
+    solver.SetCheckpointFile("checkpoint_test.bin", 30);
+    {
+        MappedTrajectory trajectory("trajectory_resumed.bin", header);
+        PipelinedTrajectory pipeline(trajectory, 8);
+        InterruptedSink interrupted(pipeline, 100);
+        ASSERT_THROW(solver.SolveTo(interrupted), std::runtime_error);
+    }
+    SolverCheckpoint checkpoint = ReadCheckpoint("checkpoint_test.bin");
+    ASSERT_EQ(checkpoint.next_point, 91);
+    std::ifstream partial("trajectory_resumed.bin", std::ios::binary);
+    ASSERT_EQ(ReadTrajectoryHeader(partial).num_points, 91u);
+    partial.close();
+
+    // The resumed run cuts the file at the checkpoint and appends the rest.
+    solver.SetCheckpointFile("", 0);
+    solver.SetRestart(checkpoint);
+    MappedTrajectory trajectory("trajectory_resumed.bin", header);
+    trajectory.Resume(checkpoint.next_point);
+    PipelinedTrajectory pipeline(trajectory, 8);
+    solver.SolveTo(pipeline);
+    TrajectoryHeader read_header;
+    ASSERT_EQ(ReadTrajectory("trajectory_resumed.bin", read_header), full);
+    ASSERT_EQ(read_header.initial_time, 0.0);
+
+    // Resumed text continues the rows and the times of the uninterrupted run.
+    std::ostringstream direct;
+    CsvTrajectory direct_trajectory(direct, 0.0, 0.01);
+    solver.SolveTo(direct_trajectory);
+    std::string text = direct.str();
+    size_t cut = 0;
+    for (long row = 0; row <= checkpoint.next_point; row++)
+        cut = text.find('\n', cut) + 1;
+    std::ostringstream resumed(text.substr(0, cut), std::ios::ate);
+    CsvTrajectory resumed_trajectory(resumed, 0.0, 0.01);
+    resumed_trajectory.Resume(checkpoint.next_point);
+    solver.SetRestart(checkpoint);
+    solver.SolveTo(resumed_trajectory);
+    ASSERT_EQ(resumed.str(), text);
+
+    // A file that does not hold the points before the checkpoint is refused rather than overwritten.
+    solver.SetRestart(checkpoint);
+    MappedTrajectory other("trajectory_resumed.bin", header);
+    other.Resume(full.cols() + 1);
+    ASSERT_THROW(solver.SolveTo(other), std::runtime_error);
+    ASSERT_EQ(ReadTrajectory("trajectory_resumed.bin", read_header), full);
+    std::remove("checkpoint_test.bin");
+    std::remove("trajectory_resumed.bin");
+}
+
+TEST(CheckpointTest, ResumedMultistepOutputAppendsToTheInterruptedFile){
+    Function oscillator({{"0", "0", "+1_6_1"}, {"0", "-1_6_1", "0"}}, {{"0", "+1_7_1"}, {"-1_7_1", "0"}});
+    Eigen::MatrixXd history(2, 3);
+    history << 1, std::cos(0.01), std::cos(0.02),
+               0, -std::sin(0.01), -std::sin(0.02);
+    Eigen::VectorXd alpha(4);
+    alpha << 11.0/6.0, 3.0, -3.0/2.0, 1.0/3.0;
+    BDF solver(0.01, 0.0, 2.0, history, oscillator, alpha);
+    Eigen::MatrixXd full = solver.Solve();
+    TrajectoryHeader header;
+    header.step_size = 0.01;
+    header.method = "BDF method";
+
+    // The points reach the file as they are computed, so the interrupted run leaves those before its last checkpoint.
+    solver.SetCheckpointFile("checkpoint_test.bin", 30);
+    {
+        MappedTrajectory trajectory("trajectory_resumed.bin", header);
+        PipelinedTrajectory pipeline(trajectory, 8);
+        InterruptedSink interrupted(pipeline, 100);
+        ASSERT_THROW(solver.SolveTo(interrupted), std::runtime_error);
+    }
+    SolverCheckpoint checkpoint = ReadCheckpoint("checkpoint_test.bin");
+    ASSERT_EQ(checkpoint.next_point, 93);
+    std::ifstream partial("trajectory_resumed.bin", std::ios::binary);
+    ASSERT_EQ(ReadTrajectoryHeader(partial).num_points, 93u);
+    partial.close();
+
+    solver.SetCheckpointFile("", 0);
+    solver.SetRestart(checkpoint);
+    MappedTrajectory trajectory("trajectory_resumed.bin", header);
+    trajectory.Resume(checkpoint.next_point);
+    PipelinedTrajectory pipeline(trajectory, 8);
+    solver.SolveTo(pipeline);
+    TrajectoryHeader read_header;
+    ASSERT_EQ(ReadTrajectory("trajectory_resumed.bin", read_header), full);
+    std::remove("checkpoint_test.bin");
+    std::remove("trajectory_resumed.bin");
+}
+
+TEST(CheckpointTest, FileRoundTripAndValidation){
+    SolverCheckpoint checkpoint;
+    checkpoint.initial_time = 0.5;
+    checkpoint.final_time = 2.0;
+    checkpoint.output_step = 0.25;
+    checkpoint.next_point = 3;
+    checkpoint.time = 1.25;
+    checkpoint.step_size = 0.0625;
+    checkpoint.accepted_steps = 12;
+    checkpoint.rejected_steps = 2;
+    checkpoint.history = Eigen::MatrixXd::Random(3, 2);
+    checkpoint.rhs_history = Eigen::MatrixXd::Random(3, 2);
+    checkpoint.controller = {1.0, 0.1};
+    checkpoint.jacobian_time = 1.0;
+    checkpoint.jacobian_state = Eigen::VectorXd::Random(3);
+    checkpoint.jacobian = Eigen::MatrixXd::Random(3, 3);
+    WriteCheckpoint("checkpoint_test.bin", checkpoint);
+
+    SolverCheckpoint read = ReadCheckpoint("checkpoint_test.bin");
+    ASSERT_EQ(read.initial_time, 0.5);
+    ASSERT_EQ(read.final_time, 2.0);
+    ASSERT_EQ(read.output_step, 0.25);
+    ASSERT_EQ(read.next_point, 3);
+    ASSERT_EQ(read.time, 1.25);
+    ASSERT_EQ(read.step_size, 0.0625);
+    ASSERT_EQ(read.accepted_steps, 12);
+    ASSERT_EQ(read.rejected_steps, 2);
+    ASSERT_EQ(read.history, checkpoint.history);
+    ASSERT_EQ(read.rhs_history, checkpoint.rhs_history);
+    ASSERT_EQ(read.controller, checkpoint.controller);
+    ASSERT_EQ(read.jacobian_time, 1.0);
+    ASSERT_EQ(read.jacobian_state, checkpoint.jacobian_state);
+    ASSERT_EQ(read.jacobian, checkpoint.jacobian);
+
+    // A checkpoint of another problem, or of a method with a longer history, is refused.
+    Function function({{"0", "-1_6_1", "0", "0"}, {"0", "0", "-1_6_1", "0"}, {"0", "0", "0", "-1_6_1"}});
+    Eigen::MatrixXd y0 = Eigen::MatrixXd::Ones(3, 1);
+    ForwardEuler other(0.25, 0.5, 3.0, y0, function);
+    other.SetRestart(checkpoint);
+    ASSERT_THROW(other.Solve(), std::runtime_error);
+    ForwardEuler same(0.25, 0.5, 2.0, y0, function);
+    same.SetRestart(checkpoint);
+    ASSERT_EQ(same.Solve().cols(), 4);
+    AdamBashforthThreeSteps longer(0.25, 0.5, 2.0, Eigen::MatrixXd::Ones(3, 3), function);
+    longer.SetRestart(checkpoint);
+    ASSERT_THROW(longer.Solve(), std::runtime_error);
+
+    // Truncated and foreign files are refused too.
+    std::string contents;
+    {
+        std::ifstream file("checkpoint_test.bin", std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::ofstream("checkpoint_test.bin", std::ios::binary) << contents.substr(0, contents.size() - 8);
+    ASSERT_THROW(ReadCheckpoint("checkpoint_test.bin"), std::runtime_error);
+    std::ofstream("checkpoint_test.bin", std::ios::binary) << "ODETRAJ" << contents.substr(7);
+    ASSERT_THROW(ReadCheckpoint("checkpoint_test.bin"), std::runtime_error);
+    std::remove("checkpoint_test.bin");
+    ASSERT_THROW(ReadCheckpoint("checkpoint_test.bin"), std::runtime_error);
+}
+
+// **************************** Server tests *******************************
+
+namespace {
+std::string ServerTestInput(int function, double step_size, double y0){
+    return "Number of equations: 2\nFunction combination: +1_6_" + std::to_string(function) + " 0 1_6_1\n1_1_1 -1_6_1 0\n"
+           "Derivative combination: 0 1_7_1\n-1_7_1 0\nMethod: 11\nInitial Time: 0.0\nFinal Time: 1.0\n"
+           "Step Size: " + std::to_string(step_size) + "\nNumber of Steps: 1\nInitial Condition: " + std::to_string(y0) + " 0\n";
+}
+
+// Checks that a response holds the solution of its input, as solved without the server.
+void ExpectSolution(const ServerResponse& response, const std::string& input){
+    ASSERT_TRUE(response.success) << response.payload;
+    std::string method;
+    Eigen::MatrixXd expected = SolveProblem(ParseInputText(input), method);
+    std::istringstream in(response.payload);
+    TrajectoryHeader header;
+    ASSERT_EQ(ReadTrajectory(in, header), expected);
+    ASSERT_EQ(header.method, method);
+    ASSERT_EQ(header.initial_time, 0.0);
+}
+}
+
+TEST(ServerTest, MemoryCacheKeepsTheMostRecentSystems){
+    MemoryProblemCache cache(2);
+    InputParameters a = ParseInputText(ServerTestInput(1, 0.1, 1.0), cache);
+    ParseInputText(ServerTestInput(2, 0.1, 1.0), cache);
+    // A hit shares the compiled system instead of copying it; the other sections are still parsed.
+    InputParameters hit = ParseInputText(ServerTestInput(1, 0.05, 2.0), cache);
+    ASSERT_EQ(hit.function, a.function);
+    ASSERT_TRUE(hit.function_matrix.empty());
+    ASSERT_EQ(hit.initial_condition(0, 0), 2.0);
+    // Storing a third system evicts the least recently used one.
+    ParseInputText(ServerTestInput(3, 0.1, 1.0), cache);
+    ASSERT_EQ(cache.GetSize(), 2);
+    ASSERT_EQ(ParseInputText(ServerTestInput(1, 0.1, 1.0), cache).function, a.function);
+    ASSERT_FALSE(ParseInputText(ServerTestInput(2, 0.1, 1.0), cache).function_matrix.empty());
+    ASSERT_EQ(cache.GetHits(), 2);
+    ASSERT_EQ(cache.GetMisses(), 4);
+    ASSERT_THROW(MemoryProblemCache(0), std::invalid_argument);
+}
+
+TEST(ServerTest, AnswersConcurrentRequestsOverAStream){
+    std::vector<ServerRequest> requests;
+    for (int i = 0; i < 8; i++){
+        requests.push_back({(std::uint64_t)i, (TrajectoryLayout)(i % 3), ServerTestInput(1 + i % 2, 0.1 / (1 + i), 1.0 + i)});
+    }
+    std::string invalid_method = ServerTestInput(1, 0.1, 1.0);
+    invalid_method.replace(invalid_method.find("Method: 11"), 10, "Method: 42");
+    requests.push_back({100, TIME_MAJOR, invalid_method});
+    requests.push_back({101, TIME_MAJOR, "Number of equations 2\n"});
+
+    int to_server[2], from_server[2];
+    ASSERT_EQ(pipe(to_server), 0);
+    ASSERT_EQ(pipe(from_server), 0);
+    SolverServer server(2, 4);
+    std::thread serving([&]{
+        server.Serve(to_server[0], from_server[1]);
+        close(from_server[1]);
+    });
+    for (const auto& request : requests){
+        WriteServerRequest(to_server[1], request);
+    }
+    close(to_server[1]);
+
+    // The responses come in the order the requests finish; every request gets exactly one.
+    std::vector<int> answered(requests.size(), 0);
+    ServerResponse response;
+    while (ReadServerResponse(from_server[0], response)){
+        // Keep reading on a failure, so that the serving thread can finish.
+        if (response.id == 100 || response.id == 101){
+            EXPECT_FALSE(response.success);
+            EXPECT_FALSE(response.payload.empty());
+            answered[response.id - 100 + 8]++;
+        }
+        else if (response.id < 8){
+            ExpectSolution(response, requests[response.id].input);
+            answered[response.id]++;
+        }
+    }
+    serving.join();
+    close(to_server[0]);
+    close(from_server[0]);
+    ASSERT_EQ(answered, std::vector<int>(requests.size(), 1));
+    ASSERT_EQ(server.GetCache().GetSize(), 2);
+    ASSERT_GE(server.GetCache().GetHits(), 5);
+
+    // An invalid frame stops the stream, after the requests before it are answered.
+    ASSERT_EQ(pipe(to_server), 0);
+    ASSERT_EQ(pipe(from_server), 0);
+    WriteServerRequest(to_server[1], requests[0]);
+    ASSERT_EQ(write(to_server[1], "garbage", 7), 7);
+    close(to_server[1]);
+    ASSERT_THROW(server.Serve(to_server[0], from_server[1]), std::runtime_error);
+    close(from_server[1]);
+    ASSERT_TRUE(ReadServerResponse(from_server[0], response));
+    ExpectSolution(response, requests[0].input);
+    ASSERT_FALSE(ReadServerResponse(from_server[0], response));
+    close(to_server[0]);
+    close(from_server[0]);
+}
+
+TEST(ServerTest, RejectsAnInitialConditionShorterThanTheHistory){
+    const std::string scalar = "Number of equations: 1\nFunction combination: +1_3_-1 1_2_1\nDerivative combination: -1_1_1\n"
+                               "Initial Time: 0.0\nFinal Time: 2.0\nStep Size: 0.1\nNumber of Steps: 2\nInitial Condition: 0.0\n0.2\n";
+    // The three-step Adams-Bashforth method needs one more initial step than the two-step one.
+    std::vector<ServerRequest> requests = {{0, TIME_MAJOR, scalar + "Method: 3\n"},
+                                           {1, TIME_MAJOR, scalar + "Method: 4\n"},
+                                           {2, TIME_MAJOR, ServerTestInput(1, 0.1, 1.0)}};
+    int to_server[2], from_server[2];
+    ASSERT_EQ(pipe(to_server), 0);
+    ASSERT_EQ(pipe(from_server), 0);
+    for (const auto& request : requests){
+        WriteServerRequest(to_server[1], request);
+    }
+    close(to_server[1]);
+    SolverServer server(1);
+    server.Serve(to_server[0], from_server[1]);
+    close(from_server[1]);
+
+    // The server keeps answering after the rejected request.
+    std::vector<int> answered(requests.size(), 0);
+    ServerResponse response;
+    while (ReadServerResponse(from_server[0], response)){
+        ASSERT_LT(response.id, requests.size());
+        answered[response.id]++;
+        if (response.id == 1){
+            ASSERT_FALSE(response.success);
+            ASSERT_EQ(response.payload, "The Adam-Bashforth three-steps needs 3 steps in the initial condition, which has 2.");
+        }
+        else{
+            ExpectSolution(response, requests[response.id].input);
+        }
+    }
+    ASSERT_EQ(answered, std::vector<int>(requests.size(), 1));
+    close(to_server[0]);
+    close(from_server[0]);
+}
+
+TEST(ServerTest, ServesConnectionsOnASocket){
+    const std::string socket_path = "server_test.sock";
+    SolverServer server(2);
+    server.Listen(socket_path);
+    ASSERT_THROW(server.Listen(socket_path), std::runtime_error);
+    std::thread serving([&]{ server.ServeConnections(); });
+
+    auto connect_client = [&]{
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, socket_path.c_str());
+        EXPECT_EQ(connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        return fd;
+    };
+    int first = connect_client();
+    int second = connect_client();
+    for (int i = 0; i < 3; i++){
+        WriteServerRequest(first, {(std::uint64_t)i, TIME_MAJOR, ServerTestInput(1, 0.1, 1.0 + i)});
+        WriteServerRequest(second, {(std::uint64_t)i, XOR_COMPRESSED, ServerTestInput(2, 0.05, 1.0 + i)});
+    }
+    ServerResponse response;
+    for (int i = 0; i < 3; i++){
+        ASSERT_TRUE(ReadServerResponse(first, response));
+        ExpectSolution(response, ServerTestInput(1, 0.1, 1.0 + response.id));
+        ASSERT_TRUE(ReadServerResponse(second, response));
+        ExpectSolution(response, ServerTestInput(2, 0.05, 1.0 + response.id));
+    }
+    close(first);
+
+    // Stopping closes the open connections and removes the socket.
+    server.Stop();
+    serving.join();
+    ASSERT_FALSE(ReadServerResponse(second, response));
+    close(second);
+    struct stat info;
+    ASSERT_NE(stat(socket_path.c_str(), &info), 0);
+}
+
+// **************************** Event tests *******************************
+
+namespace {
+RungeKutta EventTestRK4(double step_size, double final_time, Eigen::VectorXd initial_condition, Function function){
+    Eigen::VectorXd b(4);
+    b << 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0;
+    Eigen::VectorXd c(4);
+    c << 0, 0.5, 0.5, 1;
+    Eigen::MatrixXd a(4, 4);
+    a << 0, 0, 0, 0,
+         0.5, 0, 0, 0,
+         0, 0.5, 0, 0,
+         0, 0, 1, 0;
+    return RungeKutta(step_size, 0.0, final_time, initial_condition, function, a, b, c);
+}
+}
+
+TEST(EventTest, RecordsAndStopsOnAnOscillator){
+    // y1' = y2, y2' = -y1, y(0) = (1, 0) with the exact solution y1 = cos(t), y2 = -sin(t).
+    Function function({{"0", "0", "1_6_1"}, {"0", "-1_6_1", "0"}});
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1.0, 0.0;
+    RungeKutta method = EventTestRK4(0.1, 10.0, initial_condition, function);
+    ASSERT_EQ(method.AddEvent(ThresholdEvent(0, 0.0, 0, RECORD_EVENT)), 0);
+    ASSERT_EQ(method.AddEvent(ThresholdEvent(1, 0.0, 1, RECORD_EVENT)), 1);
+    Eigen::MatrixXd expected = EventTestRK4(0.1, 10.0, initial_condition, function).Solve();
+    // Recording events leave the solution untouched.
+    ASSERT_EQ(method.Solve(), expected);
+    const std::vector<EventOccurrence>& occurrences = method.GetEventOccurrences();
+    const double pi = std::acos(-1.0);
+    std::vector<double> times = {0.5 * pi, pi, 1.5 * pi, 2.5 * pi, 3.0 * pi};
+    std::vector<int> events = {0, 1, 0, 0, 1};
+    ASSERT_EQ(occurrences.size(), times.size());
+    for (std::size_t i = 0; i < times.size(); i++){
+        ASSERT_EQ(occurrences[i].event, events[i]);
+        ASSERT_NEAR(occurrences[i].time, times[i], 1e-5);
+        ASSERT_NEAR(occurrences[i].state(events[i]), 0.0, 1e-5);
+    }
+
+    // Stopping when y1 falls to 0.5, at t = pi / 3, only outputs the time points before it.
+    method.ClearEvents();
+    method.AddEvent(ThresholdEvent(0, 0.5, -1, STOP_AT_EVENT));
+    Eigen::MatrixXd approximations = method.Solve();
+    ASSERT_EQ(approximations.cols(), 11);
+    ASSERT_EQ(approximations, expected.leftCols(11));
+    ASSERT_EQ(method.GetEventOccurrences().size(), 1u);
+    ASSERT_NEAR(method.GetEventOccurrences()[0].time, pi / 3.0, 1e-6);
+    ASSERT_NEAR(method.GetEventOccurrences()[0].state(0), 0.5, 1e-6);
+}
+
+TEST(EventTest, RestartsABouncingBall){
+    // y1' = y2, y2' = -9.81: a ball dropped from a height of 1, whose velocity flips and loses 20% at every bounce.
+    Function function({{"0", "0", "1_6_1"}, {"-9.81_7_1", "0", "0"}});
+    Eigen::VectorXd initial_condition(2);
+    initial_condition << 1.0, 0.0;
+    RungeKutta method = EventTestRK4(0.05, 2.0, initial_condition, function);
+    SolverEvent bounce = ThresholdEvent(0, 0.0, -1, RESTART_AT_EVENT);
+    bounce.reset = [](double, Eigen::VectorXd& y) {
+        y(0) = 0.0;
+        y(1) = -0.8 * y(1);
+    };
+    method.AddEvent(bounce);
+    Eigen::MatrixXd approximations = method.Solve();
+    ASSERT_EQ(approximations.cols(), 41);
+    ASSERT_GE(approximations.row(0).minCoeff(), -1e-12);
+
+    // The solution is quadratic, which RK4 and the interpolant reproduce exactly.
+    double fall = std::sqrt(2.0 / 9.81);
+    std::vector<double> times = {fall, fall + 1.6 * fall, fall + 1.6 * fall + 1.28 * fall};
+    const std::vector<EventOccurrence>& occurrences = method.GetEventOccurrences();
+    ASSERT_EQ(occurrences.size(), times.size());
+    for (std::size_t i = 0; i < times.size(); i++){
+        ASSERT_NEAR(occurrences[i].time, times[i], 1e-10);
+        ASSERT_NEAR(occurrences[i].state(1), -9.81 * fall * std::pow(0.8, i), 1e-9);
+    }
+}
+
+TEST(EventTest, AdaptiveSolversStopWithinAStep){
+    // y' = -y, y(0) = 1 falls to 0.5 at t = ln 2.
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    Rodas4 rodas(0.1, 0.0, 2.0, initial_condition, function);
+    RadauIIA radau(0.1, 0.0, 2.0, initial_condition, function);
+    RadauIIA fixed(0.1, 0.0, 2.0, initial_condition, function);
+    fixed.SetAdaptive(false);
+    for (AdaptiveSolver* method : std::vector<AdaptiveSolver*>{&rodas, &radau, &fixed}){
+        method->AddEvent(ThresholdEvent(0, 0.5, 0, STOP_AT_EVENT));
+        Eigen::MatrixXd approximations = method->Solve();
+        ASSERT_EQ(approximations.cols(), 7);
+        ASSERT_NEAR(approximations(0, 6), std::exp(-0.6), 1e-5);
+        ASSERT_EQ(method->GetEventOccurrences().size(), 1u);
+        ASSERT_NEAR(method->GetEventOccurrences()[0].time, std::log(2.0), 1e-6);
+        ASSERT_NEAR(method->GetEventOccurrences()[0].state(0), 0.5, 1e-6);
+    }
+}
+
+TEST(EventTest, InvalidEventsAreRejected){
+    Function function({{"0", "-1_6_1"}}, {{"-1_7_1"}});
+    Eigen::MatrixXd initial_condition = Eigen::MatrixXd::Ones(1, 1);
+    AdamBashforthTwoSteps multistep(0.1, 0.0, 1.0, initial_condition, function);
+    ASSERT_THROW(multistep.AddEvent(ThresholdEvent(0, 0.5, 0, STOP_AT_EVENT)), std::runtime_error);
+    RungeKutta method = EventTestRK4(0.1, 1.0, initial_condition, function);
+    ASSERT_THROW(method.AddEvent(SolverEvent()), std::invalid_argument);
+    ASSERT_THROW(method.AddEvent(ThresholdEvent(0, 0.5, 0, RESTART_AT_EVENT)), std::invalid_argument);
+    ASSERT_THROW(ThresholdEvent(-1, 0.5, 0, RECORD_EVENT), std::invalid_argument);
+    ASSERT_THROW(ThresholdEvent(0, 0.5, 2, RECORD_EVENT), std::invalid_argument);
+}
+
+TEST(EventTest, InputFileEvents){
+    std::string input = "Number of equations: 2\nFunction combination: 0 0 1_6_1\n0 -1_6_1 0\n"
+                        "Derivative combination: 0 1_7_1\n-1_7_1 0\nMethod: 11\nInitial Time: 0.0\nFinal Time: 3.0\n"
+                        "Step Size: 0.1\nNumber of Steps: 1\nInitial Condition: 1 0\n"
+                        "Events: 2 -0.5 falling\n1 0.0 any stop\n";
+    InputParameters params = ParseInputText(input);
+    ASSERT_EQ(params.events.size(), 2u);
+    ASSERT_EQ(params.events[0].action, RECORD_EVENT);
+    ASSERT_EQ(params.events[0].direction, -1);
+    ASSERT_EQ(params.events[1].action, STOP_AT_EVENT);
+    ASSERT_EQ(params.events[1].direction, 0);
+
+    std::string method;
+    std::vector<EventOccurrence> occurrences;
+    Eigen::MatrixXd approximations = SolveProblem(params, method, &occurrences);
+    const double pi = std::acos(-1.0);
+    ASSERT_EQ(approximations.cols(), 16);
+    ASSERT_EQ(occurrences.size(), 2u);
+    ASSERT_EQ(occurrences[0].event, 0);
+    ASSERT_NEAR(occurrences[0].time, pi / 6.0, 1e-5);
+    ASSERT_EQ(occurrences[1].event, 1);
+    ASSERT_NEAR(occurrences[1].time, pi / 2.0, 1e-5);
+
+    ASSERT_THROW(ParseInputText(input + "0 1.0\n"), std::runtime_error);
+    ASSERT_THROW(ParseInputText(input + "1 1.0 sideways\n"), std::runtime_error);
+    ASSERT_THROW(ParseInputText(input + "1\n"), std::runtime_error);
+}